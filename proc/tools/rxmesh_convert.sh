@@ -0,0 +1,25 @@
+#!/bin/bash
+
+# Builds the mesh converter on its own, as the engine build compiles everything under ../rxtion into one binary
+mkdir -p bin/tools
+cd bin/tools
+
+inc=(
+	-I ../../vendor/					# Vendor includes
+	-I ../../rxtion/					# Rxtion includes
+)
+
+src=(
+	../../tools/rxmesh_convert.c
+	../../rxtion/rxcore/rendering/mesh_file.c
+	../../rxtion/rxcore/rendering/mesh_optimizer.c
+	../../vendor/cjson/cJSON.c
+)
+
+build_cmd="gcc -O2 -std=gnu99 ${inc[*]} ${src[*]} -lm -o rxmesh_convert"
+
+echo "Building rxmesh_convert..."
+echo $build_cmd
+$build_cmd
+
+cd ../..
@@ -6,6 +6,7 @@
 #include <rxcore/rendering/shader.h>
 #include <rxcore/rendering.h>
 #include <rxcore/profiler.h>
+#include <rxcore/benchmark.h>
 
 typedef struct rxapp_t
 {
@@ -17,8 +18,14 @@ gs_global rxcore_systems_t *g_debug_systems;
 
 void rxapp_init()
 {
+#ifdef RXCORE_BENCHMARKS_ENABLED
+    g_debug_systems = RXCORE_SYSTEMS(
+        rxcore_profiling_system,
+        rxcore_benchmark_system, );
+#else
     g_debug_systems = RXCORE_SYSTEMS(
         rxcore_profiling_system, );
+#endif
 
     g_core_systems = RXCORE_SYSTEMS(
         rxcore_rendering_system, );
@@ -0,0 +1,79 @@
+// benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/profiler.h>
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+volatile uint64_t g_rxcore_benchmark_sink;
+
+static rxcore_benchmark_suite_fn _rxcore_benchmark_suites[] = {
+    rxcore_benchmark_cull,
+    rxcore_benchmark_bvh,
+    rxcore_benchmark_spatial_grid,
+    rxcore_benchmark_occlusion,
+    rxcore_benchmark_picking,
+    rxcore_benchmark_mesh,
+    rxcore_benchmark_mesh_optimizer,
+    rxcore_benchmark_strid,
+};
+
+void rxcore_benchmark_system_init()
+{
+    gs_println("Running %d benchmark suites", (int)(sizeof(_rxcore_benchmark_suites) / sizeof(_rxcore_benchmark_suites[0])));
+    RXCORE_PROFILER_BEGIN_TASK("benchmarks");
+    for (uint32_t i = 0; i < sizeof(_rxcore_benchmark_suites) / sizeof(_rxcore_benchmark_suites[0]); i++)
+    {
+        _rxcore_benchmark_suites[i]();
+    }
+    RXCORE_PROFILER_END_TASK();
+}
+
+void rxcore_benchmark_system_update()
+{
+}
+
+void rxcore_benchmark_system_shutdown()
+{
+}
+
+double rxcore_benchmark_now_ms()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = {0};
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#endif
+}
+
+void rxcore_benchmark_report(rxcore_benchmark_result_t *result)
+{
+    // items per microsecond reads a lot better than items per millisecond at these sizes
+    double throughput = result->min_ms > 0.0 ? (double)result->size / (result->min_ms * 1000.0) : 0.0;
+    gs_println("  %-32s n=%-9llu min %9.3f ms  mean %9.3f ms  %8.2f items/us",
+               result->name,
+               (unsigned long long)result->size,
+               result->min_ms,
+               result->mean_ms,
+               throughput);
+}
+
+void rxcore_benchmark_check(const char *name, bool passed)
+{
+    gs_println("  %-32s %s", name, passed ? "ok" : "MISMATCH");
+}
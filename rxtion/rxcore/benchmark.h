@@ -0,0 +1,78 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <gs/gs.h>
+#include <rxcore/system.h>
+
+// add rxcore_benchmark_system to the debug systems, and run every suite on startup
+// #define RXCORE_BENCHMARKS_ENABLED
+
+/**
+ * Example Usage
+ * RXCORE_BENCHMARK("cull_scalar", count, 10, {
+ *     visible = _rxcore_cull_frustum_scalar(&frustum, bounds, 0, count, out);
+ * });
+ */
+
+typedef void (*rxcore_benchmark_suite_fn)(void);
+
+typedef struct rxcore_benchmark_result_t
+{
+    const char *name;
+    uint64_t size; // the number of items each iteration processes
+    uint32_t iterations;
+    double min_ms;
+    double mean_ms;
+} rxcore_benchmark_result_t;
+
+// results are written here so that the work being timed can't be optimized away
+extern volatile uint64_t g_rxcore_benchmark_sink;
+
+void rxcore_benchmark_system_init();
+void rxcore_benchmark_system_update();
+void rxcore_benchmark_system_shutdown();
+
+/// @brief A monotonic clock with sub-microsecond resolution, unlike the frame clock of the platform
+double rxcore_benchmark_now_ms();
+void rxcore_benchmark_report(rxcore_benchmark_result_t *result);
+
+/// @brief Prints a check that an optimized path agrees with the reference one
+void rxcore_benchmark_check(const char *name, bool passed);
+
+// suites, each lives in rxcore/benchmarks
+void rxcore_benchmark_cull();
+void rxcore_benchmark_bvh();
+void rxcore_benchmark_spatial_grid();
+void rxcore_benchmark_occlusion();
+void rxcore_benchmark_picking();
+void rxcore_benchmark_mesh();
+void rxcore_benchmark_mesh_optimizer();
+void rxcore_benchmark_strid();
+
+#define RXCORE_BENCHMARK(NAME, SIZE, ITERATIONS, ...)                \
+    do                                                               \
+    {                                                                \
+        rxcore_benchmark_result_t _result = {                        \
+            .name = NAME,                                            \
+            .size = SIZE,                                            \
+            .iterations = ITERATIONS,                                \
+            .min_ms = 1e30,                                          \
+        };                                                           \
+        double _total_ms = 0.0;                                      \
+        for (uint32_t _i = 0; _i < (ITERATIONS); _i++)               \
+        {                                                            \
+            double _start_ms = rxcore_benchmark_now_ms();            \
+            __VA_ARGS__;                                             \
+            double _elapsed_ms = rxcore_benchmark_now_ms() - _start_ms; \
+            _total_ms += _elapsed_ms;                                \
+            _result.min_ms = gs_min(_result.min_ms, _elapsed_ms);    \
+        }                                                            \
+        _result.mean_ms = _total_ms / (ITERATIONS);                  \
+        rxcore_benchmark_report(&_result);                           \
+    } while (0)
+
+#define rxcore_benchmark_system RXCORE_SYSTEM(rxcore_benchmark_system_init, rxcore_benchmark_system_update, rxcore_benchmark_system_shutdown)
+
+#endif // __BENCHMARK_H__
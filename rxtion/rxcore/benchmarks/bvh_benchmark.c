@@ -0,0 +1,207 @@
+// bvh_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/bvh.h>
+#include <rxcore/profiler.h>
+#include <float.h>
+
+typedef struct _rxcore_bvh_benchmark_hits_t
+{
+    uint32_t count;
+    uint64_t sum; // of the indices found, so both sides of a check have to find the same ones
+} _rxcore_bvh_benchmark_hits_t;
+
+typedef struct _rxcore_bvh_benchmark_ray_t
+{
+    rxcore_bvh_t *bvh;
+    float closest;
+} _rxcore_bvh_benchmark_ray_t;
+
+static uint32_t _rxcore_bvh_benchmark_seed = 0x9E3779B9u;
+
+static float _rxcore_bvh_benchmark_random()
+{
+    _rxcore_bvh_benchmark_seed = _rxcore_bvh_benchmark_seed * 1664525u + 1013904223u;
+    return (float)(_rxcore_bvh_benchmark_seed >> 8) / (float)(1u << 24);
+}
+
+static rxcore_bounding_box_t _rxcore_bvh_benchmark_box(float range, float size)
+{
+    gs_vec3 p = gs_v3(
+        _rxcore_bvh_benchmark_random() * range - range * 0.5f,
+        _rxcore_bvh_benchmark_random() * range - range * 0.5f,
+        _rxcore_bvh_benchmark_random() * range - range * 0.5f);
+    float s = size * (0.5f + _rxcore_bvh_benchmark_random());
+    return rxcore_bounding_box_create(p, gs_v3(p.x + s, p.y + s, p.z + s));
+}
+
+static void _rxcore_bvh_benchmark_collect(uint32_t leaf, void *leaf_data, void *user_data)
+{
+    _rxcore_bvh_benchmark_hits_t *hits = user_data;
+    hits->count++;
+    hits->sum += (uintptr_t)leaf_data;
+}
+
+static float _rxcore_bvh_benchmark_closest(uint32_t leaf, void *leaf_data, rxcore_ray_t *ray, float max_distance, void *user_data)
+{
+    // the boxes are the objects here, so the box hit is the object hit
+    _rxcore_bvh_benchmark_ray_t *search = user_data;
+    float distance = 0.f;
+    if (rxcore_bounding_box_intersects_ray(rxcore_bvh_get_bounds(search->bvh, leaf), ray, max_distance, &distance))
+    {
+        search->closest = distance;
+        return distance;
+    }
+    return max_distance;
+}
+
+void rxcore_benchmark_bvh()
+{
+    gs_println("Bounding volume hierarchy");
+
+    gs_mat4 view_projection = gs_mat4_perspective(60.f, 16.f / 9.f, 0.1f, 500.f);
+    rxcore_frustum_t frustum = rxcore_frustum_from_matrix(view_projection);
+
+    uint32_t sizes[] = {10000, 100000};
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        uint32_t count = sizes[s];
+        uint32_t moving = count / 10;
+        uint32_t queries = 100;
+
+        rxcore_bounding_box_t *boxes = malloc(sizeof(rxcore_bounding_box_t) * count);
+        uint32_t *leaves = malloc(sizeof(uint32_t) * count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            boxes[i] = _rxcore_bvh_benchmark_box(1000.f, 2.f);
+        }
+
+        rxcore_bvh_t *bvh = NULL;
+        RXCORE_BENCHMARK("insert one by one", count, 1, {
+            bvh = rxcore_bvh_create();
+            for (uint32_t i = 0; i < count; i++)
+            {
+                leaves[i] = rxcore_bvh_insert(bvh, &boxes[i], (void *)(uintptr_t)i);
+            }
+        });
+        gs_println("  inserted: height %d, cost %.1f", rxcore_bvh_get_height(bvh), rxcore_bvh_get_cost(bvh));
+
+        RXCORE_BENCHMARK("sah rebuild", count, 5, {
+            rxcore_bvh_rebuild(bvh);
+        });
+        gs_println("  rebuilt: height %d, cost %.1f", rxcore_bvh_get_height(bvh), rxcore_bvh_get_cost(bvh));
+
+        // the same tenth of the objects drift a little every frame
+        RXCORE_BENCHMARK("refit, 10% moving", moving, 20, {
+            for (uint32_t i = 0; i < moving; i++)
+            {
+                uint32_t index = i * 10;
+                gs_vec3 offset = gs_v3(_rxcore_bvh_benchmark_random() - 0.5f, _rxcore_bvh_benchmark_random() - 0.5f, _rxcore_bvh_benchmark_random() - 0.5f);
+                boxes[index].min = gs_vec3_add(boxes[index].min, offset);
+                boxes[index].max = gs_vec3_add(boxes[index].max, offset);
+                rxcore_bvh_update(bvh, leaves[index], &boxes[index]);
+            }
+            rxcore_bvh_refit(bvh);
+        });
+        gs_println("  refit: height %d, cost %.1f", rxcore_bvh_get_height(bvh), rxcore_bvh_get_cost(bvh));
+
+        _rxcore_bvh_benchmark_hits_t reference = {0};
+        _rxcore_bvh_benchmark_hits_t found = {0};
+        RXCORE_BENCHMARK("frustum, brute force", count, 20, {
+            reference = (_rxcore_bvh_benchmark_hits_t){0};
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (rxcore_frustum_test_aabb(&frustum, &boxes[i]))
+                {
+                    _rxcore_bvh_benchmark_collect(i, (void *)(uintptr_t)i, &reference);
+                }
+            }
+            g_rxcore_benchmark_sink += reference.count;
+        });
+
+        RXCORE_BENCHMARK("frustum, bvh", count, 20, {
+            found = (_rxcore_bvh_benchmark_hits_t){0};
+            rxcore_bvh_query_frustum(bvh, &frustum, _rxcore_bvh_benchmark_collect, &found);
+            g_rxcore_benchmark_sink += found.count;
+        });
+        rxcore_benchmark_check("frustum, bvh", found.count == reference.count && found.sum == reference.sum);
+
+        // small boxes, like an overlap test for a character would use
+        rxcore_bounding_box_t *query_boxes = malloc(sizeof(rxcore_bounding_box_t) * queries);
+        for (uint32_t q = 0; q < queries; q++)
+        {
+            query_boxes[q] = _rxcore_bvh_benchmark_box(1000.f, 50.f);
+        }
+
+        RXCORE_BENCHMARK("100 boxes, brute force", count, 5, {
+            reference = (_rxcore_bvh_benchmark_hits_t){0};
+            for (uint32_t q = 0; q < queries; q++)
+            {
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    if (rxcore_bounding_box_intersects_box(&query_boxes[q], &boxes[i]))
+                    {
+                        _rxcore_bvh_benchmark_collect(i, (void *)(uintptr_t)i, &reference);
+                    }
+                }
+            }
+            g_rxcore_benchmark_sink += reference.count;
+        });
+
+        RXCORE_BENCHMARK("100 boxes, bvh", count, 5, {
+            found = (_rxcore_bvh_benchmark_hits_t){0};
+            for (uint32_t q = 0; q < queries; q++)
+            {
+                rxcore_bvh_query_box(bvh, &query_boxes[q], _rxcore_bvh_benchmark_collect, &found);
+            }
+            g_rxcore_benchmark_sink += found.count;
+        });
+        rxcore_benchmark_check("100 boxes, bvh", found.count == reference.count && found.sum == reference.sum);
+
+        // rays from near the middle in every direction, looking for the nearest box
+        rxcore_ray_t *rays = malloc(sizeof(rxcore_ray_t) * queries);
+        for (uint32_t q = 0; q < queries; q++)
+        {
+            gs_vec3 direction = gs_vec3_norm(gs_v3(_rxcore_bvh_benchmark_random() - 0.5f, _rxcore_bvh_benchmark_random() - 0.5f, _rxcore_bvh_benchmark_random() - 0.5f));
+            rays[q] = rxcore_ray_create(gs_v3(0.f, 0.f, 0.f), direction);
+        }
+
+        float reference_distance = 0.f;
+        float found_distance = 0.f;
+        RXCORE_BENCHMARK("100 rays, brute force", count, 5, {
+            reference_distance = 0.f;
+            for (uint32_t q = 0; q < queries; q++)
+            {
+                float closest = 2000.f;
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    float distance;
+                    if (rxcore_bounding_box_intersects_ray(&boxes[i], &rays[q], closest, &distance))
+                    {
+                        closest = distance;
+                    }
+                }
+                reference_distance += closest;
+            }
+            g_rxcore_benchmark_sink += (uint64_t)reference_distance;
+        });
+
+        RXCORE_BENCHMARK("100 rays, bvh", count, 5, {
+            found_distance = 0.f;
+            for (uint32_t q = 0; q < queries; q++)
+            {
+                _rxcore_bvh_benchmark_ray_t search = {.bvh = bvh, .closest = 2000.f};
+                rxcore_bvh_query_ray(bvh, &rays[q], search.closest, _rxcore_bvh_benchmark_closest, &search);
+                found_distance += search.closest;
+            }
+            g_rxcore_benchmark_sink += (uint64_t)found_distance;
+        });
+        rxcore_benchmark_check("100 rays, bvh", fabsf(found_distance - reference_distance) < 1e-2f);
+
+        free(rays);
+        free(query_boxes);
+        free(boxes);
+        free(leaves);
+        rxcore_bvh_destroy(bvh);
+    }
+}
@@ -0,0 +1,82 @@
+// cull_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/cull.h>
+#include <rxcore/jobs.h>
+#include <rxcore/profiler.h>
+
+void rxcore_benchmark_cull()
+{
+    gs_println("Frustum culling (%s)", rxcore_cull_get_implementation_name());
+
+    // a camera at the origin looking down -z, with boxes scattered through a cube around it
+    gs_mat4 view_projection = gs_mat4_mul(gs_mat4_perspective(60.f, 16.f / 9.f, 0.1f, 500.f), gs_mat4_identity());
+    rxcore_frustum_t frustum = rxcore_frustum_from_matrix(view_projection);
+    rxcore_jobs_t *jobs = rxcore_jobs_create(rxcore_jobs_hardware_threads() - 1);
+
+    uint32_t sizes[] = {10000, 100000, 1000000};
+    for (uint32_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        uint32_t count = sizes[s];
+        uint32_t iterations = count >= 1000000 ? 10 : 50;
+
+        rxcore_bounding_box_t *boxes = malloc(sizeof(rxcore_bounding_box_t) * count);
+        rxcore_cull_bounds_t *bounds = rxcore_cull_bounds_create(count);
+        uint32_t *reference = malloc(sizeof(uint32_t) * count);
+        uint32_t *visible = malloc(sizeof(uint32_t) * count);
+
+        // a fixed seed, so runs can be compared against each other
+        uint32_t seed = 0x9E3779B9u;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            float p[3];
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                p[axis] = ((float)(seed >> 8) / (float)(1u << 24)) * 1000.f - 500.f;
+            }
+
+            boxes[i] = rxcore_bounding_box_create(gs_v3(p[0], p[1], p[2]), gs_v3(p[0] + 2.f, p[1] + 2.f, p[2] + 2.f));
+            rxcore_cull_bounds_push(bounds, &boxes[i]);
+        }
+
+        uint32_t reference_count = 0;
+        RXCORE_BENCHMARK("aos per object", count, iterations, {
+            reference_count = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                reference[reference_count] = i;
+                reference_count += rxcore_frustum_test_aabb(&frustum, &boxes[i]);
+            }
+            g_rxcore_benchmark_sink += reference_count;
+        });
+
+        uint32_t visible_count = 0;
+        RXCORE_BENCHMARK("soa scalar", count, iterations, {
+            visible_count = _rxcore_cull_frustum_scalar(&frustum, bounds, 0, count, visible);
+            g_rxcore_benchmark_sink += visible_count;
+        });
+        rxcore_benchmark_check("soa scalar", visible_count == reference_count && memcmp(visible, reference, sizeof(uint32_t) * visible_count) == 0);
+
+        RXCORE_BENCHMARK("soa simd", count, iterations, {
+            visible_count = rxcore_cull_frustum(&frustum, bounds, 0, count, visible);
+            g_rxcore_benchmark_sink += visible_count;
+        });
+        rxcore_benchmark_check("soa simd", visible_count == reference_count && memcmp(visible, reference, sizeof(uint32_t) * visible_count) == 0);
+
+        RXCORE_BENCHMARK("soa simd, jobs", count, iterations, {
+            visible_count = rxcore_cull_frustum_parallel(jobs, &frustum, bounds, visible);
+            g_rxcore_benchmark_sink += visible_count;
+        });
+        rxcore_benchmark_check("soa simd, jobs", visible_count == reference_count && memcmp(visible, reference, sizeof(uint32_t) * visible_count) == 0);
+
+        gs_println("  %d of %d visible", reference_count, count);
+
+        free(boxes);
+        free(reference);
+        free(visible);
+        rxcore_cull_bounds_destroy(bounds);
+    }
+
+    rxcore_jobs_destroy(jobs);
+}
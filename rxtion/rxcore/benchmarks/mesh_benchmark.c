@@ -0,0 +1,261 @@
+// mesh_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/rendering/mesh.h>
+#include <rxcore/profiler.h>
+#include <float.h>
+
+// a grid of side * side vertices, the size of a large terrain or scanned mesh
+static void _rxcore_mesh_benchmark_grid(uint32_t side, rxcore_vertex_t *vertices, uint32_t *indices)
+{
+    for (uint32_t y = 0; y < side; y++)
+    {
+        for (uint32_t x = 0; x < side; x++)
+        {
+            vertices[y * side + x] = (rxcore_vertex_t){
+                .position = gs_v3((float)x, sinf(x * 0.1f) * cosf(y * 0.1f), (float)y),
+                .normal = gs_v3(0.f, 1.f, 0.f),
+                .uv = gs_v2((float)x / side, (float)y / side),
+            };
+        }
+    }
+
+    uint32_t index = 0;
+    for (uint32_t y = 0; y + 1 < side; y++)
+    {
+        for (uint32_t x = 0; x + 1 < side; x++)
+        {
+            uint32_t a = y * side + x;
+            indices[index++] = a;
+            indices[index++] = a + side;
+            indices[index++] = a + 1;
+            indices[index++] = a + 1;
+            indices[index++] = a + side;
+            indices[index++] = a + side + 1;
+        }
+    }
+}
+
+static bool _rxcore_mesh_benchmark_same(rxcore_mesh_registry_t *a, rxcore_mesh_registry_t *b)
+{
+    // the mesh may be in either buffer of the registry, depending on how it was added
+    rxcore_mesh_t *mesh_a = &a->meshes[0];
+    rxcore_mesh_t *mesh_b = &b->meshes[0];
+    rxcore_mesh_buffer_t *buffer_a = mesh_a->buffer;
+    rxcore_mesh_buffer_t *buffer_b = mesh_b->buffer;
+    return gs_dyn_array_size(buffer_a->vertices) == gs_dyn_array_size(buffer_b->vertices) &&
+           gs_dyn_array_size(buffer_a->indices) == gs_dyn_array_size(buffer_b->indices) &&
+           memcmp(buffer_a->vertices, buffer_b->vertices, sizeof(rxcore_vertex_t) * gs_dyn_array_size(buffer_a->vertices)) == 0 &&
+           memcmp(buffer_a->indices, buffer_b->indices, sizeof(uint32_t) * gs_dyn_array_size(buffer_a->indices)) == 0 &&
+           memcmp(&mesh_a->bounds, &mesh_b->bounds, sizeof(rxcore_bounding_box_t)) == 0;
+}
+
+void rxcore_benchmark_mesh()
+{
+    gs_println("Mesh buffer");
+
+    uint32_t side = 1000;
+    uint32_t vertex_count = side * side;
+    uint32_t index_count = (side - 1) * (side - 1) * 6;
+    rxcore_vertex_t *vertices = malloc(sizeof(rxcore_vertex_t) * vertex_count);
+    uint32_t *indices = malloc(sizeof(uint32_t) * index_count);
+    _rxcore_mesh_benchmark_grid(side, vertices, indices);
+
+    // how meshes were added before the bulk append, kept as the reference
+    rxcore_mesh_registry_t *reference = NULL;
+    RXCORE_BENCHMARK("1M vertices, push one by one", vertex_count, 5, {
+        if (reference != NULL)
+        {
+            rxcore_mesh_registry_destroy(reference);
+        }
+        reference = rxcore_mesh_registry_create();
+        rxcore_mesh_t mesh = {0};
+        mesh.buffer = reference->buffer;
+        mesh.index_count = index_count;
+        mesh.bounds = rxcore_bounding_box_empty();
+        for (uint32_t i = 0; i < vertex_count; i++)
+        {
+            gs_dyn_array_push(reference->buffer->vertices, vertices[i]);
+            rxcore_bounding_box_encapsulate_point(&mesh.bounds, vertices[i].position);
+        }
+        for (uint32_t i = 0; i < index_count; i++)
+        {
+            gs_dyn_array_push(reference->buffer->indices, indices[i]);
+        }
+        gs_dyn_array_push(reference->meshes, mesh);
+        gs_dyn_array_push(reference->mesh_names, "grid");
+    });
+
+    rxcore_mesh_registry_t *registry = NULL;
+    RXCORE_BENCHMARK("1M vertices, bulk copy", vertex_count, 5, {
+        if (registry != NULL)
+        {
+            rxcore_mesh_registry_destroy(registry);
+        }
+        registry = rxcore_mesh_registry_create();
+        rxcore_mesh_registry_add_mesh(registry, "grid", vertices, vertex_count, indices, index_count);
+    });
+    rxcore_benchmark_check("1M vertices, bulk copy", _rxcore_mesh_benchmark_same(reference, registry));
+
+    // too many vertices for 16-bit indices, so the grid goes to the wide buffer and leaves the other one 16-bit
+    rxcore_benchmark_check("1M vertices, 32-bit indices", registry->meshes[0].buffer == registry->wide_buffer &&
+                                                              registry->wide_buffer->index_size == sizeof(uint32_t) &&
+                                                              registry->buffer->index_size == sizeof(uint16_t));
+
+    // the loader writes into the buffer, so the mesh is never held anywhere else. Generating it is part of the time here,
+    // so it is compared with generating into memory of its own and copying that in
+    RXCORE_BENCHMARK("1M vertices, generate and copy", vertex_count, 5, {
+        rxcore_mesh_registry_destroy(registry);
+        registry = rxcore_mesh_registry_create();
+        rxcore_vertex_t *loaded_vertices = malloc(sizeof(rxcore_vertex_t) * vertex_count);
+        uint32_t *loaded_indices = malloc(sizeof(uint32_t) * index_count);
+        _rxcore_mesh_benchmark_grid(side, loaded_vertices, loaded_indices);
+        rxcore_mesh_registry_add_mesh(registry, "grid", loaded_vertices, vertex_count, loaded_indices, index_count);
+        free(loaded_vertices);
+        free(loaded_indices);
+    });
+
+    RXCORE_BENCHMARK("1M vertices, generate in place", vertex_count, 5, {
+        rxcore_mesh_registry_destroy(registry);
+        registry = rxcore_mesh_registry_create();
+        uint32_t *loaded_indices = NULL;
+        rxcore_vertex_t *loaded_vertices = rxcore_mesh_registry_begin_mesh(registry, vertex_count, index_count, &loaded_indices);
+        _rxcore_mesh_benchmark_grid(side, loaded_vertices, loaded_indices);
+        rxcore_mesh_registry_end_mesh(registry, "grid", vertex_count, index_count);
+    });
+    rxcore_benchmark_check("1M vertices, generate in place", _rxcore_mesh_benchmark_same(reference, registry));
+    rxcore_benchmark_check("1M vertices in place, 32-bit indices", registry->meshes[0].buffer == registry->wide_buffer &&
+                                                                       registry->buffer->index_size == sizeof(uint16_t));
+
+    // a mesh ended with more than was asked for is dropped, leaving its name free and the buffer open to the next one
+    uint32_t *rejected_indices = NULL;
+    rxcore_mesh_registry_begin_mesh(registry, 3, 3, &rejected_indices);
+    uint32_t rejected_index = 0;
+    bool rejected = rxcore_mesh_registry_end_mesh(registry, "rejected", 4, 3) == NULL &&
+                    !rxcore_mesh_registry_get_mesh_index(registry, "rejected", &rejected_index) &&
+                    rxcore_mesh_registry_begin_mesh(registry, 3, 3, &rejected_indices) != NULL &&
+                    rxcore_mesh_registry_end_mesh(registry, "rejected", 0, 0) != NULL;
+    rxcore_benchmark_check("rejected mesh not registered", rejected);
+
+    // a converted mesh is mapped and copied in whole, against parsing it, which at best costs what pushing it does
+    rxcore_mesh_file_header_t header = {
+        .vertex_size = sizeof(rxcore_vertex_t),
+        .index_size = sizeof(uint32_t),
+        .vertex_count = vertex_count,
+        .index_count = index_count,
+        .lod_count = 1,
+        .bounds_min = {reference->meshes[0].bounds.min.x, reference->meshes[0].bounds.min.y, reference->meshes[0].bounds.min.z},
+        .bounds_max = {reference->meshes[0].bounds.max.x, reference->meshes[0].bounds.max.y, reference->meshes[0].bounds.max.z},
+        .lods[0] = {.starting_index = 0, .index_count = index_count, .base_vertex = 0, .screen_size = FLT_MAX},
+    };
+    const char *file_path = "rxcore_mesh_benchmark" RXCORE_MESH_FILE_EXTENSION;
+    if (rxcore_mesh_file_write(file_path, &header, vertices, indices))
+    {
+        RXCORE_BENCHMARK("1M vertices, from file", vertex_count, 5, {
+            rxcore_mesh_registry_destroy(registry);
+            registry = rxcore_mesh_registry_create();
+            rxcore_mesh_registry_add_mesh_from_file(registry, "grid", file_path);
+        });
+        rxcore_benchmark_check("1M vertices, from file", _rxcore_mesh_benchmark_same(reference, registry));
+
+        // a corrupt file is refused rather than read out of bounds, whether an offset wraps past the end of the mapping
+        // or an index runs past the vertices of its lod
+        rxcore_mesh_file_t corrupt = {0};
+        header.vertex_offset = UINT64_MAX - RXCORE_MESH_FILE_ALIGNMENT + 1;
+        FILE *f = fopen(file_path, "r+b");
+        bool refused = f != NULL && fwrite(&header, sizeof(header), 1, f) == 1;
+        refused = f != NULL && fclose(f) == 0 && refused && !rxcore_mesh_file_open(file_path, &corrupt);
+        header.vertex_count = vertex_count - 1;
+        refused = refused && rxcore_mesh_file_write(file_path, &header, vertices, indices) && !rxcore_mesh_file_open(file_path, &corrupt);
+        header.vertex_count = vertex_count;
+        rxcore_benchmark_check("corrupt files refused", refused);
+        remove(file_path);
+    }
+    else
+    {
+        rxcore_benchmark_check("1M vertices, from file", false);
+    }
+
+    // packing happens on every upload, so it has to keep up with the bulk copy. The normals are spread over the sphere,
+    // as the grid's all point up, and the largest error of each attribute is checked against what its format can hold
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        float theta = (float)i * 2.39996f;
+        float z = 1.f - 2.f * ((float)i + 0.5f) / vertex_count;
+        float r = sqrtf(1.f - z * z);
+        vertices[i].normal = gs_v3(r * cosf(theta), r * sinf(theta), z);
+    }
+    void *packed = malloc(sizeof(rxcore_vertex_t) * vertex_count);
+    RXCORE_BENCHMARK("1M vertices, pack 32 to 20 bytes", vertex_count, 5, {
+        rxcore_vertex_layout_pack(RXCORE_VERTEX_LAYOUT_PACKED, vertices, vertex_count, packed);
+    });
+
+    float normal_error = 0.f;
+    float uv_error = 0.f;
+    rxcore_vertex_packed_t *packed_vertices = packed;
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        gs_vec3 normal = rxcore_vertex_unpack_octahedral(packed_vertices[i].normal);
+        normal_error = gs_max(normal_error, gs_vec3_len(gs_vec3_sub(normal, vertices[i].normal)));
+        float u = rxcore_vertex_half_to_float(packed_vertices[i].uv & 0xffffu);
+        float v = rxcore_vertex_half_to_float(packed_vertices[i].uv >> 16);
+        uv_error = gs_max(uv_error, gs_max(fabsf(u - vertices[i].uv.x), fabsf(v - vertices[i].uv.y)));
+    }
+    gs_println("  largest normal error %.5f degrees, uv error %.6f", asinf(gs_min(normal_error, 1.f)) * 180.f / GS_PI, uv_error);
+    rxcore_benchmark_check("1M vertices, pack 32 to 20 bytes", normal_error < 1e-3f && uv_error < 1e-3f);
+
+    RXCORE_BENCHMARK("1M vertices, pack 32 to 16 bytes", vertex_count, 5, {
+        rxcore_vertex_layout_pack(RXCORE_VERTEX_LAYOUT_PACKED_HALF, vertices, vertex_count, packed);
+    });
+
+    // halves keep 11 bits, so the grid's positions, up to a thousand, are checked relative to their size
+    float position_error = 0.f;
+    rxcore_vertex_packed_half_t *half_vertices = packed;
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        gs_vec3 position = gs_v3(
+            rxcore_vertex_half_to_float(half_vertices[i].position[0] & 0xffffu),
+            rxcore_vertex_half_to_float(half_vertices[i].position[0] >> 16),
+            rxcore_vertex_half_to_float(half_vertices[i].position[1] & 0xffffu));
+        float size = gs_max(gs_vec3_len(vertices[i].position), 1.f);
+        position_error = gs_max(position_error, gs_vec3_len(gs_vec3_sub(position, vertices[i].position)) / size);
+    }
+    gs_println("  largest position error %.5f of the distance from the origin", position_error);
+    rxcore_benchmark_check("1M vertices, pack 32 to 16 bytes", position_error < 1e-3f);
+    free(packed);
+
+    // many small meshes into one buffer, where reserving only what each needs would copy everything added before it
+    uint32_t small_side = 32;
+    uint32_t small_vertex_count = small_side * small_side;
+    uint32_t small_index_count = (small_side - 1) * (small_side - 1) * 6;
+    uint32_t small_meshes = vertex_count / small_vertex_count;
+    _rxcore_mesh_benchmark_grid(small_side, vertices, indices);
+    RXCORE_BENCHMARK("976 small meshes, bulk copy", small_meshes * small_vertex_count, 5, {
+        rxcore_mesh_registry_destroy(registry);
+        registry = rxcore_mesh_registry_create();
+        for (uint32_t i = 0; i < small_meshes; i++)
+        {
+            rxcore_mesh_registry_add_mesh(registry, "small", vertices, small_vertex_count, indices, small_index_count);
+        }
+    });
+    rxcore_benchmark_check("976 small meshes, bulk copy", gs_dyn_array_size(registry->buffer->vertices) == small_meshes * small_vertex_count);
+
+    // the indices are narrowed as they are uploaded, which has to cost less than the upload it halves
+    uint32_t small_indices = gs_dyn_array_size(registry->buffer->indices);
+    RXCORE_BENCHMARK("976 small meshes, 16-bit indices", small_indices, 5, {
+        g_rxcore_benchmark_sink += (uintptr_t)_rxcore_mesh_buffer_pack_indices(registry->buffer, 0, small_indices);
+    });
+    bool narrowed = registry->wide_buffer == NULL && registry->buffer->index_size == sizeof(uint16_t);
+    uint16_t *packed_indices = registry->buffer->packed_indices;
+    for (uint32_t i = 0; narrowed && i < small_indices; i++)
+    {
+        narrowed = packed_indices[i] == registry->buffer->indices[i];
+    }
+    gs_println("  %d index bytes uploaded rather than %d", small_indices * registry->buffer->index_size, small_indices * (uint32_t)sizeof(uint32_t));
+    rxcore_benchmark_check("976 small meshes, 16-bit indices", narrowed);
+
+    rxcore_mesh_registry_destroy(reference);
+    rxcore_mesh_registry_destroy(registry);
+    free(vertices);
+    free(indices);
+}
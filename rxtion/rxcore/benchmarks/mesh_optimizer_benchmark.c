@@ -0,0 +1,173 @@
+// mesh_optimizer_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/rendering/mesh.h>
+#include <rxcore/rendering/mesh_optimizer.h>
+#include <rxcore/profiler.h>
+
+static uint32_t _rxcore_mesh_optimizer_benchmark_seed = 0x2545F491u;
+
+static uint32_t _rxcore_mesh_optimizer_benchmark_random()
+{
+    _rxcore_mesh_optimizer_benchmark_seed = _rxcore_mesh_optimizer_benchmark_seed * 1664525u + 1013904223u;
+    return _rxcore_mesh_optimizer_benchmark_seed >> 8;
+}
+
+// a sphere as exported by a tool that neither shares vertices nor orders its triangles, the worst case for the cache
+static void _rxcore_mesh_optimizer_benchmark_soup(uint32_t rings, uint32_t segments, rxcore_vertex_t *vertices, uint32_t *indices)
+{
+    uint32_t triangle_count = rings * segments * 2;
+    uint32_t *order = malloc(sizeof(uint32_t) * triangle_count);
+    for (uint32_t i = 0; i < triangle_count; i++)
+    {
+        order[i] = i;
+    }
+    for (uint32_t i = triangle_count - 1; i > 0; i--)
+    {
+        uint32_t j = _rxcore_mesh_optimizer_benchmark_random() % (i + 1);
+        uint32_t swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+
+    for (uint32_t i = 0; i < triangle_count; i++)
+    {
+        uint32_t quad = order[i] / 2;
+        uint32_t ring = quad / segments;
+        uint32_t segment = quad % segments;
+        uint32_t corners[2][3][2] = {
+            {{ring, segment}, {ring + 1, segment}, {ring, segment + 1}},
+            {{ring, segment + 1}, {ring + 1, segment}, {ring + 1, segment + 1}},
+        };
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t *corner = corners[order[i] % 2][k];
+            float theta = (float)corner[0] / rings * GS_PI;
+            float phi = (float)corner[1] / segments * 2.f * GS_PI;
+            gs_vec3 position = gs_v3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+            vertices[i * 3 + k] = (rxcore_vertex_t){
+                .position = position,
+                .normal = position,
+                .uv = gs_v2((float)corner[1] / segments, (float)corner[0] / rings),
+            };
+            indices[i * 3 + k] = i * 3 + k;
+        }
+    }
+    free(order);
+}
+
+// the area weighted sum of the normals and the centres of the triangles, which reordering keeps but losing or flipping one doesn't
+static void _rxcore_mesh_optimizer_benchmark_signature(rxcore_vertex_t *vertices, uint32_t *indices, uint32_t index_count, gs_vec3 *normal_out, gs_vec3 *centre_out)
+{
+    *normal_out = gs_v3(0.f, 0.f, 0.f);
+    *centre_out = gs_v3(0.f, 0.f, 0.f);
+    for (uint32_t i = 0; i < index_count; i += 3)
+    {
+        gs_vec3 p0 = vertices[indices[i + 0]].position;
+        gs_vec3 p1 = vertices[indices[i + 1]].position;
+        gs_vec3 p2 = vertices[indices[i + 2]].position;
+        gs_vec3 normal = gs_vec3_cross(gs_vec3_sub(p1, p0), gs_vec3_sub(p2, p0));
+        *normal_out = gs_vec3_add(*normal_out, normal);
+        *centre_out = gs_vec3_add(*centre_out, gs_vec3_scale(gs_vec3_add(gs_vec3_add(p0, p1), p2), gs_vec3_len(normal) / 3.f));
+    }
+}
+
+void rxcore_benchmark_mesh_optimizer()
+{
+    gs_println("Mesh optimizer");
+
+    uint32_t rings = 128;
+    uint32_t segments = 256;
+    uint32_t index_count = rings * segments * 6;
+    uint32_t triangle_count = index_count / 3;
+    rxcore_vertex_t *soup_vertices = malloc(sizeof(rxcore_vertex_t) * index_count);
+    uint32_t *soup_indices = malloc(sizeof(uint32_t) * index_count);
+    _rxcore_mesh_optimizer_benchmark_soup(rings, segments, soup_vertices, soup_indices);
+
+    rxcore_vertex_t *vertices = malloc(sizeof(rxcore_vertex_t) * index_count);
+    uint32_t *indices = malloc(sizeof(uint32_t) * index_count);
+    uint32_t vertex_count = 0;
+    rxcore_mesh_optimizer_stats_t before = {0};
+    rxcore_mesh_optimizer_stats_t after = {0};
+    RXCORE_BENCHMARK("65k triangle soup, all passes", triangle_count, 3, {
+        memcpy(vertices, soup_vertices, sizeof(rxcore_vertex_t) * index_count);
+        memcpy(indices, soup_indices, sizeof(uint32_t) * index_count);
+        vertex_count = rxcore_mesh_optimizer_optimize(vertices, index_count, sizeof(rxcore_vertex_t), indices, index_count, &before, &after);
+    });
+    gs_println("  %d to %d vertices, acmr %.3f to %.3f, atvr %.3f to %.3f",
+               before.vertex_count, after.vertex_count, before.acmr, after.acmr, before.atvr, after.atvr);
+
+    // each corner welds back to one vertex per point of the grid, those of the seam and the poles staying apart as their uvs differ
+    gs_vec3 normal_before, centre_before, normal_after, centre_after;
+    _rxcore_mesh_optimizer_benchmark_signature(soup_vertices, soup_indices, index_count, &normal_before, &centre_before);
+    _rxcore_mesh_optimizer_benchmark_signature(vertices, indices, index_count, &normal_after, &centre_after);
+    bool same = gs_vec3_len(gs_vec3_sub(normal_before, normal_after)) < 1e-2f && gs_vec3_len(gs_vec3_sub(centre_before, centre_after)) < 1e-2f;
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        same = same && indices[i] < vertex_count;
+    }
+    rxcore_benchmark_check("65k triangle soup, same triangles", same);
+    rxcore_benchmark_check("65k triangle soup, welded", vertex_count == (rings + 1) * (segments + 1));
+    rxcore_benchmark_check("65k triangle soup, acmr", after.acmr < 0.8f && after.atvr < 1.5f);
+
+    // the passes on their own, on the welded mesh with its triangles shuffled again, so each starts from the same place
+    for (uint32_t i = triangle_count - 1; i > 0; i--)
+    {
+        uint32_t j = _rxcore_mesh_optimizer_benchmark_random() % (i + 1);
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t swap = indices[i * 3 + k];
+            indices[i * 3 + k] = indices[j * 3 + k];
+            indices[j * 3 + k] = swap;
+        }
+    }
+    uint32_t *shuffled = malloc(sizeof(uint32_t) * index_count);
+    memcpy(shuffled, indices, sizeof(uint32_t) * index_count);
+
+    RXCORE_BENCHMARK("65k triangles, vertex cache", triangle_count, 3, {
+        memcpy(indices, shuffled, sizeof(uint32_t) * index_count);
+        rxcore_mesh_optimizer_optimize_vertex_cache(indices, index_count, vertex_count);
+    });
+    rxcore_mesh_optimizer_stats_t shuffled_stats = rxcore_mesh_optimizer_analyze(shuffled, index_count, vertex_count);
+    rxcore_mesh_optimizer_stats_t cache_stats = rxcore_mesh_optimizer_analyze(indices, index_count, vertex_count);
+    gs_println("  acmr %.3f to %.3f", shuffled_stats.acmr, cache_stats.acmr);
+
+    uint32_t *cache_ordered = malloc(sizeof(uint32_t) * index_count);
+    memcpy(cache_ordered, indices, sizeof(uint32_t) * index_count);
+    RXCORE_BENCHMARK("65k triangles, overdraw", triangle_count, 3, {
+        memcpy(indices, cache_ordered, sizeof(uint32_t) * index_count);
+        rxcore_mesh_optimizer_optimize_overdraw(indices, index_count, vertices, vertex_count, sizeof(rxcore_vertex_t));
+    });
+
+    // the clusters are runs the cache pass made, so moving them should cost little of what it gained
+    rxcore_mesh_optimizer_stats_t overdraw_stats = rxcore_mesh_optimizer_analyze(indices, index_count, vertex_count);
+    gs_println("  acmr %.3f to %.3f", cache_stats.acmr, overdraw_stats.acmr);
+    rxcore_benchmark_check("65k triangles, overdraw", overdraw_stats.acmr < cache_stats.acmr * 1.1f);
+
+    RXCORE_BENCHMARK("65k triangles, vertex fetch", vertex_count, 3, {
+        g_rxcore_benchmark_sink += rxcore_mesh_optimizer_optimize_vertex_fetch(vertices, vertex_count, sizeof(rxcore_vertex_t), indices, index_count);
+    });
+
+    // a small mesh the greedy scoring orders worse than it came, which the pass has to leave as it is
+    uint32_t small[14 * 3] = {4, 12, 1, 16, 15, 0, 15, 13, 1, 9, 15, 2, 7, 2, 14, 8, 14, 12, 3, 7, 2,
+                              8, 5, 19, 7, 8, 11, 6, 0, 14, 16, 0, 8, 0, 8, 10, 11, 16, 6, 10, 6, 1};
+    rxcore_mesh_optimizer_stats_t small_before = rxcore_mesh_optimizer_analyze(small, 14 * 3, 20);
+    rxcore_mesh_optimizer_optimize_vertex_cache(small, 14 * 3, 20);
+    rxcore_mesh_optimizer_stats_t small_after = rxcore_mesh_optimizer_analyze(small, 14 * 3, 20);
+    rxcore_benchmark_check("14 triangles, vertex cache no worse", small_after.acmr <= small_before.acmr);
+
+    // the registry optimizes what it is given when asked to, logging the stats of each mesh
+    rxcore_mesh_registry_t *registry = rxcore_mesh_registry_create();
+    rxcore_mesh_registry_set_optimize(registry, true);
+    rxcore_mesh_t *mesh = rxcore_mesh_registry_add_mesh(registry, "soup", soup_vertices, index_count, soup_indices, index_count);
+    rxcore_benchmark_check("65k triangle soup, registry", gs_dyn_array_size(mesh->buffer->vertices) == (rings + 1) * (segments + 1) &&
+                                                               mesh->index_count == index_count);
+    rxcore_mesh_registry_destroy(registry);
+
+    free(soup_vertices);
+    free(soup_indices);
+    free(vertices);
+    free(indices);
+    free(shuffled);
+    free(cache_ordered);
+}
@@ -0,0 +1,184 @@
+// occlusion_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/rendering/occlusion.h>
+#include <rxcore/jobs.h>
+#include <rxcore/profiler.h>
+
+static float _rxcore_occlusion_benchmark_random(uint32_t *seed)
+{
+    *seed = *seed * 1664525u + 1013904223u;
+    return (float)(*seed >> 8) / (float)(1u << 24);
+}
+
+// the wall is the square |x|, |y| <= 5 at z = -10, a box is behind it if every corner is farther away and projects onto it
+static bool _rxcore_occlusion_benchmark_hidden(rxcore_bounding_box_t *box)
+{
+    if (box->max.z >= -10.f)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        float x = i & 1 ? box->max.x : box->min.x;
+        float y = i & 2 ? box->max.y : box->min.y;
+        float z = i & 4 ? box->max.z : box->min.z;
+        if (fabsf(x * 10.f / -z) > 5.f || fabsf(y * 10.f / -z) > 5.f)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void rxcore_benchmark_occlusion()
+{
+    gs_println("Occlusion culling (%s, %dx%d)", rxcore_occlusion_get_implementation_name(), RXCORE_OCCLUSION_WIDTH, RXCORE_OCCLUSION_HEIGHT);
+
+    // a camera at the origin looking down -z, the aspect of the depth buffer so pixels are square
+    gs_mat4 view_projection = gs_mat4_perspective(60.f, (float)RXCORE_OCCLUSION_WIDTH / RXCORE_OCCLUSION_HEIGHT, 0.1f, 500.f);
+    rxcore_jobs_t *jobs = rxcore_jobs_create(rxcore_jobs_hardware_threads() - 1);
+    rxcore_occlusion_buffer_t *buffer = rxcore_occlusion_buffer_create(RXCORE_OCCLUSION_WIDTH, RXCORE_OCCLUSION_HEIGHT);
+
+    // the wall as a finely tessellated grid, standing in for a detailed occluder mesh
+    uint32_t wall_quads = 64;
+    uint32_t vertex_count = (wall_quads + 1) * (wall_quads + 1);
+    uint32_t index_count = wall_quads * wall_quads * 6;
+    gs_vec3 *positions = malloc(sizeof(gs_vec3) * vertex_count);
+    uint32_t *indices = malloc(sizeof(uint32_t) * index_count);
+    for (uint32_t y = 0; y <= wall_quads; y++)
+    {
+        for (uint32_t x = 0; x <= wall_quads; x++)
+        {
+            positions[y * (wall_quads + 1) + x] = gs_v3(-5.f + 10.f * x / wall_quads, -5.f + 10.f * y / wall_quads, -10.f);
+        }
+    }
+    uint32_t written = 0;
+    for (uint32_t y = 0; y < wall_quads; y++)
+    {
+        for (uint32_t x = 0; x < wall_quads; x++)
+        {
+            uint32_t i = y * (wall_quads + 1) + x;
+            uint32_t quad[6] = {i, i + 1, i + wall_quads + 2, i, i + wall_quads + 2, i + wall_quads + 1};
+            memcpy(indices + written, quad, sizeof(quad));
+            written += 6;
+        }
+    }
+
+    RXCORE_BENCHMARK("rasterize 8192 triangle wall", index_count / 3, 50, {
+        rxcore_occlusion_buffer_begin(buffer, view_projection);
+        rxcore_occlusion_buffer_add_triangles(buffer, positions, sizeof(gs_vec3), indices, index_count, gs_mat4_identity());
+    });
+
+    RXCORE_BENCHMARK("build hierarchical depth", buffer->tiles_x * buffer->tiles_y, 50, {
+        rxcore_occlusion_buffer_end(buffer);
+    });
+
+    // boxes scattered in front of, around and behind the wall
+    uint32_t count = 100000;
+    uint32_t seed = 0x9E3779B9u;
+    rxcore_bounding_box_t *boxes = malloc(sizeof(rxcore_bounding_box_t) * count);
+    uint8_t *visible = malloc(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float z = -2.f - _rxcore_occlusion_benchmark_random(&seed) * 58.f;
+        float spread = -z * 0.75f;
+        float x = (_rxcore_occlusion_benchmark_random(&seed) * 2.f - 1.f) * spread;
+        float y = (_rxcore_occlusion_benchmark_random(&seed) * 2.f - 1.f) * spread;
+        float size = 0.25f + _rxcore_occlusion_benchmark_random(&seed) * 1.75f;
+        boxes[i] = rxcore_bounding_box_create(gs_v3(x, y, z), gs_v3(x + size, y + size, z + size));
+    }
+
+    RXCORE_BENCHMARK("test boxes, calling thread", count, 20, {
+        rxcore_occlusion_buffer_test_aabbs(buffer, NULL, boxes, count, visible);
+    });
+
+    RXCORE_BENCHMARK("test boxes, jobs", count, 20, {
+        rxcore_occlusion_buffer_test_aabbs(buffer, jobs, boxes, count, visible);
+    });
+
+    // hiding a box that can be seen would make it pop out of the world, keeping one that can't only costs a draw
+    uint32_t hidden = 0, culled = 0, kept = 0, wrongly_culled = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bool truth = _rxcore_occlusion_benchmark_hidden(&boxes[i]);
+        hidden += truth;
+        if (!visible[i])
+        {
+            culled += truth;
+            wrongly_culled += !truth;
+        }
+        else
+        {
+            kept += truth;
+        }
+    }
+    gs_println("  %u of %u boxes are hidden, %u culled, %u conservatively kept, %u wrongly culled", hidden, count, culled, kept, wrongly_culled);
+    rxcore_benchmark_check("never culls a visible box", wrongly_culled == 0);
+    rxcore_benchmark_check("culls most hidden boxes", culled * 10 >= hidden * 9);
+
+    // an occluder between the camera and the near plane, as when walking into a wall, isn't drawn by the gpu so can't hide anything
+    rxcore_bounding_box_t too_near = rxcore_bounding_box_create(gs_v3(-1.f, -1.f, -0.08f), gs_v3(1.f, 1.f, -0.02f));
+    rxcore_bounding_box_t behind = rxcore_bounding_box_create(gs_v3(-0.5f, -0.5f, -11.f), gs_v3(0.5f, 0.5f, -10.f));
+    rxcore_occlusion_buffer_begin(buffer, view_projection);
+    rxcore_occlusion_buffer_add_box(buffer, &too_near, gs_mat4_identity());
+    rxcore_occlusion_buffer_end(buffer);
+    rxcore_benchmark_check("occluders clipped at the near plane", rxcore_occlusion_buffer_test_aabb(buffer, &behind));
+
+#ifdef RXCORE_OCCLUSION_SSE
+    // the same triangles through both paths, each with edge functions straight from its corners in pixels
+    rxcore_occlusion_buffer_t *scalar = rxcore_occlusion_buffer_create(RXCORE_OCCLUSION_WIDTH, RXCORE_OCCLUSION_HEIGHT);
+    rxcore_occlusion_buffer_begin(buffer, view_projection);
+    rxcore_occlusion_buffer_begin(scalar, view_projection);
+    for (uint32_t t = 0; t < 1000; t++)
+    {
+        float vx[3], vy[3];
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            vx[v] = _rxcore_occlusion_benchmark_random(&seed) * RXCORE_OCCLUSION_WIDTH;
+            vy[v] = _rxcore_occlusion_benchmark_random(&seed) * RXCORE_OCCLUSION_HEIGHT;
+        }
+
+        float edges[9];
+        float sign = (vx[1] - vx[0]) * (vy[2] - vy[0]) - (vy[1] - vy[0]) * (vx[2] - vx[0]) < 0.f ? -1.f : 1.f;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            uint32_t j = (i + 1) % 3;
+            edges[i * 3 + 0] = -(vy[j] - vy[i]) * sign;
+            edges[i * 3 + 1] = (vx[j] - vx[i]) * sign;
+            edges[i * 3 + 2] = -(edges[i * 3 + 0] * vx[i] + edges[i * 3 + 1] * vy[i]);
+        }
+        float depth_plane[3] = {
+            (_rxcore_occlusion_benchmark_random(&seed) - 0.5f) * 1e-3f,
+            (_rxcore_occlusion_benchmark_random(&seed) - 0.5f) * 1e-3f,
+            _rxcore_occlusion_benchmark_random(&seed),
+        };
+
+        int32_t min_x = (int32_t)gs_min(vx[0], gs_min(vx[1], vx[2]));
+        int32_t min_y = (int32_t)gs_min(vy[0], gs_min(vy[1], vy[2]));
+        int32_t max_x = gs_min((int32_t)gs_max(vx[0], gs_max(vx[1], vx[2])) + 1, RXCORE_OCCLUSION_WIDTH - 1);
+        int32_t max_y = gs_min((int32_t)gs_max(vy[0], gs_max(vy[1], vy[2])) + 1, RXCORE_OCCLUSION_HEIGHT - 1);
+        _rxcore_occlusion_buffer_fill_rows_sse(buffer, min_x, max_x, min_y, max_y, edges, depth_plane);
+        _rxcore_occlusion_buffer_fill_rows_scalar(scalar, min_x, max_x, min_y, max_y, edges, depth_plane);
+    }
+
+    // the sse path computes each function in a different order, so depths may differ in the last bits
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < RXCORE_OCCLUSION_WIDTH * RXCORE_OCCLUSION_HEIGHT; i++)
+    {
+        mismatches += fabsf(buffer->depth[i] - scalar->depth[i]) > 1e-5f;
+    }
+    gs_println("  %u of %d pixels differ between the sse and scalar paths", mismatches, RXCORE_OCCLUSION_WIDTH * RXCORE_OCCLUSION_HEIGHT);
+    rxcore_benchmark_check("sse matches scalar", mismatches * 1000 <= RXCORE_OCCLUSION_WIDTH * RXCORE_OCCLUSION_HEIGHT);
+    rxcore_occlusion_buffer_destroy(scalar);
+#endif
+
+    free(positions);
+    free(indices);
+    free(boxes);
+    free(visible);
+    rxcore_occlusion_buffer_destroy(buffer);
+    rxcore_jobs_destroy(jobs);
+}
@@ -0,0 +1,158 @@
+// picking_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/rendering/scene_graph.h>
+#include <rxcore/rendering/camera.h>
+#include <rxcore/profiler.h>
+
+#define _RXCORE_PICKING_BENCHMARK_RINGS 10
+#define _RXCORE_PICKING_BENCHMARK_SEGMENTS 10
+
+static uint32_t _rxcore_picking_benchmark_seed = 0x2545F491u;
+
+static float _rxcore_picking_benchmark_random()
+{
+    _rxcore_picking_benchmark_seed = _rxcore_picking_benchmark_seed * 1664525u + 1013904223u;
+    return (float)(_rxcore_picking_benchmark_seed >> 8) / (float)(1u << 24);
+}
+
+// a unit sphere of rings * segments * 2 triangles, the ones at the poles having no area
+static rxcore_mesh_t _rxcore_picking_benchmark_sphere(rxcore_mesh_buffer_t *buffer)
+{
+    uint32_t columns = _RXCORE_PICKING_BENCHMARK_SEGMENTS + 1;
+    uint32_t vertex_count = (_RXCORE_PICKING_BENCHMARK_RINGS + 1) * columns;
+    uint32_t index_count = _RXCORE_PICKING_BENCHMARK_RINGS * _RXCORE_PICKING_BENCHMARK_SEGMENTS * 6;
+    rxcore_vertex_t *vertices = malloc(sizeof(rxcore_vertex_t) * vertex_count);
+    uint32_t *indices = malloc(sizeof(uint32_t) * index_count);
+
+    for (uint32_t ring = 0; ring <= _RXCORE_PICKING_BENCHMARK_RINGS; ring++)
+    {
+        float theta = (float)ring / _RXCORE_PICKING_BENCHMARK_RINGS * GS_PI;
+        for (uint32_t segment = 0; segment <= _RXCORE_PICKING_BENCHMARK_SEGMENTS; segment++)
+        {
+            float phi = (float)segment / _RXCORE_PICKING_BENCHMARK_SEGMENTS * 2.f * GS_PI;
+            gs_vec3 position = gs_v3(sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi));
+            vertices[ring * columns + segment] = (rxcore_vertex_t){
+                .position = position,
+                .normal = position,
+                .uv = gs_v2((float)segment / _RXCORE_PICKING_BENCHMARK_SEGMENTS, (float)ring / _RXCORE_PICKING_BENCHMARK_RINGS),
+            };
+        }
+    }
+
+    uint32_t index = 0;
+    for (uint32_t ring = 0; ring < _RXCORE_PICKING_BENCHMARK_RINGS; ring++)
+    {
+        for (uint32_t segment = 0; segment < _RXCORE_PICKING_BENCHMARK_SEGMENTS; segment++)
+        {
+            uint32_t a = ring * columns + segment;
+            uint32_t b = a + columns;
+            indices[index++] = a;
+            indices[index++] = b;
+            indices[index++] = a + 1;
+            indices[index++] = a + 1;
+            indices[index++] = b;
+            indices[index++] = b + 1;
+        }
+    }
+
+    rxcore_mesh_t mesh = rxcore_mesh_buffer_add_mesh(buffer, vertices, vertex_count, indices, index_count);
+    free(vertices);
+    free(indices);
+    return mesh;
+}
+
+void rxcore_benchmark_picking()
+{
+    gs_println("Picking");
+
+    rxcore_mesh_buffer_t *buffer = rxcore_mesh_buffer_create();
+    rxcore_mesh_t sphere = _rxcore_picking_benchmark_sphere(buffer);
+
+    // enough spheres scattered in front of the camera for a 100k triangle scene
+    uint32_t triangles_per_node = sphere.index_count / 3;
+    uint32_t node_count = 100000 / triangles_per_node;
+    uint32_t triangle_count = node_count * triangles_per_node;
+    rxcore_scene_graph_t *graph = rxcore_scene_graph_create();
+    rxcore_scene_node_t **nodes = malloc(sizeof(rxcore_scene_node_t *) * node_count);
+    for (uint32_t i = 0; i < node_count; i++)
+    {
+        gs_vec3 position = gs_v3(
+            _rxcore_picking_benchmark_random() * 200.f - 100.f,
+            _rxcore_picking_benchmark_random() * 120.f - 60.f,
+            -20.f - _rxcore_picking_benchmark_random() * 180.f);
+        float radius = 2.f + _rxcore_picking_benchmark_random() * 4.f;
+        rxcore_transform_t transform = rxcore_transform_create(position, gs_v3(radius, radius, radius), gs_quat_default());
+        nodes[i] = rxcore_scene_node_create(transform, sphere, NULL);
+        rxcore_scene_graph_add_child(graph, nodes[i]);
+    }
+    rxcore_scene_graph_rebuild_bvh(graph);
+
+    // a grid of cursor positions across the screen
+    uint32_t queries = 100;
+    gs_vec2 screen_size = gs_v2(1280.f, 720.f);
+    rxcore_camera_t *camera = rxcore_camera_create_perspective((rxcore_camera_perspective_desc_t){60.f, 16.f / 9.f, 0.1f, 500.f}, gs_v3(0.f, 0.f, 0.f), gs_quat_default());
+    rxcore_ray_t *rays = malloc(sizeof(rxcore_ray_t) * queries);
+    for (uint32_t q = 0; q < queries; q++)
+    {
+        gs_vec2 cursor = gs_v2(((q % 10) + 0.5f) / 10.f * screen_size.x, ((q / 10) + 0.5f) / 10.f * screen_size.y);
+        rays[q] = rxcore_camera_screen_to_ray(camera, cursor, screen_size);
+    }
+
+    // both sides have to pick the same node for every ray, as well as agree on how far away it is
+    float max_distance = 1000.f;
+    float reference_distance = 0.f;
+    float found_distance = 0.f;
+    rxcore_scene_node_t **reference_nodes = malloc(sizeof(rxcore_scene_node_t *) * queries);
+    rxcore_scene_node_t **found_nodes = malloc(sizeof(rxcore_scene_node_t *) * queries);
+    RXCORE_BENCHMARK("100 rays, every triangle", triangle_count, 3, {
+        reference_distance = 0.f;
+        for (uint32_t q = 0; q < queries; q++)
+        {
+            float closest = max_distance;
+            reference_nodes[q] = NULL;
+            for (uint32_t i = 0; i < node_count; i++)
+            {
+                rxcore_ray_t local = rxcore_ray_transform(&rays[q], gs_mat4_inverse(nodes[i]->world_matrix));
+                rxcore_raycast_hit_t hit = {0};
+                if (rxcore_mesh_raycast(&nodes[i]->mesh, &local, closest, &hit))
+                {
+                    closest = hit.distance;
+                    reference_nodes[q] = nodes[i];
+                }
+            }
+            reference_distance += closest;
+        }
+        g_rxcore_benchmark_sink += (uint64_t)reference_distance;
+    });
+
+    RXCORE_BENCHMARK("100 rays, scene graph", triangle_count, 20, {
+        found_distance = 0.f;
+        for (uint32_t q = 0; q < queries; q++)
+        {
+            rxcore_scene_raycast_hit_t hit = {0};
+            rxcore_scene_graph_raycast(graph, &rays[q], max_distance, &hit);
+            found_distance += hit.node != NULL ? hit.distance : max_distance;
+            found_nodes[q] = hit.node;
+        }
+        g_rxcore_benchmark_sink += (uint64_t)found_distance;
+    });
+
+    uint32_t hits = 0;
+    bool same_nodes = true;
+    for (uint32_t q = 0; q < queries; q++)
+    {
+        hits += found_nodes[q] != NULL;
+        same_nodes = same_nodes && found_nodes[q] == reference_nodes[q];
+    }
+    gs_println("  %d of %d rays hit something", hits, queries);
+    rxcore_benchmark_check("100 rays, scene graph", same_nodes && fabsf(found_distance - reference_distance) < 1e-1f);
+
+    free(reference_nodes);
+    free(found_nodes);
+    free(rays);
+    free(nodes);
+    rxcore_camera_destroy(camera);
+    rxcore_scene_graph_destroy(graph);
+    rxcore_mesh_buffer_destroy(buffer);
+}
@@ -0,0 +1,145 @@
+// spatial_grid_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/spatial_grid.h>
+#include <rxcore/jobs.h>
+#include <rxcore/profiler.h>
+
+typedef struct _rxcore_spatial_grid_benchmark_hits_t
+{
+    uint32_t count;
+    uint64_t sum; // of the ids found, so both sides of a check have to find the same ones
+} _rxcore_spatial_grid_benchmark_hits_t;
+
+static void _rxcore_spatial_grid_benchmark_collect(uint32_t id, gs_vec2 position, void *user_data)
+{
+    _rxcore_spatial_grid_benchmark_hits_t *hits = user_data;
+    hits->count++;
+    hits->sum += id;
+}
+
+void rxcore_benchmark_spatial_grid()
+{
+    gs_println("Spatial grid");
+
+    // about 20 points inside the radius of any point, so the 16 neighbour queries usually fill up
+    uint32_t count = 100000;
+    uint32_t neighbours = 16;
+    float world_size = 1000.f;
+    float radius = 8.f;
+    uint32_t samples = 1000;
+
+    rxcore_jobs_t *jobs = rxcore_jobs_create(rxcore_jobs_hardware_threads() - 1);
+    rxcore_spatial_grid_t *grid = rxcore_spatial_grid_create(radius);
+    gs_vec2 *positions = malloc(sizeof(gs_vec2) * count);
+    gs_vec2 *velocities = malloc(sizeof(gs_vec2) * count);
+    uint32_t *found = malloc(sizeof(uint32_t) * count * neighbours);
+
+    uint32_t seed = 0x9E3779B9u;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float r[4];
+        for (uint32_t j = 0; j < 4; j++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            r[j] = (float)(seed >> 8) / (float)(1u << 24);
+        }
+        positions[i] = gs_v2(r[0] * world_size, r[1] * world_size);
+        velocities[i] = gs_v2(r[2] - 0.5f, r[3] - 0.5f);
+    }
+
+    RXCORE_BENCHMARK("build, calling thread", count, 20, {
+        rxcore_spatial_grid_clear(grid);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            rxcore_spatial_grid_push(grid, positions[i], i);
+        }
+        rxcore_spatial_grid_build(grid, NULL);
+    });
+
+    // every point moves every tick, as the whole grid is rebuilt anyway
+    RXCORE_BENCHMARK("move and build, jobs", count, 20, {
+        rxcore_spatial_grid_clear(grid);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            positions[i] = gs_vec2_add(positions[i], velocities[i]);
+            rxcore_spatial_grid_push(grid, positions[i], i);
+        }
+        rxcore_spatial_grid_build(grid, jobs);
+    });
+
+    uint64_t total = 0;
+    RXCORE_BENCHMARK("16 neighbours per point", count, 10, {
+        total = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            total += rxcore_spatial_grid_gather_radius(grid, positions[i], radius, found + i * neighbours, neighbours);
+        }
+        g_rxcore_benchmark_sink += total;
+    });
+    gs_println("  %.1f neighbours found per point", (double)total / count);
+
+    // brute force is far too slow for every point, so only a sample is compared
+    _rxcore_spatial_grid_benchmark_hits_t reference = {0};
+    RXCORE_BENCHMARK("radius, brute force, 1000 points", samples, 1, {
+        reference = (_rxcore_spatial_grid_benchmark_hits_t){0};
+        for (uint32_t s = 0; s < samples; s++)
+        {
+            gs_vec2 center = positions[s * (count / samples)];
+            for (uint32_t i = 0; i < count; i++)
+            {
+                gs_vec2 d = gs_vec2_sub(positions[i], center);
+                if (d.x * d.x + d.y * d.y <= radius * radius)
+                {
+                    _rxcore_spatial_grid_benchmark_collect(i, positions[i], &reference);
+                }
+            }
+        }
+    });
+
+    _rxcore_spatial_grid_benchmark_hits_t hits = {0};
+    RXCORE_BENCHMARK("radius, grid, 1000 points", samples, 10, {
+        hits = (_rxcore_spatial_grid_benchmark_hits_t){0};
+        for (uint32_t s = 0; s < samples; s++)
+        {
+            rxcore_spatial_grid_query_radius(grid, positions[s * (count / samples)], radius, _rxcore_spatial_grid_benchmark_collect, &hits);
+        }
+    });
+    rxcore_benchmark_check("radius, grid", hits.count == reference.count && hits.sum == reference.sum);
+
+    // rects several cells across, like the screen of a small camera
+    reference = (_rxcore_spatial_grid_benchmark_hits_t){0};
+    hits = (_rxcore_spatial_grid_benchmark_hits_t){0};
+    for (uint32_t s = 0; s < 100; s++)
+    {
+        gs_vec2 min = positions[s * (count / 100)];
+        gs_vec2 max = gs_vec2_add(min, gs_v2(40.f, 25.f));
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (positions[i].x >= min.x && positions[i].x <= max.x && positions[i].y >= min.y && positions[i].y <= max.y)
+            {
+                _rxcore_spatial_grid_benchmark_collect(i, positions[i], &reference);
+            }
+        }
+        rxcore_spatial_grid_query_rect(grid, min, max, _rxcore_spatial_grid_benchmark_collect, &hits);
+    }
+    rxcore_benchmark_check("rect, grid", hits.count == reference.count && hits.sum == reference.sum);
+
+    // a radius covering the whole world spans far more cells than the table has buckets, so it scans the points once
+    hits = (_rxcore_spatial_grid_benchmark_hits_t){0};
+    RXCORE_BENCHMARK("radius, whole world", count, 10, {
+        hits = (_rxcore_spatial_grid_benchmark_hits_t){0};
+        rxcore_spatial_grid_query_radius(grid, gs_v2(world_size * 0.5f, world_size * 0.5f), world_size * 4.f, _rxcore_spatial_grid_benchmark_collect, &hits);
+    });
+    rxcore_benchmark_check("radius, whole world", hits.count == count && hits.sum == (uint64_t)count * (count - 1) / 2);
+
+    // nothing may be written when there is no room for anything
+    uint32_t guard = UINT32_MAX;
+    rxcore_benchmark_check("gather, no room", rxcore_spatial_grid_gather_radius(grid, positions[0], radius, &guard, 0) == 0 && guard == UINT32_MAX);
+
+    free(positions);
+    free(velocities);
+    free(found);
+    rxcore_spatial_grid_destroy(grid);
+    rxcore_jobs_destroy(jobs);
+}
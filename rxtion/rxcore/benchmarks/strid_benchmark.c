@@ -0,0 +1,107 @@
+// strid_benchmark.c
+
+#include <rxcore/benchmark.h>
+#include <rxcore/strid.h>
+#include <rxcore/rendering/mesh.h>
+#include <rxcore/profiler.h>
+
+#define RXCORE_STRID_BENCHMARK_ASSETS 10000
+
+// the search the registries did before they were hashed
+static bool _rxcore_strid_benchmark_find_linear(rxcore_mesh_registry_t *registry, const char *mesh_name, uint32_t *index_out)
+{
+    for (uint32_t i = 0; i < gs_dyn_array_size(registry->mesh_names); i++)
+    {
+        if (strcmp(registry->mesh_names[i], mesh_name) == 0)
+        {
+            *index_out = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void rxcore_benchmark_strid()
+{
+    gs_println("String ids");
+
+    // the names share a long prefix as asset paths do, which is the worst case for strcmp
+    char (*names)[64] = malloc(sizeof(char[64]) * RXCORE_STRID_BENCHMARK_ASSETS);
+    rxcore_strid_t *ids = malloc(sizeof(rxcore_strid_t) * RXCORE_STRID_BENCHMARK_ASSETS);
+    for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "assets/meshes/props/prop_%05d", (i * 7919) % RXCORE_STRID_BENCHMARK_ASSETS);
+        ids[i] = rxcore_strid_hash(names[i]);
+    }
+
+    rxcore_vertex_t vertices[3] = {0};
+    uint32_t indices[3] = {0, 1, 2};
+    rxcore_mesh_registry_t *registry = rxcore_mesh_registry_create();
+    RXCORE_BENCHMARK("10k meshes, register", RXCORE_STRID_BENCHMARK_ASSETS, 1, {
+        for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+        {
+            rxcore_mesh_registry_add_mesh(registry, names[i], vertices, 3, indices, 3);
+        }
+    });
+
+    uint32_t *linear = malloc(sizeof(uint32_t) * RXCORE_STRID_BENCHMARK_ASSETS);
+    uint32_t *hashed = malloc(sizeof(uint32_t) * RXCORE_STRID_BENCHMARK_ASSETS);
+    uint32_t *by_id = malloc(sizeof(uint32_t) * RXCORE_STRID_BENCHMARK_ASSETS);
+    RXCORE_BENCHMARK("10k meshes, 10k lookups, strcmp", RXCORE_STRID_BENCHMARK_ASSETS, 3, {
+        for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+        {
+            g_rxcore_benchmark_sink += _rxcore_strid_benchmark_find_linear(registry, names[i], &linear[i]);
+        }
+    });
+    RXCORE_BENCHMARK("10k meshes, 10k lookups, by name", RXCORE_STRID_BENCHMARK_ASSETS, 10, {
+        for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+        {
+            g_rxcore_benchmark_sink += rxcore_mesh_registry_get_mesh_index(registry, names[i], &hashed[i]);
+        }
+    });
+    RXCORE_BENCHMARK("10k meshes, 10k lookups, by id", RXCORE_STRID_BENCHMARK_ASSETS, 10, {
+        for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+        {
+            g_rxcore_benchmark_sink += rxcore_mesh_registry_get_mesh_index_by_id(registry, ids[i], &by_id[i]);
+        }
+    });
+
+    bool same = true;
+    for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+    {
+        same = same && linear[i] == i && hashed[i] == i && by_id[i] == i;
+    }
+    uint32_t missing = 0;
+    rxcore_benchmark_check("10k meshes, same indices", same && !rxcore_mesh_registry_get_mesh_index(registry, "assets/meshes/props/prop_10000", &missing));
+
+    // a second registry of the same assets holds the same copies of their names
+    rxcore_mesh_registry_t *other = rxcore_mesh_registry_create();
+    for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+    {
+        rxcore_mesh_registry_add_mesh(other, names[i], vertices, 3, indices, 3);
+    }
+    bool interned = true;
+    for (uint32_t i = 0; i < RXCORE_STRID_BENCHMARK_ASSETS; i++)
+    {
+        interned = interned && registry->mesh_names[i] == other->mesh_names[i] && registry->mesh_names[i] != names[i] &&
+                   rxcore_strid_get_string(ids[i]) == registry->mesh_names[i];
+    }
+    rxcore_benchmark_check("10k meshes, names interned", interned);
+
+    // the macro has to give what hashing the string when the code runs does
+    rxcore_benchmark_check("RXCORE_STRID", RXCORE_STRID("assets/meshes/props/prop_00000") == rxcore_strid_hash("assets/meshes/props/prop_00000") &&
+                                                 RXCORE_STRID("") == RXCORE_STRID_OFFSET &&
+                                                 RXCORE_STRID("a") == rxcore_strid_hash("a") &&
+                                                 RXCORE_STRID("0123456789012345678901234567890123456789012345678901234567890123") ==
+                                                     rxcore_strid_hash("0123456789012345678901234567890123456789012345678901234567890123") &&
+                                                 RXCORE_STRID("01234567890123456789012345678901234567890123456789012345678901234") ==
+                                                     rxcore_strid_hash("01234567890123456789012345678901234567890123456789012345678901234"));
+
+    rxcore_mesh_registry_destroy(registry);
+    rxcore_mesh_registry_destroy(other);
+    free(names);
+    free(ids);
+    free(linear);
+    free(hashed);
+    free(by_id);
+}
@@ -0,0 +1,139 @@
+// bounding_box.c
+
+#include <rxcore/bounding_box.h>
+#include <float.h>
+#include <math.h>
+
+rxcore_bounding_box_t rxcore_bounding_box_create(gs_vec3 min, gs_vec3 max)
+{
+    return (rxcore_bounding_box_t){.min = min, .max = max};
+}
+
+rxcore_bounding_box_t rxcore_bounding_box_empty()
+{
+    return (rxcore_bounding_box_t){
+        .min = gs_v3(FLT_MAX, FLT_MAX, FLT_MAX),
+        .max = gs_v3(-FLT_MAX, -FLT_MAX, -FLT_MAX)};
+}
+
+bool rxcore_bounding_box_is_empty(rxcore_bounding_box_t *box)
+{
+    return box->min.x > box->max.x || box->min.y > box->max.y || box->min.z > box->max.z;
+}
+
+gs_vec3 rxcore_bounding_box_get_center(rxcore_bounding_box_t *box)
+{
+    return gs_vec3_scale(gs_vec3_add(box->min, box->max), 0.5f);
+}
+
+gs_vec3 rxcore_bounding_box_get_size(rxcore_bounding_box_t *box)
+{
+    return gs_vec3_sub(box->max, box->min);
+}
+
+gs_vec3 rxcore_bounding_box_get_extents(rxcore_bounding_box_t *box)
+{
+    return gs_vec3_scale(gs_vec3_sub(box->max, box->min), 0.5f);
+}
+
+void rxcore_bounding_box_encapsulate_point(rxcore_bounding_box_t *box, gs_vec3 point)
+{
+    box->min = gs_v3(gs_min(box->min.x, point.x), gs_min(box->min.y, point.y), gs_min(box->min.z, point.z));
+    box->max = gs_v3(gs_max(box->max.x, point.x), gs_max(box->max.y, point.y), gs_max(box->max.z, point.z));
+}
+
+void rxcore_bounding_box_encapsulate_box(rxcore_bounding_box_t *box, rxcore_bounding_box_t *other)
+{
+    rxcore_bounding_box_encapsulate_point(box, other->min);
+    rxcore_bounding_box_encapsulate_point(box, other->max);
+}
+
+bool rxcore_bounding_box_contains_point(rxcore_bounding_box_t *box, gs_vec3 point)
+{
+    return point.x >= box->min.x && point.x <= box->max.x &&
+           point.y >= box->min.y && point.y <= box->max.y &&
+           point.z >= box->min.z && point.z <= box->max.z;
+}
+
+bool rxcore_bounding_box_contains_box(rxcore_bounding_box_t *box, rxcore_bounding_box_t *other)
+{
+    return rxcore_bounding_box_contains_point(box, other->min) && rxcore_bounding_box_contains_point(box, other->max);
+}
+
+bool rxcore_bounding_box_intersects_box(rxcore_bounding_box_t *box, rxcore_bounding_box_t *other)
+{
+    return box->min.x <= other->max.x && box->max.x >= other->min.x &&
+           box->min.y <= other->max.y && box->max.y >= other->min.y &&
+           box->min.z <= other->max.z && box->max.z >= other->min.z;
+}
+
+rxcore_bounding_box_t rxcore_bounding_box_transform(rxcore_bounding_box_t *box, gs_mat4 transform)
+{
+    if (rxcore_bounding_box_is_empty(box))
+    {
+        return *box;
+    }
+
+    // rather than transforming all 8 corners, move the center with the full matrix and
+    // project the extents onto each world axis with the absolute value of the rotation and scale
+    gs_vec3 center = rxcore_bounding_box_get_center(box);
+    gs_vec3 extents = rxcore_bounding_box_get_extents(box);
+    float *m = transform.elements; // column major, m[column * 4 + row]
+
+    gs_vec3 world_center = gs_v3(
+        m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+        m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+        m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]);
+
+    gs_vec3 world_extents = gs_v3(
+        fabsf(m[0]) * extents.x + fabsf(m[4]) * extents.y + fabsf(m[8]) * extents.z,
+        fabsf(m[1]) * extents.x + fabsf(m[5]) * extents.y + fabsf(m[9]) * extents.z,
+        fabsf(m[2]) * extents.x + fabsf(m[6]) * extents.y + fabsf(m[10]) * extents.z);
+
+    return rxcore_bounding_box_create(gs_vec3_sub(world_center, world_extents), gs_vec3_add(world_center, world_extents));
+}
+
+float rxcore_bounding_box_get_surface_area(rxcore_bounding_box_t *box)
+{
+    gs_vec3 size = rxcore_bounding_box_get_size(box);
+    return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool rxcore_bounding_box_intersects_ray(rxcore_bounding_box_t *box, rxcore_ray_t *ray, float max_distance, float *distance_out)
+{
+    // where the ray crosses each pair of slabs, an axis the ray is parallel to gives infinities (or nans, which fminf and fmaxf skip)
+    float tx0 = (box->min.x - ray->origin.x) * ray->inv_direction.x;
+    float tx1 = (box->max.x - ray->origin.x) * ray->inv_direction.x;
+    float ty0 = (box->min.y - ray->origin.y) * ray->inv_direction.y;
+    float ty1 = (box->max.y - ray->origin.y) * ray->inv_direction.y;
+    float tz0 = (box->min.z - ray->origin.z) * ray->inv_direction.z;
+    float tz1 = (box->max.z - ray->origin.z) * ray->inv_direction.z;
+
+    float t_enter = fmaxf(fmaxf(fminf(tx0, tx1), fminf(ty0, ty1)), fmaxf(fminf(tz0, tz1), 0.f));
+    float t_exit = fminf(fminf(fmaxf(tx0, tx1), fmaxf(ty0, ty1)), fminf(fmaxf(tz0, tz1), max_distance));
+
+    if (t_enter > t_exit)
+    {
+        return false;
+    }
+
+    if (distance_out)
+    {
+        *distance_out = t_enter;
+    }
+    return true;
+}
+
+rxcore_ray_t rxcore_ray_create(gs_vec3 origin, gs_vec3 direction)
+{
+    rxcore_ray_t ray = {0};
+    ray.origin = origin;
+    ray.direction = direction;
+    ray.inv_direction = gs_v3(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+    return ray;
+}
+
+gs_vec3 rxcore_ray_get_point(rxcore_ray_t *ray, float distance)
+{
+    return gs_vec3_add(ray->origin, gs_vec3_scale(ray->direction, distance));
+}
@@ -2,6 +2,7 @@
 #define __BOUNDING_BOX_H__
 
 #include <gs/gs.h>
+#include <stdbool.h>
 
 typedef struct rxcore_bounding_box_t
 {
@@ -9,16 +10,33 @@ typedef struct rxcore_bounding_box_t
     gs_vec3 max;
 } rxcore_bounding_box_t;
 
+typedef struct rxcore_ray_t
+{
+    gs_vec3 origin;
+    gs_vec3 direction;
+    gs_vec3 inv_direction; // kept alongside the direction, as every box test needs it
+} rxcore_ray_t;
+
 rxcore_bounding_box_t rxcore_bounding_box_create(gs_vec3 min, gs_vec3 max);
-rxcore_bounding_box_t rxcore_bounding_box_empty();
+rxcore_bounding_box_t rxcore_bounding_box_empty(); // inverted, so that encapsulating anything makes it valid
+bool rxcore_bounding_box_is_empty(rxcore_bounding_box_t *box);
 gs_vec3 rxcore_bounding_box_get_center(rxcore_bounding_box_t *box);
 gs_vec3 rxcore_bounding_box_get_size(rxcore_bounding_box_t *box);
 gs_vec3 rxcore_bounding_box_get_extents(rxcore_bounding_box_t *box);
 void rxcore_bounding_box_encapsulate_point(rxcore_bounding_box_t *box, gs_vec3 point);
+void rxcore_bounding_box_encapsulate_box(rxcore_bounding_box_t *box, rxcore_bounding_box_t *other);
 bool rxcore_bounding_box_contains_point(rxcore_bounding_box_t *box, gs_vec3 point);
 bool rxcore_bounding_box_contains_box(rxcore_bounding_box_t *box, rxcore_bounding_box_t *other);
 bool rxcore_bounding_box_intersects_box(rxcore_bounding_box_t *box, rxcore_bounding_box_t *other);
 rxcore_bounding_box_t rxcore_bounding_box_transform(rxcore_bounding_box_t *box, gs_mat4 transform);
+float rxcore_bounding_box_get_surface_area(rxcore_bounding_box_t *box);
+
+/// @brief Slab test of the ray against the box
+/// @param distance_out Receives the distance along the ray where it enters the box, 0 if it starts inside. May be NULL
+/// @return true if the ray hits the box before max_distance
+bool rxcore_bounding_box_intersects_ray(rxcore_bounding_box_t *box, rxcore_ray_t *ray, float max_distance, float *distance_out);
 
+rxcore_ray_t rxcore_ray_create(gs_vec3 origin, gs_vec3 direction);
+gs_vec3 rxcore_ray_get_point(rxcore_ray_t *ray, float distance);
 
 #endif // __BOUNDING_BOX_H__
\ No newline at end of file
@@ -0,0 +1,635 @@
+// bvh.c
+
+#include <rxcore/bvh.h>
+#include <rxcore/profiler.h>
+#include <float.h>
+
+// the top bit of an entry on the frustum query stack, set when the node is already known to be inside
+#define RXCORE_BVH_INSIDE_BIT 0x80000000u
+
+rxcore_bvh_t *rxcore_bvh_create()
+{
+    rxcore_bvh_t *bvh = malloc(sizeof(rxcore_bvh_t));
+    bvh->nodes = gs_dyn_array_new(rxcore_bvh_node_t);
+    bvh->root = RXCORE_BVH_NULL;
+    bvh->free_list = RXCORE_BVH_NULL;
+    bvh->leaf_count = 0;
+    bvh->moved = gs_dyn_array_new(uint32_t);
+    bvh->stack = gs_dyn_array_new(uint32_t);
+    bvh->scratch = gs_dyn_array_new(uint32_t);
+    return bvh;
+}
+
+uint32_t rxcore_bvh_insert(rxcore_bvh_t *bvh, rxcore_bounding_box_t *bounds, void *data)
+{
+    uint32_t leaf = _rxcore_bvh_allocate_node(bvh);
+    rxcore_bvh_node_t *node = &bvh->nodes[leaf];
+    node->bounds = *bounds;
+    node->data = data;
+    node->height = 0;
+
+    _rxcore_bvh_insert_leaf(bvh, leaf);
+    bvh->leaf_count++;
+    return leaf;
+}
+
+void rxcore_bvh_remove(rxcore_bvh_t *bvh, uint32_t leaf)
+{
+    assert(leaf < gs_dyn_array_size(bvh->nodes) && bvh->nodes[leaf].height == 0);
+
+    _rxcore_bvh_remove_leaf(bvh, leaf);
+    _rxcore_bvh_free_node(bvh, leaf);
+    bvh->leaf_count--;
+}
+
+void rxcore_bvh_update(rxcore_bvh_t *bvh, uint32_t leaf, rxcore_bounding_box_t *bounds)
+{
+    assert(leaf < gs_dyn_array_size(bvh->nodes) && bvh->nodes[leaf].height == 0);
+
+    bvh->nodes[leaf].bounds = *bounds;
+    gs_dyn_array_push(bvh->moved, leaf);
+}
+
+void rxcore_bvh_refit(rxcore_bvh_t *bvh)
+{
+    rxcore_bvh_node_t *nodes = bvh->nodes;
+    for (uint32_t i = 0; i < gs_dyn_array_size(bvh->moved); i++)
+    {
+        // the leaf may have been removed since it moved
+        uint32_t leaf = bvh->moved[i];
+        if (nodes[leaf].height != 0)
+        {
+            continue;
+        }
+
+        // once a parent comes out the same, everything above it already accounts for this leaf
+        uint32_t index = nodes[leaf].parent;
+        while (index != RXCORE_BVH_NULL)
+        {
+            rxcore_bvh_node_t *node = &nodes[index];
+            rxcore_bounding_box_t bounds = _rxcore_bvh_union(&nodes[node->left].bounds, &nodes[node->right].bounds);
+            if (memcmp(&bounds, &node->bounds, sizeof(rxcore_bounding_box_t)) == 0)
+            {
+                break;
+            }
+
+            node->bounds = bounds;
+            index = node->parent;
+        }
+    }
+
+    gs_dyn_array_clear(bvh->moved);
+}
+
+void rxcore_bvh_rebuild(rxcore_bvh_t *bvh)
+{
+    RXCORE_PROFILER_BEGIN_TASK("bvh_rebuild");
+
+    // leaves keep their indices, so anything holding onto them stays valid
+    gs_dyn_array_clear(bvh->scratch);
+    gs_dyn_array_reserve(bvh->scratch, bvh->leaf_count);
+    for (uint32_t i = 0; i < gs_dyn_array_size(bvh->nodes); i++)
+    {
+        if (bvh->nodes[i].height == 0)
+        {
+            gs_dyn_array_push(bvh->scratch, i);
+        }
+        else if (bvh->nodes[i].height > 0)
+        {
+            _rxcore_bvh_free_node(bvh, i);
+        }
+    }
+
+    // the leaves are read directly, so there is nothing left to refit
+    gs_dyn_array_clear(bvh->moved);
+
+    bvh->root = RXCORE_BVH_NULL;
+    if (bvh->leaf_count > 0)
+    {
+        bvh->root = _rxcore_bvh_build(bvh, bvh->scratch, bvh->leaf_count);
+        bvh->nodes[bvh->root].parent = RXCORE_BVH_NULL;
+    }
+
+    RXCORE_BVH_DEBUG_PRINTF("Rebuilt %d leaves, height %d, cost %f", bvh->leaf_count, rxcore_bvh_get_height(bvh), rxcore_bvh_get_cost(bvh));
+    RXCORE_PROFILER_END_TASK();
+}
+
+void rxcore_bvh_query_frustum(rxcore_bvh_t *bvh, rxcore_frustum_t *frustum, rxcore_bvh_query_fn fn, void *user_data)
+{
+    if (bvh->root == RXCORE_BVH_NULL)
+    {
+        return;
+    }
+
+    // every node pushes at most two entries for the one it pops, so the stack never outgrows the tree
+    gs_dyn_array_reserve(bvh->stack, gs_dyn_array_size(bvh->nodes) + 1);
+    uint32_t *stack = bvh->stack;
+    uint32_t stack_ptr = 0;
+    stack[stack_ptr++] = bvh->root;
+
+    rxcore_bvh_node_t *nodes = bvh->nodes;
+    while (stack_ptr > 0)
+    {
+        uint32_t entry = stack[--stack_ptr];
+        uint32_t inside = entry & RXCORE_BVH_INSIDE_BIT;
+        rxcore_bvh_node_t *node = &nodes[entry & ~RXCORE_BVH_INSIDE_BIT];
+
+        // below a node that is entirely inside, nothing needs to be tested
+        if (!inside)
+        {
+            rxcore_frustum_result_t result = rxcore_frustum_classify_aabb(frustum, &node->bounds);
+            if (result == RXCORE_FRUSTUM_OUTSIDE)
+            {
+                continue;
+            }
+            inside = result == RXCORE_FRUSTUM_INSIDE ? RXCORE_BVH_INSIDE_BIT : 0;
+        }
+
+        if (node->height == 0)
+        {
+            fn(entry & ~RXCORE_BVH_INSIDE_BIT, node->data, user_data);
+            continue;
+        }
+
+        stack[stack_ptr++] = node->right | inside;
+        stack[stack_ptr++] = node->left | inside;
+    }
+}
+
+void rxcore_bvh_query_box(rxcore_bvh_t *bvh, rxcore_bounding_box_t *box, rxcore_bvh_query_fn fn, void *user_data)
+{
+    if (bvh->root == RXCORE_BVH_NULL)
+    {
+        return;
+    }
+
+    gs_dyn_array_reserve(bvh->stack, gs_dyn_array_size(bvh->nodes) + 1);
+    uint32_t *stack = bvh->stack;
+    uint32_t stack_ptr = 0;
+    stack[stack_ptr++] = bvh->root;
+
+    rxcore_bvh_node_t *nodes = bvh->nodes;
+    while (stack_ptr > 0)
+    {
+        uint32_t index = stack[--stack_ptr];
+        rxcore_bvh_node_t *node = &nodes[index];
+        if (!rxcore_bounding_box_intersects_box(&node->bounds, box))
+        {
+            continue;
+        }
+
+        if (node->height == 0)
+        {
+            fn(index, node->data, user_data);
+            continue;
+        }
+
+        stack[stack_ptr++] = node->right;
+        stack[stack_ptr++] = node->left;
+    }
+}
+
+void rxcore_bvh_query_ray(rxcore_bvh_t *bvh, rxcore_ray_t *ray, float max_distance, rxcore_bvh_ray_fn fn, void *user_data)
+{
+    if (bvh->root == RXCORE_BVH_NULL)
+    {
+        return;
+    }
+
+    gs_dyn_array_reserve(bvh->stack, gs_dyn_array_size(bvh->nodes) + 1);
+    uint32_t *stack = bvh->stack;
+    uint32_t stack_ptr = 0;
+    stack[stack_ptr++] = bvh->root;
+
+    rxcore_bvh_node_t *nodes = bvh->nodes;
+    while (stack_ptr > 0)
+    {
+        // a hit found since this was pushed may have moved the end of the ray in front of it
+        uint32_t index = stack[--stack_ptr];
+        rxcore_bvh_node_t *node = &nodes[index];
+        if (!rxcore_bounding_box_intersects_ray(&node->bounds, ray, max_distance, NULL))
+        {
+            continue;
+        }
+
+        if (node->height == 0)
+        {
+            max_distance = fn(index, node->data, ray, max_distance, user_data);
+            if (max_distance <= 0.f)
+            {
+                return;
+            }
+            continue;
+        }
+
+        // visit the nearer child first, so that hits in it can clip the search of the other
+        float left_distance = 0.f;
+        float right_distance = 0.f;
+        bool hit_left = rxcore_bounding_box_intersects_ray(&nodes[node->left].bounds, ray, max_distance, &left_distance);
+        bool hit_right = rxcore_bounding_box_intersects_ray(&nodes[node->right].bounds, ray, max_distance, &right_distance);
+        if (hit_left && hit_right)
+        {
+            uint32_t near = left_distance <= right_distance ? node->left : node->right;
+            uint32_t far = left_distance <= right_distance ? node->right : node->left;
+            stack[stack_ptr++] = far;
+            stack[stack_ptr++] = near;
+        }
+        else if (hit_left)
+        {
+            stack[stack_ptr++] = node->left;
+        }
+        else if (hit_right)
+        {
+            stack[stack_ptr++] = node->right;
+        }
+    }
+}
+
+void *rxcore_bvh_get_data(rxcore_bvh_t *bvh, uint32_t leaf)
+{
+    return bvh->nodes[leaf].data;
+}
+
+rxcore_bounding_box_t *rxcore_bvh_get_bounds(rxcore_bvh_t *bvh, uint32_t leaf)
+{
+    return &bvh->nodes[leaf].bounds;
+}
+
+uint32_t rxcore_bvh_get_height(rxcore_bvh_t *bvh)
+{
+    return bvh->root == RXCORE_BVH_NULL ? 0 : (uint32_t)bvh->nodes[bvh->root].height;
+}
+
+float rxcore_bvh_get_cost(rxcore_bvh_t *bvh)
+{
+    if (bvh->root == RXCORE_BVH_NULL)
+    {
+        return 0.f;
+    }
+
+    float root_area = rxcore_bounding_box_get_surface_area(&bvh->nodes[bvh->root].bounds);
+    if (root_area <= 0.f)
+    {
+        return 0.f;
+    }
+
+    float total_area = 0.f;
+    for (uint32_t i = 0; i < gs_dyn_array_size(bvh->nodes); i++)
+    {
+        if (bvh->nodes[i].height > 0)
+        {
+            total_area += rxcore_bounding_box_get_surface_area(&bvh->nodes[i].bounds);
+        }
+    }
+    return total_area / root_area;
+}
+
+void rxcore_bvh_destroy(rxcore_bvh_t *bvh)
+{
+    gs_dyn_array_free(bvh->nodes);
+    gs_dyn_array_free(bvh->moved);
+    gs_dyn_array_free(bvh->stack);
+    gs_dyn_array_free(bvh->scratch);
+    free(bvh);
+}
+
+uint32_t _rxcore_bvh_allocate_node(rxcore_bvh_t *bvh)
+{
+    uint32_t index = bvh->free_list;
+    if (index == RXCORE_BVH_NULL)
+    {
+        rxcore_bvh_node_t node = {0};
+        gs_dyn_array_push(bvh->nodes, node);
+        index = gs_dyn_array_size(bvh->nodes) - 1;
+    }
+    else
+    {
+        bvh->free_list = bvh->nodes[index].parent;
+    }
+
+    rxcore_bvh_node_t *node = &bvh->nodes[index];
+    node->parent = RXCORE_BVH_NULL;
+    node->left = RXCORE_BVH_NULL;
+    node->right = RXCORE_BVH_NULL;
+    node->height = 0;
+    node->data = NULL;
+    return index;
+}
+
+void _rxcore_bvh_free_node(rxcore_bvh_t *bvh, uint32_t index)
+{
+    bvh->nodes[index].parent = bvh->free_list;
+    bvh->nodes[index].height = -1;
+    bvh->free_list = index;
+}
+
+void _rxcore_bvh_insert_leaf(rxcore_bvh_t *bvh, uint32_t leaf)
+{
+    if (bvh->root == RXCORE_BVH_NULL)
+    {
+        bvh->root = leaf;
+        bvh->nodes[leaf].parent = RXCORE_BVH_NULL;
+        return;
+    }
+
+    // walk down to the sibling that adds the least surface area, counting the growth of every ancestor on the way
+    rxcore_bounding_box_t leaf_bounds = bvh->nodes[leaf].bounds;
+    uint32_t index = bvh->root;
+    while (bvh->nodes[index].height > 0)
+    {
+        rxcore_bvh_node_t *node = &bvh->nodes[index];
+        float area = rxcore_bounding_box_get_surface_area(&node->bounds);
+        rxcore_bounding_box_t combined = _rxcore_bvh_union(&node->bounds, &leaf_bounds);
+        float combined_area = rxcore_bounding_box_get_surface_area(&combined);
+
+        // the cost of making a new parent for this node and the leaf, and of pushing the leaf further down
+        float cost = 2.f * combined_area;
+        float inherited_cost = 2.f * (combined_area - area);
+
+        float child_costs[2];
+        uint32_t children[2] = {node->left, node->right};
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            rxcore_bvh_node_t *child = &bvh->nodes[children[i]];
+            rxcore_bounding_box_t child_combined = _rxcore_bvh_union(&child->bounds, &leaf_bounds);
+            child_costs[i] = rxcore_bounding_box_get_surface_area(&child_combined) + inherited_cost;
+            if (child->height > 0)
+            {
+                child_costs[i] -= rxcore_bounding_box_get_surface_area(&child->bounds);
+            }
+        }
+
+        if (cost < child_costs[0] && cost < child_costs[1])
+        {
+            break;
+        }
+
+        index = child_costs[0] < child_costs[1] ? children[0] : children[1];
+    }
+
+    // give the sibling and the leaf a new parent, in the place the sibling used to be
+    uint32_t sibling = index;
+    uint32_t old_parent = bvh->nodes[sibling].parent;
+    uint32_t new_parent = _rxcore_bvh_allocate_node(bvh);
+
+    rxcore_bvh_node_t *parent = &bvh->nodes[new_parent];
+    parent->parent = old_parent;
+    parent->bounds = _rxcore_bvh_union(&leaf_bounds, &bvh->nodes[sibling].bounds);
+    parent->height = bvh->nodes[sibling].height + 1;
+    parent->left = sibling;
+    parent->right = leaf;
+    bvh->nodes[sibling].parent = new_parent;
+    bvh->nodes[leaf].parent = new_parent;
+
+    if (old_parent == RXCORE_BVH_NULL)
+    {
+        bvh->root = new_parent;
+    }
+    else if (bvh->nodes[old_parent].left == sibling)
+    {
+        bvh->nodes[old_parent].left = new_parent;
+    }
+    else
+    {
+        bvh->nodes[old_parent].right = new_parent;
+    }
+
+    _rxcore_bvh_fix_upwards(bvh, bvh->nodes[leaf].parent);
+}
+
+void _rxcore_bvh_remove_leaf(rxcore_bvh_t *bvh, uint32_t leaf)
+{
+    if (leaf == bvh->root)
+    {
+        bvh->root = RXCORE_BVH_NULL;
+        return;
+    }
+
+    // the sibling takes the place of the parent, which isn't needed anymore
+    uint32_t parent = bvh->nodes[leaf].parent;
+    uint32_t grandparent = bvh->nodes[parent].parent;
+    uint32_t sibling = bvh->nodes[parent].left == leaf ? bvh->nodes[parent].right : bvh->nodes[parent].left;
+
+    _rxcore_bvh_free_node(bvh, parent);
+    bvh->nodes[sibling].parent = grandparent;
+    if (grandparent == RXCORE_BVH_NULL)
+    {
+        bvh->root = sibling;
+        return;
+    }
+
+    if (bvh->nodes[grandparent].left == parent)
+    {
+        bvh->nodes[grandparent].left = sibling;
+    }
+    else
+    {
+        bvh->nodes[grandparent].right = sibling;
+    }
+
+    _rxcore_bvh_fix_upwards(bvh, grandparent);
+}
+
+void _rxcore_bvh_fix_upwards(rxcore_bvh_t *bvh, uint32_t index)
+{
+    while (index != RXCORE_BVH_NULL)
+    {
+        index = _rxcore_bvh_balance(bvh, index);
+
+        rxcore_bvh_node_t *node = &bvh->nodes[index];
+        rxcore_bvh_node_t *left = &bvh->nodes[node->left];
+        rxcore_bvh_node_t *right = &bvh->nodes[node->right];
+        node->height = 1 + gs_max(left->height, right->height);
+        node->bounds = _rxcore_bvh_union(&left->bounds, &right->bounds);
+
+        index = node->parent;
+    }
+}
+
+uint32_t _rxcore_bvh_balance(rxcore_bvh_t *bvh, uint32_t index_a)
+{
+    rxcore_bvh_node_t *nodes = bvh->nodes;
+    rxcore_bvh_node_t *a = &nodes[index_a];
+    if (a->height < 2)
+    {
+        return index_a;
+    }
+
+    // when one side is more than a level deeper than the other, rotate its root up to take a's place,
+    // and hand the shallower of its children down to a
+    uint32_t index_b = a->left;
+    uint32_t index_c = a->right;
+    int32_t balance = nodes[index_c].height - nodes[index_b].height;
+    if (balance >= -1 && balance <= 1)
+    {
+        return index_a;
+    }
+
+    bool right_heavy = balance > 1;
+    uint32_t index_up = right_heavy ? index_c : index_b;
+    uint32_t index_stay = right_heavy ? index_b : index_c;
+    rxcore_bvh_node_t *up = &nodes[index_up];
+
+    uint32_t index_f = up->left;
+    uint32_t index_g = up->right;
+
+    up->left = index_a;
+    up->parent = a->parent;
+    a->parent = index_up;
+
+    if (up->parent == RXCORE_BVH_NULL)
+    {
+        bvh->root = index_up;
+    }
+    else if (nodes[up->parent].left == index_a)
+    {
+        nodes[up->parent].left = index_up;
+    }
+    else
+    {
+        nodes[up->parent].right = index_up;
+    }
+
+    // the deeper grandchild stays with the node going up, the other moves under a in the slot up used to fill
+    uint32_t index_keep = nodes[index_f].height > nodes[index_g].height ? index_f : index_g;
+    uint32_t index_give = nodes[index_f].height > nodes[index_g].height ? index_g : index_f;
+    up->right = index_keep;
+    if (right_heavy)
+    {
+        a->right = index_give;
+    }
+    else
+    {
+        a->left = index_give;
+    }
+    nodes[index_give].parent = index_a;
+
+    a->bounds = _rxcore_bvh_union(&nodes[index_stay].bounds, &nodes[index_give].bounds);
+    a->height = 1 + gs_max(nodes[index_stay].height, nodes[index_give].height);
+    up->bounds = _rxcore_bvh_union(&a->bounds, &nodes[index_keep].bounds);
+    up->height = 1 + gs_max(a->height, nodes[index_keep].height);
+
+    return index_up;
+}
+
+uint32_t _rxcore_bvh_build(rxcore_bvh_t *bvh, uint32_t *leaves, uint32_t count)
+{
+    if (count == 1)
+    {
+        return leaves[0];
+    }
+
+    // split along the axis the centroids are most spread out on
+    rxcore_bounding_box_t centroid_bounds = rxcore_bounding_box_empty();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        rxcore_bounding_box_encapsulate_point(&centroid_bounds, rxcore_bounding_box_get_center(&bvh->nodes[leaves[i]].bounds));
+    }
+
+    gs_vec3 spread = rxcore_bounding_box_get_size(&centroid_bounds);
+    uint32_t axis = spread.x > spread.y ? (spread.x > spread.z ? 0 : 2) : (spread.y > spread.z ? 1 : 2);
+    float axis_min = axis == 0 ? centroid_bounds.min.x : axis == 1 ? centroid_bounds.min.y : centroid_bounds.min.z;
+    float axis_spread = axis == 0 ? spread.x : axis == 1 ? spread.y : spread.z;
+
+    uint32_t mid = count / 2;
+    if (axis_spread > FLT_EPSILON)
+    {
+        // sort the centroids into buckets, then find the boundary between buckets that minimizes
+        // the surface area of each side times the number of leaves in it
+        rxcore_bounding_box_t bin_bounds[RXCORE_BVH_SAH_BINS];
+        uint32_t bin_counts[RXCORE_BVH_SAH_BINS] = {0};
+        for (uint32_t b = 0; b < RXCORE_BVH_SAH_BINS; b++)
+        {
+            bin_bounds[b] = rxcore_bounding_box_empty();
+        }
+
+        float bin_scale = (float)RXCORE_BVH_SAH_BINS / axis_spread;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            rxcore_bounding_box_t *bounds = &bvh->nodes[leaves[i]].bounds;
+            gs_vec3 center = rxcore_bounding_box_get_center(bounds);
+            float c = axis == 0 ? center.x : axis == 1 ? center.y : center.z;
+            uint32_t b = gs_min((uint32_t)((c - axis_min) * bin_scale), RXCORE_BVH_SAH_BINS - 1);
+            bin_counts[b]++;
+            rxcore_bounding_box_encapsulate_box(&bin_bounds[b], bounds);
+        }
+
+        // the cost of everything right of each boundary, swept from the right
+        float right_costs[RXCORE_BVH_SAH_BINS];
+        rxcore_bounding_box_t running = rxcore_bounding_box_empty();
+        uint32_t running_count = 0;
+        for (uint32_t b = RXCORE_BVH_SAH_BINS - 1; b > 0; b--)
+        {
+            if (bin_counts[b] > 0)
+            {
+                rxcore_bounding_box_encapsulate_box(&running, &bin_bounds[b]);
+            }
+            running_count += bin_counts[b];
+            right_costs[b] = running_count > 0 ? running_count * rxcore_bounding_box_get_surface_area(&running) : 0.f;
+        }
+
+        float best_cost = FLT_MAX;
+        uint32_t best_split = 0;
+        running = rxcore_bounding_box_empty();
+        running_count = 0;
+        for (uint32_t b = 1; b < RXCORE_BVH_SAH_BINS; b++)
+        {
+            if (bin_counts[b - 1] > 0)
+            {
+                rxcore_bounding_box_encapsulate_box(&running, &bin_bounds[b - 1]);
+            }
+            running_count += bin_counts[b - 1];
+            if (running_count == 0 || running_count == count)
+            {
+                continue;
+            }
+
+            float cost = running_count * rxcore_bounding_box_get_surface_area(&running) + right_costs[b];
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_split = b;
+            }
+        }
+
+        // partition the leaves around the boundary in place
+        if (best_split > 0)
+        {
+            uint32_t left = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                gs_vec3 center = rxcore_bounding_box_get_center(&bvh->nodes[leaves[i]].bounds);
+                float c = axis == 0 ? center.x : axis == 1 ? center.y : center.z;
+                uint32_t b = gs_min((uint32_t)((c - axis_min) * bin_scale), RXCORE_BVH_SAH_BINS - 1);
+                if (b < best_split)
+                {
+                    uint32_t tmp = leaves[left];
+                    leaves[left++] = leaves[i];
+                    leaves[i] = tmp;
+                }
+            }
+            mid = left;
+        }
+    }
+
+    // allocating can move the nodes, so only hold onto indices across the recursion
+    uint32_t index = _rxcore_bvh_allocate_node(bvh);
+    uint32_t left = _rxcore_bvh_build(bvh, leaves, mid);
+    uint32_t right = _rxcore_bvh_build(bvh, leaves + mid, count - mid);
+
+    rxcore_bvh_node_t *node = &bvh->nodes[index];
+    node->left = left;
+    node->right = right;
+    node->height = 1 + gs_max(bvh->nodes[left].height, bvh->nodes[right].height);
+    node->bounds = _rxcore_bvh_union(&bvh->nodes[left].bounds, &bvh->nodes[right].bounds);
+    bvh->nodes[left].parent = index;
+    bvh->nodes[right].parent = index;
+    return index;
+}
+
+rxcore_bounding_box_t _rxcore_bvh_union(rxcore_bounding_box_t *a, rxcore_bounding_box_t *b)
+{
+    return rxcore_bounding_box_create(
+        gs_v3(gs_min(a->min.x, b->min.x), gs_min(a->min.y, b->min.y), gs_min(a->min.z, b->min.z)),
+        gs_v3(gs_max(a->max.x, b->max.x), gs_max(a->max.y, b->max.y), gs_max(a->max.z, b->max.z)));
+}
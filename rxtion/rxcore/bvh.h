@@ -0,0 +1,106 @@
+#ifndef __BVH_H__
+#define __BVH_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rxcore/bounding_box.h>
+#include <rxcore/frustum.h>
+#include <rxcore/log.h>
+
+// #define RXCORE_BVH_DEBUG
+
+#ifdef RXCORE_BVH_DEBUG
+#define RXCORE_BVH_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("bvh", str)
+#define RXCORE_BVH_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("bvh", str, __VA_ARGS__)
+#else
+#define RXCORE_BVH_DEBUG_PRINT(...) ((void)0)
+#define RXCORE_BVH_DEBUG_PRINTF(...) ((void)0)
+#endif
+
+#define RXCORE_BVH_NULL 0xFFFFFFFFu
+
+// the number of buckets the centroids are sorted into when looking for the cheapest split during a rebuild
+#define RXCORE_BVH_SAH_BINS 12
+
+/**
+ * Example Usage
+ * rxcore_bvh_t *bvh = rxcore_bvh_create();
+ * uint32_t leaf = rxcore_bvh_insert(bvh, &bounds, object);
+ * rxcore_bvh_update(bvh, leaf, &moved_bounds);
+ * rxcore_bvh_refit(bvh);
+ * rxcore_bvh_query_frustum(bvh, &frustum, on_visible, NULL);
+ */
+
+/// @brief Called for each leaf a query finds
+typedef void (*rxcore_bvh_query_fn)(uint32_t leaf, void *leaf_data, void *user_data);
+
+/// @brief Called for each leaf whose bounds the ray hits, nearest boxes first
+/// @return The distance to keep searching up to. Return max_distance to keep going, the distance of a hit to
+/// only look for closer ones, or 0 to stop
+typedef float (*rxcore_bvh_ray_fn)(uint32_t leaf, void *leaf_data, rxcore_ray_t *ray, float max_distance, void *user_data);
+
+typedef struct rxcore_bvh_node_t
+{
+    rxcore_bounding_box_t bounds;
+    uint32_t parent; // the next free node, while the node is unused
+    uint32_t left;   // RXCORE_BVH_NULL for leaves
+    uint32_t right;
+    int32_t height;  // 0 for leaves, -1 while the node is unused
+    void *data;      // only for leaves
+} rxcore_bvh_node_t;
+
+/// @brief A dynamic tree of axis aligned boxes. Leaves keep their index for as long as they are in the tree,
+/// internal nodes are created and destroyed as the tree changes shape
+typedef struct rxcore_bvh_t
+{
+    gs_dyn_array(rxcore_bvh_node_t) nodes;
+    uint32_t root;
+    uint32_t free_list;
+    uint32_t leaf_count;
+    gs_dyn_array(uint32_t) moved;   // leaves updated since the last refit
+    gs_dyn_array(uint32_t) stack;   // scratch for the queries, contains garbage
+    gs_dyn_array(uint32_t) scratch; // the leaves being rebuilt
+} rxcore_bvh_t;
+
+rxcore_bvh_t *rxcore_bvh_create();
+
+/// @brief Adds a leaf, placed next to whichever node makes the tree cheapest to search
+/// @return The leaf, to update or remove it with
+uint32_t rxcore_bvh_insert(rxcore_bvh_t *bvh, rxcore_bounding_box_t *bounds, void *data);
+void rxcore_bvh_remove(rxcore_bvh_t *bvh, uint32_t leaf);
+
+/// @brief Moves a leaf without changing the shape of the tree. Its ancestors aren't updated until rxcore_bvh_refit
+void rxcore_bvh_update(rxcore_bvh_t *bvh, uint32_t leaf, rxcore_bounding_box_t *bounds);
+
+/// @brief Grows and shrinks the ancestors of every leaf moved since the last refit. Must be called before querying
+void rxcore_bvh_refit(rxcore_bvh_t *bvh);
+
+/// @brief Throws away the internal nodes and builds them again top down with the surface area heuristic.
+/// Worth doing after loading, or once refitting has let the tree get loose
+void rxcore_bvh_rebuild(rxcore_bvh_t *bvh);
+
+void rxcore_bvh_query_frustum(rxcore_bvh_t *bvh, rxcore_frustum_t *frustum, rxcore_bvh_query_fn fn, void *user_data);
+void rxcore_bvh_query_box(rxcore_bvh_t *bvh, rxcore_bounding_box_t *box, rxcore_bvh_query_fn fn, void *user_data);
+void rxcore_bvh_query_ray(rxcore_bvh_t *bvh, rxcore_ray_t *ray, float max_distance, rxcore_bvh_ray_fn fn, void *user_data);
+
+void *rxcore_bvh_get_data(rxcore_bvh_t *bvh, uint32_t leaf);
+rxcore_bounding_box_t *rxcore_bvh_get_bounds(rxcore_bvh_t *bvh, uint32_t leaf);
+uint32_t rxcore_bvh_get_height(rxcore_bvh_t *bvh);
+
+/// @brief The sum of the surface areas of the internal nodes over that of the root, lower is faster to search
+float rxcore_bvh_get_cost(rxcore_bvh_t *bvh);
+
+void rxcore_bvh_destroy(rxcore_bvh_t *bvh);
+
+// private methods
+uint32_t _rxcore_bvh_allocate_node(rxcore_bvh_t *bvh);
+void _rxcore_bvh_free_node(rxcore_bvh_t *bvh, uint32_t node);
+void _rxcore_bvh_insert_leaf(rxcore_bvh_t *bvh, uint32_t leaf);
+void _rxcore_bvh_remove_leaf(rxcore_bvh_t *bvh, uint32_t leaf);
+void _rxcore_bvh_fix_upwards(rxcore_bvh_t *bvh, uint32_t node);
+uint32_t _rxcore_bvh_balance(rxcore_bvh_t *bvh, uint32_t node);
+uint32_t _rxcore_bvh_build(rxcore_bvh_t *bvh, uint32_t *leaves, uint32_t count);
+rxcore_bounding_box_t _rxcore_bvh_union(rxcore_bounding_box_t *a, rxcore_bounding_box_t *b);
+
+#endif // __BVH_H__
@@ -0,0 +1,278 @@
+// cull.c
+
+#include <rxcore/cull.h>
+#include <rxcore/profiler.h>
+
+#if defined(RXCORE_CULL_AVX2)
+#include <immintrin.h>
+#elif defined(RXCORE_CULL_SSE)
+#include <emmintrin.h>
+#endif
+
+rxcore_cull_bounds_t *rxcore_cull_bounds_create(uint32_t capacity)
+{
+    rxcore_cull_bounds_t *bounds = malloc(sizeof(rxcore_cull_bounds_t));
+    memset(bounds, 0, sizeof(rxcore_cull_bounds_t));
+    rxcore_cull_bounds_reserve(bounds, gs_max(capacity, RXCORE_CULL_BATCH_WIDTH));
+    return bounds;
+}
+
+void rxcore_cull_bounds_reserve(rxcore_cull_bounds_t *bounds, uint32_t capacity)
+{
+    if (capacity <= bounds->capacity)
+    {
+        return;
+    }
+
+    capacity = (capacity + RXCORE_CULL_BATCH_WIDTH - 1) & ~(RXCORE_CULL_BATCH_WIDTH - 1);
+
+    // all six arrays share one allocation, each starting on an aligned boundary
+    void *memory = malloc(sizeof(float) * capacity * 6 + RXCORE_CULL_ALIGNMENT);
+    float *base = (float *)(((uintptr_t)memory + RXCORE_CULL_ALIGNMENT - 1) & ~(uintptr_t)(RXCORE_CULL_ALIGNMENT - 1));
+    float *arrays[6];
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        arrays[i] = base + capacity * i;
+    }
+
+    if (bounds->memory != NULL)
+    {
+        memcpy(arrays[0], bounds->center_x, sizeof(float) * bounds->count);
+        memcpy(arrays[1], bounds->center_y, sizeof(float) * bounds->count);
+        memcpy(arrays[2], bounds->center_z, sizeof(float) * bounds->count);
+        memcpy(arrays[3], bounds->extent_x, sizeof(float) * bounds->count);
+        memcpy(arrays[4], bounds->extent_y, sizeof(float) * bounds->count);
+        memcpy(arrays[5], bounds->extent_z, sizeof(float) * bounds->count);
+        free(bounds->memory);
+    }
+
+    bounds->center_x = arrays[0];
+    bounds->center_y = arrays[1];
+    bounds->center_z = arrays[2];
+    bounds->extent_x = arrays[3];
+    bounds->extent_y = arrays[4];
+    bounds->extent_z = arrays[5];
+    bounds->capacity = capacity;
+    bounds->memory = memory;
+}
+
+void rxcore_cull_bounds_clear(rxcore_cull_bounds_t *bounds)
+{
+    bounds->count = 0;
+}
+
+void rxcore_cull_bounds_push(rxcore_cull_bounds_t *bounds, rxcore_bounding_box_t *box)
+{
+    if (bounds->count == bounds->capacity)
+    {
+        rxcore_cull_bounds_reserve(bounds, bounds->capacity * 2);
+    }
+
+    rxcore_cull_bounds_set(bounds, bounds->count++, box);
+}
+
+void rxcore_cull_bounds_set(rxcore_cull_bounds_t *bounds, uint32_t index, rxcore_bounding_box_t *box)
+{
+    gs_vec3 center = rxcore_bounding_box_get_center(box);
+    gs_vec3 extents = rxcore_bounding_box_get_extents(box);
+    bounds->center_x[index] = center.x;
+    bounds->center_y[index] = center.y;
+    bounds->center_z[index] = center.z;
+    bounds->extent_x[index] = extents.x;
+    bounds->extent_y[index] = extents.y;
+    bounds->extent_z[index] = extents.z;
+}
+
+void rxcore_cull_bounds_destroy(rxcore_cull_bounds_t *bounds)
+{
+    free(bounds->memory);
+    free(bounds);
+}
+
+uint32_t rxcore_cull_frustum(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out)
+{
+#if defined(RXCORE_CULL_AVX2)
+    return _rxcore_cull_frustum_avx2(frustum, bounds, start, end, visible_out);
+#elif defined(RXCORE_CULL_SSE)
+    return _rxcore_cull_frustum_sse(frustum, bounds, start, end, visible_out);
+#else
+    return _rxcore_cull_frustum_scalar(frustum, bounds, start, end, visible_out);
+#endif
+}
+
+uint32_t rxcore_cull_frustum_parallel(rxcore_jobs_t *jobs, rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t *visible_out)
+{
+    uint32_t worker_count = jobs != NULL ? rxcore_jobs_get_worker_count(jobs) : 1;
+    if (worker_count == 1 || bounds->count < RXCORE_CULL_MIN_CHUNK_SIZE * 2)
+    {
+        return rxcore_cull_frustum(frustum, bounds, 0, bounds->count, visible_out);
+    }
+
+    // one chunk per worker, kept to whole batches so that only the last chunk has a scalar tail
+    uint32_t chunk_size = gs_max((bounds->count + worker_count - 1) / worker_count, RXCORE_CULL_MIN_CHUNK_SIZE);
+    chunk_size = (chunk_size + RXCORE_CULL_BATCH_WIDTH - 1) & ~(RXCORE_CULL_BATCH_WIDTH - 1);
+    uint32_t chunk_count = (bounds->count + chunk_size - 1) / chunk_size;
+
+    rxcore_cull_job_t job = {
+        .frustum = frustum,
+        .bounds = bounds,
+        .visible_out = visible_out,
+        .chunk_size = chunk_size,
+    };
+    rxcore_jobs_parallel_for(jobs, bounds->count, chunk_size, _rxcore_cull_job, &job);
+
+    // every chunk wrote to the start of its own range, so close the gaps between them
+    uint32_t visible = job.chunk_counts[0];
+    for (uint32_t i = 1; i < chunk_count; i++)
+    {
+        memmove(visible_out + visible, visible_out + i * chunk_size, sizeof(uint32_t) * job.chunk_counts[i]);
+        visible += job.chunk_counts[i];
+    }
+
+    return visible;
+}
+
+const char *rxcore_cull_get_implementation_name()
+{
+#if defined(RXCORE_CULL_AVX2)
+    return "avx2";
+#elif defined(RXCORE_CULL_SSE)
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+uint32_t _rxcore_cull_frustum_scalar(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out)
+{
+    uint32_t visible = 0;
+    for (uint32_t i = start; i < end; i++)
+    {
+        bool outside = false;
+        for (uint32_t p = 0; p < RXCORE_FRUSTUM_PLANE_COUNT && !outside; p++)
+        {
+            rxcore_plane_t *plane = &frustum->planes[p];
+            float dist = plane->normal.x * bounds->center_x[i] + plane->normal.y * bounds->center_y[i] + plane->normal.z * bounds->center_z[i] + plane->d;
+            float reach = fabsf(plane->normal.x) * bounds->extent_x[i] + fabsf(plane->normal.y) * bounds->extent_y[i] + fabsf(plane->normal.z) * bounds->extent_z[i];
+            outside = dist + reach < 0.f;
+        }
+
+        visible_out[visible] = i;
+        visible += !outside;
+    }
+
+    return visible;
+}
+
+#ifdef RXCORE_CULL_SSE
+uint32_t _rxcore_cull_frustum_sse(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out)
+{
+    // splat every plane once, rather than once per batch
+    __m128 nx[RXCORE_FRUSTUM_PLANE_COUNT], ny[RXCORE_FRUSTUM_PLANE_COUNT], nz[RXCORE_FRUSTUM_PLANE_COUNT], d[RXCORE_FRUSTUM_PLANE_COUNT];
+    __m128 ax[RXCORE_FRUSTUM_PLANE_COUNT], ay[RXCORE_FRUSTUM_PLANE_COUNT], az[RXCORE_FRUSTUM_PLANE_COUNT];
+    for (uint32_t p = 0; p < RXCORE_FRUSTUM_PLANE_COUNT; p++)
+    {
+        rxcore_plane_t *plane = &frustum->planes[p];
+        nx[p] = _mm_set1_ps(plane->normal.x);
+        ny[p] = _mm_set1_ps(plane->normal.y);
+        nz[p] = _mm_set1_ps(plane->normal.z);
+        d[p] = _mm_set1_ps(plane->d);
+        ax[p] = _mm_set1_ps(fabsf(plane->normal.x));
+        ay[p] = _mm_set1_ps(fabsf(plane->normal.y));
+        az[p] = _mm_set1_ps(fabsf(plane->normal.z));
+    }
+
+    __m128 zero = _mm_setzero_ps();
+    uint32_t visible = 0;
+    uint32_t i = start;
+    for (; i + 4 <= end; i += 4)
+    {
+        __m128 cx = _mm_loadu_ps(bounds->center_x + i);
+        __m128 cy = _mm_loadu_ps(bounds->center_y + i);
+        __m128 cz = _mm_loadu_ps(bounds->center_z + i);
+        __m128 ex = _mm_loadu_ps(bounds->extent_x + i);
+        __m128 ey = _mm_loadu_ps(bounds->extent_y + i);
+        __m128 ez = _mm_loadu_ps(bounds->extent_z + i);
+
+        __m128 outside = zero;
+        for (uint32_t p = 0; p < RXCORE_FRUSTUM_PLANE_COUNT; p++)
+        {
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)), _mm_add_ps(_mm_mul_ps(nz[p], cz), d[p]));
+            __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)), _mm_mul_ps(az[p], ez));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(dist, reach), zero));
+        }
+
+        // write every index, but only advance past the visible ones
+        uint32_t mask = ~_mm_movemask_ps(outside) & 0xF;
+        for (uint32_t lane = 0; lane < 4; lane++)
+        {
+            visible_out[visible] = i + lane;
+            visible += (mask >> lane) & 1;
+        }
+    }
+
+    return visible + _rxcore_cull_frustum_scalar(frustum, bounds, i, end, visible_out + visible);
+}
+#endif
+
+#ifdef RXCORE_CULL_AVX2
+uint32_t _rxcore_cull_frustum_avx2(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out)
+{
+    // splat every plane once, rather than once per batch
+    __m256 nx[RXCORE_FRUSTUM_PLANE_COUNT], ny[RXCORE_FRUSTUM_PLANE_COUNT], nz[RXCORE_FRUSTUM_PLANE_COUNT], d[RXCORE_FRUSTUM_PLANE_COUNT];
+    __m256 ax[RXCORE_FRUSTUM_PLANE_COUNT], ay[RXCORE_FRUSTUM_PLANE_COUNT], az[RXCORE_FRUSTUM_PLANE_COUNT];
+    for (uint32_t p = 0; p < RXCORE_FRUSTUM_PLANE_COUNT; p++)
+    {
+        rxcore_plane_t *plane = &frustum->planes[p];
+        nx[p] = _mm256_set1_ps(plane->normal.x);
+        ny[p] = _mm256_set1_ps(plane->normal.y);
+        nz[p] = _mm256_set1_ps(plane->normal.z);
+        d[p] = _mm256_set1_ps(plane->d);
+        ax[p] = _mm256_set1_ps(fabsf(plane->normal.x));
+        ay[p] = _mm256_set1_ps(fabsf(plane->normal.y));
+        az[p] = _mm256_set1_ps(fabsf(plane->normal.z));
+    }
+
+    __m256 zero = _mm256_setzero_ps();
+    uint32_t visible = 0;
+    uint32_t i = start;
+    for (; i + 8 <= end; i += 8)
+    {
+        __m256 cx = _mm256_loadu_ps(bounds->center_x + i);
+        __m256 cy = _mm256_loadu_ps(bounds->center_y + i);
+        __m256 cz = _mm256_loadu_ps(bounds->center_z + i);
+        __m256 ex = _mm256_loadu_ps(bounds->extent_x + i);
+        __m256 ey = _mm256_loadu_ps(bounds->extent_y + i);
+        __m256 ez = _mm256_loadu_ps(bounds->extent_z + i);
+
+        __m256 outside = zero;
+        for (uint32_t p = 0; p < RXCORE_FRUSTUM_PLANE_COUNT; p++)
+        {
+            __m256 dist = _mm256_fmadd_ps(nx[p], cx, _mm256_fmadd_ps(ny[p], cy, _mm256_fmadd_ps(nz[p], cz, d[p])));
+            __m256 reach = _mm256_fmadd_ps(ax[p], ex, _mm256_fmadd_ps(ay[p], ey, _mm256_mul_ps(az[p], ez)));
+            outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(dist, reach), zero, _CMP_LT_OQ));
+        }
+
+        // most batches are entirely in or entirely out, so skip the per lane work for those
+        uint32_t mask = ~_mm256_movemask_ps(outside) & 0xFF;
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        for (uint32_t lane = 0; lane < 8; lane++)
+        {
+            visible_out[visible] = i + lane;
+            visible += (mask >> lane) & 1;
+        }
+    }
+
+    return visible + _rxcore_cull_frustum_scalar(frustum, bounds, i, end, visible_out + visible);
+}
+#endif
+
+void _rxcore_cull_job(void *data, uint32_t start, uint32_t end, uint32_t worker)
+{
+    rxcore_cull_job_t *job = data;
+    job->chunk_counts[start / job->chunk_size] = rxcore_cull_frustum(job->frustum, job->bounds, start, end, job->visible_out + start);
+}
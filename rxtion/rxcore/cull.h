@@ -0,0 +1,78 @@
+#ifndef __CULL_H__
+#define __CULL_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rxcore/bounding_box.h>
+#include <rxcore/frustum.h>
+#include <rxcore/jobs.h>
+
+// the widest batch any of the implementations test at once, arrays are padded and aligned to it
+#define RXCORE_CULL_BATCH_WIDTH 8
+#define RXCORE_CULL_ALIGNMENT 32
+
+// below this many bounds per worker, culling isn't worth spreading across the job system
+#define RXCORE_CULL_MIN_CHUNK_SIZE 4096
+
+#if defined(__AVX2__) && defined(__FMA__)
+#define RXCORE_CULL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RXCORE_CULL_SSE
+#endif
+
+/// @brief Axis aligned boxes stored as centers and extents, one array per component,
+/// so that several boxes can be tested against a plane with a single set of instructions
+typedef struct rxcore_cull_bounds_t
+{
+    float *center_x;
+    float *center_y;
+    float *center_z;
+    float *extent_x;
+    float *extent_y;
+    float *extent_z;
+    uint32_t count;
+    uint32_t capacity; // always a multiple of RXCORE_CULL_BATCH_WIDTH
+    void *memory;      // the unaligned allocation that all of the arrays live in
+} rxcore_cull_bounds_t;
+
+/// @brief The state of one chunk of a parallel cull
+typedef struct rxcore_cull_job_t
+{
+    rxcore_frustum_t *frustum;
+    rxcore_cull_bounds_t *bounds;
+    uint32_t *visible_out;
+    uint32_t chunk_size;
+    uint32_t chunk_counts[RXCORE_JOBS_MAX_WORKERS + 1];
+} rxcore_cull_job_t;
+
+rxcore_cull_bounds_t *rxcore_cull_bounds_create(uint32_t capacity);
+void rxcore_cull_bounds_reserve(rxcore_cull_bounds_t *bounds, uint32_t capacity);
+void rxcore_cull_bounds_clear(rxcore_cull_bounds_t *bounds);
+void rxcore_cull_bounds_push(rxcore_cull_bounds_t *bounds, rxcore_bounding_box_t *box);
+void rxcore_cull_bounds_set(rxcore_cull_bounds_t *bounds, uint32_t index, rxcore_bounding_box_t *box);
+void rxcore_cull_bounds_destroy(rxcore_cull_bounds_t *bounds);
+
+/// @brief Tests the bounds in [start, end) against the frustum, with the widest instructions that were compiled in
+/// @param visible_out Receives the indices of the bounds that may be visible, in increasing order. Needs room for end - start
+/// @return The number of indices written
+uint32_t rxcore_cull_frustum(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out);
+
+/// @brief The same as rxcore_cull_frustum over every bound, spread across the job system when there are enough of them
+/// @param jobs May be NULL, in which case everything runs on the calling thread
+uint32_t rxcore_cull_frustum_parallel(rxcore_jobs_t *jobs, rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t *visible_out);
+
+/// @brief The name of the instruction set rxcore_cull_frustum uses, for reports
+const char *rxcore_cull_get_implementation_name();
+
+// private methods
+uint32_t _rxcore_cull_frustum_scalar(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out);
+#ifdef RXCORE_CULL_SSE
+uint32_t _rxcore_cull_frustum_sse(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out);
+#endif
+#ifdef RXCORE_CULL_AVX2
+uint32_t _rxcore_cull_frustum_avx2(rxcore_frustum_t *frustum, rxcore_cull_bounds_t *bounds, uint32_t start, uint32_t end, uint32_t *visible_out);
+#endif
+void _rxcore_cull_job(void *data, uint32_t start, uint32_t end, uint32_t worker);
+
+#endif // __CULL_H__
@@ -0,0 +1,94 @@
+// frustum.c
+
+#include <rxcore/frustum.h>
+
+rxcore_frustum_t rxcore_frustum_from_matrix(gs_mat4 view_projection)
+{
+    // gs matrices are column major, so row i is elements i, i + 4, i + 8, i + 12
+    float *m = view_projection.elements;
+    gs_vec4 row_x = gs_v4(m[0], m[4], m[8], m[12]);
+    gs_vec4 row_y = gs_v4(m[1], m[5], m[9], m[13]);
+    gs_vec4 row_z = gs_v4(m[2], m[6], m[10], m[14]);
+    gs_vec4 row_w = gs_v4(m[3], m[7], m[11], m[15]);
+
+    // a point is inside when -w <= x, y, z <= w in clip space, each side of that is a plane
+    rxcore_frustum_t frustum = {0};
+    frustum.planes[RXCORE_FRUSTUM_PLANE_LEFT] = _rxcore_plane_normalize(gs_vec4_add(row_w, row_x));
+    frustum.planes[RXCORE_FRUSTUM_PLANE_RIGHT] = _rxcore_plane_normalize(gs_vec4_sub(row_w, row_x));
+    frustum.planes[RXCORE_FRUSTUM_PLANE_BOTTOM] = _rxcore_plane_normalize(gs_vec4_add(row_w, row_y));
+    frustum.planes[RXCORE_FRUSTUM_PLANE_TOP] = _rxcore_plane_normalize(gs_vec4_sub(row_w, row_y));
+    frustum.planes[RXCORE_FRUSTUM_PLANE_NEAR] = _rxcore_plane_normalize(gs_vec4_add(row_w, row_z));
+    frustum.planes[RXCORE_FRUSTUM_PLANE_FAR] = _rxcore_plane_normalize(gs_vec4_sub(row_w, row_z));
+    return frustum;
+}
+
+float rxcore_plane_distance(rxcore_plane_t *plane, gs_vec3 point)
+{
+    return gs_vec3_dot(plane->normal, point) + plane->d;
+}
+
+bool rxcore_frustum_test_sphere(rxcore_frustum_t *frustum, gs_vec3 center, float radius)
+{
+    for (uint32_t i = 0; i < RXCORE_FRUSTUM_PLANE_COUNT; i++)
+    {
+        if (rxcore_plane_distance(&frustum->planes[i], center) < -radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool rxcore_frustum_test_aabb(rxcore_frustum_t *frustum, rxcore_bounding_box_t *box)
+{
+    gs_vec3 center = rxcore_bounding_box_get_center(box);
+    gs_vec3 extents = rxcore_bounding_box_get_extents(box);
+
+    for (uint32_t i = 0; i < RXCORE_FRUSTUM_PLANE_COUNT; i++)
+    {
+        // how far the box reaches towards the plane, measured along its normal
+        rxcore_plane_t *plane = &frustum->planes[i];
+        float reach = extents.x * fabsf(plane->normal.x) + extents.y * fabsf(plane->normal.y) + extents.z * fabsf(plane->normal.z);
+        if (rxcore_plane_distance(plane, center) < -reach)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+rxcore_frustum_result_t rxcore_frustum_classify_aabb(rxcore_frustum_t *frustum, rxcore_bounding_box_t *box)
+{
+    gs_vec3 center = rxcore_bounding_box_get_center(box);
+    gs_vec3 extents = rxcore_bounding_box_get_extents(box);
+    rxcore_frustum_result_t result = RXCORE_FRUSTUM_INSIDE;
+
+    for (uint32_t i = 0; i < RXCORE_FRUSTUM_PLANE_COUNT; i++)
+    {
+        rxcore_plane_t *plane = &frustum->planes[i];
+        float reach = extents.x * fabsf(plane->normal.x) + extents.y * fabsf(plane->normal.y) + extents.z * fabsf(plane->normal.z);
+        float distance = rxcore_plane_distance(plane, center);
+        if (distance < -reach)
+        {
+            return RXCORE_FRUSTUM_OUTSIDE;
+        }
+
+        // straddling this plane, but it may still be outside of another one
+        if (distance < reach)
+        {
+            result = RXCORE_FRUSTUM_INTERSECTS;
+        }
+    }
+
+    return result;
+}
+
+rxcore_plane_t _rxcore_plane_normalize(gs_vec4 plane)
+{
+    gs_vec3 normal = gs_v3(plane.x, plane.y, plane.z);
+    float len = gs_vec3_len(normal);
+    float inv_len = len > 0.f ? 1.f / len : 0.f;
+    return (rxcore_plane_t){.normal = gs_vec3_scale(normal, inv_len), .d = plane.w * inv_len};
+}
@@ -0,0 +1,56 @@
+#ifndef __FRUSTUM_H__
+#define __FRUSTUM_H__
+
+#include <gs/gs.h>
+#include <stdbool.h>
+#include <rxcore/bounding_box.h>
+
+typedef enum rxcore_frustum_plane_t
+{
+    RXCORE_FRUSTUM_PLANE_LEFT,
+    RXCORE_FRUSTUM_PLANE_RIGHT,
+    RXCORE_FRUSTUM_PLANE_BOTTOM,
+    RXCORE_FRUSTUM_PLANE_TOP,
+    RXCORE_FRUSTUM_PLANE_NEAR,
+    RXCORE_FRUSTUM_PLANE_FAR,
+    RXCORE_FRUSTUM_PLANE_COUNT
+} rxcore_frustum_plane_t;
+
+/// @brief A plane where dot(normal, p) + d = 0, with the normal pointing into the frustum
+typedef struct rxcore_plane_t
+{
+    gs_vec3 normal;
+    float d;
+} rxcore_plane_t;
+
+typedef enum rxcore_frustum_result_t
+{
+    RXCORE_FRUSTUM_OUTSIDE,
+    RXCORE_FRUSTUM_INTERSECTS,
+    RXCORE_FRUSTUM_INSIDE
+} rxcore_frustum_result_t;
+
+typedef struct rxcore_frustum_t
+{
+    rxcore_plane_t planes[RXCORE_FRUSTUM_PLANE_COUNT];
+} rxcore_frustum_t;
+
+/// @brief Extracts the six planes of a view projection matrix, in the space the matrix transforms from
+rxcore_frustum_t rxcore_frustum_from_matrix(gs_mat4 view_projection);
+
+/// @brief Signed distance from the plane, positive on the inside
+float rxcore_plane_distance(rxcore_plane_t *plane, gs_vec3 point);
+
+/// @return true if any part of the sphere may be inside the frustum
+bool rxcore_frustum_test_sphere(rxcore_frustum_t *frustum, gs_vec3 center, float radius);
+
+/// @return true if any part of the box may be inside the frustum
+bool rxcore_frustum_test_aabb(rxcore_frustum_t *frustum, rxcore_bounding_box_t *box);
+
+/// @brief Like rxcore_frustum_test_aabb, but also tells when the box is entirely inside, so hierarchies can stop testing
+rxcore_frustum_result_t rxcore_frustum_classify_aabb(rxcore_frustum_t *frustum, rxcore_bounding_box_t *box);
+
+// private methods
+rxcore_plane_t _rxcore_plane_normalize(gs_vec4 plane);
+
+#endif // __FRUSTUM_H__
@@ -0,0 +1,169 @@
+// jobs.c
+
+#include <rxcore/jobs.h>
+#include <rxcore/profiler.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+rxcore_jobs_t *rxcore_jobs_create(uint32_t thread_count)
+{
+    rxcore_jobs_t *jobs = malloc(sizeof(rxcore_jobs_t));
+    memset(jobs, 0, sizeof(rxcore_jobs_t));
+    jobs->thread_count = gs_min(thread_count, RXCORE_JOBS_MAX_WORKERS);
+    pthread_mutex_init(&jobs->mutex, NULL);
+    pthread_cond_init(&jobs->work_cond, NULL);
+    pthread_cond_init(&jobs->done_cond, NULL);
+
+    for (uint32_t i = 0; i < jobs->thread_count; i++)
+    {
+        // the calling thread is worker 0
+        jobs->workers[i] = (rxcore_jobs_worker_t){.jobs = jobs, .index = i + 1};
+        if (pthread_create(&jobs->threads[i], NULL, _rxcore_jobs_worker_main, &jobs->workers[i]) != 0)
+        {
+            RXCORE_LOG_WARN("jobs", "Failed to start job worker %d, running with %d workers", i, i);
+            jobs->thread_count = i;
+            break;
+        }
+    }
+
+    RXCORE_JOBS_DEBUG_PRINTF("Started %d workers", jobs->thread_count);
+    return jobs;
+}
+
+uint32_t rxcore_jobs_hardware_threads()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return gs_max((uint32_t)info.dwNumberOfProcessors, 1);
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (uint32_t)count : 1;
+#endif
+}
+
+uint32_t rxcore_jobs_get_worker_count(rxcore_jobs_t *jobs)
+{
+    return jobs->thread_count + 1;
+}
+
+void rxcore_jobs_parallel_for(rxcore_jobs_t *jobs, uint32_t count, uint32_t chunk_size, rxcore_job_fn fn, void *data)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    chunk_size = gs_max(chunk_size, 1);
+    uint32_t chunk_count = (count + chunk_size - 1) / chunk_size;
+
+    // not worth waking anyone up
+    if (jobs->thread_count == 0 || chunk_count == 1)
+    {
+        fn(data, 0, count, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&jobs->mutex);
+    jobs->fn = fn;
+    jobs->data = data;
+    jobs->count = count;
+    jobs->chunk_size = chunk_size;
+    jobs->next_chunk = 0;
+    jobs->chunk_count = chunk_count;
+    jobs->chunks_remaining = chunk_count;
+    jobs->generation++;
+    pthread_cond_broadcast(&jobs->work_cond);
+    pthread_mutex_unlock(&jobs->mutex);
+
+    while (_rxcore_jobs_run_chunk(jobs, 0))
+        ;
+
+    // the last chunks may still be running on the workers
+    pthread_mutex_lock(&jobs->mutex);
+    while (jobs->chunks_remaining > 0)
+    {
+        pthread_cond_wait(&jobs->done_cond, &jobs->mutex);
+    }
+    jobs->fn = NULL;
+    pthread_mutex_unlock(&jobs->mutex);
+}
+
+void rxcore_jobs_destroy(rxcore_jobs_t *jobs)
+{
+    pthread_mutex_lock(&jobs->mutex);
+    jobs->shutdown = true;
+    pthread_cond_broadcast(&jobs->work_cond);
+    pthread_mutex_unlock(&jobs->mutex);
+
+    for (uint32_t i = 0; i < jobs->thread_count; i++)
+    {
+        pthread_join(jobs->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&jobs->work_cond);
+    pthread_cond_destroy(&jobs->done_cond);
+    pthread_mutex_destroy(&jobs->mutex);
+    free(jobs);
+}
+
+void *_rxcore_jobs_worker_main(void *arg)
+{
+    rxcore_jobs_worker_t *worker = arg;
+    rxcore_jobs_t *jobs = worker->jobs;
+    uint32_t seen_generation = 0;
+
+    while (true)
+    {
+        pthread_mutex_lock(&jobs->mutex);
+        while (!jobs->shutdown && jobs->generation == seen_generation)
+        {
+            pthread_cond_wait(&jobs->work_cond, &jobs->mutex);
+        }
+
+        if (jobs->shutdown)
+        {
+            pthread_mutex_unlock(&jobs->mutex);
+            break;
+        }
+
+        seen_generation = jobs->generation;
+        pthread_mutex_unlock(&jobs->mutex);
+
+        while (_rxcore_jobs_run_chunk(jobs, worker->index))
+            ;
+    }
+
+    return NULL;
+}
+
+bool _rxcore_jobs_run_chunk(rxcore_jobs_t *jobs, uint32_t worker)
+{
+    pthread_mutex_lock(&jobs->mutex);
+    if (jobs->fn == NULL || jobs->next_chunk >= jobs->chunk_count)
+    {
+        pthread_mutex_unlock(&jobs->mutex);
+        return false;
+    }
+
+    uint32_t chunk = jobs->next_chunk++;
+    rxcore_job_fn fn = jobs->fn;
+    void *data = jobs->data;
+    uint32_t start = chunk * jobs->chunk_size;
+    uint32_t end = gs_min(start + jobs->chunk_size, jobs->count);
+    pthread_mutex_unlock(&jobs->mutex);
+
+    fn(data, start, end, worker);
+
+    pthread_mutex_lock(&jobs->mutex);
+    if (--jobs->chunks_remaining == 0)
+    {
+        pthread_cond_signal(&jobs->done_cond);
+    }
+    pthread_mutex_unlock(&jobs->mutex);
+    return true;
+}
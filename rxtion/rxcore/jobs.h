@@ -0,0 +1,77 @@
+#ifndef __JOBS_H__
+#define __JOBS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <gs/gs.h>
+#include <rxcore/log.h>
+
+// #define RXCORE_JOBS_DEBUG
+
+#ifdef RXCORE_JOBS_DEBUG
+#define RXCORE_JOBS_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("jobs", str)
+#define RXCORE_JOBS_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("jobs", str, __VA_ARGS__)
+#else
+#define RXCORE_JOBS_DEBUG_PRINT(...) ((void)0)
+#define RXCORE_JOBS_DEBUG_PRINTF(...) ((void)0)
+#endif
+
+#define RXCORE_JOBS_MAX_WORKERS 16
+
+/// @brief Processes the items [start, end) of a parallel for
+/// @param worker The index of the thread running the chunk, 0 is always the calling thread
+typedef void (*rxcore_job_fn)(void *data, uint32_t start, uint32_t end, uint32_t worker);
+
+typedef struct rxcore_jobs_t rxcore_jobs_t;
+
+typedef struct rxcore_jobs_worker_t
+{
+    rxcore_jobs_t *jobs;
+    uint32_t index;
+} rxcore_jobs_worker_t;
+
+/// @brief A fixed pool of worker threads that run one parallel for at a time.
+/// Jobs must not allocate through the profiler, as it isn't thread safe
+typedef struct rxcore_jobs_t
+{
+    pthread_t threads[RXCORE_JOBS_MAX_WORKERS];
+    rxcore_jobs_worker_t workers[RXCORE_JOBS_MAX_WORKERS];
+    uint32_t thread_count;
+    pthread_mutex_t mutex;
+    pthread_cond_t work_cond; // signalled when a new job is posted, or on shutdown
+    pthread_cond_t done_cond; // signalled when the last chunk of a job finishes
+    bool shutdown;
+
+    // the job currently running, guarded by the mutex
+    rxcore_job_fn fn;
+    void *data;
+    uint32_t count;
+    uint32_t chunk_size;
+    uint32_t next_chunk;
+    uint32_t chunk_count;
+    uint32_t chunks_remaining;
+    uint32_t generation; // bumped for every job, so sleeping workers know there is something new
+} rxcore_jobs_t;
+
+/// @brief Starts a pool of worker threads, allocated on the heap
+/// @param thread_count The number of workers, not counting the calling thread. 0 runs everything inline
+rxcore_jobs_t *rxcore_jobs_create(uint32_t thread_count);
+
+/// @brief The number of threads the machine can run at once, at least 1
+uint32_t rxcore_jobs_hardware_threads();
+
+/// @brief The number of threads a parallel for is spread over, including the calling thread
+uint32_t rxcore_jobs_get_worker_count(rxcore_jobs_t *jobs);
+
+/// @brief Splits [0, count) into chunks and runs them across the pool, blocking until all of them are done.
+/// The calling thread works on chunks too, and chunks are not run in any particular order
+void rxcore_jobs_parallel_for(rxcore_jobs_t *jobs, uint32_t count, uint32_t chunk_size, rxcore_job_fn fn, void *data);
+
+void rxcore_jobs_destroy(rxcore_jobs_t *jobs);
+
+// private methods
+void *_rxcore_jobs_worker_main(void *arg);
+bool _rxcore_jobs_run_chunk(rxcore_jobs_t *jobs, uint32_t worker);
+
+#endif // __JOBS_H__
@@ -0,0 +1,57 @@
+// log.c
+
+#include <rxcore/log.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+void rxcore_log_write(uint32_t level, const char *channel, const char *fmt, ...)
+{
+    // build the whole line first, so lines from different threads don't interleave
+    char line[1024];
+    int len = snprintf(line, sizeof(line), "[%s] RXCORE::%s::", _rxcore_log_level_name(level), channel);
+    if (len < 0 || len >= (int)sizeof(line))
+    {
+        len = 0;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(line + len, sizeof(line) - len, fmt, args);
+    va_end(args);
+
+    FILE *stream = level >= RXCORE_LOG_LEVEL_WARN ? stderr : stdout;
+    fprintf(stream, "%s\n", line);
+}
+
+bool rxcore_log_limiter_allow(rxcore_log_limiter_t *limiter, double interval)
+{
+    // gs reports elapsed time in milliseconds
+    double now = gs_platform_elapsed_time() / 1000.0;
+    if (now - limiter->last_time < interval)
+    {
+        limiter->suppressed++;
+        return false;
+    }
+
+    limiter->last_time = now;
+    return true;
+}
+
+const char *_rxcore_log_level_name(uint32_t level)
+{
+    switch (level)
+    {
+    case RXCORE_LOG_LEVEL_TRACE:
+        return "TRACE";
+    case RXCORE_LOG_LEVEL_DEBUG:
+        return "DEBUG";
+    case RXCORE_LOG_LEVEL_INFO:
+        return "INFO";
+    case RXCORE_LOG_LEVEL_WARN:
+        return "WARN";
+    case RXCORE_LOG_LEVEL_ERROR:
+        return "ERROR";
+    default:
+        return "?";
+    }
+}
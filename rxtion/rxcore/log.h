@@ -0,0 +1,104 @@
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <gs/gs.h>
+
+/**
+ * Example Usage
+ * RXCORE_LOG_INFO("rendering::shader", "Compiled %s", name);
+ * RXCORE_LOG_TRACE_HOT("rendering::pipeline", 1.0, "Drawing item %d", i); // at most once a second
+ *
+ * Anything below RXCORE_LOG_LEVEL is removed by the preprocessor, arguments and all,
+ * so release builds can pass -DRXCORE_LOG_LEVEL=RXCORE_LOG_LEVEL_WARN (or _NONE) to pay nothing
+ */
+
+#define RXCORE_LOG_LEVEL_TRACE 0
+#define RXCORE_LOG_LEVEL_DEBUG 1
+#define RXCORE_LOG_LEVEL_INFO 2
+#define RXCORE_LOG_LEVEL_WARN 3
+#define RXCORE_LOG_LEVEL_ERROR 4
+#define RXCORE_LOG_LEVEL_NONE 5
+
+// per module debug output (RXCORE_MESH_DEBUG and friends) is logged at the debug level
+#ifndef RXCORE_LOG_LEVEL
+#define RXCORE_LOG_LEVEL RXCORE_LOG_LEVEL_DEBUG
+#endif
+
+// usable in #if, for blocks of logging that are more than a single call
+#define RXCORE_LOG_ENABLED(level) ((level) >= RXCORE_LOG_LEVEL)
+
+/// @brief Per call site state of a rate limited log, lives in a static so that it costs nothing to set up
+typedef struct rxcore_log_limiter_t
+{
+    double last_time;
+    uint32_t suppressed;
+} rxcore_log_limiter_t;
+
+void rxcore_log_write(uint32_t level, const char *channel, const char *fmt, ...);
+
+/// @brief Checks if a rate limited log may be written, counting the ones that are dropped.
+/// Not thread safe, a race only ever loses a count or lets an extra line through
+bool rxcore_log_limiter_allow(rxcore_log_limiter_t *limiter, double interval);
+
+// private methods
+const char *_rxcore_log_level_name(uint32_t level);
+
+#define _RXCORE_LOG(level, channel, fmt, ...) rxcore_log_write(level, channel, fmt, ##__VA_ARGS__)
+
+#define _RXCORE_LOG_HOT(level, channel, interval, fmt, ...)                          \
+    do                                                                               \
+    {                                                                                \
+        static rxcore_log_limiter_t _rxcore_log_limiter = {.last_time = -1e9};       \
+        if (rxcore_log_limiter_allow(&_rxcore_log_limiter, interval))                \
+        {                                                                            \
+            rxcore_log_write(level, channel, fmt, ##__VA_ARGS__);                    \
+            if (_rxcore_log_limiter.suppressed > 0)                                  \
+            {                                                                        \
+                rxcore_log_write(level, channel, "(%u similar messages suppressed)", \
+                                 _rxcore_log_limiter.suppressed);                    \
+                _rxcore_log_limiter.suppressed = 0;                                  \
+            }                                                                        \
+        }                                                                            \
+    } while (0)
+
+#if RXCORE_LOG_ENABLED(RXCORE_LOG_LEVEL_TRACE)
+#define RXCORE_LOG_TRACE(channel, fmt, ...) _RXCORE_LOG(RXCORE_LOG_LEVEL_TRACE, channel, fmt, ##__VA_ARGS__)
+#define RXCORE_LOG_TRACE_HOT(channel, interval, fmt, ...) _RXCORE_LOG_HOT(RXCORE_LOG_LEVEL_TRACE, channel, interval, fmt, ##__VA_ARGS__)
+#else
+#define RXCORE_LOG_TRACE(...) ((void)0)
+#define RXCORE_LOG_TRACE_HOT(...) ((void)0)
+#endif
+
+#if RXCORE_LOG_ENABLED(RXCORE_LOG_LEVEL_DEBUG)
+#define RXCORE_LOG_DEBUG(channel, fmt, ...) _RXCORE_LOG(RXCORE_LOG_LEVEL_DEBUG, channel, fmt, ##__VA_ARGS__)
+#define RXCORE_LOG_DEBUG_HOT(channel, interval, fmt, ...) _RXCORE_LOG_HOT(RXCORE_LOG_LEVEL_DEBUG, channel, interval, fmt, ##__VA_ARGS__)
+#else
+#define RXCORE_LOG_DEBUG(...) ((void)0)
+#define RXCORE_LOG_DEBUG_HOT(...) ((void)0)
+#endif
+
+#if RXCORE_LOG_ENABLED(RXCORE_LOG_LEVEL_INFO)
+#define RXCORE_LOG_INFO(channel, fmt, ...) _RXCORE_LOG(RXCORE_LOG_LEVEL_INFO, channel, fmt, ##__VA_ARGS__)
+#define RXCORE_LOG_INFO_HOT(channel, interval, fmt, ...) _RXCORE_LOG_HOT(RXCORE_LOG_LEVEL_INFO, channel, interval, fmt, ##__VA_ARGS__)
+#else
+#define RXCORE_LOG_INFO(...) ((void)0)
+#define RXCORE_LOG_INFO_HOT(...) ((void)0)
+#endif
+
+#if RXCORE_LOG_ENABLED(RXCORE_LOG_LEVEL_WARN)
+#define RXCORE_LOG_WARN(channel, fmt, ...) _RXCORE_LOG(RXCORE_LOG_LEVEL_WARN, channel, fmt, ##__VA_ARGS__)
+#define RXCORE_LOG_WARN_HOT(channel, interval, fmt, ...) _RXCORE_LOG_HOT(RXCORE_LOG_LEVEL_WARN, channel, interval, fmt, ##__VA_ARGS__)
+#else
+#define RXCORE_LOG_WARN(...) ((void)0)
+#define RXCORE_LOG_WARN_HOT(...) ((void)0)
+#endif
+
+#if RXCORE_LOG_ENABLED(RXCORE_LOG_LEVEL_ERROR)
+#define RXCORE_LOG_ERROR(channel, fmt, ...) _RXCORE_LOG(RXCORE_LOG_LEVEL_ERROR, channel, fmt, ##__VA_ARGS__)
+#else
+#define RXCORE_LOG_ERROR(...) ((void)0)
+#endif
+
+#endif // __LOG_H__
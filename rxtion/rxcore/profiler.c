@@ -6,6 +6,7 @@
 #include <string.h>
 #include <time.h>
 #include <gs/gs.h>
+#include <rxcore/log.h>
 
 // undefine malloc and free redefined in rxcore_profiler.h
 // this is to use the system malloc and free functions
@@ -105,6 +106,7 @@ rxcore_profiler_t rxcore_profiler_create()
     profiler.completed_tasks = gs_dyn_array_new(rxcore_profiling_task_t *);
     profiler.stack = gs_dyn_array_new(rxcore_profiling_task_t *);
     profiler.stack_index = 0;
+    profiler.counters = gs_dyn_array_new(rxcore_profiling_counter_t);
     profiler.settings = (rxcore_profiler_settings_t){
         .allow_panic = false,
         .panic_on_memory_leak = false,
@@ -134,7 +136,7 @@ void rxcore_profiler_begin_task(rxcore_profiler_t *profiler, const char *name)
     rxcore_profiling_task_t *task = rxcore_profiling_task_create(name);
     if (rxcore_profiler_any_tasks(profiler))
     {
-        gs_println("Starting task: %s, child of %s", task->name, profiler->stack_index > 1 ? profiler->stack[profiler->stack_index - 2]->name : "root");
+        RXCORE_LOG_TRACE("profiler", "Starting task: %s, child of %s", task->name, profiler->stack_index > 1 ? profiler->stack[profiler->stack_index - 2]->name : "root");
         rxcore_profiling_task_t *parent = profiler->stack[profiler->stack_index - 1];
         gs_dyn_array_push(parent->children, task);
     }
@@ -214,9 +216,47 @@ void rxcore_profiler_report(rxcore_profiler_t *profiler)
         rxcore_profiling_task_traverse(task, rxcore_profiling_task_traversal_print, 0, printf);
     }
 
+    if (gs_dyn_array_size(profiler->counters) > 0)
+    {
+        printf("\n*** Counters ***\n");
+    }
+
+    for (int i = 0; i < gs_dyn_array_size(profiler->counters); ++i)
+    {
+        printf("%s: %llu\n", profiler->counters[i].name, (unsigned long long)profiler->counters[i].value);
+    }
+
     printf("\n");
 }
 
+rxcore_profiling_counter_t *rxcore_profiler_get_counter(rxcore_profiler_t *profiler, const char *name)
+{
+    for (int i = 0; i < gs_dyn_array_size(profiler->counters); ++i)
+    {
+        rxcore_profiling_counter_t *counter = &profiler->counters[i];
+        if (strcmp(counter->name, name) == 0)
+        {
+            return counter;
+        }
+    }
+
+    rxcore_profiling_counter_t counter = {0};
+    counter.name = strdup(name);
+    counter.value = 0;
+    gs_dyn_array_push(profiler->counters, counter);
+    return &profiler->counters[gs_dyn_array_size(profiler->counters) - 1];
+}
+
+void rxcore_profiler_counter_add(rxcore_profiler_t *profiler, const char *name, uint64_t amount)
+{
+    rxcore_profiler_get_counter(profiler, name)->value += amount;
+}
+
+void rxcore_profiler_counter_set(rxcore_profiler_t *profiler, const char *name, uint64_t value)
+{
+    rxcore_profiler_get_counter(profiler, name)->value = value;
+}
+
 void rxcore_profiler_destroy(rxcore_profiler_t *profiler)
 {
     for (int i = 0; i < gs_dyn_array_size(profiler->completed_tasks); ++i)
@@ -225,6 +265,12 @@ void rxcore_profiler_destroy(rxcore_profiler_t *profiler)
     }
     gs_dyn_array_free(profiler->completed_tasks);
     gs_dyn_array_free(profiler->stack);
+
+    for (int i = 0; i < gs_dyn_array_size(profiler->counters); ++i)
+    {
+        free((void *)profiler->counters[i].name);
+    }
+    gs_dyn_array_free(profiler->counters);
 }
 
 void *rxcore_profiler_malloc(size_t size)
@@ -284,7 +330,7 @@ void rxcore_profiler_free(void *ptr)
         return;
     }
 
-    gs_println("Freeing %d bytes", size);
+    RXCORE_LOG_TRACE_HOT("profiler", 1.0, "Freeing %d bytes", size);
     if (rxcore_profiler_any_tasks(&g_profiler))
     {
         rxcore_profiling_task_t *current_task = rxcore_profiler_get_current_task(&g_profiler);
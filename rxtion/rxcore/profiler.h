@@ -45,11 +45,18 @@ typedef struct rxcore_profiling_task_t
     gs_dyn_array(rxcore_profiling_task_t *) children;
 } rxcore_profiling_task_t;
 
+typedef struct rxcore_profiling_counter_t
+{
+    const char *name;
+    uint64_t value;
+} rxcore_profiling_counter_t;
+
 typedef struct rxcore_profiler_t
 {
     gs_dyn_array(rxcore_profiling_task_t *) completed_tasks;
     gs_dyn_array(rxcore_profiling_task_t *) stack;
     uint32_t stack_index;
+    gs_dyn_array(rxcore_profiling_counter_t) counters;
     rxcore_profiler_settings_t settings;
 } rxcore_profiler_t;
 
@@ -87,6 +94,9 @@ void rxcore_profiler_end_task(rxcore_profiler_t *profiler);
 bool rxcore_profiler_any_tasks(rxcore_profiler_t *profiler);
 bool rxcore_profiler_any_unfreed_memory(rxcore_profiler_t *profiler);
 void rxcore_profiler_report(rxcore_profiler_t *profiler);
+rxcore_profiling_counter_t *rxcore_profiler_get_counter(rxcore_profiler_t *profiler, const char *name);
+void rxcore_profiler_counter_add(rxcore_profiler_t *profiler, const char *name, uint64_t amount);
+void rxcore_profiler_counter_set(rxcore_profiler_t *profiler, const char *name, uint64_t value);
 void rxcore_profiler_destroy(rxcore_profiler_t *profiler);
 
 void *rxcore_profiler_malloc(size_t size);
@@ -102,6 +112,8 @@ char* rxcore_profiler_corrupted_heap_msg(rxcore_profiler_heap_header_t *header,
 #define RXCORE_PROFILER_END_TASK() rxcore_profiler_end_task(&g_profiler)
 #define RXCORE_PROFILER_ANY_UNFREED_MEMORY() rxcore_profiler_any_unfreed_memory(&g_profiler)
 #define RXCORE_PROFILER_REPORT() rxcore_profiler_report(&g_profiler)
+#define RXCORE_PROFILER_COUNTER_ADD(name, amount) rxcore_profiler_counter_add(&g_profiler, name, amount)
+#define RXCORE_PROFILER_COUNTER_SET(name, value) rxcore_profiler_counter_set(&g_profiler, name, value)
 #define RXCORE_PROFILER_CLEAR()                \
     do                                         \
     {                                          \
@@ -114,6 +126,8 @@ char* rxcore_profiler_corrupted_heap_msg(rxcore_profiler_heap_header_t *header,
 #define RXCORE_PROFILER_BEGIN_TASK(name) ((void)0)
 #define RXCORE_PROFILER_END_TASK(name) ((void)0)
 #define RXCORE_PROFILER_REPORT() ((void)0)
+#define RXCORE_PROFILER_COUNTER_ADD(name, amount) ((void)0)
+#define RXCORE_PROFILER_COUNTER_SET(name, value) ((void)0)
 #define RXCORE_PROFILER_CLEAR() ((void)0)
 #define RXCORE_PROFILER_PANIC(msg) ((void)0)
 #endif
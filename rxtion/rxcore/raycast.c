@@ -0,0 +1,81 @@
+// raycast.c
+
+#include <rxcore/raycast.h>
+
+rxcore_ray_t rxcore_ray_transform(rxcore_ray_t *ray, gs_mat4 matrix)
+{
+    // the direction is a vector, so it isn't moved by the translation
+    gs_vec4 origin = gs_mat4_mul_vec4(matrix, gs_v4(ray->origin.x, ray->origin.y, ray->origin.z, 1.f));
+    gs_vec4 direction = gs_mat4_mul_vec4(matrix, gs_v4(ray->direction.x, ray->direction.y, ray->direction.z, 0.f));
+    return rxcore_ray_create(gs_v3(origin.x, origin.y, origin.z), gs_v3(direction.x, direction.y, direction.z));
+}
+
+bool rxcore_raycast_triangle(rxcore_ray_t *ray, gs_vec3 a, gs_vec3 b, gs_vec3 c, float max_distance, float *distance_out, gs_vec2 *barycentric_out)
+{
+    gs_vec3 edge_ab = gs_vec3_sub(b, a);
+    gs_vec3 edge_ac = gs_vec3_sub(c, a);
+
+    // the determinant is near zero when the ray runs along the plane of the triangle
+    gs_vec3 p = gs_vec3_cross(ray->direction, edge_ac);
+    float determinant = gs_vec3_dot(edge_ab, p);
+    if (fabsf(determinant) < RXCORE_RAYCAST_EPSILON)
+    {
+        return false;
+    }
+    float inv_determinant = 1.f / determinant;
+
+    gs_vec3 to_origin = gs_vec3_sub(ray->origin, a);
+    float u = gs_vec3_dot(to_origin, p) * inv_determinant;
+    if (u < 0.f || u > 1.f)
+    {
+        return false;
+    }
+
+    gs_vec3 q = gs_vec3_cross(to_origin, edge_ab);
+    float v = gs_vec3_dot(ray->direction, q) * inv_determinant;
+    if (v < 0.f || u + v > 1.f)
+    {
+        return false;
+    }
+
+    float distance = gs_vec3_dot(edge_ac, q) * inv_determinant;
+    if (distance < 0.f || distance >= max_distance)
+    {
+        return false;
+    }
+
+    if (distance_out != NULL)
+    {
+        *distance_out = distance;
+    }
+    if (barycentric_out != NULL)
+    {
+        *barycentric_out = gs_v2(u, v);
+    }
+    return true;
+}
+
+bool rxcore_raycast_triangles(rxcore_ray_t *ray, gs_vec3 *positions, uint32_t stride, uint32_t *indices, uint32_t index_count, float max_distance, rxcore_raycast_hit_t *hit_out)
+{
+    const uint8_t *base = (const uint8_t *)positions;
+    bool hit = false;
+    for (uint32_t i = 0; i + 2 < index_count; i += 3)
+    {
+        gs_vec3 a = *(const gs_vec3 *)(base + (size_t)indices[i] * stride);
+        gs_vec3 b = *(const gs_vec3 *)(base + (size_t)indices[i + 1] * stride);
+        gs_vec3 c = *(const gs_vec3 *)(base + (size_t)indices[i + 2] * stride);
+
+        // every hit shortens the ray, so later triangles only count if they are nearer
+        float distance = 0.f;
+        gs_vec2 barycentric = {0};
+        if (rxcore_raycast_triangle(ray, a, b, c, max_distance, &distance, &barycentric))
+        {
+            max_distance = distance;
+            hit_out->distance = distance;
+            hit_out->triangle = i / 3;
+            hit_out->barycentric = barycentric;
+            hit = true;
+        }
+    }
+    return hit;
+}
@@ -0,0 +1,43 @@
+#ifndef __RAYCAST_H__
+#define __RAYCAST_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rxcore/bounding_box.h>
+
+/**
+ * Example Usage
+ * rxcore_ray_t local = rxcore_ray_transform(&ray, gs_mat4_inverse(world_matrix));
+ * rxcore_raycast_hit_t hit = {0};
+ * if (rxcore_raycast_triangles(&local, &vertices->position, sizeof(rxcore_vertex_t), indices, index_count, max_distance, &hit))
+ *     select(rxcore_ray_get_point(&ray, hit.distance));
+ */
+
+// rays closer to parallel with a triangle than this miss it, rather than hitting it somewhere far off
+#define RXCORE_RAYCAST_EPSILON 1e-8f
+
+typedef struct rxcore_raycast_hit_t
+{
+    float distance;      // along the ray, in units of its direction
+    uint32_t triangle;   // the first index of the triangle is 3 * triangle
+    gs_vec2 barycentric; // the weights of the second and third vertex, the first gets 1 - x - y
+} rxcore_raycast_hit_t;
+
+/// @brief Transforms a ray by a matrix without normalizing its direction, so distances along both rays are the same
+rxcore_ray_t rxcore_ray_transform(rxcore_ray_t *ray, gs_mat4 matrix);
+
+/// @brief Moller-Trumbore test of the ray against a triangle, from either side
+/// @param distance_out May be NULL
+/// @param barycentric_out May be NULL
+/// @return true if the ray hits the triangle in front of its origin and before max_distance
+bool rxcore_raycast_triangle(rxcore_ray_t *ray, gs_vec3 a, gs_vec3 b, gs_vec3 c, float max_distance, float *distance_out, gs_vec2 *barycentric_out);
+
+/// @brief Finds the nearest of many indexed triangles the ray hits
+/// @param positions The first position, each following one stride bytes further on
+/// @param indices Offsets from positions, three per triangle
+/// @param hit_out Receives the nearest hit, untouched if there is none
+/// @return true if any triangle is hit before max_distance
+bool rxcore_raycast_triangles(rxcore_ray_t *ray, gs_vec3 *positions, uint32_t stride, uint32_t *indices, uint32_t index_count, float max_distance, rxcore_raycast_hit_t *hit_out);
+
+#endif // __RAYCAST_H__
@@ -36,19 +36,21 @@ void rxcore_rendering_init()
         g_rendering_context.scene_graph,
         rxcore_scene_node_create(
             rxcore_transform_empty(),
-            rxcore_mesh_registry_get_mesh(g_rendering_context.mesh_registry, "triangle"),
-            rxcore_material_registry_get_material(g_rendering_context.material_registry, "unlit")
+            rxcore_mesh_registry_get_mesh_by_id(g_rendering_context.mesh_registry, RXCORE_STRID("triangle")),
+            rxcore_material_registry_get_material_by_id(g_rendering_context.material_registry, RXCORE_STRID("unlit"))
         )
     );
     rxcore_scene_graph_add_child(
         g_rendering_context.scene_graph,
         rxcore_scene_node_create(
             rxcore_transform_create(gs_v3(0.f, 2.f, 5.f), gs_v3(1.f, 1.f, 1.f), gs_quat_default()),
-            rxcore_mesh_registry_get_mesh(g_rendering_context.mesh_registry, "quad"),
-            rxcore_material_registry_get_material(g_rendering_context.material_registry, "unlit")
+            rxcore_mesh_registry_get_mesh_by_id(g_rendering_context.mesh_registry, RXCORE_STRID("quad")),
+            rxcore_material_registry_get_material_by_id(g_rendering_context.material_registry, RXCORE_STRID("unlit"))
         )
     );
 
+    // inserting nodes one by one leaves a worse tree than building it from everything at once
+    rxcore_scene_graph_rebuild_bvh(g_rendering_context.scene_graph);
     RXCORE_PROFILER_END_TASK();
 
     RXCORE_PROFILER_BEGIN_TASK("camera_loading");
@@ -62,18 +64,24 @@ void rxcore_rendering_init()
         gs_vec3_ctor(0.f, 0.f, 5.0f),
         gs_quat_default()
     );
+    rxcore_rendering_context_add_camera(&g_rendering_context, g_rendering_context.camera);
 
     RXCORE_PROFILER_END_TASK();
     RXCORE_PROFILER_END_TASK();
 
     // print out the two meshes
-    rxcore_mesh_t quad = rxcore_mesh_registry_get_mesh(g_rendering_context.mesh_registry, "quad");
-    rxcore_mesh_t triangle = rxcore_mesh_registry_get_mesh(g_rendering_context.mesh_registry, "triangle");
+    rxcore_mesh_t quad = rxcore_mesh_registry_get_mesh_by_id(g_rendering_context.mesh_registry, RXCORE_STRID("quad"));
+    rxcore_mesh_t triangle = rxcore_mesh_registry_get_mesh_by_id(g_rendering_context.mesh_registry, RXCORE_STRID("triangle"));
 
     rxcore_mesh_print(&quad, printf, true);
     rxcore_mesh_print(&triangle, printf, true);
 
     g_rendering_context.pipeline = rxcore_pipeline_default(g_rendering_context.shader_registry);
+    if (g_rendering_context.pipeline == NULL)
+    {
+        RXCORE_LOG_ERROR("rendering", "No pipeline to render with, nothing will be drawn");
+        return;
+    }
     rxcore_pipeline_begin(&g_rendering_context);
 }
 
@@ -122,19 +130,34 @@ void rxcore_rendering_update()
         rot += 1.f;
     }
 
-    g_rendering_context.camera->rotation = gs_quat_mul(g_rendering_context.camera->rotation, 
-        gs_quat_angle_axis(rot * gs_platform_delta_time(), gs_v3(0.f, 1.f, 0.f))
-    );
+    // only touch the camera when it moves, so its matrices stay cached while it is still
+    if (rot != 0.f)
+    {
+        rxcore_camera_set_rotation(g_rendering_context.camera, gs_quat_mul(g_rendering_context.camera->rotation, 
+            gs_quat_angle_axis(rot * gs_platform_delta_time(), gs_v3(0.f, 1.f, 0.f))
+        ));
+    }
 
-    gs_mat4 rot_mat = gs_quat_to_mat4(g_rendering_context.camera->rotation);
-    gs_vec4 rot_mov = gs_mat4_mul_vec4(rot_mat, gs_v4_xyz_s(movement, 0.f));
-    movement = gs_vec3_ctor(rot_mov.x, rot_mov.y, rot_mov.z);
+    if (movement.x != 0.f || movement.y != 0.f || movement.z != 0.f)
+    {
+        gs_mat4 rot_mat = gs_quat_to_mat4(g_rendering_context.camera->rotation);
+        gs_vec4 rot_mov = gs_mat4_mul_vec4(rot_mat, gs_v4_xyz_s(movement, 0.f));
+        movement = gs_vec3_ctor(rot_mov.x, rot_mov.y, rot_mov.z);
 
-    g_rendering_context.camera->position = gs_vec3_add(g_rendering_context.camera->position, gs_vec3_scale(movement, 5.f * gs_platform_delta_time()));
+        rxcore_camera_set_position(g_rendering_context.camera, gs_vec3_add(g_rendering_context.camera->position, gs_vec3_scale(movement, 5.f * gs_platform_delta_time())));
+    }
     float fps = 1.f / gs_platform_delta_time();
     // gs_println("FPS: %f", fps);
 
-    rxcore_pipeline_render(&g_rendering_context);
+    // hand the finished tick over to rendering, the scene graph and camera are free to change after this
+    gs_vec2 fs = gs_platform_framebuffer_sizev(gs_platform_main_window());
+    rxcore_render_snapshots_extract(g_rendering_context.snapshots, g_rendering_context.scene_graph, g_rendering_context.cameras, gs_dyn_array_size(g_rendering_context.cameras), fs.x / fs.y);
+    rxcore_render_snapshots_publish(g_rendering_context.snapshots);
+
+    if (g_rendering_context.pipeline != NULL)
+    {
+        rxcore_pipeline_render(&g_rendering_context);
+    }
 }
 
 void rxcore_rendering_shutdown()
@@ -153,6 +176,12 @@ rxcore_rendering_context_t rxcore_rendering_context_create()
     *cb = gs_command_buffer_new();
     context.cb = cb;
     context.render_group = NULL;
+    context.cameras = gs_dyn_array_new(rxcore_camera_t *);
+    context.mesh_buffers = gs_dyn_array_new(rxcore_mesh_buffer_t *);
+    context.snapshots = rxcore_render_snapshots_create();
+    // the main thread is a worker too
+    context.jobs = rxcore_jobs_create(rxcore_jobs_hardware_threads() - 1);
+    context.scene_graph->jobs = context.jobs;
 
     return context;
 }
@@ -163,9 +192,24 @@ void rxcore_rendering_context_destroy(rxcore_rendering_context_t *context)
     rxcore_material_registry_destroy(context->material_registry);
     rxcore_mesh_registry_destroy(context->mesh_registry);
     rxcore_scene_graph_destroy(context->scene_graph);
+    rxcore_jobs_destroy(context->jobs);
+    rxcore_render_snapshots_destroy(context->snapshots);
+    gs_dyn_array_free(context->cameras);
+    gs_dyn_array_free(context->mesh_buffers);
     free(context);
 }
 
+uint32_t rxcore_rendering_context_add_camera(rxcore_rendering_context_t *context, rxcore_camera_t *camera)
+{
+    gs_dyn_array_push(context->cameras, camera);
+    return gs_dyn_array_size(context->cameras) - 1;
+}
+
+void rxcore_rendering_context_add_mesh_buffer(rxcore_rendering_context_t *context, rxcore_mesh_buffer_t *buffer)
+{
+    gs_dyn_array_push(context->mesh_buffers, buffer);
+}
+
 void _rxcore_rendering_load_core_shader_dependencies(rxcore_shader_registry_t *reg)
 {
     rxcore_shader_registry_add_dependency(reg, 
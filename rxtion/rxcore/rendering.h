@@ -10,6 +10,8 @@
 #include <rxcore/rendering/camera.h>
 #include <rxcore/rendering/render_group.h>
 #include <rxcore/rendering/pipeline.h>
+#include <rxcore/rendering/render_snapshot.h>
+#include <rxcore/jobs.h>
 
 #define CORE_ASSET(ASSET_NAME) "rxtion/rxcore/" ASSET_NAME
 #define APP_ASSET(ASSET_NAME) "rxtion/rxapp/assets/" ASSET_NAME
@@ -35,10 +37,14 @@ typedef struct rxcore_rendering_context_t
     rxcore_material_registry_t *material_registry;
     rxcore_mesh_registry_t *mesh_registry;
     rxcore_scene_graph_t *scene_graph;
-    rxcore_camera_t *camera;
+    rxcore_camera_t *camera;                  // the main camera, always cameras[0]
+    gs_dyn_array(rxcore_camera_t *) cameras;  // non-owning, every camera extracted into the snapshot, which views refer to by index
+    gs_dyn_array(rxcore_mesh_buffer_t *) mesh_buffers; // non-owning, streaming buffers uploaded before every frame is rendered
     gs_command_buffer_t *cb;
     rxcore_render_group_t *render_group;
     rxcore_pipeline_t *pipeline;
+    rxcore_jobs_t *jobs;
+    rxcore_render_snapshots_t *snapshots; // rendering only ever reads these, never the scene graph or camera
     // probably will add more stuff here later...
 } rxcore_rendering_context_t;
 
@@ -49,6 +55,14 @@ void rxcore_rendering_update();
 void rxcore_rendering_shutdown();
 
 rxcore_rendering_context_t rxcore_rendering_context_create();
+
+/// @brief Adds a camera to be extracted every tick, for views other than the main one to render from
+/// @return The index of the camera, for rxcore_render_view_desc_t
+uint32_t rxcore_rendering_context_add_camera(rxcore_rendering_context_t *context, rxcore_camera_t *camera);
+
+/// @brief Adds a streaming mesh buffer for the pipeline to upload on the main thread before every frame,
+/// which has to happen before its draws are recorded on the workers
+void rxcore_rendering_context_add_mesh_buffer(rxcore_rendering_context_t *context, rxcore_mesh_buffer_t *buffer);
 void rxcore_rendering_context_destroy(rxcore_rendering_context_t *context);
 
 // private methods for rendering
@@ -6,6 +6,9 @@
 rxcore_camera_t *_rxcore_camera_create_base()
 {
     rxcore_camera_t *camera = malloc(sizeof(rxcore_camera_t));
+    memset(camera, 0, sizeof(rxcore_camera_t));
+    camera->view_dirty = true;
+    camera->projection_dirty = true;
     camera->framebuffer = gs_graphics_framebuffer_create(NULL);
 
     // Create view and projection uniforms
@@ -45,57 +48,107 @@ rxcore_camera_t *rxcore_camera_create_orthographic(rxcore_camera_orthographic_de
     return camera;
 }
 
-gs_mat4 rxcore_camera_get_view_matrix(rxcore_camera_t *camera)
+void rxcore_camera_set_position(rxcore_camera_t *camera, gs_vec3 position)
 {
-    gs_mat4 m = gs_mat4_identity();
-    m = gs_mat4_mul(m, gs_quat_to_mat4(camera->rotation));
-    m = gs_mat4_mul(m, gs_mat4_translate(
-        -camera->position.x,
-        -camera->position.y,
-        -camera->position.z
-    ));
+    camera->position = position;
+    camera->view_dirty = true;
+}
 
-    return m;
+void rxcore_camera_set_rotation(rxcore_camera_t *camera, gs_quat rotation)
+{
+    camera->rotation = rotation;
+    camera->view_dirty = true;
 }
 
-gs_mat4 rxcore_camera_get_projection_matrix(rxcore_camera_t *camera)
+void rxcore_camera_set_perspective(rxcore_camera_t *camera, rxcore_camera_perspective_desc_t desc)
 {
-    switch (camera->projection_type)
+    camera->projection_type = RXCORE_CAMERA_PROJECTION_PERSPECTIVE;
+    camera->perspective_desc = desc;
+    camera->projection_dirty = true;
+}
+
+void rxcore_camera_set_orthographic(rxcore_camera_t *camera, rxcore_camera_orthographic_desc_t desc)
+{
+    camera->projection_type = RXCORE_CAMERA_PROJECTION_ORTHOGRAPHIC;
+    camera->orthographic_desc = desc;
+    camera->projection_dirty = true;
+}
+
+void rxcore_camera_set_aspect_ratio(rxcore_camera_t *camera, float aspect_ratio)
+{
+    if (camera->projection_type != RXCORE_CAMERA_PROJECTION_PERSPECTIVE || camera->perspective_desc.aspect_ratio == aspect_ratio)
     {
-    case RXCORE_CAMERA_PROJECTION_PERSPECTIVE:
-        return gs_mat4_perspective(camera->perspective_desc.fov, camera->perspective_desc.aspect_ratio, camera->perspective_desc.near_plane, camera->perspective_desc.far_plane);
-    case RXCORE_CAMERA_PROJECTION_ORTHOGRAPHIC:
-        return gs_mat4_ortho(camera->orthographic_desc.left, camera->orthographic_desc.right, camera->orthographic_desc.bottom, camera->orthographic_desc.top, camera->orthographic_desc.near_plane, camera->orthographic_desc.far_plane);
-    default:
-        return gs_mat4_identity();
+        return;
     }
+
+    camera->perspective_desc.aspect_ratio = aspect_ratio;
+    camera->projection_dirty = true;
+}
+
+gs_mat4 rxcore_camera_get_view_matrix(rxcore_camera_t *camera)
+{
+    _rxcore_camera_update(camera);
+    return camera->view_matrix;
+}
+
+gs_mat4 rxcore_camera_get_projection_matrix(rxcore_camera_t *camera)
+{
+    _rxcore_camera_update(camera);
+    return camera->projection_matrix;
 }
 
 gs_mat4 rxcore_camera_get_view_projection_matrix(rxcore_camera_t *camera)
 {
-    return gs_mat4_mul(rxcore_camera_get_projection_matrix(camera), rxcore_camera_get_view_matrix(camera));
+    _rxcore_camera_update(camera);
+    return camera->view_projection_matrix;
+}
+
+gs_mat4 rxcore_camera_get_inverse_view_projection_matrix(rxcore_camera_t *camera)
+{
+    _rxcore_camera_update(camera);
+    return camera->inverse_view_projection_matrix;
+}
+
+rxcore_frustum_t *rxcore_camera_get_frustum(rxcore_camera_t *camera)
+{
+    _rxcore_camera_update(camera);
+    return &camera->frustum;
+}
+
+rxcore_ray_t rxcore_camera_screen_to_ray(rxcore_camera_t *camera, gs_vec2 screen_position, gs_vec2 screen_size)
+{
+    _rxcore_camera_update(camera);
+
+    // normalized device coordinates have y going up, the screen has it going down
+    float x = screen_position.x / screen_size.x * 2.f - 1.f;
+    float y = 1.f - screen_position.y / screen_size.y * 2.f;
+
+    // unprojecting both ends works the same for perspective and orthographic cameras
+    gs_vec4 near = gs_mat4_mul_vec4(camera->inverse_view_projection_matrix, gs_v4(x, y, -1.f, 1.f));
+    gs_vec4 far = gs_mat4_mul_vec4(camera->inverse_view_projection_matrix, gs_v4(x, y, 1.f, 1.f));
+    gs_vec3 origin = gs_vec3_scale(gs_v3(near.x, near.y, near.z), 1.f / near.w);
+    gs_vec3 end = gs_vec3_scale(gs_v3(far.x, far.y, far.z), 1.f / far.w);
+    return rxcore_ray_create(origin, gs_vec3_norm(gs_vec3_sub(end, origin)));
 }
 
 bool rxcore_camera_frustum_cull(gs_mat4 view_projection, gs_vec3 position, float radius)
 {
-    gs_vec4 sphere = gs_vec4_ctor(position.x, position.y, position.z, radius);
-    gs_vec4 clip = gs_mat4_mul_vec4(view_projection, sphere);
-    return clip.x + clip.w < -1 || clip.x - clip.w > 1 || clip.y + clip.w < -1 || clip.y - clip.w > 1 || clip.z + clip.w < -1 || clip.z - clip.w > 1;
+    // a sphere can't be pushed through the projection, so test it against the planes of the frustum instead
+    rxcore_frustum_t frustum = rxcore_frustum_from_matrix(view_projection);
+    return !rxcore_frustum_test_sphere(&frustum, position, radius);
 }
 
 bool rxcore_camera_frustum_cull_aabb(gs_mat4 view_projection, gs_vec3 position, gs_vec3 scale)
 {
-    gs_vec4 clip = gs_mat4_mul_vec4(view_projection, gs_vec4_ctor(position.x, position.y, position.z, 1));
+    rxcore_frustum_t frustum = rxcore_frustum_from_matrix(view_projection);
     gs_vec3 extents = gs_vec3_scale(scale, 0.5f);
-    gs_vec3 min = gs_vec3_sub(position, extents);
-    gs_vec3 max = gs_vec3_add(position, extents);
-    return clip.x + clip.w < -1 || clip.x - clip.w > 1 || clip.y + clip.w < -1 || clip.y - clip.w > 1 || clip.z + clip.w < -1 || clip.z - clip.w > 1;
+    rxcore_bounding_box_t box = rxcore_bounding_box_create(gs_vec3_sub(position, extents), gs_vec3_add(position, extents));
+    return !rxcore_frustum_test_aabb(&frustum, &box);
 }
 
 void rxcore_camera_apply_bindings(rxcore_camera_t *camera, gs_command_buffer_t *cb)
 {
-    camera->view_matrix = rxcore_camera_get_view_matrix(camera);
-    camera->projection_matrix = rxcore_camera_get_projection_matrix(camera);
+    _rxcore_camera_update(camera);
 
     gs_graphics_bind_uniform_desc_t view_binding = {
         .uniform = camera->view_uniform,
@@ -123,3 +176,53 @@ void rxcore_camera_destroy(rxcore_camera_t *camera)
     gs_graphics_framebuffer_destroy(camera->framebuffer);
     free(camera);
 }
+
+void _rxcore_camera_update(rxcore_camera_t *camera)
+{
+    if (!camera->view_dirty && !camera->projection_dirty)
+    {
+        return;
+    }
+
+    if (camera->view_dirty)
+    {
+        camera->view_matrix = _rxcore_camera_build_view_matrix(camera);
+    }
+    if (camera->projection_dirty)
+    {
+        camera->projection_matrix = _rxcore_camera_build_projection_matrix(camera);
+    }
+
+    // everything else depends on both
+    camera->view_projection_matrix = gs_mat4_mul(camera->projection_matrix, camera->view_matrix);
+    camera->inverse_view_projection_matrix = gs_mat4_inverse(camera->view_projection_matrix);
+    camera->frustum = rxcore_frustum_from_matrix(camera->view_projection_matrix);
+    camera->view_dirty = false;
+    camera->projection_dirty = false;
+}
+
+gs_mat4 _rxcore_camera_build_view_matrix(rxcore_camera_t *camera)
+{
+    gs_mat4 m = gs_mat4_identity();
+    m = gs_mat4_mul(m, gs_quat_to_mat4(camera->rotation));
+    m = gs_mat4_mul(m, gs_mat4_translate(
+        -camera->position.x,
+        -camera->position.y,
+        -camera->position.z
+    ));
+
+    return m;
+}
+
+gs_mat4 _rxcore_camera_build_projection_matrix(rxcore_camera_t *camera)
+{
+    switch (camera->projection_type)
+    {
+    case RXCORE_CAMERA_PROJECTION_PERSPECTIVE:
+        return gs_mat4_perspective(camera->perspective_desc.fov, camera->perspective_desc.aspect_ratio, camera->perspective_desc.near_plane, camera->perspective_desc.far_plane);
+    case RXCORE_CAMERA_PROJECTION_ORTHOGRAPHIC:
+        return gs_mat4_ortho(camera->orthographic_desc.left, camera->orthographic_desc.right, camera->orthographic_desc.bottom, camera->orthographic_desc.top, camera->orthographic_desc.near_plane, camera->orthographic_desc.far_plane);
+    default:
+        return gs_mat4_identity();
+    }
+}
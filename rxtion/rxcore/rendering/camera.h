@@ -3,6 +3,7 @@
 
 #include <gs/gs.h>
 #include <stddef.h>
+#include <rxcore/frustum.h>
 
 typedef enum rxcore_camera_projection_t
 {
@@ -28,6 +29,8 @@ typedef struct rxcore_camera_orthographic_desc_t
     float far_plane;
 } rxcore_camera_orthographic_desc_t;
 
+/// @brief A camera, whose matrices and frustum are cached and only rebuilt after something they depend on changes.
+/// The position, rotation and projection should be changed through the setters, so the camera knows to rebuild them
 typedef struct rxcore_camera_t
 {
     rxcore_camera_projection_t projection_type;
@@ -43,21 +46,52 @@ typedef struct rxcore_camera_t
     gs_handle(gs_graphics_uniform_t) projection_uniform;
     gs_mat4 view_matrix;
     gs_mat4 projection_matrix;
+    gs_mat4 view_projection_matrix;
+    gs_mat4 inverse_view_projection_matrix; // takes normalized device coordinates back into the world, for picking
+    rxcore_frustum_t frustum;               // in world space
+    bool view_dirty;                        // the position or rotation changed since the view was built
+    bool projection_dirty;                  // the projection changed since it was built
 } rxcore_camera_t;
 
 rxcore_camera_t *_rxcore_camera_create_base();
 rxcore_camera_t *rxcore_camera_create_perspective(rxcore_camera_perspective_desc_t desc, gs_vec3 position, gs_quat rotation);
 rxcore_camera_t *rxcore_camera_create_orthographic(rxcore_camera_orthographic_desc_t desc, gs_vec3 position, gs_quat rotation);
 
+void rxcore_camera_set_position(rxcore_camera_t *camera, gs_vec3 position);
+void rxcore_camera_set_rotation(rxcore_camera_t *camera, gs_quat rotation);
+void rxcore_camera_set_perspective(rxcore_camera_t *camera, rxcore_camera_perspective_desc_t desc);
+void rxcore_camera_set_orthographic(rxcore_camera_t *camera, rxcore_camera_orthographic_desc_t desc);
+
+/// @brief Only changes perspective cameras, and only marks the projection dirty if the ratio is different
+void rxcore_camera_set_aspect_ratio(rxcore_camera_t *camera, float aspect_ratio);
+
 gs_mat4 rxcore_camera_get_view_matrix(rxcore_camera_t *camera);
 gs_mat4 rxcore_camera_get_projection_matrix(rxcore_camera_t *camera);
 gs_mat4 rxcore_camera_get_view_projection_matrix(rxcore_camera_t *camera);
+gs_mat4 rxcore_camera_get_inverse_view_projection_matrix(rxcore_camera_t *camera);
+
+/// @return The frustum of the camera in world space, valid until the camera next changes
+rxcore_frustum_t *rxcore_camera_get_frustum(rxcore_camera_t *camera);
 
+/// @brief The ray through a point on the screen, from the near plane towards the far plane.
+/// Its direction is normalized, so distances along it are in world units
+/// @param screen_position In pixels, from the top left corner
+/// @param screen_size The size in pixels of whatever the camera renders to
+rxcore_ray_t rxcore_camera_screen_to_ray(rxcore_camera_t *camera, gs_vec2 screen_position, gs_vec2 screen_size);
+
+/// @return true if the sphere is entirely outside the frustum of the view projection, and can be skipped
 bool rxcore_camera_frustum_cull(gs_mat4 view_projection, gs_vec3 position, float radius);
+
+/// @return true if the box centered at position, with the given size, is entirely outside the frustum
 bool rxcore_camera_frustum_cull_aabb(gs_mat4 view_projection, gs_vec3 position, gs_vec3 scale);
 
 void rxcore_camera_apply_bindings(rxcore_camera_t *camera, gs_command_buffer_t *cb);
 
 void rxcore_camera_destroy(rxcore_camera_t *camera);
 
+// private methods
+void _rxcore_camera_update(rxcore_camera_t *camera);
+gs_mat4 _rxcore_camera_build_view_matrix(rxcore_camera_t *camera);
+gs_mat4 _rxcore_camera_build_projection_matrix(rxcore_camera_t *camera);
+
 #endif // __CAMERA_H__
\ No newline at end of file
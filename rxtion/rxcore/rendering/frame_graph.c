@@ -0,0 +1,514 @@
+// frame_graph.c
+
+#include <rxcore/rendering/frame_graph.h>
+#include <gs/gs.h>
+
+rxcore_render_pass_t rxcore_render_pass_create(const char *name, rxcore_render_pass_fn execute)
+{
+    rxcore_render_pass_t pass = {0};
+    pass.name = name;
+    pass.execute = execute;
+    return pass;
+}
+
+void rxcore_render_pass_read(rxcore_render_pass_t *pass, uint32_t target)
+{
+    if (pass->read_count == RXCORE_RENDER_PASS_MAX_TARGETS)
+    {
+        RXCORE_FRAME_GRAPH_DEBUG_PRINTF("Pass %s reads too many targets!", pass->name);
+        return;
+    }
+
+    pass->reads[pass->read_count++] = target;
+}
+
+void rxcore_render_pass_write(rxcore_render_pass_t *pass, uint32_t target)
+{
+    if (pass->write_count == RXCORE_RENDER_PASS_MAX_TARGETS)
+    {
+        RXCORE_FRAME_GRAPH_DEBUG_PRINTF("Pass %s writes too many targets!", pass->name);
+        return;
+    }
+
+    pass->writes[pass->write_count++] = target;
+}
+
+gs_handle(gs_graphics_texture_t) rxcore_render_pass_get_texture(rxcore_render_pass_t *pass, uint32_t target)
+{
+    return rxcore_frame_graph_get_texture(pass->graph, target);
+}
+
+bool _rxcore_render_pass_reads(rxcore_render_pass_t *pass, uint32_t target)
+{
+    for (uint32_t i = 0; i < pass->read_count; i++)
+    {
+        if (pass->reads[i] == target)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool _rxcore_render_pass_writes(rxcore_render_pass_t *pass, uint32_t target)
+{
+    for (uint32_t i = 0; i < pass->write_count; i++)
+    {
+        if (pass->writes[i] == target)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool _rxcore_render_target_is_depth(rxcore_render_target_desc_t *desc)
+{
+    switch (desc->format)
+    {
+    case GS_GRAPHICS_TEXTURE_FORMAT_DEPTH8:
+    case GS_GRAPHICS_TEXTURE_FORMAT_DEPTH16:
+    case GS_GRAPHICS_TEXTURE_FORMAT_DEPTH24:
+    case GS_GRAPHICS_TEXTURE_FORMAT_DEPTH32F:
+    case GS_GRAPHICS_TEXTURE_FORMAT_DEPTH24_STENCIL8:
+    case GS_GRAPHICS_TEXTURE_FORMAT_DEPTH32F_STENCIL8:
+        return true;
+    default:
+        return false;
+    }
+}
+
+rxcore_frame_graph_t *rxcore_frame_graph_create()
+{
+    rxcore_frame_graph_t *graph = malloc(sizeof(rxcore_frame_graph_t));
+    graph->targets = gs_dyn_array_new(rxcore_render_target_desc_t);
+    graph->passes = gs_dyn_array_new(rxcore_render_pass_t);
+    graph->pass_data = gs_dyn_array_new(void *);
+    graph->is_dirty = true;
+    graph->width = 0;
+    graph->height = 0;
+    graph->order = gs_dyn_array_new(uint32_t);
+    graph->renderpasses = gs_dyn_array_new(gs_handle(gs_graphics_renderpass_t));
+    graph->textures = gs_dyn_array_new(rxcore_frame_graph_texture_t);
+    graph->target_textures = gs_dyn_array_new(uint32_t);
+    graph->fbo = gs_graphics_framebuffer_create(NULL);
+    return graph;
+}
+
+uint32_t rxcore_frame_graph_add_target(rxcore_frame_graph_t *graph, rxcore_render_target_desc_t desc)
+{
+    if (desc.scale <= 0.f)
+    {
+        desc.scale = 1.f;
+    }
+
+    gs_dyn_array_push(graph->targets, desc);
+    graph->is_dirty = true;
+    return gs_dyn_array_size(graph->targets);
+}
+
+rxcore_render_pass_t *rxcore_frame_graph_add_pass(rxcore_frame_graph_t *graph, rxcore_render_pass_t pass, void *data)
+{
+    pass.graph = graph;
+    gs_dyn_array_push(graph->passes, pass);
+    gs_dyn_array_push(graph->pass_data, data);
+    graph->is_dirty = true;
+    return &graph->passes[gs_dyn_array_size(graph->passes) - 1];
+}
+
+void _rxcore_frame_graph_cull(rxcore_frame_graph_t *graph, bool *live)
+{
+    uint32_t num_passes = gs_dyn_array_size(graph->passes);
+    uint32_t num_targets = gs_dyn_array_size(graph->targets) + 1;
+    bool *needed = malloc(sizeof(bool) * num_targets);
+    memset(needed, 0, sizeof(bool) * num_targets);
+    memset(live, 0, sizeof(bool) * num_passes);
+
+    // only the backbuffer is needed up front, everything else is needed because a live pass reads it
+    needed[RXCORE_RENDER_TARGET_BACKBUFFER] = true;
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (uint32_t i = 0; i < num_passes; i++)
+        {
+            rxcore_render_pass_t *pass = &graph->passes[i];
+            if (live[i])
+            {
+                continue;
+            }
+
+            for (uint32_t w = 0; w < pass->write_count; w++)
+            {
+                if (pass->writes[w] < num_targets && needed[pass->writes[w]])
+                {
+                    live[i] = true;
+                    break;
+                }
+            }
+
+            if (!live[i])
+            {
+                continue;
+            }
+
+            changed = true;
+            for (uint32_t r = 0; r < pass->read_count; r++)
+            {
+                if (pass->reads[r] < num_targets)
+                {
+                    needed[pass->reads[r]] = true;
+                }
+            }
+        }
+    }
+
+    free(needed);
+}
+
+bool _rxcore_frame_graph_sort(rxcore_frame_graph_t *graph, bool *live)
+{
+    uint32_t num_passes = gs_dyn_array_size(graph->passes);
+    uint32_t num_targets = gs_dyn_array_size(graph->targets) + 1;
+
+    // edges[i * n + j] means pass i has to run before pass j
+    bool *edges = malloc(sizeof(bool) * num_passes * num_passes);
+    uint32_t *in_degree = malloc(sizeof(uint32_t) * num_passes);
+    bool *emitted = malloc(sizeof(bool) * num_passes);
+    memset(edges, 0, sizeof(bool) * num_passes * num_passes);
+    memset(in_degree, 0, sizeof(uint32_t) * num_passes);
+    memset(emitted, 0, sizeof(bool) * num_passes);
+
+    for (uint32_t t = 0; t < num_targets; t++)
+    {
+        for (uint32_t i = 0; i < num_passes; i++)
+        {
+            if (!live[i] || !_rxcore_render_pass_writes(&graph->passes[i], t))
+            {
+                continue;
+            }
+
+            for (uint32_t j = 0; j < num_passes; j++)
+            {
+                if (!live[j] || i == j || edges[i * num_passes + j])
+                {
+                    continue;
+                }
+
+                // writers run before readers, and writers of the same target keep the order they were added in
+                bool read_after_write = _rxcore_render_pass_reads(&graph->passes[j], t);
+                bool write_after_write = j > i && _rxcore_render_pass_writes(&graph->passes[j], t);
+                if (read_after_write || write_after_write)
+                {
+                    edges[i * num_passes + j] = true;
+                    in_degree[j]++;
+                }
+            }
+        }
+    }
+
+    // kahn's algorithm, always taking the earliest added pass that is ready
+    gs_dyn_array_clear(graph->order);
+    uint32_t num_live = 0;
+    for (uint32_t i = 0; i < num_passes; i++)
+    {
+        num_live += live[i] ? 1 : 0;
+    }
+
+    bool acyclic = true;
+    while (gs_dyn_array_size(graph->order) < num_live)
+    {
+        uint32_t next = UINT32_MAX;
+        for (uint32_t i = 0; i < num_passes; i++)
+        {
+            if (live[i] && !emitted[i] && in_degree[i] == 0)
+            {
+                next = i;
+                break;
+            }
+        }
+
+        if (next == UINT32_MAX)
+        {
+            acyclic = false;
+            break;
+        }
+
+        emitted[next] = true;
+        gs_dyn_array_push(graph->order, next);
+        for (uint32_t j = 0; j < num_passes; j++)
+        {
+            if (edges[next * num_passes + j])
+            {
+                in_degree[j]--;
+            }
+        }
+    }
+
+    if (!acyclic)
+    {
+        RXCORE_LOG_WARN("rendering::frame_graph", "Frame graph has a cyclic dependency, falling back to the order passes were added in");
+        gs_dyn_array_clear(graph->order);
+        for (uint32_t i = 0; i < num_passes; i++)
+        {
+            if (live[i])
+            {
+                gs_dyn_array_push(graph->order, i);
+            }
+        }
+    }
+
+    free(edges);
+    free(in_degree);
+    free(emitted);
+    return acyclic;
+}
+
+void _rxcore_frame_graph_allocate(rxcore_frame_graph_t *graph)
+{
+    uint32_t num_targets = gs_dyn_array_size(graph->targets);
+    uint32_t num_live = gs_dyn_array_size(graph->order);
+
+    // find the first and last position in the execution order that touches each target
+    uint32_t *first_use = malloc(sizeof(uint32_t) * (num_targets + 1));
+    uint32_t *last_use = malloc(sizeof(uint32_t) * (num_targets + 1));
+    for (uint32_t t = 0; t <= num_targets; t++)
+    {
+        first_use[t] = UINT32_MAX;
+        last_use[t] = 0;
+    }
+
+    for (uint32_t p = 0; p < num_live; p++)
+    {
+        rxcore_render_pass_t *pass = &graph->passes[graph->order[p]];
+        for (uint32_t t = 1; t <= num_targets; t++)
+        {
+            if (_rxcore_render_pass_reads(pass, t) || _rxcore_render_pass_writes(pass, t))
+            {
+                first_use[t] = first_use[t] == UINT32_MAX ? p : first_use[t];
+                last_use[t] = p;
+            }
+        }
+    }
+
+    gs_dyn_array_clear(graph->target_textures);
+    for (uint32_t t = 0; t < num_targets; t++)
+    {
+        gs_dyn_array_push(graph->target_textures, UINT32_MAX);
+    }
+
+    // walk the execution order, handing out textures whose previous owner is already dead
+    for (uint32_t p = 0; p < num_live; p++)
+    {
+        for (uint32_t t = 1; t <= num_targets; t++)
+        {
+            if (first_use[t] != p)
+            {
+                continue;
+            }
+
+            rxcore_render_target_desc_t *desc = &graph->targets[t - 1];
+            uint32_t texture_index = UINT32_MAX;
+            for (uint32_t i = 0; i < gs_dyn_array_size(graph->textures); i++)
+            {
+                rxcore_frame_graph_texture_t *texture = &graph->textures[i];
+                if (texture->last_use < p && texture->desc.format == desc->format && texture->desc.scale == desc->scale)
+                {
+                    texture_index = i;
+                    break;
+                }
+            }
+
+            if (texture_index == UINT32_MAX)
+            {
+                rxcore_frame_graph_texture_t texture = {0};
+                texture.desc = *desc;
+                texture.texture = gs_graphics_texture_create(
+                    &(gs_graphics_texture_desc_t){
+                        .width = gs_max((uint32_t)(graph->width * desc->scale), 1),
+                        .height = gs_max((uint32_t)(graph->height * desc->scale), 1),
+                        .format = desc->format,
+                        .min_filter = GS_GRAPHICS_TEXTURE_FILTER_LINEAR,
+                        .mag_filter = GS_GRAPHICS_TEXTURE_FILTER_LINEAR,
+                    });
+                gs_dyn_array_push(graph->textures, texture);
+                texture_index = gs_dyn_array_size(graph->textures) - 1;
+            }
+            else
+            {
+                RXCORE_FRAME_GRAPH_DEBUG_PRINTF("Target %s aliases texture %d", desc->name, texture_index);
+            }
+
+            graph->textures[texture_index].last_use = last_use[t];
+            graph->target_textures[t - 1] = texture_index;
+        }
+    }
+
+    // now create a renderpass for every live pass, attaching the targets it writes
+    gs_dyn_array_clear(graph->renderpasses);
+    for (uint32_t p = 0; p < num_live; p++)
+    {
+        rxcore_render_pass_t *pass = &graph->passes[graph->order[p]];
+        if (_rxcore_render_pass_writes(pass, RXCORE_RENDER_TARGET_BACKBUFFER))
+        {
+            if (pass->write_count > 1)
+            {
+                RXCORE_LOG_WARN("rendering::frame_graph", "Pass %s writes to the backbuffer and other targets, only the backbuffer will be written", pass->name);
+            }
+
+            gs_dyn_array_push(graph->renderpasses, GS_GRAPHICS_RENDER_PASS_DEFAULT);
+            continue;
+        }
+
+        gs_handle(gs_graphics_texture_t) color[RXCORE_RENDER_PASS_MAX_TARGETS];
+        uint32_t color_count = 0;
+        gs_handle(gs_graphics_texture_t) depth = {0};
+        for (uint32_t w = 0; w < pass->write_count; w++)
+        {
+            uint32_t target = pass->writes[w];
+            if (target == RXCORE_RENDER_TARGET_BACKBUFFER || target > num_targets)
+            {
+                continue;
+            }
+
+            gs_handle(gs_graphics_texture_t) texture = graph->textures[graph->target_textures[target - 1]].texture;
+            if (_rxcore_render_target_is_depth(&graph->targets[target - 1]))
+            {
+                depth = texture;
+            }
+            else
+            {
+                color[color_count++] = texture;
+            }
+        }
+
+        gs_handle(gs_graphics_renderpass_t) renderpass = gs_graphics_renderpass_create(
+            &(gs_graphics_renderpass_desc_t){
+                .fbo = graph->fbo,
+                .color = color,
+                .color_size = color_count * sizeof(gs_handle(gs_graphics_texture_t)),
+                .depth = depth,
+            });
+        gs_dyn_array_push(graph->renderpasses, renderpass);
+    }
+
+    free(first_use);
+    free(last_use);
+}
+
+void _rxcore_frame_graph_release(rxcore_frame_graph_t *graph)
+{
+    for (uint32_t i = 0; i < gs_dyn_array_size(graph->renderpasses); i++)
+    {
+        if (graph->renderpasses[i].id != GS_GRAPHICS_RENDER_PASS_DEFAULT.id)
+        {
+            gs_graphics_renderpass_destroy(graph->renderpasses[i]);
+        }
+    }
+
+    for (uint32_t i = 0; i < gs_dyn_array_size(graph->textures); i++)
+    {
+        gs_graphics_texture_destroy(graph->textures[i].texture);
+    }
+
+    gs_dyn_array_clear(graph->renderpasses);
+    gs_dyn_array_clear(graph->textures);
+}
+
+bool rxcore_frame_graph_compile(rxcore_frame_graph_t *graph, uint32_t width, uint32_t height)
+{
+    _rxcore_frame_graph_release(graph);
+    graph->width = width;
+    graph->height = height;
+
+    uint32_t num_passes = gs_dyn_array_size(graph->passes);
+    bool *live = malloc(sizeof(bool) * gs_max(num_passes, 1));
+    _rxcore_frame_graph_cull(graph, live);
+    bool acyclic = _rxcore_frame_graph_sort(graph, live);
+    _rxcore_frame_graph_allocate(graph);
+    free(live);
+
+    graph->is_dirty = false;
+
+    RXCORE_PROFILER_COUNTER_SET("frame_graph_passes_live", gs_dyn_array_size(graph->order));
+    RXCORE_PROFILER_COUNTER_SET("frame_graph_passes_culled", num_passes - gs_dyn_array_size(graph->order));
+    RXCORE_PROFILER_COUNTER_SET("frame_graph_textures", gs_dyn_array_size(graph->textures));
+    return acyclic;
+}
+
+void rxcore_frame_graph_execute(rxcore_frame_graph_t *graph, gs_command_buffer_t *cb, uint32_t width, uint32_t height)
+{
+    if (graph->is_dirty || graph->width != width || graph->height != height)
+    {
+        rxcore_frame_graph_compile(graph, width, height);
+    }
+
+    for (uint32_t p = 0; p < gs_dyn_array_size(graph->order); p++)
+    {
+        uint32_t index = graph->order[p];
+        rxcore_render_pass_t *pass = &graph->passes[index];
+        void *data = graph->pass_data[index];
+
+        // the viewport covers the first target that is written
+        float scale = 1.f;
+        uint32_t target = pass->write_count > 0 ? pass->writes[0] : RXCORE_RENDER_TARGET_BACKBUFFER;
+        if (target != RXCORE_RENDER_TARGET_BACKBUFFER && target <= gs_dyn_array_size(graph->targets))
+        {
+            scale = graph->targets[target - 1].scale;
+        }
+
+        gs_graphics_renderpass_begin(cb, graph->renderpasses[p]);
+        gs_graphics_set_viewport(cb, 0, 0, gs_max((uint32_t)(width * scale), 1), gs_max((uint32_t)(height * scale), 1));
+
+        if (pass->begin)
+            pass->begin(cb, pass, data);
+        if (pass->execute)
+            pass->execute(cb, pass, data);
+        if (pass->end)
+            pass->end(cb, pass, data);
+
+        gs_graphics_renderpass_end(cb);
+    }
+}
+
+gs_handle(gs_graphics_texture_t) rxcore_frame_graph_get_texture(rxcore_frame_graph_t *graph, uint32_t target)
+{
+    if (target == RXCORE_RENDER_TARGET_BACKBUFFER ||
+        target > gs_dyn_array_size(graph->target_textures) ||
+        graph->target_textures[target - 1] == UINT32_MAX)
+    {
+        return (gs_handle(gs_graphics_texture_t)){0};
+    }
+
+    return graph->textures[graph->target_textures[target - 1]].texture;
+}
+
+void rxcore_frame_graph_print(rxcore_frame_graph_t *graph, void (*print_fn)(const char *str, ...))
+{
+    print_fn("Frame Graph: %d passes, %d live, %d targets in %d textures\n",
+             gs_dyn_array_size(graph->passes),
+             gs_dyn_array_size(graph->order),
+             gs_dyn_array_size(graph->targets),
+             gs_dyn_array_size(graph->textures));
+
+    for (uint32_t p = 0; p < gs_dyn_array_size(graph->order); p++)
+    {
+        rxcore_render_pass_t *pass = &graph->passes[graph->order[p]];
+        print_fn("  %d: %s, reads %d, writes %d\n", p, pass->name, pass->read_count, pass->write_count);
+    }
+}
+
+void rxcore_frame_graph_destroy(rxcore_frame_graph_t *graph)
+{
+    _rxcore_frame_graph_release(graph);
+    gs_graphics_framebuffer_destroy(graph->fbo);
+    gs_dyn_array_free(graph->targets);
+    gs_dyn_array_free(graph->passes);
+    gs_dyn_array_free(graph->pass_data);
+    gs_dyn_array_free(graph->order);
+    gs_dyn_array_free(graph->renderpasses);
+    gs_dyn_array_free(graph->textures);
+    gs_dyn_array_free(graph->target_textures);
+    free(graph);
+}
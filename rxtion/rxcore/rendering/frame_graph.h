@@ -0,0 +1,116 @@
+#ifndef __FRAME_GRAPH_H__
+#define __FRAME_GRAPH_H__
+
+#include <gs/gs.h>
+#include <rxcore/log.h>
+#include <stdbool.h>
+#include <rxcore/profiler.h>
+
+// #define RXCORE_FRAME_GRAPH_DEBUG
+
+#ifdef RXCORE_FRAME_GRAPH_DEBUG
+#define RXCORE_FRAME_GRAPH_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("rendering::frame_graph", str)
+#define RXCORE_FRAME_GRAPH_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("rendering::frame_graph", str, __VA_ARGS__)
+#else
+#define RXCORE_FRAME_GRAPH_DEBUG_PRINT(...) ((void)0)
+#define RXCORE_FRAME_GRAPH_DEBUG_PRINTF(...) ((void)0)
+#endif
+
+#define RXCORE_RENDER_PASS_MAX_TARGETS 4
+
+// the default framebuffer, every frame graph has it, and passes that write to it are always executed
+#define RXCORE_RENDER_TARGET_BACKBUFFER 0
+
+typedef struct rxcore_render_pass_t rxcore_render_pass_t;
+typedef struct rxcore_frame_graph_t rxcore_frame_graph_t;
+typedef void (*rxcore_render_pass_fn)(gs_command_buffer_t *cb, rxcore_render_pass_t *pass, void *data);
+
+/// @brief Describes a transient render target, the texture behind it is owned and aliased by the frame graph
+typedef struct rxcore_render_target_desc_t
+{
+    const char *name;
+    gs_graphics_texture_format_type format;
+    float scale; // relative to the size of the framebuffer
+} rxcore_render_target_desc_t;
+
+/// @brief A pass in the frame graph, which declares the targets it reads and writes
+typedef struct rxcore_render_pass_t
+{
+    const char *name;
+    uint32_t reads[RXCORE_RENDER_PASS_MAX_TARGETS];
+    uint32_t read_count;
+    uint32_t writes[RXCORE_RENDER_PASS_MAX_TARGETS];
+    uint32_t write_count;
+    rxcore_render_pass_fn begin;
+    rxcore_render_pass_fn execute;
+    rxcore_render_pass_fn end;
+    rxcore_frame_graph_t *graph; // set when the pass is added, used to look up the textures of the targets
+} rxcore_render_pass_t;
+
+/// @brief A physical texture, which may back several targets whose lifetimes don't overlap
+typedef struct rxcore_frame_graph_texture_t
+{
+    gs_handle(gs_graphics_texture_t) texture;
+    rxcore_render_target_desc_t desc;
+    uint32_t last_use; // position in the execution order of the last pass that uses it
+} rxcore_frame_graph_texture_t;
+
+typedef struct rxcore_frame_graph_t
+{
+    gs_dyn_array(rxcore_render_target_desc_t) targets; // target id - 1, as 0 is the backbuffer
+    gs_dyn_array(rxcore_render_pass_t) passes;
+    gs_dyn_array(void *) pass_data;
+
+    // compiled state, rebuilt whenever a pass or target is added, or the framebuffer is resized
+    bool is_dirty;
+    uint32_t width;
+    uint32_t height;
+    gs_dyn_array(uint32_t) order; // indices of the live passes, in execution order
+    gs_dyn_array(gs_handle(gs_graphics_renderpass_t)) renderpasses; // one per live pass
+    gs_dyn_array(rxcore_frame_graph_texture_t) textures;
+    gs_dyn_array(uint32_t) target_textures; // target id - 1 to index into textures, UINT32_MAX if unused
+    gs_handle(gs_graphics_framebuffer_t) fbo;
+} rxcore_frame_graph_t;
+
+// RXCORE_RENDER_PASS methods
+rxcore_render_pass_t rxcore_render_pass_create(const char *name, rxcore_render_pass_fn execute);
+void rxcore_render_pass_read(rxcore_render_pass_t *pass, uint32_t target);
+void rxcore_render_pass_write(rxcore_render_pass_t *pass, uint32_t target);
+
+/// @brief Gets the texture behind a target this pass reads, only valid while the frame graph is executing
+gs_handle(gs_graphics_texture_t) rxcore_render_pass_get_texture(rxcore_render_pass_t *pass, uint32_t target);
+
+// RXCORE_FRAME_GRAPH methods
+
+/// @brief Creates an empty frame graph, allocated on the heap
+rxcore_frame_graph_t *rxcore_frame_graph_create();
+
+/// @brief Declares a transient render target
+/// @return The id of the target, to be used with rxcore_render_pass_read and rxcore_render_pass_write
+uint32_t rxcore_frame_graph_add_target(rxcore_frame_graph_t *graph, rxcore_render_target_desc_t desc);
+
+/// @brief Adds a pass to the graph. Passes are ordered by their dependencies, ties keep the order they were added in
+/// @return A pointer to the stored pass, valid until the next pass is added
+rxcore_render_pass_t *rxcore_frame_graph_add_pass(rxcore_frame_graph_t *graph, rxcore_render_pass_t pass, void *data);
+
+/// @brief Orders the passes, culls the ones whose outputs are never used, and allocates the transient targets
+/// @return false if the passes have a cyclic dependency, in which case the order they were added in is used
+bool rxcore_frame_graph_compile(rxcore_frame_graph_t *graph, uint32_t width, uint32_t height);
+
+/// @brief Records every live pass into the command buffer, compiling the graph first if needed
+void rxcore_frame_graph_execute(rxcore_frame_graph_t *graph, gs_command_buffer_t *cb, uint32_t width, uint32_t height);
+
+gs_handle(gs_graphics_texture_t) rxcore_frame_graph_get_texture(rxcore_frame_graph_t *graph, uint32_t target);
+void rxcore_frame_graph_print(rxcore_frame_graph_t *graph, void (*print_fn)(const char *str, ...));
+void rxcore_frame_graph_destroy(rxcore_frame_graph_t *graph);
+
+// private methods
+bool _rxcore_render_pass_reads(rxcore_render_pass_t *pass, uint32_t target);
+bool _rxcore_render_pass_writes(rxcore_render_pass_t *pass, uint32_t target);
+bool _rxcore_render_target_is_depth(rxcore_render_target_desc_t *desc);
+void _rxcore_frame_graph_cull(rxcore_frame_graph_t *graph, bool *live);
+bool _rxcore_frame_graph_sort(rxcore_frame_graph_t *graph, bool *live);
+void _rxcore_frame_graph_allocate(rxcore_frame_graph_t *graph);
+void _rxcore_frame_graph_release(rxcore_frame_graph_t *graph);
+
+#endif // __FRAME_GRAPH_H__
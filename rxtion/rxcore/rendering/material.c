@@ -18,13 +18,16 @@ rxcore_material_t *rxcore_material_create_base(rxcore_shader_set_t set, gs_graph
 
     rxcore_material_t *material = malloc(sizeof(rxcore_material_t));
     material->shader_set = set;
+    material->pso_key = rxcore_pso_key_create(set, RXCORE_VERTEX_LAYOUT_DEFAULT, rxcore_pso_state_default());
     material->num_uniforms = num_uniforms;
+    material->snapshot_frame = UINT64_MAX; // never copied into one
+    material->snapshot_index = 0;
 
     // create the uniform handles
     material->uniform_handles = malloc(sizeof(gs_handle(gs_graphics_uniform_t)) * num_uniforms);
     for (uint32_t i = 0; i < num_uniforms; i++)
     {
-        gs_println("Creating uniform %d: %s of type: %d", i, uniform_descs[i].name, uniform_descs[i].layout->type);
+        RXCORE_MATERIAL_DEBUG_PRINTF("Creating uniform %d: %s of type: %d", i, uniform_descs[i].name, uniform_descs[i].layout->type);
         gs_handle(gs_graphics_uniform_t) uniform = gs_graphics_uniform_create(&uniform_descs[i]);
         material->uniform_handles[i] = uniform;
     }
@@ -146,6 +149,11 @@ void rxcore_material_add_binding(rxcore_material_t *material, const char *unifor
     material->uniform_bindings[index].binding = size;
 }
 
+void rxcore_material_set_pso_state(rxcore_material_t *material, rxcore_pso_state_t state)
+{
+    material->pso_key.state = state;
+}
+
 void rxcore_material_bind(rxcore_material_t *material, gs_command_buffer_t *cb)
 {
     // gs_println("Binding material with %d uniforms", material->num_uniforms);
@@ -222,16 +230,21 @@ rxcore_material_registry_t *rxcore_material_registry_create()
 {
     rxcore_material_registry_t *reg = malloc(sizeof(rxcore_material_registry_t));
     reg->prototypes = gs_dyn_array_new(rxcore_material_prototype_t *);
-    reg->prototype_names = gs_dyn_array_new(char *);
+    reg->prototype_names = gs_dyn_array_new(const char *);
+    reg->prototype_ids = rxcore_strid_map_create();
     reg->materials = gs_dyn_array_new(rxcore_material_t *);
-    reg->material_names = gs_dyn_array_new(char *);
+    reg->material_names = gs_dyn_array_new(const char *);
+    reg->material_ids = rxcore_strid_map_create();
     return reg;
 }
 
 rxcore_material_t *rxcore_material_registry_add_material(rxcore_material_registry_t *reg, const char *material_name, rxcore_material_t *material)
 {
+    // a second material with a name leaves the first one found by it
+    rxcore_strid_t material_id = rxcore_strid_intern(material_name);
+    rxcore_strid_map_insert(reg->material_ids, material_id, gs_dyn_array_size(reg->materials));
     gs_dyn_array_push(reg->materials, material);
-    gs_dyn_array_push(reg->material_names, material_name);
+    gs_dyn_array_push(reg->material_names, rxcore_strid_get_string(material_id));
     return &reg->materials[gs_dyn_array_size(reg->materials) - 1];
 }
 
@@ -249,16 +262,24 @@ rxcore_material_t *rxcore_material_registry_get_material(rxcore_material_registr
 
 bool rxcore_material_registry_get_material_index(rxcore_material_registry_t *reg, const char *material_name, uint32_t *out_index)
 {
-    for (uint32_t i = 0; i < gs_dyn_array_size(reg->material_names); i++)
+    return rxcore_material_registry_get_material_index_by_id(reg, rxcore_strid_hash(material_name), out_index);
+}
+
+rxcore_material_t *rxcore_material_registry_get_material_by_id(rxcore_material_registry_t *reg, rxcore_strid_t material_id)
+{
+    uint32_t index = 0;
+    if (!rxcore_material_registry_get_material_index_by_id(reg, material_id, &index))
     {
-        if (strcmp(reg->material_names[i], material_name) == 0)
-        {
-            *out_index = i;
-            return true;
-        }
+        RXCORE_MATERIAL_DEBUG_PRINTF("Failed to find material: %llx", (unsigned long long)material_id);
+        return NULL;
     }
 
-    return false;
+    return reg->materials[index];
+}
+
+bool rxcore_material_registry_get_material_index_by_id(rxcore_material_registry_t *reg, rxcore_strid_t material_id, uint32_t *out_index)
+{
+    return rxcore_strid_map_get(reg->material_ids, material_id, out_index);
 }
 
 rxcore_material_prototype_t *rxcore_material_registry_add_prototype(rxcore_material_registry_t *reg, const char *prototype_name, rxcore_material_prototype_t *prototype)
@@ -287,8 +308,10 @@ rxcore_material_prototype_t *rxcore_material_registry_add_prototype(rxcore_mater
     }
 
     // add the prototype to the registry
+    rxcore_strid_t prototype_id = rxcore_strid_intern(prototype_name);
+    rxcore_strid_map_insert(reg->prototype_ids, prototype_id, gs_dyn_array_size(reg->prototypes));
     gs_dyn_array_push(reg->prototypes, proto_copy);
-    gs_dyn_array_push(reg->prototype_names, prototype_name);
+    gs_dyn_array_push(reg->prototype_names, rxcore_strid_get_string(prototype_id));
     return proto_copy;
 }
 
@@ -306,16 +329,24 @@ rxcore_material_prototype_t *rxcore_material_registry_get_prototype(rxcore_mater
 
 bool rxcore_material_registry_get_prototype_index(rxcore_material_registry_t *reg, const char *prototype_name, uint32_t *out_index)
 {
-    for (uint32_t i = 0; i < gs_dyn_array_size(reg->prototype_names); i++)
+    return rxcore_material_registry_get_prototype_index_by_id(reg, rxcore_strid_hash(prototype_name), out_index);
+}
+
+rxcore_material_prototype_t *rxcore_material_registry_get_prototype_by_id(rxcore_material_registry_t *reg, rxcore_strid_t prototype_id)
+{
+    uint32_t index = 0;
+    if (!rxcore_material_registry_get_prototype_index_by_id(reg, prototype_id, &index))
     {
-        if (strcmp(reg->prototype_names[i], prototype_name) == 0)
-        {
-            *out_index = i;
-            return true;
-        }
+        RXCORE_MATERIAL_DEBUG_PRINTF("Failed to find prototype: %llx", (unsigned long long)prototype_id);
+        return NULL;
     }
 
-    return false;
+    return reg->prototypes[index];
+}
+
+bool rxcore_material_registry_get_prototype_index_by_id(rxcore_material_registry_t *reg, rxcore_strid_t prototype_id, uint32_t *out_index)
+{
+    return rxcore_strid_map_get(reg->prototype_ids, prototype_id, out_index);
 }
 
 
@@ -340,8 +371,10 @@ void rxcore_material_registry_destroy(rxcore_material_registry_t *reg)
 
     gs_dyn_array_free(reg->prototypes);
     gs_dyn_array_free(reg->prototype_names);
+    rxcore_strid_map_destroy(reg->prototype_ids);
     gs_dyn_array_free(reg->materials);
     gs_dyn_array_free(reg->material_names);
+    rxcore_strid_map_destroy(reg->material_ids);
     free(reg);
 }
 
@@ -3,14 +3,17 @@
 
 #include <stdint.h>
 #include <rxcore/rendering/shader.h>
+#include <rxcore/rendering/pso.h>
 #include <rxcore/profiler.h>
 #include <gs/gs.h>
+#include <rxcore/log.h>
+#include <rxcore/strid.h>
 
 // #define RXCORE_MATERIAL_DEBUG
 
 #ifdef RXCORE_MATERIAL_DEBUG
-#define RXCORE_MATERIAL_DEBUG_PRINT(str) gs_println("RXCORE::rendering::material::" str)
-#define RXCORE_MATERIAL_DEBUG_PRINTF(str, ...) gs_println("RXCORE::rendering::material::" str, __VA_ARGS__)
+#define RXCORE_MATERIAL_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("rendering::material", str)
+#define RXCORE_MATERIAL_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("rendering::material", str, __VA_ARGS__)
 #else
 #define RXCORE_MATERIAL_DEBUG_PRINT(...) ((void)0)
 #define RXCORE_MATERIAL_DEBUG_PRINTF(...) ((void)0)
@@ -26,18 +29,23 @@ typedef struct rxcore_material_prototype_t
 typedef struct rxcore_material_t
 {
     rxcore_shader_set_t shader_set;
+    rxcore_pso_key_t pso_key; // the pipeline this material renders with, resolved by the pipeline's pso cache
     gs_handle(gs_graphics_uniform_t) * uniform_handles;
     gs_graphics_bind_uniform_desc_t *uniform_bindings;
     const char **uniform_name_to_index;
     uint32_t num_uniforms;
+    uint64_t snapshot_frame; // of the last render snapshot the material was copied into, see rxcore/rendering/render_snapshot.h
+    uint32_t snapshot_index; // of the copy in the materials of that snapshot
 } rxcore_material_t;
 
 typedef struct rxcore_material_registry_t
 {
     gs_dyn_array(rxcore_material_prototype_t *) prototypes;
-    gs_dyn_array(char *) prototype_names;
+    gs_dyn_array(const char *) prototype_names; // interned, see rxcore/strid.h
+    rxcore_strid_map_t *prototype_ids; // to indices into prototypes
     gs_dyn_array(rxcore_material_t *) materials;
-    gs_dyn_array(char *) material_names;
+    gs_dyn_array(const char *) material_names;
+    rxcore_strid_map_t *material_ids;
 } rxcore_material_registry_t;
 
 // RXCORE_MATERIAL_PROTOTYPE methods
@@ -48,6 +56,7 @@ rxcore_material_prototype_t rxcore_material_prototype_create(rxcore_shader_set_t
 rxcore_material_t *rxcore_material_create_base(rxcore_shader_set_t set, gs_graphics_uniform_desc_t *uniform_descs, uint32_t num_uniforms);
 rxcore_material_t *rxcore_material_create_from_prototype(const rxcore_material_prototype_t *prototype, gs_graphics_uniform_desc_t *override_uniform_descs, uint32_t num_overrides);
 void rxcore_material_add_binding(rxcore_material_t *material, const char *uniform_name, void *data, uint32_t size);
+void rxcore_material_set_pso_state(rxcore_material_t *material, rxcore_pso_state_t state);
 void rxcore_material_bind(rxcore_material_t *material, gs_command_buffer_t *cb);
 void rxcore_material_print(rxcore_material_t *material);
 bool rxcore_material_uniform_exists(rxcore_material_t *material, const char *uniform_name);
@@ -72,9 +81,13 @@ rxcore_material_registry_t *rxcore_material_registry_create();
 rxcore_material_t *rxcore_material_registry_add_material(rxcore_material_registry_t *reg, const char *material_name, rxcore_material_t *material);
 rxcore_material_t *rxcore_material_registry_get_material(rxcore_material_registry_t *reg, const char *material_name);
 bool rxcore_material_registry_get_material_index(rxcore_material_registry_t *reg, const char *material_name, uint32_t *out_index);
+rxcore_material_t *rxcore_material_registry_get_material_by_id(rxcore_material_registry_t *reg, rxcore_strid_t material_id);
+bool rxcore_material_registry_get_material_index_by_id(rxcore_material_registry_t *reg, rxcore_strid_t material_id, uint32_t *out_index);
 rxcore_material_prototype_t *rxcore_material_registry_add_prototype(rxcore_material_registry_t *reg, const char *prototype_name, rxcore_material_prototype_t *prototype);
 rxcore_material_prototype_t *rxcore_material_registry_get_prototype(rxcore_material_registry_t *reg, const char *prototype_name);
 bool rxcore_material_registry_get_prototype_index(rxcore_material_registry_t *reg, const char *prototype_name, uint32_t *out_index);
+rxcore_material_prototype_t *rxcore_material_registry_get_prototype_by_id(rxcore_material_registry_t *reg, rxcore_strid_t prototype_id);
+bool rxcore_material_registry_get_prototype_index_by_id(rxcore_material_registry_t *reg, rxcore_strid_t prototype_id, uint32_t *out_index);
 
 void rxcore_material_registry_destroy(rxcore_material_registry_t *reg);
 
@@ -3,109 +3,226 @@
 #include <rxcore/rendering/mesh.h>
 #include <gs/gs.h>
 #include <stdbool.h>
+#include <float.h>
 
 rxcore_mesh_buffer_t *rxcore_mesh_buffer_create()
 {
     rxcore_mesh_buffer_t *buffer = malloc(sizeof(rxcore_mesh_buffer_t));
     buffer->vertices = gs_dyn_array_new(rxcore_vertex_t);
     buffer->indices = gs_dyn_array_new(uint32_t);
-    buffer->vertex_dirty = true;
-    buffer->index_dirty = true;
+    buffer->vertex_buffer_capacity = 0;
+    buffer->index_buffer_capacity = 0;
+    buffer->vertex_dirty = (rxcore_mesh_buffer_range_t){0};
+    buffer->index_dirty = (rxcore_mesh_buffer_range_t){0};
     buffer->vertex_generated = false;
     buffer->index_generated = false;
+    buffer->usage = RXCORE_MESH_BUFFER_STATIC;
+    buffer->stream_frame = 0;
+    buffer->is_appending = false;
+    buffer->pending_vertices = 0;
+    buffer->pending_indices = 0;
+    buffer->layout = RXCORE_VERTEX_LAYOUT_DEFAULT;
+    buffer->index_size = sizeof(uint16_t);
+    buffer->format_changed = false;
+    buffer->packed_vertices = NULL;
+    buffer->packed_vertices_capacity = 0;
+    buffer->packed_indices = NULL;
+    buffer->packed_indices_capacity = 0;
     return buffer;
 }
 
-rxcore_mesh_t rxcore_mesh_buffer_add_mesh(rxcore_mesh_buffer_t *buffer, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count)
+rxcore_mesh_buffer_t *rxcore_mesh_buffer_create_streaming()
 {
-    rxcore_mesh_t mesh = {0};
-    mesh.buffer = buffer;
-    mesh.starting_index = gs_dyn_array_size(buffer->indices);
-    mesh.index_count = index_count;
-    mesh.base_vertex = gs_dyn_array_size(buffer->vertices);
+    rxcore_mesh_buffer_t *buffer = rxcore_mesh_buffer_create();
+    buffer->usage = RXCORE_MESH_BUFFER_STREAM;
 
-    for (uint32_t i = 0; i < vertex_count; i++)
+    // the ring starts out empty, each slot is given storage by the first frame written to it
+    for (uint32_t i = 0; i < RXCORE_MESH_STREAM_FRAMES; i++)
+    {
+        buffer->stream_vertex_buffers[i] = gs_graphics_vertex_buffer_create(&(gs_graphics_vertex_buffer_desc_t){.usage = GS_GRAPHICS_BUFFER_USAGE_STREAM});
+        buffer->stream_index_buffers[i] = gs_graphics_index_buffer_create(&(gs_graphics_index_buffer_desc_t){.usage = GS_GRAPHICS_BUFFER_USAGE_STREAM});
+    }
+    buffer->vertex_buffer = buffer->stream_vertex_buffers[0];
+    buffer->index_buffer = buffer->stream_index_buffers[0];
+    return buffer;
+}
+
+void rxcore_mesh_buffer_set_layout(rxcore_mesh_buffer_t *buffer, rxcore_vertex_layout_t layout)
+{
+    if (buffer->layout == layout)
     {
-        gs_dyn_array_push(buffer->vertices, vertices[i]);
+        return;
     }
 
-    for (uint32_t i = 0; i < index_count; i++)
+    // the gpu buffer is sized in vertices of the old layout, so a static one is made again by the next upload
+    buffer->layout = layout;
+    buffer->format_changed = true;
+    if (buffer->usage == RXCORE_MESH_BUFFER_STATIC && buffer->vertex_generated)
     {
-        gs_dyn_array_push(buffer->indices, indices[i]);
+        gs_graphics_vertex_buffer_destroy(buffer->vertex_buffer);
+        buffer->vertex_generated = false;
+        buffer->vertex_buffer_capacity = 0;
     }
+    rxcore_mesh_buffer_mark_vertices_dirty(buffer, 0, gs_dyn_array_size(buffer->vertices));
+}
 
-    buffer->vertex_dirty = true;
-    buffer->index_dirty = true;
+void rxcore_mesh_buffer_begin_frame(rxcore_mesh_buffer_t *buffer)
+{
+    if (buffer->usage != RXCORE_MESH_BUFFER_STREAM)
+    {
+        RXCORE_MESH_DEBUG_PRINT("Failed to begin a frame, the buffer isn't a streaming one");
+        return;
+    }
 
-    return mesh;
+    // the arrays keep their capacity, so a frame about as big as the last doesn't allocate
+    gs_dyn_array_clear(buffer->vertices);
+    gs_dyn_array_clear(buffer->indices);
+    buffer->vertex_dirty = (rxcore_mesh_buffer_range_t){0};
+    buffer->index_dirty = (rxcore_mesh_buffer_range_t){0};
+    buffer->is_appending = false;
+    buffer->stream_frame = (buffer->stream_frame + 1) % RXCORE_MESH_STREAM_FRAMES;
 }
 
-rxcore_mesh_t rxcore_mesh_buffer_add_mesh_from_file(rxcore_mesh_buffer_t *buffer, const char *file_path)
+void rxcore_mesh_buffer_reserve(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count)
 {
-    rxcore_vertex_t *vertices = NULL;
-    uint32_t vertex_count = 0;
-    uint32_t *indices = NULL;
-    uint32_t index_count = 0;
+    uint32_t vertices_needed = gs_dyn_array_size(buffer->vertices) + vertex_count;
+    uint32_t indices_needed = gs_dyn_array_size(buffer->indices) + index_count;
 
-    if (!rxcore_mesh_load_from_file(file_path, vertices, &vertex_count, indices, &index_count))
+    // reserving exactly what is needed would copy the whole buffer again for every mesh added after the first
+    if (vertices_needed > (uint32_t)gs_dyn_array_capacity(buffer->vertices))
     {
-        RXCORE_MESH_DEBUG_PRINTF("Failed to load mesh from file %s", file_path);
-        return (rxcore_mesh_t){0};
+        gs_dyn_array_reserve(buffer->vertices, gs_max(vertices_needed, (uint32_t)gs_dyn_array_capacity(buffer->vertices) * 2));
+    }
+    if (indices_needed > (uint32_t)gs_dyn_array_capacity(buffer->indices))
+    {
+        gs_dyn_array_reserve(buffer->indices, gs_max(indices_needed, (uint32_t)gs_dyn_array_capacity(buffer->indices) * 2));
+    }
+}
+
+rxcore_mesh_t rxcore_mesh_buffer_add_mesh(rxcore_mesh_buffer_t *buffer, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count)
+{
+    uint32_t *indices_out = NULL;
+    rxcore_vertex_t *vertices_out = rxcore_mesh_buffer_begin_mesh(buffer, vertex_count, index_count, &indices_out);
+    if (vertices_out == NULL)
+    {
+        return rxcore_mesh_empty();
     }
 
-    return rxcore_mesh_buffer_add_mesh(buffer, vertices, vertex_count, indices, index_count);
+    memcpy(vertices_out, vertices, sizeof(rxcore_vertex_t) * vertex_count);
+    memcpy(indices_out, indices, sizeof(uint32_t) * index_count);
+    return rxcore_mesh_buffer_end_mesh(buffer, vertex_count, index_count);
 }
 
-gs_handle(gs_graphics_vertex_buffer_t) rxcore_mesh_buffer_get_vertex_buffer(rxcore_mesh_buffer_t *buffer)
+rxcore_vertex_t *rxcore_mesh_buffer_begin_mesh(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count, uint32_t **indices_out)
 {
-    if (buffer->vertex_dirty)
+    if (buffer->is_appending)
     {
-        // free the old buffer, if there was one
-        if (buffer->vertex_generated)
-        {
-            gs_graphics_vertex_buffer_destroy(buffer->vertex_buffer);
-        }
+        RXCORE_MESH_DEBUG_PRINT("Failed to begin a mesh, the last one hasn't been ended");
+        return NULL;
+    }
 
-        // update the vertex buffer
-        gs_graphics_vertex_buffer_desc_t desc = {
-            .data = buffer->vertices,
-            .size = sizeof(rxcore_vertex_t) * gs_dyn_array_size(buffer->vertices),
-            .usage = GS_GRAPHICS_BUFFER_USAGE_STATIC};
-        buffer->vertex_buffer = gs_graphics_vertex_buffer_create(&desc);
+    // the mesh is written past the end of the arrays, and only becomes part of them once it is ended
+    rxcore_mesh_buffer_reserve(buffer, vertex_count, index_count);
+    buffer->is_appending = true;
+    buffer->pending_vertices = vertex_count;
+    buffer->pending_indices = index_count;
 
-        buffer->vertex_dirty = false;
+    *indices_out = buffer->indices + gs_dyn_array_size(buffer->indices);
+    return buffer->vertices + gs_dyn_array_size(buffer->vertices);
+}
 
-        gs_println("Generated vertex buffer with %d vertices", gs_dyn_array_size(buffer->vertices));
+rxcore_mesh_t rxcore_mesh_buffer_end_mesh(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count)
+{
+    if (!buffer->is_appending || vertex_count > buffer->pending_vertices || index_count > buffer->pending_indices)
+    {
+        // whatever was written is past the end of the arrays, so dropping it is all it takes for the buffer to take another mesh
+        RXCORE_MESH_DEBUG_PRINTF("Failed to end a mesh of %d vertices and %d indices", vertex_count, index_count);
+        buffer->is_appending = false;
+        buffer->pending_vertices = 0;
+        buffer->pending_indices = 0;
+        return rxcore_mesh_empty();
     }
 
-    return buffer->vertex_buffer;
+    rxcore_bounding_box_t bounds = rxcore_bounding_box_empty();
+    rxcore_vertex_t *vertices = buffer->vertices + gs_dyn_array_size(buffer->vertices);
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        rxcore_bounding_box_encapsulate_point(&bounds, vertices[i].position);
+    }
+
+    _rxcore_mesh_buffer_fit_indices(buffer, vertex_count);
+    return _rxcore_mesh_buffer_commit(buffer, vertex_count, index_count, bounds);
 }
 
-gs_handle(gs_graphics_index_buffer_t) rxcore_mesh_buffer_get_index_buffer(rxcore_mesh_buffer_t *buffer)
+bool rxcore_mesh_buffer_add_lod(rxcore_mesh_buffer_t *buffer, rxcore_mesh_t *mesh, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count, float screen_size)
 {
-    if (buffer->index_dirty)
+    if (mesh->lod_count == 0 || mesh->lod_count >= RXCORE_MESH_MAX_LODS || screen_size >= mesh->lods[mesh->lod_count - 1].screen_size)
     {
-        // free the old buffer, if there was one
-        if (buffer->index_generated)
-        {
-            gs_graphics_index_buffer_destroy(buffer->index_buffer);
-        }
+        RXCORE_MESH_DEBUG_PRINTF("Failed to add lod %d with screen size %f", mesh->lod_count, screen_size);
+        return false;
+    }
 
-        // update the index buffer
-        gs_graphics_index_buffer_desc_t desc = {
-            .data = buffer->indices,
-            .size = sizeof(uint32_t) * gs_dyn_array_size(buffer->indices),
-            .usage = GS_GRAPHICS_BUFFER_USAGE_STATIC};
-        buffer->index_buffer = gs_graphics_index_buffer_create(&desc);
+    // the lod goes in the buffer like any other mesh, it just isn't registered on its own.
+    // it should fit inside the bounds of the mesh, which are kept as they are
+    rxcore_mesh_t range = rxcore_mesh_buffer_add_mesh(buffer, vertices, vertex_count, indices, index_count);
+    if (range.buffer == NULL)
+    {
+        return false;
+    }
+    mesh->lods[mesh->lod_count++] = (rxcore_mesh_lod_t){
+        .starting_index = range.starting_index,
+        .index_count = range.index_count,
+        .base_vertex = range.base_vertex,
+        .screen_size = screen_size,
+    };
+
+    return true;
+}
 
-        buffer->index_dirty = false;
+rxcore_mesh_t rxcore_mesh_buffer_add_mesh_from_file(rxcore_mesh_buffer_t *buffer, const char *file_path)
+{
+    rxcore_mesh_file_t file = {0};
+    if (!rxcore_mesh_file_open(file_path, &file))
+    {
+        RXCORE_MESH_DEBUG_PRINTF("Failed to load mesh from file %s, %s", file_path, file.error);
+        return rxcore_mesh_empty();
     }
 
+    rxcore_mesh_t mesh = _rxcore_mesh_buffer_add_mesh_file(buffer, &file, file_path);
+    rxcore_mesh_file_close(&file);
+    return mesh;
+}
+
+void rxcore_mesh_buffer_mark_vertices_dirty(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count)
+{
+    _rxcore_mesh_buffer_range_add(&buffer->vertex_dirty, first, count);
+}
+
+void rxcore_mesh_buffer_mark_indices_dirty(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count)
+{
+    _rxcore_mesh_buffer_range_add(&buffer->index_dirty, first, count);
+}
+
+void rxcore_mesh_buffer_upload(rxcore_mesh_buffer_t *buffer)
+{
+    _rxcore_mesh_buffer_upload_vertices(buffer);
+    _rxcore_mesh_buffer_upload_indices(buffer);
+}
+
+gs_handle(gs_graphics_vertex_buffer_t) rxcore_mesh_buffer_get_vertex_buffer(rxcore_mesh_buffer_t *buffer)
+{
+    return buffer->vertex_buffer;
+}
+
+gs_handle(gs_graphics_index_buffer_t) rxcore_mesh_buffer_get_index_buffer(rxcore_mesh_buffer_t *buffer)
+{
     return buffer->index_buffer;
 }
 
 void rxcore_mesh_buffer_apply_bindings(rxcore_mesh_buffer_t *buffer, gs_command_buffer_t *cb)
 {
+    rxcore_mesh_buffer_upload(buffer);
+
     gs_handle(gs_graphics_vertex_buffer_t) vb = rxcore_mesh_buffer_get_vertex_buffer(buffer);
     gs_handle(gs_graphics_index_buffer_t) ib = rxcore_mesh_buffer_get_index_buffer(buffer);
 
@@ -121,8 +238,24 @@ void rxcore_mesh_buffer_destroy(rxcore_mesh_buffer_t *buffer)
 {
     gs_dyn_array_free(buffer->vertices);
     gs_dyn_array_free(buffer->indices);
-    gs_graphics_vertex_buffer_destroy(buffer->vertex_buffer);
-    gs_graphics_index_buffer_destroy(buffer->index_buffer);
+    free(buffer->packed_vertices);
+    free(buffer->packed_indices);
+    if (buffer->vertex_generated)
+    {
+        gs_graphics_vertex_buffer_destroy(buffer->vertex_buffer);
+    }
+    if (buffer->index_generated)
+    {
+        gs_graphics_index_buffer_destroy(buffer->index_buffer);
+    }
+    if (buffer->usage == RXCORE_MESH_BUFFER_STREAM)
+    {
+        for (uint32_t i = 0; i < RXCORE_MESH_STREAM_FRAMES; i++)
+        {
+            gs_graphics_vertex_buffer_destroy(buffer->stream_vertex_buffers[i]);
+            gs_graphics_index_buffer_destroy(buffer->stream_index_buffers[i]);
+        }
+    }
     free(buffer);
 }
 
@@ -132,7 +265,9 @@ rxcore_mesh_t rxcore_mesh_empty()
         .buffer = NULL,
         .starting_index = 0,
         .base_vertex = 0,
-        .index_count = 0};
+        .index_count = 0,
+        .bounds = rxcore_bounding_box_empty(),
+        .lod_count = 0};
 }
 
 rxcore_vertex_t *rxcore_mesh_get_vertices(rxcore_mesh_t *mesh)
@@ -155,23 +290,72 @@ uint32_t *rxcore_mesh_get_indices(rxcore_mesh_t *mesh)
 
 void rxcore_mesh_draw(rxcore_mesh_t *mesh, gs_command_buffer_t *cb)
 {
-    // gs_println("Drawing mesh starting at %d for %d verts", mesh->starting_index, mesh->index_count);
+    rxcore_mesh_draw_lod(mesh, 0, cb);
+}
+
+void rxcore_mesh_draw_lod(rxcore_mesh_t *mesh, uint32_t lod, gs_command_buffer_t *cb)
+{
+    rxcore_mesh_lod_t range = rxcore_mesh_get_lod(mesh, lod);
+
+    // gs_println("Drawing mesh starting at %d for %d verts", range.starting_index, range.index_count);
     gs_graphics_draw(cb, &(gs_graphics_draw_desc_t){
                             .start = 0,
-                            .count = mesh->index_count,
+                            .count = range.index_count,
                              .range = {
-                                 .start = mesh->starting_index,
-                                 .end = mesh->starting_index + mesh->index_count,
+                                 .start = range.starting_index,
+                                 .end = range.starting_index + range.index_count,
                              },
-                             .base_vertex = mesh->base_vertex,
+                             .base_vertex = range.base_vertex,
                              .instances = 1});
 }
 
-bool rxcore_mesh_load_from_file(const char *file_path, rxcore_vertex_t *vertex_out, uint32_t *vertex_count_out, uint32_t *indices_out, uint32_t *index_count_out)
+rxcore_mesh_lod_t rxcore_mesh_get_lod(rxcore_mesh_t *mesh, uint32_t lod)
+{
+    // meshes that never went through a buffer only have the one range
+    if (mesh->lod_count == 0)
+    {
+        return (rxcore_mesh_lod_t){
+            .starting_index = mesh->starting_index,
+            .index_count = mesh->index_count,
+            .base_vertex = mesh->base_vertex,
+            .screen_size = FLT_MAX,
+        };
+    }
+
+    return mesh->lods[gs_min(lod, mesh->lod_count - 1)];
+}
+
+uint32_t rxcore_mesh_select_lod(rxcore_mesh_t *mesh, float screen_size, uint32_t current)
 {
-    RXCORE_MESH_DEBUG_PRINTF("Loading mesh from file: %s", file_path);
-    RXCORE_MESH_DEBUG_PRINT("Not implemented yet");
-    return false;
+    if (mesh->lod_count <= 1)
+    {
+        return 0;
+    }
+
+    // coarser while the mesh is well under the next threshold, finer while it is well over the current one
+    uint32_t lod = gs_min(current, mesh->lod_count - 1);
+    while (lod + 1 < mesh->lod_count && screen_size < mesh->lods[lod + 1].screen_size * (1.f - RXCORE_MESH_LOD_HYSTERESIS))
+    {
+        lod++;
+    }
+    while (lod > 0 && screen_size > mesh->lods[lod].screen_size * (1.f + RXCORE_MESH_LOD_HYSTERESIS))
+    {
+        lod--;
+    }
+
+    return lod;
+}
+
+bool rxcore_mesh_raycast(rxcore_mesh_t *mesh, rxcore_ray_t *ray, float max_distance, rxcore_raycast_hit_t *hit_out)
+{
+    if (mesh->buffer == NULL || mesh->index_count == 0)
+    {
+        return false;
+    }
+
+    // the indices of a mesh start from its base vertex, not the start of the buffer
+    rxcore_vertex_t *vertices = mesh->buffer->vertices + mesh->base_vertex;
+    return rxcore_raycast_triangles(ray, &vertices->position, sizeof(rxcore_vertex_t), rxcore_mesh_get_indices(mesh), mesh->index_count, max_distance, hit_out);
 }
 
 bool rxcore_mesh_is_empty(rxcore_mesh_t *mesh)
@@ -216,25 +400,127 @@ rxcore_mesh_registry_t *rxcore_mesh_registry_create()
 {
     rxcore_mesh_registry_t *reg = malloc(sizeof(rxcore_mesh_registry_t));
     reg->buffer = rxcore_mesh_buffer_create();
+    reg->wide_buffer = NULL;
+    reg->appending_buffer = NULL;
     reg->meshes = gs_dyn_array_new(rxcore_mesh_t);
     reg->mesh_names = gs_dyn_array_new(const char *);
+    reg->mesh_ids = rxcore_strid_map_create();
+    reg->optimize = false;
     return reg;
 }
 
 rxcore_mesh_t *rxcore_mesh_registry_add_mesh(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count)
 {
-    rxcore_mesh_t mesh = rxcore_mesh_buffer_add_mesh(reg->buffer, vertices, vertex_count, indices, index_count);
-    gs_dyn_array_push(reg->meshes, mesh);
-    gs_dyn_array_push(reg->mesh_names, mesh_name);
-    return &reg->meshes[gs_dyn_array_size(reg->meshes) - 1];
+    // copied in first, so the optimizer works on the buffer's copy rather than one of its own
+    rxcore_mesh_buffer_t *buffer = _rxcore_mesh_registry_get_buffer(reg, vertex_count);
+    uint32_t *indices_out = NULL;
+    rxcore_vertex_t *vertices_out = rxcore_mesh_buffer_begin_mesh(buffer, vertex_count, index_count, &indices_out);
+    if (vertices_out == NULL)
+    {
+        RXCORE_MESH_DEBUG_PRINTF("Failed to add mesh: %s", mesh_name);
+        return NULL;
+    }
+
+    memcpy(vertices_out, vertices, sizeof(rxcore_vertex_t) * vertex_count);
+    memcpy(indices_out, indices, sizeof(uint32_t) * index_count);
+    vertex_count = _rxcore_mesh_registry_optimize(reg, mesh_name, vertices_out, vertex_count, indices_out, index_count);
+    rxcore_mesh_t mesh = rxcore_mesh_buffer_end_mesh(buffer, vertex_count, index_count);
+    return _rxcore_mesh_registry_push(reg, mesh_name, mesh);
+}
+
+void rxcore_mesh_registry_set_layout(rxcore_mesh_registry_t *reg, rxcore_vertex_layout_t layout)
+{
+    rxcore_mesh_buffer_set_layout(reg->buffer, layout);
+    if (reg->wide_buffer != NULL)
+    {
+        rxcore_mesh_buffer_set_layout(reg->wide_buffer, layout);
+    }
+}
+
+void rxcore_mesh_registry_set_optimize(rxcore_mesh_registry_t *reg, bool optimize)
+{
+    reg->optimize = optimize;
+}
+
+rxcore_vertex_t *rxcore_mesh_registry_begin_mesh(rxcore_mesh_registry_t *reg, uint32_t vertex_count, uint32_t index_count, uint32_t **indices_out)
+{
+    rxcore_mesh_buffer_t *buffer = _rxcore_mesh_registry_get_buffer(reg, vertex_count);
+    rxcore_vertex_t *vertices_out = rxcore_mesh_buffer_begin_mesh(buffer, vertex_count, index_count, indices_out);
+    if (vertices_out != NULL)
+    {
+        reg->appending_buffer = buffer;
+    }
+    return vertices_out;
+}
+
+rxcore_mesh_t *rxcore_mesh_registry_end_mesh(rxcore_mesh_registry_t *reg, const char *mesh_name, uint32_t vertex_count, uint32_t index_count)
+{
+    rxcore_mesh_buffer_t *buffer = reg->appending_buffer != NULL ? reg->appending_buffer : reg->buffer;
+    reg->appending_buffer = NULL;
+    if (buffer->is_appending && vertex_count <= buffer->pending_vertices && index_count <= buffer->pending_indices)
+    {
+        vertex_count = _rxcore_mesh_registry_optimize(reg, mesh_name, buffer->vertices + gs_dyn_array_size(buffer->vertices), vertex_count,
+                                                      buffer->indices + gs_dyn_array_size(buffer->indices), index_count);
+    }
+
+    // a mesh that couldn't be ended isn't registered, or its name would find the empty mesh from then on
+    rxcore_mesh_t mesh = rxcore_mesh_buffer_end_mesh(buffer, vertex_count, index_count);
+    if (mesh.buffer == NULL)
+    {
+        return NULL;
+    }
+    return _rxcore_mesh_registry_push(reg, mesh_name, mesh);
 }
 
 rxcore_mesh_t *rxcore_mesh_registry_add_mesh_from_file(rxcore_mesh_registry_t *reg, const char *mesh_name, const char *file_path)
 {
-    rxcore_mesh_t mesh = rxcore_mesh_buffer_add_mesh_from_file(reg->buffer, file_path);
-    gs_dyn_array_push(reg->meshes, mesh);
-    gs_dyn_array_push(reg->mesh_names, mesh_name);
-    return &reg->meshes[gs_dyn_array_size(reg->meshes) - 1];
+    // the file says how big the mesh is before any of it is copied, so it goes straight to the buffer it fits
+    rxcore_mesh_file_t file = {0};
+    if (!rxcore_mesh_file_open(file_path, &file))
+    {
+        RXCORE_MESH_DEBUG_PRINTF("Failed to load mesh from file %s, %s", file_path, file.error);
+        return NULL;
+    }
+
+    rxcore_mesh_buffer_t *buffer = _rxcore_mesh_registry_get_buffer(reg, rxcore_mesh_file_get_max_lod_vertex_count(file.header));
+    rxcore_mesh_t mesh = _rxcore_mesh_buffer_add_mesh_file(buffer, &file, file_path);
+    rxcore_mesh_file_close(&file);
+    if (mesh.buffer == NULL)
+    {
+        return NULL;
+    }
+    return _rxcore_mesh_registry_push(reg, mesh_name, mesh);
+}
+
+rxcore_mesh_t *rxcore_mesh_registry_add_lod(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count, float screen_size)
+{
+    uint32_t index = 0;
+    if (!rxcore_mesh_registry_get_mesh_index(reg, mesh_name, &index))
+    {
+        RXCORE_MESH_DEBUG_PRINTF("Failed to find mesh: %s", mesh_name);
+        return NULL;
+    }
+
+    // the caller's lod is left as it is, so an optimized one is worked on in a copy
+    rxcore_vertex_t *optimized_vertices = NULL;
+    uint32_t *optimized_indices = NULL;
+    if (reg->optimize)
+    {
+        optimized_vertices = malloc(sizeof(rxcore_vertex_t) * vertex_count);
+        optimized_indices = malloc(sizeof(uint32_t) * index_count);
+        memcpy(optimized_vertices, vertices, sizeof(rxcore_vertex_t) * vertex_count);
+        memcpy(optimized_indices, indices, sizeof(uint32_t) * index_count);
+        vertex_count = _rxcore_mesh_registry_optimize(reg, mesh_name, optimized_vertices, vertex_count, optimized_indices, index_count);
+        vertices = optimized_vertices;
+        indices = optimized_indices;
+    }
+
+    rxcore_mesh_t *mesh = &reg->meshes[index];
+    // the lod has to be in the same buffer as the mesh, which makes that buffer 32-bit if the lod is too big for it
+    bool added = rxcore_mesh_buffer_add_lod(mesh->buffer, mesh, vertices, vertex_count, indices, index_count, screen_size);
+    free(optimized_vertices);
+    free(optimized_indices);
+    return added ? mesh : NULL;
 }
 
 rxcore_mesh_t rxcore_mesh_registry_get_mesh(rxcore_mesh_registry_t *reg, const char *mesh_name)
@@ -251,22 +537,379 @@ rxcore_mesh_t rxcore_mesh_registry_get_mesh(rxcore_mesh_registry_t *reg, const c
 
 bool rxcore_mesh_registry_get_mesh_index(rxcore_mesh_registry_t *reg, const char *mesh_name, uint32_t *index_out)
 {
-    for (uint32_t i = 0; i < gs_dyn_array_size(reg->mesh_names); i++)
+    return rxcore_mesh_registry_get_mesh_index_by_id(reg, rxcore_strid_hash(mesh_name), index_out);
+}
+
+rxcore_mesh_t rxcore_mesh_registry_get_mesh_by_id(rxcore_mesh_registry_t *reg, rxcore_strid_t mesh_id)
+{
+    uint32_t index = 0;
+    if (!rxcore_mesh_registry_get_mesh_index_by_id(reg, mesh_id, &index))
     {
-        if (strcmp(reg->mesh_names[i], mesh_name) == 0)
-        {
-            *index_out = i;
-            return true;
-        }
+        RXCORE_MESH_DEBUG_PRINTF("Failed to find mesh: %llx", (unsigned long long)mesh_id);
+        return (rxcore_mesh_t){0};
     }
 
-    return false;
+    return reg->meshes[index];
+}
+
+bool rxcore_mesh_registry_get_mesh_index_by_id(rxcore_mesh_registry_t *reg, rxcore_strid_t mesh_id, uint32_t *index_out)
+{
+    return rxcore_strid_map_get(reg->mesh_ids, mesh_id, index_out);
+}
+
+void rxcore_mesh_registry_upload(rxcore_mesh_registry_t *reg)
+{
+    rxcore_mesh_buffer_upload(reg->buffer);
+    if (reg->wide_buffer != NULL)
+    {
+        rxcore_mesh_buffer_upload(reg->wide_buffer);
+    }
 }
 
 void rxcore_mesh_registry_destroy(rxcore_mesh_registry_t *reg)
 {
     rxcore_mesh_buffer_destroy(reg->buffer);
+    if (reg->wide_buffer != NULL)
+    {
+        rxcore_mesh_buffer_destroy(reg->wide_buffer);
+    }
     gs_dyn_array_free(reg->meshes);
     gs_dyn_array_free(reg->mesh_names);
+    rxcore_strid_map_destroy(reg->mesh_ids);
     free(reg);
 }
+
+rxcore_mesh_buffer_t *_rxcore_mesh_registry_get_buffer(rxcore_mesh_registry_t *reg, uint32_t vertex_count)
+{
+    if (vertex_count <= RXCORE_MESH_SHORT_INDEX_VERTICES)
+    {
+        return reg->buffer;
+    }
+
+    // the few meshes this big share a buffer of their own, so that every other mesh keeps its 16-bit indices
+    if (reg->wide_buffer == NULL)
+    {
+        reg->wide_buffer = rxcore_mesh_buffer_create();
+        reg->wide_buffer->index_size = sizeof(uint32_t);
+        rxcore_mesh_buffer_set_layout(reg->wide_buffer, reg->buffer->layout);
+        RXCORE_MESH_DEBUG_PRINTF("Created a buffer with 32-bit indices for meshes of more than %d vertices", RXCORE_MESH_SHORT_INDEX_VERTICES);
+    }
+    return reg->wide_buffer;
+}
+
+rxcore_mesh_t *_rxcore_mesh_registry_push(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_mesh_t mesh)
+{
+    // a second mesh with a name leaves the first one found by it, as the linear search before the map did
+    rxcore_strid_t mesh_id = rxcore_strid_intern(mesh_name);
+    rxcore_strid_map_insert(reg->mesh_ids, mesh_id, gs_dyn_array_size(reg->meshes));
+    gs_dyn_array_push(reg->meshes, mesh);
+    gs_dyn_array_push(reg->mesh_names, rxcore_strid_get_string(mesh_id));
+    return &reg->meshes[gs_dyn_array_size(reg->meshes) - 1];
+}
+
+uint32_t _rxcore_mesh_registry_optimize(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count)
+{
+    if (!reg->optimize)
+    {
+        return vertex_count;
+    }
+
+    rxcore_mesh_optimizer_stats_t before, after;
+    vertex_count = rxcore_mesh_optimizer_optimize(vertices, vertex_count, sizeof(rxcore_vertex_t), indices, index_count, &before, &after);
+    RXCORE_MESH_DEBUG_PRINTF("Optimized mesh %s, %d to %d vertices, acmr %.3f to %.3f, atvr %.3f to %.3f", mesh_name,
+                             before.vertex_count, after.vertex_count, before.acmr, after.acmr, before.atvr, after.atvr);
+    return vertex_count;
+}
+
+void _rxcore_mesh_buffer_range_add(rxcore_mesh_buffer_range_t *range, uint32_t first, uint32_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // the ranges are uploaded in one go, so anything between two changes is uploaded with them
+    if (range->start >= range->end)
+    {
+        *range = (rxcore_mesh_buffer_range_t){first, first + count};
+        return;
+    }
+    range->start = gs_min(range->start, first);
+    range->end = gs_max(range->end, first + count);
+}
+
+void *_rxcore_mesh_buffer_pack_vertices(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count)
+{
+    const rxcore_vertex_layout_info_t *info = rxcore_vertex_layout_get_info(buffer->layout);
+    if (info->pack == NULL)
+    {
+        return buffer->vertices + first;
+    }
+
+    // kept between uploads, as a streaming buffer packs about as much every frame
+    uint32_t bytes = info->size * count;
+    if (bytes > buffer->packed_vertices_capacity)
+    {
+        free(buffer->packed_vertices);
+        buffer->packed_vertices_capacity = gs_max(bytes, buffer->packed_vertices_capacity * 2);
+        buffer->packed_vertices = malloc(buffer->packed_vertices_capacity);
+    }
+
+    info->pack(buffer->vertices + first, count, buffer->packed_vertices);
+    return buffer->packed_vertices;
+}
+
+void *_rxcore_mesh_buffer_pack_indices(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count)
+{
+    if (buffer->index_size == sizeof(uint32_t))
+    {
+        return buffer->indices + first;
+    }
+
+    uint32_t bytes = sizeof(uint16_t) * count;
+    if (bytes > buffer->packed_indices_capacity)
+    {
+        free(buffer->packed_indices);
+        buffer->packed_indices_capacity = gs_max(bytes, buffer->packed_indices_capacity * 2);
+        buffer->packed_indices = malloc(buffer->packed_indices_capacity);
+    }
+
+    // every mesh in the buffer has few enough vertices that its indices fit
+    uint16_t *packed = buffer->packed_indices;
+    const uint32_t *indices = buffer->indices + first;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        packed[i] = (uint16_t)indices[i];
+    }
+    return packed;
+}
+
+void _rxcore_mesh_buffer_upload_vertices(rxcore_mesh_buffer_t *buffer)
+{
+    if (buffer->usage == RXCORE_MESH_BUFFER_STREAM)
+    {
+        _rxcore_mesh_buffer_stream_vertices(buffer);
+        return;
+    }
+
+    uint32_t size = gs_dyn_array_size(buffer->vertices);
+    uint32_t vertex_size = rxcore_vertex_layout_get_info(buffer->layout)->size;
+    if (!buffer->vertex_generated || size > buffer->vertex_buffer_capacity)
+    {
+        if (buffer->vertex_generated)
+        {
+            gs_graphics_vertex_buffer_destroy(buffer->vertex_buffer);
+        }
+
+        // the new buffer starts out empty, so everything in it has to be uploaded
+        buffer->vertex_buffer_capacity = gs_max(size, buffer->vertex_buffer_capacity * 2);
+        gs_graphics_vertex_buffer_desc_t desc = {
+            .data = NULL,
+            .size = vertex_size * buffer->vertex_buffer_capacity,
+            .usage = GS_GRAPHICS_BUFFER_USAGE_DYNAMIC};
+        buffer->vertex_buffer = gs_graphics_vertex_buffer_create(&desc);
+        buffer->vertex_generated = true;
+        buffer->vertex_dirty = (rxcore_mesh_buffer_range_t){0, size};
+
+        RXCORE_MESH_DEBUG_PRINTF("Generated vertex buffer with room for %d vertices", buffer->vertex_buffer_capacity);
+    }
+
+    rxcore_mesh_buffer_range_t range = buffer->vertex_dirty;
+    range.end = gs_min(range.end, size);
+    if (range.start < range.end)
+    {
+        uint32_t bytes = vertex_size * (range.end - range.start);
+        gs_graphics_vertex_buffer_desc_t desc = {
+            .data = _rxcore_mesh_buffer_pack_vertices(buffer, range.start, range.end - range.start),
+            .size = bytes,
+            .usage = GS_GRAPHICS_BUFFER_USAGE_DYNAMIC,
+            .update = {.type = GS_GRAPHICS_BUFFER_UPDATE_SUBDATA, .offset = vertex_size * range.start}};
+        gs_graphics_vertex_buffer_update(buffer->vertex_buffer, &desc);
+        RXCORE_PROFILER_COUNTER_ADD("mesh_upload_bytes", bytes);
+    }
+    buffer->vertex_dirty = (rxcore_mesh_buffer_range_t){0};
+}
+
+void _rxcore_mesh_buffer_upload_indices(rxcore_mesh_buffer_t *buffer)
+{
+    if (buffer->usage == RXCORE_MESH_BUFFER_STREAM)
+    {
+        _rxcore_mesh_buffer_stream_indices(buffer);
+        return;
+    }
+
+    uint32_t size = gs_dyn_array_size(buffer->indices);
+    if (!buffer->index_generated || size > buffer->index_buffer_capacity)
+    {
+        if (buffer->index_generated)
+        {
+            gs_graphics_index_buffer_destroy(buffer->index_buffer);
+        }
+
+        buffer->index_buffer_capacity = gs_max(size, buffer->index_buffer_capacity * 2);
+        gs_graphics_index_buffer_desc_t desc = {
+            .data = NULL,
+            .size = buffer->index_size * buffer->index_buffer_capacity,
+            .usage = GS_GRAPHICS_BUFFER_USAGE_DYNAMIC};
+        buffer->index_buffer = gs_graphics_index_buffer_create(&desc);
+        buffer->index_generated = true;
+        buffer->index_dirty = (rxcore_mesh_buffer_range_t){0, size};
+    }
+
+    rxcore_mesh_buffer_range_t range = buffer->index_dirty;
+    range.end = gs_min(range.end, size);
+    if (range.start < range.end)
+    {
+        uint32_t bytes = buffer->index_size * (range.end - range.start);
+        gs_graphics_index_buffer_desc_t desc = {
+            .data = _rxcore_mesh_buffer_pack_indices(buffer, range.start, range.end - range.start),
+            .size = bytes,
+            .usage = GS_GRAPHICS_BUFFER_USAGE_DYNAMIC,
+            .update = {.type = GS_GRAPHICS_BUFFER_UPDATE_SUBDATA, .offset = buffer->index_size * range.start}};
+        gs_graphics_index_buffer_update(buffer->index_buffer, &desc);
+        RXCORE_PROFILER_COUNTER_ADD("mesh_upload_bytes", bytes);
+    }
+    buffer->index_dirty = (rxcore_mesh_buffer_range_t){0};
+}
+
+void _rxcore_mesh_buffer_stream_vertices(rxcore_mesh_buffer_t *buffer)
+{
+    if (buffer->vertex_dirty.start >= buffer->vertex_dirty.end)
+    {
+        return;
+    }
+
+    // the frame goes up whole, into a slot last drawn from frames ago. Recreating its storage orphans whatever the driver
+    // still holds of it, so even a gpu further behind than the ring doesn't make the upload wait
+    uint32_t count = gs_dyn_array_size(buffer->vertices);
+    uint32_t bytes = rxcore_vertex_layout_get_info(buffer->layout)->size * count;
+    gs_handle(gs_graphics_vertex_buffer_t) slot = buffer->stream_vertex_buffers[buffer->stream_frame];
+    gs_graphics_vertex_buffer_desc_t desc = {
+        .data = _rxcore_mesh_buffer_pack_vertices(buffer, 0, count),
+        .size = bytes,
+        .usage = GS_GRAPHICS_BUFFER_USAGE_STREAM,
+        .update = {.type = GS_GRAPHICS_BUFFER_UPDATE_RECREATE}};
+    gs_graphics_vertex_buffer_update(slot, &desc);
+    RXCORE_PROFILER_COUNTER_ADD("mesh_stream_bytes", bytes);
+
+    buffer->vertex_buffer = slot;
+    buffer->vertex_dirty = (rxcore_mesh_buffer_range_t){0};
+}
+
+void _rxcore_mesh_buffer_stream_indices(rxcore_mesh_buffer_t *buffer)
+{
+    if (buffer->index_dirty.start >= buffer->index_dirty.end)
+    {
+        return;
+    }
+
+    uint32_t count = gs_dyn_array_size(buffer->indices);
+    uint32_t bytes = buffer->index_size * count;
+    gs_handle(gs_graphics_index_buffer_t) slot = buffer->stream_index_buffers[buffer->stream_frame];
+    gs_graphics_index_buffer_desc_t desc = {
+        .data = _rxcore_mesh_buffer_pack_indices(buffer, 0, count),
+        .size = bytes,
+        .usage = GS_GRAPHICS_BUFFER_USAGE_STREAM,
+        .update = {.type = GS_GRAPHICS_BUFFER_UPDATE_RECREATE}};
+    gs_graphics_index_buffer_update(slot, &desc);
+    RXCORE_PROFILER_COUNTER_ADD("mesh_stream_bytes", bytes);
+
+    buffer->index_buffer = slot;
+    buffer->index_dirty = (rxcore_mesh_buffer_range_t){0};
+}
+
+rxcore_mesh_t _rxcore_mesh_buffer_add_mesh_file(rxcore_mesh_buffer_t *buffer, rxcore_mesh_file_t *file, const char *file_path)
+{
+    rxcore_mesh_file_header_t *header = file->header;
+    if (header->vertex_size != sizeof(rxcore_vertex_t) || header->index_size != sizeof(uint32_t))
+    {
+        RXCORE_MESH_DEBUG_PRINTF("Failed to load mesh from file %s, it was written for a different vertex layout", file_path);
+        return rxcore_mesh_empty();
+    }
+
+    // the file is laid out just like the buffer, so it is copied in without looking at any of it
+    uint32_t *indices = NULL;
+    rxcore_vertex_t *vertices = rxcore_mesh_buffer_begin_mesh(buffer, header->vertex_count, header->index_count, &indices);
+    if (vertices == NULL)
+    {
+        return rxcore_mesh_empty();
+    }
+    memcpy(vertices, file->vertices, sizeof(rxcore_vertex_t) * header->vertex_count);
+    memcpy(indices, file->indices, sizeof(uint32_t) * header->index_count);
+
+    rxcore_bounding_box_t bounds = rxcore_bounding_box_create(
+        gs_v3(header->bounds_min[0], header->bounds_min[1], header->bounds_min[2]),
+        gs_v3(header->bounds_max[0], header->bounds_max[1], header->bounds_max[2]));
+    _rxcore_mesh_buffer_fit_indices(buffer, rxcore_mesh_file_get_max_lod_vertex_count(header));
+    rxcore_mesh_t range = _rxcore_mesh_buffer_commit(buffer, header->vertex_count, header->index_count, bounds);
+
+    // the lods are ranges of the file, which now starts where the range does
+    rxcore_mesh_t mesh = range;
+    mesh.lod_count = header->lod_count;
+    for (uint32_t i = 0; i < header->lod_count; i++)
+    {
+        mesh.lods[i] = (rxcore_mesh_lod_t){
+            .starting_index = range.starting_index + header->lods[i].starting_index,
+            .index_count = header->lods[i].index_count,
+            .base_vertex = range.base_vertex + header->lods[i].base_vertex,
+            .screen_size = i == 0 ? FLT_MAX : header->lods[i].screen_size,
+        };
+    }
+    mesh.starting_index = mesh.lods[0].starting_index;
+    mesh.index_count = mesh.lods[0].index_count;
+    mesh.base_vertex = mesh.lods[0].base_vertex;
+
+    RXCORE_MESH_DEBUG_PRINTF("Loaded mesh from file %s, %d vertices, %d indices and %d lods", file_path, header->vertex_count, header->index_count, header->lod_count);
+    return mesh;
+}
+
+void _rxcore_mesh_buffer_fit_indices(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count)
+{
+    if (buffer->index_size == sizeof(uint32_t) || vertex_count <= RXCORE_MESH_SHORT_INDEX_VERTICES)
+    {
+        return;
+    }
+
+    // the gpu buffer is sized in 16-bit indices, so a static one is made again by the next upload, with all of them
+    RXCORE_MESH_DEBUG_PRINTF("Switching to 32-bit indices for a mesh of %d vertices", vertex_count);
+    buffer->index_size = sizeof(uint32_t);
+    buffer->format_changed = true;
+    if (buffer->usage == RXCORE_MESH_BUFFER_STATIC && buffer->index_generated)
+    {
+        gs_graphics_index_buffer_destroy(buffer->index_buffer);
+        buffer->index_generated = false;
+        buffer->index_buffer_capacity = 0;
+    }
+    rxcore_mesh_buffer_mark_indices_dirty(buffer, 0, gs_dyn_array_size(buffer->indices));
+}
+
+rxcore_mesh_t _rxcore_mesh_buffer_commit(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count, rxcore_bounding_box_t bounds)
+{
+    rxcore_mesh_t mesh = {0};
+    mesh.buffer = buffer;
+    mesh.starting_index = gs_dyn_array_size(buffer->indices);
+    mesh.index_count = index_count;
+    mesh.base_vertex = gs_dyn_array_size(buffer->vertices);
+    mesh.bounds = bounds;
+
+    gs_dyn_array_head(buffer->vertices)->size += vertex_count;
+    gs_dyn_array_head(buffer->indices)->size += index_count;
+    buffer->is_appending = false;
+    buffer->pending_vertices = 0;
+    buffer->pending_indices = 0;
+
+    // only the new mesh has to be uploaded
+    rxcore_mesh_buffer_mark_vertices_dirty(buffer, mesh.base_vertex, vertex_count);
+    rxcore_mesh_buffer_mark_indices_dirty(buffer, mesh.starting_index, index_count);
+
+    // the mesh itself is the most detailed lod, used however big it gets
+    mesh.lods[0] = (rxcore_mesh_lod_t){
+        .starting_index = mesh.starting_index,
+        .index_count = mesh.index_count,
+        .base_vertex = mesh.base_vertex,
+        .screen_size = FLT_MAX,
+    };
+    mesh.lod_count = 1;
+
+    return mesh;
+}
@@ -2,25 +2,51 @@
 #define __MESH_H__
 
 #include <gs/gs.h>
+#include <rxcore/log.h>
 #include <stdbool.h>
 #include <rxcore/profiler.h>
+#include <rxcore/bounding_box.h>
+#include <rxcore/raycast.h>
+#include <rxcore/strid.h>
+#include <rxcore/rendering/mesh_file.h>
+#include <rxcore/rendering/mesh_optimizer.h>
+#include <rxcore/rendering/vertex.h>
 
 #define RXCORE_MESH_DEBUG
 
 #ifdef RXCORE_MESH_DEBUG
-#define RXCORE_MESH_DEBUG_PRINT(str) gs_println("RXCORE::rendering::mesh::" str)
-#define RXCORE_MESH_DEBUG_PRINTF(str, ...) gs_println("RXCORE::rendering::mesh::" str, __VA_ARGS__)
+#define RXCORE_MESH_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("rendering::mesh", str)
+#define RXCORE_MESH_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("rendering::mesh", str, __VA_ARGS__)
 #else
 #define RXCORE_MESH_DEBUG_PRINT(...) ((void)0)
 #define RXCORE_MESH_DEBUG_PRINTF(...) ((void)0)
 #endif
 
-typedef struct rxcore_vertex_t
+// the most levels of detail a mesh can have, the first being the mesh itself
+#define RXCORE_MESH_MAX_LODS 4
+
+// how far past a threshold the screen size has to go before the level of detail changes, as a fraction of the threshold,
+// so that something sitting right on it doesn't switch back and forth every frame
+#define RXCORE_MESH_LOD_HYSTERESIS 0.1f
+
+// the most vertices a mesh can have and still be drawn with 16-bit indices, which count from its base vertex
+#define RXCORE_MESH_SHORT_INDEX_VERTICES 65536
+
+// how many frames a streaming buffer cycles through, so that the one being written is never one the gpu may still be drawing from
+#define RXCORE_MESH_STREAM_FRAMES 3
+
+typedef enum rxcore_mesh_buffer_usage_t
+{
+    RXCORE_MESH_BUFFER_STATIC, // meshes are added once and drawn for many frames, and only what is added gets uploaded
+    RXCORE_MESH_BUFFER_STREAM  // written from scratch every frame, like particles, debug lines or chunks being simulated
+} rxcore_mesh_buffer_usage_t;
+
+/// @brief A range of elements, empty when start isn't below end
+typedef struct rxcore_mesh_buffer_range_t
 {
-    gs_vec3 position;
-    gs_vec3 normal;
-    gs_vec2 uv;
-} rxcore_vertex_t;
+    uint32_t start;
+    uint32_t end;
+} rxcore_mesh_buffer_range_t;
 
 typedef struct rxcore_mesh_buffer_t
 {
@@ -28,32 +54,115 @@ typedef struct rxcore_mesh_buffer_t
     gs_dyn_array          (uint32_t) indices;
     gs_handle(gs_graphics_vertex_buffer_t) vertex_buffer;
     gs_handle(gs_graphics_index_buffer_t) index_buffer;
-    bool vertex_dirty;
-    bool index_dirty;
+    uint32_t vertex_buffer_capacity;        // in vertices. The gpu buffers grow twofold, so appending to them rarely recreates them
+    uint32_t index_buffer_capacity;         // in indices
+    rxcore_mesh_buffer_range_t vertex_dirty; // the vertices changed since they were last uploaded
+    rxcore_mesh_buffer_range_t index_dirty;
     bool vertex_generated;
     bool index_generated;
+    rxcore_mesh_buffer_usage_t usage;
+    gs_handle(gs_graphics_vertex_buffer_t) stream_vertex_buffers[RXCORE_MESH_STREAM_FRAMES]; // the ring of a streaming buffer, vertex_buffer being the current one
+    gs_handle(gs_graphics_index_buffer_t) stream_index_buffers[RXCORE_MESH_STREAM_FRAMES];
+    uint32_t stream_frame;       // the slot of the ring this frame is written to
+    bool is_appending;           // between rxcore_mesh_buffer_begin_mesh and rxcore_mesh_buffer_end_mesh
+    uint32_t pending_vertices;   // how many vertices the mesh being appended has room for
+    uint32_t pending_indices;
+    rxcore_vertex_layout_t layout;     // what the vertices are packed into on the gpu
+    uint32_t index_size;               // bytes per index on the gpu, sizeof(uint16_t) until a mesh has too many vertices for it
+    bool format_changed;               // the layout or index size changed, so pipelines resolved for the buffer are stale
+    void *packed_vertices;             // room to pack vertices into as they are uploaded, unused by the default layout
+    uint32_t packed_vertices_capacity; // in bytes
+    void *packed_indices;              // the same for indices, unused once they are 32-bit
+    uint32_t packed_indices_capacity;
 } rxcore_mesh_buffer_t;
 
+/// @brief A range of the mesh buffer drawn in place of a mesh once it is small enough on screen
+typedef struct rxcore_mesh_lod_t
+{
+    uint32_t starting_index;
+    uint32_t index_count;
+    uint32_t base_vertex;
+    float screen_size; // the fraction of the screen's height the mesh has to cover less of for this lod to replace the one before it
+} rxcore_mesh_lod_t;
+
 typedef struct rxcore_mesh_t
 {
     rxcore_mesh_buffer_t *buffer;
     uint32_t starting_index;
     uint32_t index_count;
     uint32_t base_vertex;
+    rxcore_bounding_box_t bounds; // in the space of the mesh, before any transform
+    rxcore_mesh_lod_t lods[RXCORE_MESH_MAX_LODS]; // most detailed first, lods[0] is the range above
+    uint32_t lod_count;
 } rxcore_mesh_t;
 
 typedef struct rxcore_mesh_registry_t
 {
     rxcore_mesh_buffer_t *buffer;
+    rxcore_mesh_buffer_t *wide_buffer; // for meshes of more than RXCORE_MESH_SHORT_INDEX_VERTICES, so the rest keep 16-bit indices. NULL until there is one
+    rxcore_mesh_buffer_t *appending_buffer; // the one rxcore_mesh_registry_begin_mesh began on, NULL when no mesh is begun
     gs_dyn_array(rxcore_mesh_t) meshes;
-    gs_dyn_array(const char *) mesh_names;
+    gs_dyn_array(const char *) mesh_names; // interned, see rxcore/strid.h
+    rxcore_strid_map_t *mesh_ids; // to indices into meshes
+    bool optimize; // meshes and lods are run through rxcore/rendering/mesh_optimizer.h as they are added
 } rxcore_mesh_registry_t;
 
 rxcore_mesh_buffer_t *rxcore_mesh_buffer_create();
+
+/// @brief A buffer whose meshes only last a frame, for geometry that changes every frame. Each frame is uploaded whole into the next
+/// of RXCORE_MESH_STREAM_FRAMES gpu buffers, orphaning its old storage, so the upload never waits on the gpu
+rxcore_mesh_buffer_t *rxcore_mesh_buffer_create_streaming();
+
+/// @brief Changes what the vertices are packed into on the gpu, uploading all of them again. Draws of the buffer's meshes
+/// use pipelines made for the layout, see rxcore/rendering/vertex.h
+void rxcore_mesh_buffer_set_layout(rxcore_mesh_buffer_t *buffer, rxcore_vertex_layout_t layout);
+
+/// @brief Starts a new frame of a streaming buffer, throwing away the meshes of the last one, whose rxcore_mesh_t are no longer valid
+void rxcore_mesh_buffer_begin_frame(rxcore_mesh_buffer_t *buffer);
+
+/// @brief Makes room for this many more vertices and indices, growing the storage at least twofold when it has to grow,
+/// so that adding many meshes one after another doesn't reallocate for each of them
+void rxcore_mesh_buffer_reserve(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count);
+
+/// @brief Copies a mesh to the end of the buffer
 rxcore_mesh_t rxcore_mesh_buffer_add_mesh(rxcore_mesh_buffer_t *buffer, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count);
+
+/// @brief Makes room for a mesh at the end of the buffer and hands out where it goes, so a loader can write it in place
+/// rather than into memory of its own that then has to be copied. Nothing else can be added to the buffer until the mesh is ended
+/// @param indices_out Receives where the index_count indices go, relative to the first vertex of the mesh
+/// @return Where the vertex_count vertices go, or NULL if another mesh is already being appended
+rxcore_vertex_t *rxcore_mesh_buffer_begin_mesh(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count, uint32_t **indices_out);
+
+/// @brief Finishes the mesh begun last, the pointers handed out for it no longer being valid
+/// @param vertex_count How many vertices were written, which may be fewer than were asked for. The same goes for index_count
+/// @return The mesh, or an empty one if none was begun or more was written than was asked for. The mesh is dropped then,
+/// and the buffer can begin another
+rxcore_mesh_t rxcore_mesh_buffer_end_mesh(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count);
+
+/// @brief Copies the mesh and lods of a .rxmesh file to the end of the buffer, see rxcore/rendering/mesh_file.h
+/// @return The mesh, or an empty one if the file couldn't be loaded
 rxcore_mesh_t rxcore_mesh_buffer_add_mesh_from_file(rxcore_mesh_buffer_t *buffer, const char *file_path);
+
+/// @brief Adds a coarser version of a mesh to the buffer, drawn once the mesh covers less than screen_size of the screen's height.
+/// Copies of the mesh taken before this don't have the lod
+/// @return false if the mesh already has RXCORE_MESH_MAX_LODS, or screen_size isn't below that of the last lod
+bool rxcore_mesh_buffer_add_lod(rxcore_mesh_buffer_t *buffer, rxcore_mesh_t *mesh, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count, float screen_size);
+
+/// @brief Marks vertices changed in place, so that they are uploaded again. Meshes added to the buffer are marked already
+void rxcore_mesh_buffer_mark_vertices_dirty(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count);
+void rxcore_mesh_buffer_mark_indices_dirty(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count);
+
+/// @brief Uploads only what changed since the last upload, growing the gpu buffers when they are too small.
+/// Indices go up as uint16_t unless a mesh in the buffer has more than RXCORE_MESH_SHORT_INDEX_VERTICES vertices.
+/// Talks to the graphics api, so it belongs on the main thread, before anything records draws of the buffer on the workers
+void rxcore_mesh_buffer_upload(rxcore_mesh_buffer_t *buffer);
+
+/// @return The gpu buffer as of the last rxcore_mesh_buffer_upload. Doesn't upload anything, so draws can be recorded
+/// with it on the workers
 gs_handle(gs_graphics_vertex_buffer_t) rxcore_mesh_buffer_get_vertex_buffer(rxcore_mesh_buffer_t *buffer);
 gs_handle(gs_graphics_index_buffer_t) rxcore_mesh_buffer_get_index_buffer(rxcore_mesh_buffer_t *buffer);
+
+/// @brief Uploads the buffer, then binds it. Only for the main thread, see rxcore_mesh_buffer_upload
 void rxcore_mesh_buffer_apply_bindings(rxcore_mesh_buffer_t *buffer, gs_command_buffer_t *cb);
 void rxcore_mesh_buffer_destroy(rxcore_mesh_buffer_t *buffer);
 
@@ -61,15 +170,75 @@ rxcore_mesh_t rxcore_mesh_empty();
 rxcore_vertex_t *rxcore_mesh_get_vertices(rxcore_mesh_t *mesh);
 uint32_t *rxcore_mesh_get_indices(rxcore_mesh_t *mesh);
 void rxcore_mesh_draw(rxcore_mesh_t *mesh, gs_command_buffer_t *cb);
-bool rxcore_mesh_load_from_file(const char *file_path, rxcore_vertex_t *vertex_out, uint32_t *vertex_count_out, uint32_t *indices_out, uint32_t *index_count_out);
+void rxcore_mesh_draw_lod(rxcore_mesh_t *mesh, uint32_t lod, gs_command_buffer_t *cb);
+
+/// @return The range of the lod, or of the coarsest lod if there are fewer
+rxcore_mesh_lod_t rxcore_mesh_get_lod(rxcore_mesh_t *mesh, uint32_t lod);
+
+/// @brief Picks the lod for how much of the screen's height the mesh covers, only moving away from the current one
+/// once the size is RXCORE_MESH_LOD_HYSTERESIS past the threshold between them
+uint32_t rxcore_mesh_select_lod(rxcore_mesh_t *mesh, float screen_size, uint32_t current);
+
+/// @brief Finds the nearest triangle of the full detail mesh the ray hits, the ray being in the space of the mesh
+/// @param hit_out Receives the nearest hit, with the triangle counted from the start of the mesh
+/// @return true if any triangle is hit before max_distance
+bool rxcore_mesh_raycast(rxcore_mesh_t *mesh, rxcore_ray_t *ray, float max_distance, rxcore_raycast_hit_t *hit_out);
 bool rxcore_mesh_is_empty(rxcore_mesh_t *mesh);
 void rxcore_mesh_print(rxcore_mesh_t *mesh, void (*print_func)(const char *, ...), bool add_newlines);
 
 rxcore_mesh_registry_t *rxcore_mesh_registry_create();
+
+/// @brief Adds a mesh to the registry's buffer, or to its wide buffer if it has too many vertices for 16-bit indices
+/// @return The mesh, or NULL if it couldn't be added, in which case nothing is registered under the name
 rxcore_mesh_t *rxcore_mesh_registry_add_mesh(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count);
+
+/// @brief Sets the vertex layout of the registry's buffers, see rxcore_mesh_buffer_set_layout
+void rxcore_mesh_registry_set_layout(rxcore_mesh_registry_t *reg, rxcore_vertex_layout_t layout);
+
+/// @brief Optimizes the meshes added from now on for drawing, logging how much better each gets. Off by default, as it
+/// costs several times what copying the mesh does. Meshes from files aren't touched, rxmesh_convert optimizes those
+void rxcore_mesh_registry_set_optimize(rxcore_mesh_registry_t *reg, bool optimize);
+
+/// @brief Makes room for a mesh in whichever of the registry's buffers it fits, like rxcore_mesh_buffer_begin_mesh, so a mesh
+/// too big for 16-bit indices is written straight into the wide buffer. Finish it with rxcore_mesh_registry_end_mesh
+/// @return Where the vertex_count vertices go, or NULL if a mesh is already being appended to that buffer
+rxcore_vertex_t *rxcore_mesh_registry_begin_mesh(rxcore_mesh_registry_t *reg, uint32_t vertex_count, uint32_t index_count, uint32_t **indices_out);
+
+/// @brief Registers the mesh begun with rxcore_mesh_registry_begin_mesh, on the buffer it was begun on. A mesh begun on the
+/// registry's buffer itself with rxcore_mesh_buffer_begin_mesh is ended there, and makes that buffer 32-bit if it is too big for 16-bit indices
+/// @return The mesh, or NULL if it couldn't be ended, see rxcore_mesh_buffer_end_mesh. Nothing is registered under the name then
+rxcore_mesh_t *rxcore_mesh_registry_end_mesh(rxcore_mesh_registry_t *reg, const char *mesh_name, uint32_t vertex_count, uint32_t index_count);
+
+/// @return The mesh, or NULL if the file couldn't be loaded
 rxcore_mesh_t *rxcore_mesh_registry_add_mesh_from_file(rxcore_mesh_registry_t *reg, const char *mesh_name, const char *file_path);
+
+/// @brief Adds a coarser version of a registered mesh, which has to happen before nodes are given the mesh
+/// @return The mesh, or NULL if there is no mesh with the name or the lod couldn't be added
+rxcore_mesh_t *rxcore_mesh_registry_add_lod(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count, float screen_size);
 rxcore_mesh_t rxcore_mesh_registry_get_mesh(rxcore_mesh_registry_t *reg, const char *mesh_name);
 bool rxcore_mesh_registry_get_mesh_index(rxcore_mesh_registry_t *reg, const char *mesh_name, uint32_t *out_index);
+
+/// @brief Finds a mesh by the id of its name, without hashing the name again, e.g. RXCORE_STRID("quad")
+rxcore_mesh_t rxcore_mesh_registry_get_mesh_by_id(rxcore_mesh_registry_t *reg, rxcore_strid_t mesh_id);
+bool rxcore_mesh_registry_get_mesh_index_by_id(rxcore_mesh_registry_t *reg, rxcore_strid_t mesh_id, uint32_t *out_index);
+
+/// @brief Uploads the registry's buffers, see rxcore_mesh_buffer_upload
+void rxcore_mesh_registry_upload(rxcore_mesh_registry_t *reg);
 void rxcore_mesh_registry_destroy(rxcore_mesh_registry_t *reg);
 
+// private methods
+rxcore_mesh_t _rxcore_mesh_buffer_add_mesh_file(rxcore_mesh_buffer_t *buffer, rxcore_mesh_file_t *file, const char *file_path);
+void _rxcore_mesh_buffer_fit_indices(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count);
+rxcore_mesh_buffer_t *_rxcore_mesh_registry_get_buffer(rxcore_mesh_registry_t *reg, uint32_t vertex_count);
+rxcore_mesh_t *_rxcore_mesh_registry_push(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_mesh_t mesh);
+uint32_t _rxcore_mesh_registry_optimize(rxcore_mesh_registry_t *reg, const char *mesh_name, rxcore_vertex_t *vertices, uint32_t vertex_count, uint32_t *indices, uint32_t index_count);
+rxcore_mesh_t _rxcore_mesh_buffer_commit(rxcore_mesh_buffer_t *buffer, uint32_t vertex_count, uint32_t index_count, rxcore_bounding_box_t bounds);
+void _rxcore_mesh_buffer_range_add(rxcore_mesh_buffer_range_t *range, uint32_t first, uint32_t count);
+void *_rxcore_mesh_buffer_pack_vertices(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count);
+void *_rxcore_mesh_buffer_pack_indices(rxcore_mesh_buffer_t *buffer, uint32_t first, uint32_t count);
+void _rxcore_mesh_buffer_upload_vertices(rxcore_mesh_buffer_t *buffer);
+void _rxcore_mesh_buffer_upload_indices(rxcore_mesh_buffer_t *buffer);
+void _rxcore_mesh_buffer_stream_vertices(rxcore_mesh_buffer_t *buffer);
+void _rxcore_mesh_buffer_stream_indices(rxcore_mesh_buffer_t *buffer);
+
 #endif // __MESH_H__
\ No newline at end of file
@@ -0,0 +1,259 @@
+// mesh_file.c
+
+#include <rxcore/rendering/mesh_file.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool rxcore_mesh_file_open(const char *file_path, rxcore_mesh_file_t *file_out)
+{
+    memset(file_out, 0, sizeof(rxcore_mesh_file_t));
+    if (!_rxcore_mesh_file_map(file_path, file_out))
+    {
+        return false;
+    }
+
+    if (!_rxcore_mesh_file_validate(file_out))
+    {
+        const char *error = file_out->error;
+        rxcore_mesh_file_close(file_out);
+        file_out->error = error;
+        return false;
+    }
+
+    uint8_t *memory = file_out->memory;
+    file_out->header = (rxcore_mesh_file_header_t *)memory;
+    file_out->vertices = memory + file_out->header->vertex_offset;
+    file_out->indices = (uint32_t *)(memory + file_out->header->index_offset);
+    return true;
+}
+
+void rxcore_mesh_file_close(rxcore_mesh_file_t *file)
+{
+    if (file->memory != NULL)
+    {
+        _rxcore_mesh_file_unmap(file);
+    }
+    memset(file, 0, sizeof(rxcore_mesh_file_t));
+}
+
+bool rxcore_mesh_file_write(const char *file_path, rxcore_mesh_file_header_t *header, const void *vertices, const uint32_t *indices)
+{
+    uint64_t vertex_bytes = (uint64_t)header->vertex_count * header->vertex_size;
+    uint64_t index_bytes = (uint64_t)header->index_count * header->index_size;
+    uint64_t alignment = RXCORE_MESH_FILE_ALIGNMENT;
+    header->magic = RXCORE_MESH_FILE_MAGIC;
+    header->version = RXCORE_MESH_FILE_VERSION;
+    header->vertex_offset = (sizeof(rxcore_mesh_file_header_t) + alignment - 1) / alignment * alignment;
+    header->index_offset = (header->vertex_offset + vertex_bytes + alignment - 1) / alignment * alignment;
+
+    FILE *f = fopen(file_path, "wb");
+    if (f == NULL)
+    {
+        return false;
+    }
+
+    static const uint8_t padding[RXCORE_MESH_FILE_ALIGNMENT] = {0};
+    bool written = fwrite(header, sizeof(rxcore_mesh_file_header_t), 1, f) == 1;
+    written = written && fwrite(padding, 1, header->vertex_offset - sizeof(rxcore_mesh_file_header_t), f) == header->vertex_offset - sizeof(rxcore_mesh_file_header_t);
+    written = written && fwrite(vertices, 1, vertex_bytes, f) == vertex_bytes;
+    written = written && fwrite(padding, 1, header->index_offset - header->vertex_offset - vertex_bytes, f) == header->index_offset - header->vertex_offset - vertex_bytes;
+    written = written && fwrite(indices, 1, index_bytes, f) == index_bytes;
+    return fclose(f) == 0 && written;
+}
+
+uint32_t rxcore_mesh_file_get_max_lod_vertex_count(const rxcore_mesh_file_header_t *header)
+{
+    uint32_t max_count = 0;
+    for (uint32_t lod = 0; lod < header->lod_count && lod < RXCORE_MESH_FILE_MAX_LODS; lod++)
+    {
+        uint32_t count = _rxcore_mesh_file_get_lod_vertex_count(header, lod);
+        max_count = count > max_count ? count : max_count;
+    }
+
+    return max_count;
+}
+
+uint32_t _rxcore_mesh_file_get_lod_vertex_count(const rxcore_mesh_file_header_t *header, uint32_t lod)
+{
+    // the lods aren't required to be in order, so the next one is whichever starts closest after it
+    uint32_t base_vertex = header->lods[lod].base_vertex;
+    uint32_t end = header->vertex_count;
+    for (uint32_t i = 0; i < header->lod_count && i < RXCORE_MESH_FILE_MAX_LODS; i++)
+    {
+        if (header->lods[i].base_vertex > base_vertex && header->lods[i].base_vertex < end)
+        {
+            end = header->lods[i].base_vertex;
+        }
+    }
+
+    return end > base_vertex ? end - base_vertex : 0;
+}
+
+bool _rxcore_mesh_file_validate(rxcore_mesh_file_t *file)
+{
+    if (file->size < sizeof(rxcore_mesh_file_header_t))
+    {
+        file->error = "too small to hold a header";
+        return false;
+    }
+
+    rxcore_mesh_file_header_t *header = file->memory;
+    if (header->magic != RXCORE_MESH_FILE_MAGIC)
+    {
+        file->error = "not a mesh file";
+        return false;
+    }
+    if (header->version != RXCORE_MESH_FILE_VERSION)
+    {
+        file->error = "written for a different version";
+        return false;
+    }
+    if (header->lod_count == 0 || header->lod_count > RXCORE_MESH_FILE_MAX_LODS)
+    {
+        file->error = "bad lod count";
+        return false;
+    }
+
+    if (header->index_size != sizeof(uint32_t))
+    {
+        file->error = "indices aren't 32-bit";
+        return false;
+    }
+
+    // the offsets come from the file too, so each blob is measured against what is left after its offset rather than
+    // added to it, which a corrupt offset could wrap around. The sizes are widened, which 32-bit counts can't overflow
+    uint64_t vertex_bytes = (uint64_t)header->vertex_count * header->vertex_size;
+    uint64_t index_bytes = (uint64_t)header->index_count * header->index_size;
+    if (header->vertex_offset % RXCORE_MESH_FILE_ALIGNMENT != 0 || header->index_offset % RXCORE_MESH_FILE_ALIGNMENT != 0 ||
+        header->vertex_offset < sizeof(rxcore_mesh_file_header_t) || header->index_offset < sizeof(rxcore_mesh_file_header_t) ||
+        header->vertex_offset > file->size || vertex_bytes > file->size - header->vertex_offset ||
+        header->index_offset > file->size || index_bytes > file->size - header->index_offset)
+    {
+        file->error = "vertices or indices outside of the file";
+        return false;
+    }
+
+    for (uint32_t i = 0; i < header->lod_count; i++)
+    {
+        rxcore_mesh_file_lod_t *lod = &header->lods[i];
+        if ((uint64_t)lod->starting_index + lod->index_count > header->index_count || lod->base_vertex > header->vertex_count)
+        {
+            file->error = "lod outside of the file";
+            return false;
+        }
+
+        // raycasts and the occlusion rasterizer read vertices through the indices on the cpu, so an index past the
+        // vertices of its lod would have them read outside of the mesh. Costs a pass over the indices, which the
+        // copy out of the mapping makes anyway
+        const uint32_t *indices = (const uint32_t *)((const uint8_t *)file->memory + header->index_offset) + lod->starting_index;
+        uint32_t vertex_count = _rxcore_mesh_file_get_lod_vertex_count(header, i);
+        for (uint32_t j = 0; j < lod->index_count; j++)
+        {
+            if (indices[j] >= vertex_count)
+            {
+                file->error = "index outside of its lod's vertices";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+#ifdef _WIN32
+
+bool _rxcore_mesh_file_map(const char *file_path, rxcore_mesh_file_t *file)
+{
+    HANDLE handle = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        file->error = "couldn't open the file";
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(handle);
+        file->error = "couldn't get the size of the file";
+        return false;
+    }
+
+    // the mapping keeps the file open, so the handle isn't needed once it exists
+    HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (mapping == NULL)
+    {
+        file->error = "couldn't map the file";
+        return false;
+    }
+
+    file->memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (file->memory == NULL)
+    {
+        CloseHandle(mapping);
+        file->error = "couldn't map the file";
+        return false;
+    }
+
+    file->mapping = mapping;
+    file->size = (size_t)size.QuadPart;
+    return true;
+}
+
+void _rxcore_mesh_file_unmap(rxcore_mesh_file_t *file)
+{
+    UnmapViewOfFile(file->memory);
+    CloseHandle((HANDLE)file->mapping);
+}
+
+#else
+
+bool _rxcore_mesh_file_map(const char *file_path, rxcore_mesh_file_t *file)
+{
+    int fd = open(file_path, O_RDONLY);
+    if (fd < 0)
+    {
+        file->error = "couldn't open the file";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        file->error = "couldn't get the size of the file";
+        return false;
+    }
+
+    // the mapping keeps the file open, so the descriptor isn't needed once it exists
+    void *memory = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        file->error = "couldn't map the file";
+        return false;
+    }
+
+    // it is read once from start to end
+    madvise(memory, (size_t)st.st_size, MADV_SEQUENTIAL);
+    file->memory = memory;
+    file->size = (size_t)st.st_size;
+    return true;
+}
+
+void _rxcore_mesh_file_unmap(rxcore_mesh_file_t *file)
+{
+    munmap(file->memory, file->size);
+}
+
+#endif
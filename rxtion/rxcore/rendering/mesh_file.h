@@ -0,0 +1,94 @@
+#ifndef __MESH_FILE_H__
+#define __MESH_FILE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * The .rxmesh container, which holds a mesh exactly as it sits in a mesh buffer, so that loading it is a copy and nothing more.
+ * Written by tools/rxmesh_convert.c, and depends on nothing else in the engine so the tool can build it on its own.
+ *
+ * Layout:
+ *   rxcore_mesh_file_header_t
+ *   vertices, vertex_count * vertex_size bytes at vertex_offset
+ *   indices, index_count * index_size bytes at index_offset, relative to the first vertex
+ *
+ * Example Usage
+ * rxcore_mesh_file_t file = {0};
+ * if (rxcore_mesh_file_open("assets/meshes/rock.rxmesh", &file))
+ * {
+ *     memcpy(vertices, file.vertices, file.header->vertex_count * file.header->vertex_size);
+ *     rxcore_mesh_file_close(&file);
+ * }
+ */
+
+#define RXCORE_MESH_FILE_MAGIC 0x48534d52u // "RMSH", read as a little endian uint32_t
+#define RXCORE_MESH_FILE_VERSION 1
+#define RXCORE_MESH_FILE_EXTENSION ".rxmesh"
+
+// the same as RXCORE_MESH_MAX_LODS, which this header can't include
+#define RXCORE_MESH_FILE_MAX_LODS 4
+
+// the vertices and indices start on multiples of this, so they can be read straight from the mapping
+#define RXCORE_MESH_FILE_ALIGNMENT 16
+
+/// @brief A range of the file's vertices and indices, like rxcore_mesh_lod_t
+typedef struct rxcore_mesh_file_lod_t
+{
+    uint32_t starting_index;
+    uint32_t index_count;
+    uint32_t base_vertex;
+    float screen_size; // FLT_MAX for the first
+} rxcore_mesh_file_lod_t;
+
+typedef struct rxcore_mesh_file_header_t
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertex_size; // bytes per vertex, files written for a different rxcore_vertex_t are refused
+    uint32_t index_size;  // bytes per index
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t lod_count; // at least 1, lods[0] being the mesh itself
+    uint32_t flags;     // none yet
+    float bounds_min[3]; // of lods[0], in the space of the mesh
+    float bounds_max[3];
+    rxcore_mesh_file_lod_t lods[RXCORE_MESH_FILE_MAX_LODS];
+    uint64_t vertex_offset; // from the start of the file
+    uint64_t index_offset;
+} rxcore_mesh_file_header_t;
+
+/// @brief A file mapped into memory, read only
+typedef struct rxcore_mesh_file_t
+{
+    rxcore_mesh_file_header_t *header;
+    void *vertices;    // header->vertex_count vertices, header->vertex_size bytes each
+    uint32_t *indices; // header->index_count indices
+    void *memory;      // the mapping
+    size_t size;
+    void *mapping; // the file mapping object on windows, unused elsewhere
+    const char *error; // why the file couldn't be opened, a string literal
+} rxcore_mesh_file_t;
+
+/// @brief Maps a file and checks that everything the header describes lies inside it, and that every index of each lod
+/// lies inside that lod's vertices. Files aren't trusted, a corrupt one fails to open rather than being read out of bounds
+/// @param file_out Receives the mapping, or an error if it returns false
+bool rxcore_mesh_file_open(const char *file_path, rxcore_mesh_file_t *file_out);
+void rxcore_mesh_file_close(rxcore_mesh_file_t *file);
+
+/// @brief Writes a file, filling in the magic, version and offsets of the header and padding the blobs to RXCORE_MESH_FILE_ALIGNMENT.
+/// The rest of the header has to be filled in already
+bool rxcore_mesh_file_write(const char *file_path, rxcore_mesh_file_header_t *header, const void *vertices, const uint32_t *indices);
+
+/// @brief The most vertices any lod spans, from its base vertex to that of the next lod or the end of the file,
+/// which is as far as its indices can reach
+uint32_t rxcore_mesh_file_get_max_lod_vertex_count(const rxcore_mesh_file_header_t *header);
+
+// private methods
+bool _rxcore_mesh_file_validate(rxcore_mesh_file_t *file);
+uint32_t _rxcore_mesh_file_get_lod_vertex_count(const rxcore_mesh_file_header_t *header, uint32_t lod);
+bool _rxcore_mesh_file_map(const char *file_path, rxcore_mesh_file_t *file);
+void _rxcore_mesh_file_unmap(rxcore_mesh_file_t *file);
+
+#endif // __MESH_FILE_H__
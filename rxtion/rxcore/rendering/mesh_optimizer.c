@@ -0,0 +1,513 @@
+// mesh_optimizer.c
+
+#include <rxcore/rendering/mesh_optimizer.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// how much of the valence boost of the vertex cache pass is looked up rather than computed, no vertex of a usual mesh has more triangles
+#define RXCORE_MESH_OPTIMIZER_VALENCE_TABLE_SIZE 64
+
+rxcore_mesh_optimizer_stats_t rxcore_mesh_optimizer_analyze(const uint32_t *indices, uint32_t index_count, uint32_t vertex_count)
+{
+    rxcore_mesh_optimizer_stats_t stats = {0};
+    stats.triangle_count = index_count / 3;
+
+    // when each vertex was last transformed, which is all the fifo needs to know whether it is still there
+    uint32_t *timestamps = calloc(vertex_count + 1, sizeof(uint32_t));
+    uint32_t time = RXCORE_MESH_OPTIMIZER_CACHE_SIZE + 1;
+    uint32_t misses = 0;
+    for (uint32_t i = 0; i < stats.triangle_count; i++)
+    {
+        const uint32_t *triangle = indices + i * 3;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            stats.vertex_count += timestamps[triangle[k]] == 0;
+        }
+        misses += _rxcore_mesh_optimizer_cache_triangle(triangle, timestamps, &time);
+    }
+    free(timestamps);
+
+    stats.acmr = stats.triangle_count > 0 ? (float)misses / stats.triangle_count : 0.f;
+    stats.atvr = stats.vertex_count > 0 ? (float)misses / stats.vertex_count : 0.f;
+    return stats;
+}
+
+uint32_t rxcore_mesh_optimizer_optimize(void *vertices, uint32_t vertex_count, size_t vertex_size, uint32_t *indices, uint32_t index_count,
+                                        rxcore_mesh_optimizer_stats_t *before_out, rxcore_mesh_optimizer_stats_t *after_out)
+{
+    if (before_out != NULL)
+    {
+        *before_out = rxcore_mesh_optimizer_analyze(indices, index_count, vertex_count);
+    }
+
+    vertex_count = rxcore_mesh_optimizer_weld(vertices, vertex_count, vertex_size, indices, index_count);
+    rxcore_mesh_optimizer_optimize_vertex_cache(indices, index_count, vertex_count);
+    rxcore_mesh_optimizer_optimize_overdraw(indices, index_count, vertices, vertex_count, vertex_size);
+    vertex_count = rxcore_mesh_optimizer_optimize_vertex_fetch(vertices, vertex_count, vertex_size, indices, index_count);
+
+    if (after_out != NULL)
+    {
+        *after_out = rxcore_mesh_optimizer_analyze(indices, index_count, vertex_count);
+    }
+    return vertex_count;
+}
+
+uint32_t rxcore_mesh_optimizer_weld(void *vertices, uint32_t vertex_count, size_t vertex_size, uint32_t *indices, uint32_t index_count)
+{
+    if (vertex_count == 0)
+    {
+        return 0;
+    }
+
+    // an open addressed table of the vertices kept so far, kept at most half full
+    uint32_t capacity = 1;
+    while (capacity < vertex_count * 2)
+    {
+        capacity *= 2;
+    }
+    uint32_t *table = malloc(sizeof(uint32_t) * capacity);
+    memset(table, 0xff, sizeof(uint32_t) * capacity);
+    uint32_t *remap = malloc(sizeof(uint32_t) * vertex_count);
+
+    // kept vertices are moved down over the merged ones, which is safe as none is moved past where it is read from
+    uint8_t *bytes = vertices;
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        const uint8_t *vertex = bytes + i * vertex_size;
+        uint32_t slot = (uint32_t)_rxcore_mesh_optimizer_hash_vertex(vertex, vertex_size) & (capacity - 1);
+        while (table[slot] != UINT32_MAX && memcmp(bytes + table[slot] * vertex_size, vertex, vertex_size) != 0)
+        {
+            slot = (slot + 1) & (capacity - 1);
+        }
+
+        if (table[slot] == UINT32_MAX)
+        {
+            if (kept != i)
+            {
+                memcpy(bytes + kept * vertex_size, vertex, vertex_size);
+            }
+            table[slot] = kept;
+            remap[i] = kept++;
+        }
+        else
+        {
+            remap[i] = table[slot];
+        }
+    }
+
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        indices[i] = remap[indices[i]];
+    }
+
+    free(table);
+    free(remap);
+    return kept;
+}
+
+void rxcore_mesh_optimizer_optimize_vertex_cache(uint32_t *indices, uint32_t index_count, uint32_t vertex_count)
+{
+    uint32_t triangle_count = index_count / 3;
+    if (triangle_count == 0)
+    {
+        return;
+    }
+
+    // the scores only depend on the cache position and the triangles left, so the common ones are worked out once
+    float cache_scores[RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE];
+    float valence_scores[RXCORE_MESH_OPTIMIZER_VALENCE_TABLE_SIZE];
+    for (uint32_t i = 0; i < RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE; i++)
+    {
+        cache_scores[i] = _rxcore_mesh_optimizer_vertex_score((int32_t)i, 1) - _rxcore_mesh_optimizer_vertex_score(-1, 1);
+    }
+    for (uint32_t i = 0; i < RXCORE_MESH_OPTIMIZER_VALENCE_TABLE_SIZE; i++)
+    {
+        valence_scores[i] = _rxcore_mesh_optimizer_vertex_score(-1, i);
+    }
+
+    // the triangles of each vertex, as ranges of one array. The ones left are kept at the front of each range
+    uint32_t *remaining = calloc(vertex_count, sizeof(uint32_t));
+    uint32_t *offsets = malloc(sizeof(uint32_t) * (vertex_count + 1));
+    uint32_t *adjacency = malloc(sizeof(uint32_t) * triangle_count * 3);
+    for (uint32_t i = 0; i < triangle_count * 3; i++)
+    {
+        remaining[indices[i]]++;
+    }
+    offsets[0] = 0;
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        offsets[v + 1] = offsets[v] + remaining[v];
+        remaining[v] = 0;
+    }
+    for (uint32_t t = 0; t < triangle_count; t++)
+    {
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t v = indices[t * 3 + k];
+            adjacency[offsets[v] + remaining[v]++] = t;
+        }
+    }
+
+    float *vertex_scores = malloc(sizeof(float) * vertex_count);
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        vertex_scores[v] = remaining[v] < RXCORE_MESH_OPTIMIZER_VALENCE_TABLE_SIZE ? valence_scores[remaining[v]] : _rxcore_mesh_optimizer_vertex_score(-1, remaining[v]);
+    }
+
+    float *triangle_scores = malloc(sizeof(float) * triangle_count);
+    uint8_t *emitted = calloc(triangle_count, sizeof(uint8_t));
+    uint32_t best = 0;
+    for (uint32_t t = 0; t < triangle_count; t++)
+    {
+        const uint32_t *triangle = indices + t * 3;
+        triangle_scores[t] = vertex_scores[triangle[0]] + vertex_scores[triangle[1]] + vertex_scores[triangle[2]];
+        best = triangle_scores[t] > triangle_scores[best] ? t : best;
+    }
+
+    uint32_t *output = malloc(sizeof(uint32_t) * triangle_count * 3);
+    uint32_t cache[RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE + 3];
+    uint32_t cache_count = 0;
+    uint32_t next_unemitted = 0;
+    for (uint32_t emitted_count = 0; emitted_count < triangle_count; emitted_count++)
+    {
+        // nothing in the cache has triangles left, so carry on with the next triangle of the input
+        if (best == UINT32_MAX)
+        {
+            while (emitted[next_unemitted])
+            {
+                next_unemitted++;
+            }
+            best = next_unemitted;
+        }
+
+        const uint32_t *triangle = indices + best * 3;
+        memcpy(output + emitted_count * 3, triangle, sizeof(uint32_t) * 3);
+        emitted[best] = 1;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            uint32_t v = triangle[k];
+            uint32_t *triangles = adjacency + offsets[v];
+            for (uint32_t j = 0; j < remaining[v]; j++)
+            {
+                if (triangles[j] == best)
+                {
+                    triangles[j] = triangles[--remaining[v]];
+                    break;
+                }
+            }
+        }
+
+        // the triangle's vertices go to the front of the lru, pushing the last few out
+        uint32_t new_cache[RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE + 3];
+        uint32_t new_count = 0;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            if (new_count == 0 || (new_cache[0] != triangle[k] && new_cache[new_count - 1] != triangle[k]))
+            {
+                new_cache[new_count++] = triangle[k];
+            }
+        }
+        for (uint32_t j = 0; j < cache_count; j++)
+        {
+            uint32_t v = cache[j];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+            {
+                new_cache[new_count++] = v;
+            }
+        }
+
+        // every vertex that moved or fell out is scored again, which moves the scores of its triangles by as much
+        for (uint32_t j = 0; j < new_count; j++)
+        {
+            uint32_t v = new_cache[j];
+            int32_t position = j < RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE ? (int32_t)j : -1;
+
+            float score = -1.f;
+            if (remaining[v] > 0)
+            {
+                score = remaining[v] < RXCORE_MESH_OPTIMIZER_VALENCE_TABLE_SIZE ? valence_scores[remaining[v]] : _rxcore_mesh_optimizer_vertex_score(-1, remaining[v]);
+                score += position >= 0 ? cache_scores[position] : 0.f;
+            }
+            float delta = score - vertex_scores[v];
+            vertex_scores[v] = score;
+
+            const uint32_t *triangles = adjacency + offsets[v];
+            for (uint32_t i = 0; i < remaining[v]; i++)
+            {
+                triangle_scores[triangles[i]] += delta;
+            }
+        }
+
+        // the next triangle is the best one using a vertex still in the cache
+        cache_count = new_count < RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE ? new_count : RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE;
+        memcpy(cache, new_cache, sizeof(uint32_t) * cache_count);
+        best = UINT32_MAX;
+        float best_score = -1.f;
+        for (uint32_t j = 0; j < cache_count; j++)
+        {
+            uint32_t v = cache[j];
+            const uint32_t *triangles = adjacency + offsets[v];
+            for (uint32_t i = 0; i < remaining[v]; i++)
+            {
+                if (triangle_scores[triangles[i]] > best_score)
+                {
+                    best = triangles[i];
+                    best_score = triangle_scores[triangles[i]];
+                }
+            }
+        }
+    }
+
+    // the scoring is a greedy guess, and a mesh already in strip order can come out worse than it went in
+    rxcore_mesh_optimizer_stats_t before = rxcore_mesh_optimizer_analyze(indices, triangle_count * 3, vertex_count);
+    rxcore_mesh_optimizer_stats_t after = rxcore_mesh_optimizer_analyze(output, triangle_count * 3, vertex_count);
+    if (after.acmr < before.acmr)
+    {
+        memcpy(indices, output, sizeof(uint32_t) * triangle_count * 3);
+    }
+    free(remaining);
+    free(offsets);
+    free(adjacency);
+    free(vertex_scores);
+    free(triangle_scores);
+    free(emitted);
+    free(output);
+}
+
+int _rxcore_mesh_optimizer_cluster_compare(const void *a, const void *b)
+{
+    const rxcore_mesh_optimizer_cluster_t *ca = a;
+    const rxcore_mesh_optimizer_cluster_t *cb = b;
+
+    // outward facing first, then in the order they were in, so the sort is stable
+    if (ca->key != cb->key)
+    {
+        return ca->key > cb->key ? -1 : 1;
+    }
+    return ca->start < cb->start ? -1 : ca->start > cb->start;
+}
+
+void rxcore_mesh_optimizer_optimize_overdraw(uint32_t *indices, uint32_t index_count, const void *vertices, uint32_t vertex_count, size_t vertex_size)
+{
+    uint32_t triangle_count = index_count / 3;
+    if (triangle_count == 0 || vertex_count == 0)
+    {
+        return;
+    }
+
+    uint32_t *cluster_starts = malloc(sizeof(uint32_t) * triangle_count);
+    uint32_t cluster_count = _rxcore_mesh_optimizer_split_clusters(indices, index_count, vertex_count, cluster_starts);
+
+    const uint8_t *bytes = vertices;
+    float middle[3] = {0.f, 0.f, 0.f};
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        const float *position = (const float *)(bytes + v * vertex_size);
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            middle[axis] += position[axis] / vertex_count;
+        }
+    }
+
+    // a cluster is as far out as its centre and facing the way of its triangles, both weighed by their area
+    rxcore_mesh_optimizer_cluster_t *clusters = malloc(sizeof(rxcore_mesh_optimizer_cluster_t) * cluster_count);
+    for (uint32_t c = 0; c < cluster_count; c++)
+    {
+        uint32_t start = cluster_starts[c];
+        uint32_t end = c + 1 < cluster_count ? cluster_starts[c + 1] : triangle_count;
+        float centre[3] = {0.f, 0.f, 0.f};
+        float normal[3] = {0.f, 0.f, 0.f};
+        float area = 0.f;
+        for (uint32_t t = start; t < end; t++)
+        {
+            const float *p0 = (const float *)(bytes + indices[t * 3 + 0] * vertex_size);
+            const float *p1 = (const float *)(bytes + indices[t * 3 + 1] * vertex_size);
+            const float *p2 = (const float *)(bytes + indices[t * 3 + 2] * vertex_size);
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            float a = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                centre[axis] += (p0[axis] + p1[axis] + p2[axis]) / 3.f * a;
+                normal[axis] += n[axis];
+            }
+            area += a;
+        }
+
+        float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        float key = 0.f;
+        if (area > 0.f && length > 0.f)
+        {
+            for (uint32_t axis = 0; axis < 3; axis++)
+            {
+                key += (centre[axis] / area - middle[axis]) * normal[axis] / length;
+            }
+        }
+        clusters[c] = (rxcore_mesh_optimizer_cluster_t){.key = key, .start = start, .end = end};
+    }
+
+    qsort(clusters, cluster_count, sizeof(rxcore_mesh_optimizer_cluster_t), _rxcore_mesh_optimizer_cluster_compare);
+
+    uint32_t *output = malloc(sizeof(uint32_t) * triangle_count * 3);
+    uint32_t written = 0;
+    for (uint32_t c = 0; c < cluster_count; c++)
+    {
+        uint32_t count = (clusters[c].end - clusters[c].start) * 3;
+        memcpy(output + written, indices + clusters[c].start * 3, sizeof(uint32_t) * count);
+        written += count;
+    }
+    memcpy(indices, output, sizeof(uint32_t) * written);
+
+    free(cluster_starts);
+    free(clusters);
+    free(output);
+}
+
+uint32_t rxcore_mesh_optimizer_optimize_vertex_fetch(void *vertices, uint32_t vertex_count, size_t vertex_size, uint32_t *indices, uint32_t index_count)
+{
+    if (vertex_count == 0)
+    {
+        return 0;
+    }
+
+    uint32_t *remap = malloc(sizeof(uint32_t) * vertex_count);
+    memset(remap, 0xff, sizeof(uint32_t) * vertex_count);
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < index_count; i++)
+    {
+        uint32_t v = indices[i];
+        if (remap[v] == UINT32_MAX)
+        {
+            remap[v] = used++;
+        }
+        indices[i] = remap[v];
+    }
+
+    // moved through a copy, as the order can go any way
+    uint8_t *bytes = vertices;
+    uint8_t *original = malloc(vertex_size * vertex_count);
+    memcpy(original, bytes, vertex_size * vertex_count);
+    for (uint32_t v = 0; v < vertex_count; v++)
+    {
+        if (remap[v] != UINT32_MAX)
+        {
+            memcpy(bytes + remap[v] * vertex_size, original + v * vertex_size, vertex_size);
+        }
+    }
+
+    free(remap);
+    free(original);
+    return used;
+}
+
+uint64_t _rxcore_mesh_optimizer_hash_vertex(const uint8_t *vertex, size_t vertex_size)
+{
+    // fnv-1a, then the high bits folded down as the table only uses the low ones
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < vertex_size; i++)
+    {
+        hash ^= vertex[i];
+        hash *= 1099511628211ull;
+    }
+    return hash ^ (hash >> 32);
+}
+
+float _rxcore_mesh_optimizer_vertex_score(int32_t cache_position, uint32_t remaining_triangles)
+{
+    if (remaining_triangles == 0)
+    {
+        return -1.f;
+    }
+
+    float score = 0.f;
+    if (cache_position >= 0)
+    {
+        // the last triangle's vertices score the same, so which of them was used first doesn't matter
+        if (cache_position < 3)
+        {
+            score = 0.75f;
+        }
+        else
+        {
+            float scale = 1.f / (RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE - 3);
+            score = powf(1.f - (cache_position - 3) * scale, 1.5f);
+        }
+    }
+
+    // vertices with few triangles left are finished off, rather than left to be transformed again later
+    return score + 2.f * powf((float)remaining_triangles, -0.5f);
+}
+
+uint32_t _rxcore_mesh_optimizer_cache_triangle(const uint32_t *triangle, uint32_t *timestamps, uint32_t *time)
+{
+    // a vertex is still in the fifo until as many others as it holds have been transformed after it
+    uint32_t misses = 0;
+    for (uint32_t k = 0; k < 3; k++)
+    {
+        uint32_t v = triangle[k];
+        if (*time - timestamps[v] > RXCORE_MESH_OPTIMIZER_CACHE_SIZE)
+        {
+            timestamps[v] = (*time)++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+uint32_t _rxcore_mesh_optimizer_split_clusters(const uint32_t *indices, uint32_t index_count, uint32_t vertex_count, uint32_t *cluster_starts)
+{
+    uint32_t triangle_count = index_count / 3;
+    uint32_t *timestamps = calloc(vertex_count, sizeof(uint32_t));
+    uint32_t time = RXCORE_MESH_OPTIMIZER_CACHE_SIZE + 1;
+
+    // the vertex cache pass starts over wherever none of a triangle's vertices are in the cache, and can't be made worse by moving those runs
+    uint32_t *hard_starts = malloc(sizeof(uint32_t) * triangle_count);
+    uint32_t hard_count = 0;
+    for (uint32_t t = 0; t < triangle_count; t++)
+    {
+        if (_rxcore_mesh_optimizer_cache_triangle(indices + t * 3, timestamps, &time) == 3 || t == 0)
+        {
+            hard_starts[hard_count++] = t;
+        }
+    }
+
+    // a run is split further wherever what came before reuses vertices about as well as the whole run,
+    // each piece being measured from an empty cache as it may be drawn after anything
+    uint32_t cluster_count = 0;
+    for (uint32_t h = 0; h < hard_count; h++)
+    {
+        uint32_t start = hard_starts[h];
+        uint32_t end = h + 1 < hard_count ? hard_starts[h + 1] : triangle_count;
+
+        time += RXCORE_MESH_OPTIMIZER_CACHE_SIZE + 1;
+        uint32_t run_misses = 0;
+        for (uint32_t t = start; t < end; t++)
+        {
+            run_misses += _rxcore_mesh_optimizer_cache_triangle(indices + t * 3, timestamps, &time);
+        }
+        float threshold = (float)run_misses / (end - start) * RXCORE_MESH_OPTIMIZER_OVERDRAW_THRESHOLD;
+
+        time += RXCORE_MESH_OPTIMIZER_CACHE_SIZE + 1;
+        uint32_t piece_start = start;
+        uint32_t piece_misses = 0;
+        for (uint32_t t = start; t < end; t++)
+        {
+            piece_misses += _rxcore_mesh_optimizer_cache_triangle(indices + t * 3, timestamps, &time);
+            if (t + 1 < end && (float)piece_misses / (t - piece_start + 1) <= threshold)
+            {
+                cluster_starts[cluster_count++] = piece_start;
+                piece_start = t + 1;
+                piece_misses = 0;
+                time += RXCORE_MESH_OPTIMIZER_CACHE_SIZE + 1;
+            }
+        }
+        cluster_starts[cluster_count++] = piece_start;
+    }
+
+    free(timestamps);
+    free(hard_starts);
+    return cluster_count;
+}
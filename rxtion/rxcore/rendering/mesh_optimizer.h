@@ -0,0 +1,82 @@
+#ifndef __MESH_OPTIMIZER_H__
+#define __MESH_OPTIMIZER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Reorders a mesh so the gpu does less work drawing it, without changing what is drawn. Run once when a mesh is
+ * converted or loaded, not every frame. Vertices are taken as vertex_size bytes each, starting with the position as
+ * three floats, so it works on rxcore_vertex_t and depends on nothing else in the engine, like the mesh files.
+ *
+ * The passes, in the order rxcore_mesh_optimizer_optimize runs them:
+ *   weld          merges vertices whose bytes are all the same, so the ones shared between triangles are shaded once
+ *   vertex cache  orders the triangles so their vertices are still in the post transform cache when used again (Forsyth)
+ *   overdraw      orders clusters of those triangles outside in, so nearer surfaces are drawn first (Sander et al.)
+ *   vertex fetch  orders the vertices as the triangles first use them, so they are read from memory in order
+ *
+ * Example Usage
+ * rxcore_mesh_optimizer_stats_t before, after;
+ * vertex_count = rxcore_mesh_optimizer_optimize(vertices, vertex_count, sizeof(rxcore_vertex_t), indices, index_count, &before, &after);
+ */
+
+// the fifo cache the meshes are measured against, about what current gpus reuse
+#define RXCORE_MESH_OPTIMIZER_CACHE_SIZE 16
+
+// the lru cache the vertex cache pass scores vertices with, larger than the measured one so it keeps working on bigger ones
+#define RXCORE_MESH_OPTIMIZER_SCORING_CACHE_SIZE 32
+
+// how much worse than its whole cluster a piece of it may reuse vertices, for it to be drawn on its own by the overdraw pass.
+// Higher splits the mesh into more clusters, which sort better and reuse worse
+#define RXCORE_MESH_OPTIMIZER_OVERDRAW_THRESHOLD 1.05f
+
+/// @brief A run of triangles the overdraw pass moves as one
+typedef struct rxcore_mesh_optimizer_cluster_t
+{
+    float key; // how far the cluster faces away from the middle of the mesh
+    uint32_t start; // in triangles
+    uint32_t end;
+} rxcore_mesh_optimizer_cluster_t;
+
+/// @brief How well a mesh reuses transformed vertices, simulated with a fifo cache of RXCORE_MESH_OPTIMIZER_CACHE_SIZE
+typedef struct rxcore_mesh_optimizer_stats_t
+{
+    float acmr; // average cache miss ratio, vertices transformed per triangle. 3 at worst, about 0.5 for a regular grid at best
+    float atvr; // average transform to vertex ratio, vertices transformed per vertex used. 1 at best
+    uint32_t vertex_count; // of the vertices the indices use
+    uint32_t triangle_count;
+} rxcore_mesh_optimizer_stats_t;
+
+rxcore_mesh_optimizer_stats_t rxcore_mesh_optimizer_analyze(const uint32_t *indices, uint32_t index_count, uint32_t vertex_count);
+
+/// @brief Runs every pass
+/// @param before_out Receives the stats of the mesh as it was, can be NULL. The same goes for after_out
+/// @return The number of vertices left, all at the start of the array
+uint32_t rxcore_mesh_optimizer_optimize(void *vertices, uint32_t vertex_count, size_t vertex_size, uint32_t *indices, uint32_t index_count,
+                                        rxcore_mesh_optimizer_stats_t *before_out, rxcore_mesh_optimizer_stats_t *after_out);
+
+/// @brief Merges vertices that are the same byte for byte, rewriting the indices to the ones kept
+/// @return The number of vertices left, all at the start of the array in the order they were first seen
+uint32_t rxcore_mesh_optimizer_weld(void *vertices, uint32_t vertex_count, size_t vertex_size, uint32_t *indices, uint32_t index_count);
+
+/// @brief Reorders the triangles for the post transform cache, keeping the winding of each. The order is left as it was
+/// unless the new one has a lower acmr
+void rxcore_mesh_optimizer_optimize_vertex_cache(uint32_t *indices, uint32_t index_count, uint32_t vertex_count);
+
+/// @brief Reorders clusters of triangles so that those facing out from the middle of the mesh are drawn first. Expects
+/// triangles already ordered by rxcore_mesh_optimizer_optimize_vertex_cache, whose runs it keeps together
+void rxcore_mesh_optimizer_optimize_overdraw(uint32_t *indices, uint32_t index_count, const void *vertices, uint32_t vertex_count, size_t vertex_size);
+
+/// @brief Reorders the vertices by when the indices first use them, dropping those they don't
+/// @return The number of vertices left
+uint32_t rxcore_mesh_optimizer_optimize_vertex_fetch(void *vertices, uint32_t vertex_count, size_t vertex_size, uint32_t *indices, uint32_t index_count);
+
+// private methods
+uint64_t _rxcore_mesh_optimizer_hash_vertex(const uint8_t *vertex, size_t vertex_size);
+float _rxcore_mesh_optimizer_vertex_score(int32_t cache_position, uint32_t remaining_triangles);
+uint32_t _rxcore_mesh_optimizer_cache_triangle(const uint32_t *triangle, uint32_t *timestamps, uint32_t *time);
+int _rxcore_mesh_optimizer_cluster_compare(const void *a, const void *b);
+uint32_t _rxcore_mesh_optimizer_split_clusters(const uint32_t *indices, uint32_t index_count, uint32_t vertex_count, uint32_t *cluster_starts);
+
+#endif // __MESH_OPTIMIZER_H__
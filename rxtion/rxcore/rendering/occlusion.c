@@ -0,0 +1,425 @@
+// occlusion.c
+
+#include <rxcore/rendering/occlusion.h>
+#include <rxcore/profiler.h>
+#include <float.h>
+
+#ifdef RXCORE_OCCLUSION_SSE
+#include <emmintrin.h>
+#endif
+
+rxcore_occlusion_buffer_t *rxcore_occlusion_buffer_create(uint32_t width, uint32_t height)
+{
+    assert(width % RXCORE_OCCLUSION_TILE_SIZE == 0 && height % RXCORE_OCCLUSION_TILE_SIZE == 0);
+
+    rxcore_occlusion_buffer_t *buffer = malloc(sizeof(rxcore_occlusion_buffer_t));
+    memset(buffer, 0, sizeof(rxcore_occlusion_buffer_t));
+    buffer->width = width;
+    buffer->height = height;
+    buffer->tiles_x = width / RXCORE_OCCLUSION_TILE_SIZE;
+    buffer->tiles_y = height / RXCORE_OCCLUSION_TILE_SIZE;
+
+    // both buffers share one allocation, the rows of the depth buffer are whole groups of 4 so the rasterizer can load them aligned
+    buffer->memory = malloc(sizeof(float) * (width * height + buffer->tiles_x * buffer->tiles_y) + 16);
+    buffer->depth = (float *)(((uintptr_t)buffer->memory + 15) & ~(uintptr_t)15);
+    buffer->hiz = buffer->depth + width * height;
+
+    rxcore_occlusion_buffer_begin(buffer, gs_mat4_identity());
+    return buffer;
+}
+
+void rxcore_occlusion_buffer_begin(rxcore_occlusion_buffer_t *buffer, gs_mat4 view_projection)
+{
+    buffer->view_projection = view_projection;
+    buffer->triangles_rasterized = 0;
+    buffer->has_occluders = false;
+
+    uint32_t pixel_count = buffer->width * buffer->height;
+    for (uint32_t i = 0; i < pixel_count; i++)
+    {
+        buffer->depth[i] = 1.f;
+    }
+}
+
+void rxcore_occlusion_buffer_add_triangles(rxcore_occlusion_buffer_t *buffer, gs_vec3 *positions, uint32_t stride, uint32_t *indices, uint32_t index_count, gs_mat4 world_matrix)
+{
+    gs_mat4 mvp = gs_mat4_mul(buffer->view_projection, world_matrix);
+    uint8_t *base = (uint8_t *)positions;
+
+    for (uint32_t i = 0; i + 2 < index_count; i += 3)
+    {
+        gs_vec4 clip[3];
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            gs_vec3 p = *(gs_vec3 *)(base + (size_t)indices[i + v] * stride);
+            clip[v] = gs_mat4_mul_vec4(mvp, gs_v4(p.x, p.y, p.z, 1.f));
+        }
+
+        _rxcore_occlusion_buffer_clip_triangle(buffer, clip[0], clip[1], clip[2]);
+    }
+
+    buffer->has_occluders = true;
+}
+
+void rxcore_occlusion_buffer_add_box(rxcore_occlusion_buffer_t *buffer, rxcore_bounding_box_t *box, gs_mat4 world_matrix)
+{
+    // corner i has the max of the axes whose bit is set, x being bit 0
+    gs_vec3 corners[8];
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        corners[i] = gs_v3(
+            i & 1 ? box->max.x : box->min.x,
+            i & 2 ? box->max.y : box->min.y,
+            i & 4 ? box->max.z : box->min.z);
+    }
+
+    static uint32_t indices[36] = {
+        0, 1, 3, 0, 3, 2, // -z
+        4, 6, 7, 4, 7, 5, // +z
+        0, 4, 5, 0, 5, 1, // -y
+        2, 3, 7, 2, 7, 6, // +y
+        0, 2, 6, 0, 6, 4, // -x
+        1, 5, 7, 1, 7, 3, // +x
+    };
+
+    rxcore_occlusion_buffer_add_triangles(buffer, corners, sizeof(gs_vec3), indices, 36, world_matrix);
+}
+
+void rxcore_occlusion_buffer_end(rxcore_occlusion_buffer_t *buffer)
+{
+    // each tile keeps the farthest depth in it, anything nearer than that can't be hidden anywhere in the tile
+    for (uint32_t ty = 0; ty < buffer->tiles_y; ty++)
+    {
+        for (uint32_t tx = 0; tx < buffer->tiles_x; tx++)
+        {
+            float farthest = 0.f;
+            for (uint32_t y = 0; y < RXCORE_OCCLUSION_TILE_SIZE; y++)
+            {
+                float *row = buffer->depth + (ty * RXCORE_OCCLUSION_TILE_SIZE + y) * buffer->width + tx * RXCORE_OCCLUSION_TILE_SIZE;
+                for (uint32_t x = 0; x < RXCORE_OCCLUSION_TILE_SIZE; x++)
+                {
+                    farthest = gs_max(farthest, row[x]);
+                }
+            }
+            buffer->hiz[ty * buffer->tiles_x + tx] = farthest;
+        }
+    }
+}
+
+bool rxcore_occlusion_buffer_test_aabb(rxcore_occlusion_buffer_t *buffer, rxcore_bounding_box_t *box)
+{
+    if (!buffer->has_occluders)
+    {
+        return true;
+    }
+
+    // the screen rectangle of the box, and the nearest depth of any part of it
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX, min_z = FLT_MAX;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        gs_vec4 corner = gs_v4(
+            i & 1 ? box->max.x : box->min.x,
+            i & 2 ? box->max.y : box->min.y,
+            i & 4 ? box->max.z : box->min.z,
+            1.f);
+        gs_vec4 clip = gs_mat4_mul_vec4(buffer->view_projection, corner);
+
+        // part of the box is behind the camera, where its rectangle can't be known
+        if (clip.w < RXCORE_OCCLUSION_NEAR_W)
+        {
+            return true;
+        }
+
+        float inv_w = 1.f / clip.w;
+        min_x = gs_min(min_x, clip.x * inv_w);
+        max_x = gs_max(max_x, clip.x * inv_w);
+        min_y = gs_min(min_y, clip.y * inv_w);
+        max_y = gs_max(max_y, clip.y * inv_w);
+        min_z = gs_min(min_z, clip.z * inv_w);
+    }
+
+    // every pixel the rectangle touches, not just the ones whose centers it covers. off the screen nothing was rasterized to hide it,
+    // leaving it to the frustum to cull
+    float screen_min_x = (min_x * 0.5f + 0.5f) * buffer->width;
+    float screen_max_x = (max_x * 0.5f + 0.5f) * buffer->width;
+    float screen_min_y = (min_y * 0.5f + 0.5f) * buffer->height;
+    float screen_max_y = (max_y * 0.5f + 0.5f) * buffer->height;
+    if (screen_max_x < 0.f || screen_max_y < 0.f || screen_min_x >= (float)buffer->width || screen_min_y >= (float)buffer->height)
+    {
+        return true;
+    }
+
+    // a pixel on the edge of an occluder is written if its center is covered, though the box may show through the rest of it.
+    // the pixel beyond that part always has its center outside the occluder, so testing one more pixel all round keeps this conservative
+    int32_t x0 = gs_max((int32_t)floorf(screen_min_x) - 1, 0);
+    int32_t y0 = gs_max((int32_t)floorf(screen_min_y) - 1, 0);
+    int32_t x1 = gs_min((int32_t)floorf(screen_max_x) + 1, (int32_t)buffer->width - 1);
+    int32_t y1 = gs_min((int32_t)floorf(screen_max_y) + 1, (int32_t)buffer->height - 1);
+    float nearest = min_z * 0.5f + 0.5f;
+
+    // the tiles rule most boxes out, only tiles that might let the box through are looked at pixel by pixel
+    for (int32_t ty = y0 / RXCORE_OCCLUSION_TILE_SIZE; ty <= y1 / RXCORE_OCCLUSION_TILE_SIZE; ty++)
+    {
+        for (int32_t tx = x0 / RXCORE_OCCLUSION_TILE_SIZE; tx <= x1 / RXCORE_OCCLUSION_TILE_SIZE; tx++)
+        {
+            if (nearest > buffer->hiz[ty * buffer->tiles_x + tx])
+            {
+                continue;
+            }
+
+            int32_t py0 = gs_max(y0, ty * RXCORE_OCCLUSION_TILE_SIZE);
+            int32_t py1 = gs_min(y1, ty * RXCORE_OCCLUSION_TILE_SIZE + RXCORE_OCCLUSION_TILE_SIZE - 1);
+            int32_t px0 = gs_max(x0, tx * RXCORE_OCCLUSION_TILE_SIZE);
+            int32_t px1 = gs_min(x1, tx * RXCORE_OCCLUSION_TILE_SIZE + RXCORE_OCCLUSION_TILE_SIZE - 1);
+            for (int32_t y = py0; y <= py1; y++)
+            {
+                float *row = buffer->depth + y * buffer->width;
+                for (int32_t x = px0; x <= px1; x++)
+                {
+                    if (nearest <= row[x])
+                    {
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+void rxcore_occlusion_buffer_test_aabbs(rxcore_occlusion_buffer_t *buffer, rxcore_jobs_t *jobs, rxcore_bounding_box_t *boxes, uint32_t count, uint8_t *visible_out)
+{
+    rxcore_occlusion_job_t job = {
+        .buffer = buffer,
+        .boxes = boxes,
+        .visible_out = visible_out,
+    };
+
+    uint32_t worker_count = jobs != NULL ? rxcore_jobs_get_worker_count(jobs) : 1;
+    if (worker_count == 1 || count < RXCORE_OCCLUSION_MIN_CHUNK_SIZE * 2)
+    {
+        _rxcore_occlusion_job(&job, 0, count, 0);
+        return;
+    }
+
+    uint32_t chunk_size = gs_max((count + worker_count - 1) / worker_count, RXCORE_OCCLUSION_MIN_CHUNK_SIZE);
+    rxcore_jobs_parallel_for(jobs, count, chunk_size, _rxcore_occlusion_job, &job);
+}
+
+void rxcore_occlusion_buffer_destroy(rxcore_occlusion_buffer_t *buffer)
+{
+    free(buffer->memory);
+    free(buffer);
+}
+
+const char *rxcore_occlusion_get_implementation_name()
+{
+#ifdef RXCORE_OCCLUSION_SSE
+    return "sse";
+#else
+    return "scalar";
+#endif
+}
+
+void _rxcore_occlusion_buffer_clip_triangle(rxcore_occlusion_buffer_t *buffer, gs_vec4 a, gs_vec4 b, gs_vec4 c)
+{
+    // entirely outside one of the side planes, so nothing would be drawn
+    if ((a.x > a.w && b.x > b.w && c.x > c.w) || (a.x < -a.w && b.x < -b.w && c.x < -c.w) ||
+        (a.y > a.w && b.y > b.w && c.y > c.w) || (a.y < -a.w && b.y < -b.w && c.y < -c.w))
+    {
+        return;
+    }
+
+    // only what the gpu draws may hide anything, so the triangle is clipped at the near plane, z = -w, as the gpu clips it.
+    // The part between the camera and that plane isn't drawn, stepping into a wall shouldn't hide what is behind it
+    float distance[3] = {a.z + a.w, b.z + b.w, c.z + c.w};
+    bool inside[3] = {distance[0] >= 0.f, distance[1] >= 0.f, distance[2] >= 0.f};
+    if (inside[0] && inside[1] && inside[2])
+    {
+        _rxcore_occlusion_buffer_rasterize_triangle(buffer, a, b, c);
+        return;
+    }
+    if (!inside[0] && !inside[1] && !inside[2])
+    {
+        return;
+    }
+
+    // cut the triangle at the near plane, which leaves a triangle or a quad
+    gs_vec4 in[3] = {a, b, c};
+    gs_vec4 out[4];
+    uint32_t out_count = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        gs_vec4 from = in[i];
+        gs_vec4 to = in[(i + 1) % 3];
+        bool from_inside = inside[i];
+        bool to_inside = inside[(i + 1) % 3];
+
+        if (from_inside)
+        {
+            out[out_count++] = from;
+        }
+        if (from_inside != to_inside)
+        {
+            float t = distance[i] / (distance[i] - distance[(i + 1) % 3]);
+            out[out_count++] = gs_vec4_add(from, gs_vec4_scale(gs_vec4_sub(to, from), t));
+        }
+    }
+
+    for (uint32_t i = 1; i + 1 < out_count; i++)
+    {
+        _rxcore_occlusion_buffer_rasterize_triangle(buffer, out[0], out[i], out[i + 1]);
+    }
+}
+
+void _rxcore_occlusion_buffer_rasterize_triangle(rxcore_occlusion_buffer_t *buffer, gs_vec4 a, gs_vec4 b, gs_vec4 c)
+{
+    // into pixels, with depth remapped to [0, 1]
+    float w = (float)buffer->width;
+    float h = (float)buffer->height;
+    float ax = (a.x / a.w * 0.5f + 0.5f) * w, ay = (a.y / a.w * 0.5f + 0.5f) * h, az = a.z / a.w * 0.5f + 0.5f;
+    float bx = (b.x / b.w * 0.5f + 0.5f) * w, by = (b.y / b.w * 0.5f + 0.5f) * h, bz = b.z / b.w * 0.5f + 0.5f;
+    float cx = (c.x / c.w * 0.5f + 0.5f) * w, cy = (c.y / c.w * 0.5f + 0.5f) * h, cz = c.z / c.w * 0.5f + 0.5f;
+
+    float area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    if (fabsf(area) < 1e-6f)
+    {
+        return;
+    }
+
+    // occluders aren't backface culled, just wound the same way so the edge functions agree on what inside is
+    if (area < 0.f)
+    {
+        float tx = bx, ty = by, tz = bz;
+        bx = cx, by = cy, bz = cz;
+        cx = tx, cy = ty, cz = tz;
+        area = -area;
+    }
+
+    int32_t min_x = gs_max((int32_t)floorf(gs_min(ax, gs_min(bx, cx))), 0);
+    int32_t min_y = gs_max((int32_t)floorf(gs_min(ay, gs_min(by, cy))), 0);
+    int32_t max_x = gs_min((int32_t)ceilf(gs_max(ax, gs_max(bx, cx))), (int32_t)buffer->width - 1);
+    int32_t max_y = gs_min((int32_t)ceilf(gs_max(ay, gs_max(by, cy))), (int32_t)buffer->height - 1);
+    if (min_x > max_x || min_y > max_y)
+    {
+        return;
+    }
+
+    // edge functions e = A * x + B * y + C, positive inside, for the edges a->b, b->c and c->a
+    float vx[3] = {ax, bx, cx};
+    float vy[3] = {ay, by, cy};
+    // pixels are covered when their center is, like the gpu does, so triangles sharing an edge leave no cracks between them
+    float edges[9];
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        uint32_t j = (i + 1) % 3;
+        edges[i * 3 + 0] = -(vy[j] - vy[i]);
+        edges[i * 3 + 1] = vx[j] - vx[i];
+        edges[i * 3 + 2] = -(edges[i * 3 + 0] * vx[i] + edges[i * 3 + 1] * vy[i]);
+    }
+
+    // depth is linear in screen space, the weight of b comes from the edge across from it (c->a) and the weight of c from a->b
+    float inv_area = 1.f / area;
+    float db = (bz - az) * inv_area;
+    float dc = (cz - az) * inv_area;
+    float depth_plane[3];
+    depth_plane[0] = db * edges[6] + dc * edges[0];
+    depth_plane[1] = db * edges[7] + dc * edges[1];
+    depth_plane[2] = az + db * edges[8] + dc * edges[2];
+
+    // and the farthest the depth gets anywhere in the pixel, rather than at its center
+    depth_plane[2] += 0.5f * (fabsf(depth_plane[0]) + fabsf(depth_plane[1]));
+
+    _rxcore_occlusion_buffer_fill_rows(buffer, min_x, max_x, min_y, max_y, edges, depth_plane);
+    buffer->triangles_rasterized++;
+}
+
+void _rxcore_occlusion_buffer_fill_rows(rxcore_occlusion_buffer_t *buffer, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y, float *edges, float *depth_plane)
+{
+#ifdef RXCORE_OCCLUSION_SSE
+    _rxcore_occlusion_buffer_fill_rows_sse(buffer, min_x, max_x, min_y, max_y, edges, depth_plane);
+#else
+    _rxcore_occlusion_buffer_fill_rows_scalar(buffer, min_x, max_x, min_y, max_y, edges, depth_plane);
+#endif
+}
+
+void _rxcore_occlusion_buffer_fill_rows_scalar(rxcore_occlusion_buffer_t *buffer, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y, float *edges, float *depth_plane)
+{
+    for (int32_t y = min_y; y <= max_y; y++)
+    {
+        float py = (float)y + 0.5f;
+        float *row = buffer->depth + y * buffer->width;
+        for (int32_t x = min_x; x <= max_x; x++)
+        {
+            float px = (float)x + 0.5f;
+            if (edges[0] * px + edges[1] * py + edges[2] < 0.f ||
+                edges[3] * px + edges[4] * py + edges[5] < 0.f ||
+                edges[6] * px + edges[7] * py + edges[8] < 0.f)
+            {
+                continue;
+            }
+
+            float z = depth_plane[0] * px + depth_plane[1] * py + depth_plane[2];
+            row[x] = gs_min(row[x], z);
+        }
+    }
+}
+
+#ifdef RXCORE_OCCLUSION_SSE
+void _rxcore_occlusion_buffer_fill_rows_sse(rxcore_occlusion_buffer_t *buffer, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y, float *edges, float *depth_plane)
+{
+    // 4 pixels at a time, starting on a group boundary so the loads and stores are aligned.
+    // pixels of the group outside the bounding box are still tested against the edges, so they are only written if covered
+    int32_t start_x = min_x & ~3;
+    __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    __m128 step_x = _mm_set1_ps(4.f);
+    __m128 zero = _mm_setzero_ps();
+
+    __m128 a0 = _mm_set1_ps(edges[0]), b0 = _mm_set1_ps(edges[1]), c0 = _mm_set1_ps(edges[2]);
+    __m128 a1 = _mm_set1_ps(edges[3]), b1 = _mm_set1_ps(edges[4]), c1 = _mm_set1_ps(edges[5]);
+    __m128 a2 = _mm_set1_ps(edges[6]), b2 = _mm_set1_ps(edges[7]), c2 = _mm_set1_ps(edges[8]);
+    __m128 za = _mm_set1_ps(depth_plane[0]), zb = _mm_set1_ps(depth_plane[1]), zc = _mm_set1_ps(depth_plane[2]);
+
+    for (int32_t y = min_y; y <= max_y; y++)
+    {
+        __m128 py = _mm_set1_ps((float)y + 0.5f);
+        __m128 px = _mm_add_ps(_mm_set1_ps((float)start_x), offsets);
+
+        // the parts of each function that are the same along the row
+        __m128 row0 = _mm_add_ps(_mm_mul_ps(b0, py), c0);
+        __m128 row1 = _mm_add_ps(_mm_mul_ps(b1, py), c1);
+        __m128 row2 = _mm_add_ps(_mm_mul_ps(b2, py), c2);
+        __m128 rowz = _mm_add_ps(_mm_mul_ps(zb, py), zc);
+
+        float *row = buffer->depth + y * buffer->width;
+        for (int32_t x = start_x; x <= max_x; x += 4)
+        {
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+            if (_mm_movemask_ps(inside))
+            {
+                __m128 z = _mm_add_ps(_mm_mul_ps(za, px), rowz);
+                __m128 current = _mm_load_ps(row + x);
+                __m128 nearer = _mm_min_ps(current, z);
+                _mm_store_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+            }
+
+            px = _mm_add_ps(px, step_x);
+        }
+    }
+}
+
+#endif
+
+void _rxcore_occlusion_job(void *data, uint32_t start, uint32_t end, uint32_t worker)
+{
+    rxcore_occlusion_job_t *job = data;
+    for (uint32_t i = start; i < end; i++)
+    {
+        job->visible_out[i] = rxcore_occlusion_buffer_test_aabb(job->buffer, &job->boxes[i]);
+    }
+}
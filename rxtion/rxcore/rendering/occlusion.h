@@ -0,0 +1,109 @@
+#ifndef __OCCLUSION_H__
+#define __OCCLUSION_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rxcore/bounding_box.h>
+#include <rxcore/jobs.h>
+#include <rxcore/log.h>
+
+// #define RXCORE_OCCLUSION_DEBUG
+
+#ifdef RXCORE_OCCLUSION_DEBUG
+#define RXCORE_OCCLUSION_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("rendering::occlusion", str)
+#define RXCORE_OCCLUSION_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("rendering::occlusion", str, __VA_ARGS__)
+#else
+#define RXCORE_OCCLUSION_DEBUG_PRINT(...) ((void)0)
+#define RXCORE_OCCLUSION_DEBUG_PRINTF(...) ((void)0)
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RXCORE_OCCLUSION_SSE
+#endif
+
+// the resolution occluders are rasterized at, small enough to fill every frame on one core
+#define RXCORE_OCCLUSION_WIDTH 256
+#define RXCORE_OCCLUSION_HEIGHT 128
+
+// each texel of the hierarchical depth covers a square of this many pixels
+#define RXCORE_OCCLUSION_TILE_SIZE 8
+
+// boxes with a corner closer to the camera than this, in clip space w, are taken to be visible. Occluders are clipped at the near plane
+#define RXCORE_OCCLUSION_NEAR_W 1e-3f
+
+// below this many boxes, testing isn't worth spreading across the job system
+#define RXCORE_OCCLUSION_MIN_CHUNK_SIZE 1024
+
+/**
+ * Example Usage
+ * rxcore_occlusion_buffer_begin(buffer, view_projection);
+ * rxcore_occlusion_buffer_add_box(buffer, &wall_bounds, wall_matrix);
+ * rxcore_occlusion_buffer_end(buffer);
+ * if (rxcore_occlusion_buffer_test_aabb(buffer, &bounds)) draw(...);
+ */
+
+/// @brief A depth buffer that occluders are rasterized into on the CPU, and a coarser one holding the farthest depth of each tile.
+/// Depths are normalized device z remapped to [0, 1], 1 being the far plane
+typedef struct rxcore_occlusion_buffer_t
+{
+    uint32_t width;  // a multiple of RXCORE_OCCLUSION_TILE_SIZE
+    uint32_t height; // a multiple of RXCORE_OCCLUSION_TILE_SIZE
+    uint32_t tiles_x;
+    uint32_t tiles_y;
+    float *depth; // width * height, row major, 16 byte aligned
+    float *hiz;   // tiles_x * tiles_y, the farthest depth in each tile
+    void *memory; // the unaligned allocation the buffers live in
+    gs_mat4 view_projection;
+    uint32_t triangles_rasterized;
+    bool has_occluders; // nothing is ever occluded until something has been rasterized
+} rxcore_occlusion_buffer_t;
+
+/// @brief The state of a parallel test of many boxes
+typedef struct rxcore_occlusion_job_t
+{
+    rxcore_occlusion_buffer_t *buffer;
+    rxcore_bounding_box_t *boxes;
+    uint8_t *visible_out;
+} rxcore_occlusion_job_t;
+
+rxcore_occlusion_buffer_t *rxcore_occlusion_buffer_create(uint32_t width, uint32_t height);
+
+/// @brief Clears the buffer for a new frame
+void rxcore_occlusion_buffer_begin(rxcore_occlusion_buffer_t *buffer, gs_mat4 view_projection);
+
+/// @brief Rasterizes indexed triangles, which may be wound either way
+/// @param positions The first position, each following one stride bytes further on
+/// @param indices Offsets from positions, three per triangle
+void rxcore_occlusion_buffer_add_triangles(rxcore_occlusion_buffer_t *buffer, gs_vec3 *positions, uint32_t stride, uint32_t *indices, uint32_t index_count, gs_mat4 world_matrix);
+
+/// @brief Rasterizes a box, for occluders whose mesh would be too detailed to be worth drawing
+void rxcore_occlusion_buffer_add_box(rxcore_occlusion_buffer_t *buffer, rxcore_bounding_box_t *box, gs_mat4 world_matrix);
+
+/// @brief Builds the hierarchical depth, after which boxes can be tested. Safe to call from a job, as it reports nothing to the profiler
+void rxcore_occlusion_buffer_end(rxcore_occlusion_buffer_t *buffer);
+
+/// @return false only if every part of the box is behind what has been rasterized
+bool rxcore_occlusion_buffer_test_aabb(rxcore_occlusion_buffer_t *buffer, rxcore_bounding_box_t *box);
+
+/// @brief Tests many boxes across the job system
+/// @param jobs May be NULL, in which case everything runs on the calling thread
+/// @param visible_out Receives 1 for each box that may be visible, and 0 for each that is occluded
+void rxcore_occlusion_buffer_test_aabbs(rxcore_occlusion_buffer_t *buffer, rxcore_jobs_t *jobs, rxcore_bounding_box_t *boxes, uint32_t count, uint8_t *visible_out);
+
+void rxcore_occlusion_buffer_destroy(rxcore_occlusion_buffer_t *buffer);
+
+/// @brief The name of the instruction set the rasterizer uses, for reports
+const char *rxcore_occlusion_get_implementation_name();
+
+// private methods
+void _rxcore_occlusion_buffer_clip_triangle(rxcore_occlusion_buffer_t *buffer, gs_vec4 a, gs_vec4 b, gs_vec4 c);
+void _rxcore_occlusion_buffer_rasterize_triangle(rxcore_occlusion_buffer_t *buffer, gs_vec4 a, gs_vec4 b, gs_vec4 c);
+void _rxcore_occlusion_buffer_fill_rows(rxcore_occlusion_buffer_t *buffer, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y, float *edges, float *depth_plane);
+void _rxcore_occlusion_buffer_fill_rows_scalar(rxcore_occlusion_buffer_t *buffer, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y, float *edges, float *depth_plane);
+#ifdef RXCORE_OCCLUSION_SSE
+void _rxcore_occlusion_buffer_fill_rows_sse(rxcore_occlusion_buffer_t *buffer, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y, float *edges, float *depth_plane);
+#endif
+void _rxcore_occlusion_job(void *data, uint32_t start, uint32_t end, uint32_t worker);
+
+#endif // __OCCLUSION_H__
@@ -8,58 +8,103 @@
 #include <rxcore/rendering/shader.h>
 #include <rxcore/rendering/render_group.h>
 
-rxcore_pipeline_t *rxcore_pipeline_create(gs_graphics_pipeline_desc_t pipeline_desc)
+rxcore_pipeline_t *rxcore_pipeline_create(rxcore_shader_registry_t *shader_registry, rxcore_pso_key_t default_key)
 {
     rxcore_pipeline_t *pipeline = malloc(sizeof(rxcore_pipeline_t));
-    pipeline->pipeline_hndl = gs_graphics_pipeline_create(&pipeline_desc);
-    pipeline->render_passes = NULL;
-    pipeline->render_pass_data = NULL;
-    pipeline->render_pass_count = 0;
+    pipeline->pso_cache = rxcore_pso_cache_create(shader_registry);
+    pipeline->default_pso = rxcore_pso_cache_get(pipeline->pso_cache, &default_key);
+    if (pipeline->default_pso == NULL)
+    {
+        // every view pass binds the default pipeline before anything else, so nothing can be drawn without it
+        RXCORE_LOG_ERROR("rendering::pipeline", "Failed to create the pipeline, the default shader program couldn't be built");
+        rxcore_pso_cache_destroy(pipeline->pso_cache);
+        free(pipeline);
+        return NULL;
+    }
+    pipeline->frame_graph = rxcore_frame_graph_create();
+    pipeline->chunks = gs_dyn_array_new(rxcore_pipeline_chunk_t);
+    pipeline->views = gs_dyn_array_new(rxcore_render_view_t *);
+    pipeline->view_passes = gs_dyn_array_new(uint32_t);
+    pipeline->ctx = NULL;
+
+    // the model matrix is bound for every draw, so the uniform is only created once
+    pipeline->model_uniform = gs_graphics_uniform_create(
+        &(gs_graphics_uniform_desc_t){
+            .stage = GS_GRAPHICS_SHADER_STAGE_VERTEX,
+            .name = "u_model",
+            .layout = &(gs_graphics_uniform_layout_desc_t){
+                .type = GS_GRAPHICS_UNIFORM_MAT4,
+            },
+        });
+
+    // the main view draws straight into the backbuffer until a target is set
+    rxcore_pipeline_add_view(pipeline, (rxcore_render_view_desc_t){
+        .name = "scene",
+        .camera = 0,
+        .target = RXCORE_RENDER_TARGET_BACKBUFFER,
+        .clear_color = gs_v4(0.1f, 0.1f, 0.1f, 1.f),
+        .use_occlusion = true,
+    });
+
     return pipeline;
 }
 
 rxcore_pipeline_t *rxcore_pipeline_default(rxcore_shader_registry_t *shader_registry)
 {
-    gs_graphics_pipeline_desc_t pipeline_desc = {
-        .raster = {
-            .face_culling = GS_GRAPHICS_FACE_CULLING_BACK,
-            .index_buffer_element_size = sizeof(uint32_t),
-            .winding_order = GS_GRAPHICS_WINDING_ORDER_CCW,
-            .shader = (rxcore_shader_program_set(
-                           rxcore_shader_registry_get_shader_set(
-                               shader_registry,
-                               RXCORE_SHADER_SET_UNLIT_DEFAULT))
-                           ->program),
-            .primitive = GS_GRAPHICS_PRIMITIVE_TRIANGLES,
-        },
-        .layout = {
-            .attrs = (gs_graphics_vertex_attribute_desc_t[]){
-                {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT3, .name = "a_position"},
-                {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT3, .name = "a_normal"},
-                {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT2, .name = "a_uv"},
-            },
-            .size = 3 * sizeof(gs_graphics_vertex_attribute_desc_t),
-        },
-        .depth = {
-            .func = GS_GRAPHICS_DEPTH_FUNC_LESS,
-        }};
+    rxcore_pso_key_t default_key = rxcore_pso_key_create(
+        rxcore_shader_registry_get_shader_set(shader_registry, RXCORE_SHADER_SET_UNLIT_DEFAULT),
+        RXCORE_VERTEX_LAYOUT_DEFAULT,
+        rxcore_pso_state_default());
 
-    return rxcore_pipeline_create(pipeline_desc);
+    return rxcore_pipeline_create(shader_registry, default_key);
 }
 
 rxcore_pipeline_t *rxcore_pipeline_add_render_pass(rxcore_pipeline_t *pipeline, rxcore_render_pass_t pass, void *data)
 {
-    pipeline->render_passes = realloc(pipeline->render_passes, sizeof(rxcore_render_pass_t) * (pipeline->render_pass_count + 1));
-    pipeline->render_pass_data = realloc(pipeline->render_pass_data, sizeof(void *) * (pipeline->render_pass_count + 1));
-    pipeline->render_passes[pipeline->render_pass_count] = pass;
-    pipeline->render_pass_data[pipeline->render_pass_count] = data;
-    pipeline->render_pass_count++;
+    rxcore_frame_graph_add_pass(pipeline->frame_graph, pass, data);
     return pipeline;
 }
 
-void rxcore_pipeline_begin(rxcore_rendering_context_t *ctx)
+uint32_t rxcore_pipeline_add_render_target(rxcore_pipeline_t *pipeline, rxcore_render_target_desc_t desc)
+{
+    return rxcore_frame_graph_add_target(pipeline->frame_graph, desc);
+}
+
+void rxcore_pipeline_set_scene_target(rxcore_pipeline_t *pipeline, uint32_t target)
+{
+    rxcore_render_pass_t *scene_pass = &pipeline->frame_graph->passes[pipeline->view_passes[RXCORE_RENDER_VIEW_MAIN]];
+    scene_pass->writes[0] = target;
+    pipeline->views[RXCORE_RENDER_VIEW_MAIN]->desc.target = target;
+    pipeline->frame_graph->is_dirty = true;
+}
+
+uint32_t rxcore_pipeline_add_view(rxcore_pipeline_t *pipeline, rxcore_render_view_desc_t desc)
 {
+    rxcore_render_view_t *view = rxcore_render_view_create(desc);
+    view->ctx = pipeline->ctx;
+    gs_dyn_array_push(pipeline->views, view);
+
+    rxcore_render_pass_t pass = rxcore_render_pass_create(desc.name, _rxcore_pipeline_view_pass);
+    rxcore_render_pass_write(&pass, desc.target);
+    gs_dyn_array_push(pipeline->view_passes, gs_dyn_array_size(pipeline->frame_graph->passes));
+    rxcore_frame_graph_add_pass(pipeline->frame_graph, pass, view);
 
+    return gs_dyn_array_size(pipeline->views) - 1;
+}
+
+rxcore_render_view_t *rxcore_pipeline_get_view(rxcore_pipeline_t *pipeline, uint32_t index)
+{
+    return pipeline->views[index];
+}
+
+void rxcore_pipeline_begin(rxcore_rendering_context_t *ctx)
+{
+    // the view passes need the whole context, which doesn't exist yet when the pipeline is created
+    ctx->pipeline->ctx = ctx;
+    for (uint32_t i = 0; i < gs_dyn_array_size(ctx->pipeline->views); i++)
+    {
+        ctx->pipeline->views[i]->ctx = ctx;
+    }
 }
 
 void rxcore_pipeline_render(rxcore_rendering_context_t *ctx)
@@ -67,104 +112,332 @@ void rxcore_pipeline_render(rxcore_rendering_context_t *ctx)
     gs_command_buffer_t *cb = ctx->cb;
     rxcore_pipeline_t *pipeline = ctx->pipeline;
     gs_vec2 fs = gs_platform_framebuffer_sizev(gs_platform_main_window());
-    gs_vec2 ws = gs_platform_window_sizev(gs_platform_main_window());
-
-    gs_graphics_renderpass_begin(cb, GS_GRAPHICS_RENDER_PASS_DEFAULT);
-    gs_graphics_pipeline_bind(cb, pipeline->pipeline_hndl);
-    gs_graphics_set_viewport(cb, 0, 0, (uint32_t)fs.x, (uint32_t)fs.y);
-    gs_graphics_clear_desc_t clear = {.actions = &(gs_graphics_clear_action_t){.color = {0.1f, 0.1f, 0.1f, 1.f}}};
-    gs_graphics_clear(cb, &clear);
-
-    // now create the bindings for the meshes
-    rxcore_mesh_buffer_apply_bindings(ctx->mesh_registry->buffer, cb);
 
     // gs_println("Rendering pipeline");
 
-    // now create the bindings for the cameras
-    if (ctx->camera->projection_type = RXCORE_CAMERA_PROJECTION_PERSPECTIVE)
-    {
-        // update the aspect ratio
-        ctx->camera->perspective_desc.aspect_ratio = fs.x / fs.y;
-    }
+    // meshes added since the last frame are uploaded here, as the workers recording draws can't talk to the graphics api
+    rxcore_render_snapshot_t *snapshot = rxcore_render_snapshots_get_read(ctx->snapshots);
+    bool formats_changed = _rxcore_pipeline_upload_meshes(ctx, snapshot);
 
-    rxcore_camera_apply_bindings(ctx->camera, cb);
-    // now traverse the scene graph to draw meshes
-    if (ctx->scene_graph->is_dirty || ctx->render_group == NULL)
+    // the render group only has to be rebuilt when nodes were added or removed, or a buffer now needs other pipelines
+    if (ctx->render_group == NULL || ctx->render_group->structure_version != snapshot->structure_version || formats_changed)
     {
-        gs_println("Scene graph is dirty, updating render group");
+        RXCORE_LOG_DEBUG("rendering::pipeline", "Scene graph is dirty, updating render group");
         // free the old render_group
         if (ctx->render_group != NULL)
         {
             rxcore_render_group_destroy(ctx->render_group);
         }
 
-        ctx->render_group = rxcore_render_group_create(ctx->scene_graph);
+        ctx->render_group = rxcore_render_group_create(snapshot);
+        _rxcore_pipeline_resolve_psos(pipeline, ctx->render_group);
+    }
+
+    // only what each camera can see goes on to be recorded
+    _rxcore_pipeline_cull_views(ctx, snapshot);
+
+    // now execute the render passes, every view is one of them
+    rxcore_frame_graph_execute(pipeline->frame_graph, cb, (uint32_t)fs.x, (uint32_t)fs.y);
+    gs_graphics_command_buffer_submit(cb);
+    // gs_println("Pipeline rendered");
+}
+
+bool _rxcore_pipeline_upload_meshes(rxcore_rendering_context_t *ctx, rxcore_render_snapshot_t *snapshot)
+{
+    rxcore_mesh_registry_upload(ctx->mesh_registry);
+    bool formats_changed = ctx->mesh_registry->buffer->format_changed ||
+                           (ctx->mesh_registry->wide_buffer != NULL && ctx->mesh_registry->wide_buffer->format_changed);
+    ctx->mesh_registry->buffer->format_changed = false;
+    if (ctx->mesh_registry->wide_buffer != NULL)
+    {
+        ctx->mesh_registry->wide_buffer->format_changed = false;
+    }
+
+    for (uint32_t i = 0; i < gs_dyn_array_size(ctx->mesh_buffers); i++)
+    {
+        rxcore_mesh_buffer_upload(ctx->mesh_buffers[i]);
+        formats_changed = formats_changed || ctx->mesh_buffers[i]->format_changed;
+        ctx->mesh_buffers[i]->format_changed = false;
+    }
+
+    // a node can draw from a buffer that was never added to the context. Uploading a buffer with nothing changed does
+    // nothing, and the nodes of one buffer mostly follow each other, so only a change of buffer is looked at
+    rxcore_mesh_buffer_t *last = NULL;
+    for (uint32_t i = 0; i < gs_dyn_array_size(snapshot->proxies); i++)
+    {
+        rxcore_mesh_buffer_t *buffer = snapshot->proxies[i].mesh.buffer;
+        if (buffer == NULL || buffer == last)
+        {
+            continue;
+        }
+        last = buffer;
+
+        rxcore_mesh_buffer_upload(buffer);
+        formats_changed = formats_changed || buffer->format_changed;
+        buffer->format_changed = false;
+    }
+
+    return formats_changed;
+}
+
+void _rxcore_pipeline_view_pass(gs_command_buffer_t *cb, rxcore_render_pass_t *pass, void *data)
+{
+    rxcore_render_view_t *view = data;
+    rxcore_rendering_context_t *ctx = view->ctx;
+    rxcore_pipeline_t *pipeline = ctx->pipeline;
+    rxcore_render_snapshot_t *snapshot = rxcore_render_snapshots_get_read(ctx->snapshots);
+    rxcore_render_state_t state = rxcore_render_state_create(cb);
+
+    rxcore_render_state_bind_pipeline(&state, pipeline->default_pso->pipeline_hndl);
+    gs_vec4 color = view->desc.clear_color;
+    gs_graphics_clear_desc_t clear = {.actions = &(gs_graphics_clear_action_t){.color = {color.x, color.y, color.z, color.w}}};
+    gs_graphics_clear(cb, &clear);
+
+    // culling left nothing for a view without a camera, but it still has nothing to bind
+    rxcore_render_camera_t *camera = rxcore_render_view_get_camera(view, snapshot);
+    if (camera == NULL)
+    {
+        return;
+    }
+
+    uint32_t num_render_items = gs_dyn_array_size(view->visible_items);
+    if (ctx->jobs == NULL || num_render_items < RXCORE_PIPELINE_PARALLEL_THRESHOLD)
+    {
+        _rxcore_pipeline_bind_frame(ctx, camera, &state);
+        _rxcore_pipeline_record_items(ctx, view, snapshot, &state, 0, num_render_items);
+    }
+    else
+    {
+        _rxcore_pipeline_record_parallel(ctx, view, snapshot, &state);
+    }
+
+    rxcore_render_state_report(&state);
+}
+
+void _rxcore_pipeline_cull_views(rxcore_rendering_context_t *ctx, rxcore_render_snapshot_t *snapshot)
+{
+    rxcore_pipeline_t *pipeline = ctx->pipeline;
+    uint32_t num_views = gs_dyn_array_size(pipeline->views);
+
+    // everything a view fills in is sized here, as jobs can't allocate
+    for (uint32_t i = 0; i < num_views; i++)
+    {
+        rxcore_render_view_prepare(pipeline->views[i], snapshot, ctx->render_group);
+    }
+
+    // the job system runs one parallel for at a time, so either the views are spread across it, or a lone view's objects are
+    rxcore_pipeline_cull_job_t job = {.pipeline = pipeline, .snapshot = snapshot, .group = ctx->render_group};
+    if (num_views == 1 || ctx->jobs == NULL)
+    {
+        for (uint32_t i = 0; i < num_views; i++)
+        {
+            rxcore_render_view_cull(pipeline->views[i], snapshot, ctx->jobs);
+            rxcore_render_view_build_draw_list(pipeline->views[i], ctx->render_group);
+        }
     }
     else
     {
-        RXCORE_SCENE_GRAPH_UPDATE_MATRICES(ctx->scene_graph);
+        rxcore_jobs_parallel_for(ctx->jobs, num_views, 1, _rxcore_pipeline_cull_job, &job);
+    }
+
+    uint32_t num_proxies = gs_dyn_array_size(snapshot->proxies);
+    uint32_t visible = 0, culled = 0, occluded = 0, occlusion_triangles = 0, reduced = 0;
+    for (uint32_t i = 0; i < num_views; i++)
+    {
+        rxcore_render_view_t *view = pipeline->views[i];
+        visible += view->visible;
+        culled += num_proxies - view->in_frustum;
+        occluded += view->in_frustum - view->visible;
+        occlusion_triangles += view->occlusion != NULL ? view->occlusion->triangles_rasterized : 0;
+        reduced += view->reduced;
+    }
+
+    RXCORE_PROFILER_COUNTER_SET("render_views", num_views);
+    RXCORE_PROFILER_COUNTER_SET("cull_visible", visible);
+    RXCORE_PROFILER_COUNTER_SET("cull_culled", culled);
+    RXCORE_PROFILER_COUNTER_SET("cull_occluded", occluded);
+    RXCORE_PROFILER_COUNTER_SET("occlusion_triangles", occlusion_triangles);
+    RXCORE_PROFILER_COUNTER_SET("lod_reduced", reduced);
+}
+
+void _rxcore_pipeline_cull_job(void *data, uint32_t start, uint32_t end, uint32_t worker)
+{
+    rxcore_pipeline_cull_job_t *job = data;
+    for (uint32_t i = start; i < end; i++)
+    {
+        rxcore_render_view_t *view = job->pipeline->views[i];
+        rxcore_render_view_cull(view, job->snapshot, NULL);
+        rxcore_render_view_build_draw_list(view, job->group);
+    }
+}
+
+void _rxcore_pipeline_resolve_psos(rxcore_pipeline_t *pipeline, rxcore_render_group_t *group)
+{
+    // creating a pso talks to the graphics backend, so it has to happen here rather than while recording
+    for (uint32_t i = 0; i < gs_dyn_array_size(group->items); i++)
+    {
+        rxcore_render_item_t *item = &group->items[i];
+        if (item->type == RXCORE_SWAP_ITEM)
+        {
+            rxcore_pso_key_t key = rxcore_swap_item_get_pso_key(&item->swap_item);
+            item->swap_item.pso = rxcore_pso_cache_get(pipeline->pso_cache, &key);
+        }
     }
+}
 
-    uint32_t num_render_items = gs_dyn_array_size(ctx->render_group->items);
+void _rxcore_pipeline_record_items(rxcore_rendering_context_t *ctx, rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_state_t *state, uint32_t start, uint32_t end)
+{
+    rxcore_pipeline_t *pipeline = ctx->pipeline;
+    rxcore_render_camera_t *camera = rxcore_render_view_get_camera(view, snapshot);
 
-    for (uint32_t i = 0; i < num_render_items; i++)
+    for (uint32_t i = start; i < end; i++)
     {
-        gs_println("Processing rendering item %d", i);
-        rxcore_render_item_t item = ctx->render_group->items[i];
+        RXCORE_LOG_TRACE_HOT("rendering::pipeline", 1.0, "Processing rendering item %d", i);
+        rxcore_render_item_t item = view->visible_items[i];
         switch (item.type)
         {
         case RXCORE_SWAP_ITEM:
-            gs_println("Swapping material");
-            gs_println("Material: %p", item.swap_item.material);
-            gs_println("Shader set: %p", item.swap_item.material->shader_set);
-            rxcore_shader_program_set(item.swap_item.material->shader_set);
-            rxcore_material_bind(item.swap_item.material, cb);
+            RXCORE_LOG_TRACE_HOT("rendering::pipeline", 1.0, "Swapping to the material of proxy %d", item.swap_item.proxy);
+            // the render group is sorted by pso, so this only binds when the pso actually changes
+            rxcore_pso_t *pso = item.swap_item.pso;
+            if (pso != NULL && rxcore_render_state_bind_pipeline(state, pso->pipeline_hndl))
+            {
+                // a new program has none of the per-frame uniforms
+                _rxcore_pipeline_bind_frame(ctx, camera, state);
+            }
+            _rxcore_pipeline_bind_material(state, snapshot, &item.swap_item);
             break;
         case RXCORE_DRAW_ITEM:
-            rxcore_pipeline_render_node(cb, item.draw_item);
+            rxcore_pipeline_render_node(pipeline, state, &snapshot->proxies[item.draw_item.proxy], item.draw_item.lod);
             break;
         }
     }
+}
 
-    gs_graphics_renderpass_end(cb);
-    // now execute the render passes
-    gs_graphics_command_buffer_submit(cb);
-    // gs_println("Pipeline rendered");
+void _rxcore_pipeline_record_job(void *data, uint32_t start, uint32_t end, uint32_t worker)
+{
+    rxcore_pipeline_record_job_t *job = data;
+    rxcore_rendering_context_t *ctx = job->ctx;
+    rxcore_render_view_t *view = job->view;
+    rxcore_render_snapshot_t *snapshot = job->snapshot;
+    rxcore_pipeline_chunk_t *chunk = &ctx->pipeline->chunks[start / job->chunk_size];
+    rxcore_render_state_t state = rxcore_render_state_create(&chunk->cb);
+
+    // a chunk can start in the middle of a material, so find the swap that it continues from
+    rxcore_swap_item_t *swap = NULL;
+    for (uint32_t i = start; i > 0; i--)
+    {
+        if (view->visible_items[i - 1].type == RXCORE_SWAP_ITEM)
+        {
+            swap = &view->visible_items[i - 1].swap_item;
+            break;
+        }
+    }
+
+    // the commands are appended after the previous chunk, so everything it left bound has to be bound again
+    rxcore_pso_t *pso = swap != NULL && swap->pso != NULL ? swap->pso : ctx->pipeline->default_pso;
+    rxcore_render_state_bind_pipeline(&state, pso->pipeline_hndl);
+    _rxcore_pipeline_bind_frame(ctx, rxcore_render_view_get_camera(view, snapshot), &state);
+    if (swap != NULL)
+    {
+        _rxcore_pipeline_bind_material(&state, snapshot, swap);
+    }
+
+    _rxcore_pipeline_record_items(ctx, view, snapshot, &state, start, end);
+    chunk->stats = state.stats;
+}
+
+void _rxcore_pipeline_record_parallel(rxcore_rendering_context_t *ctx, rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_state_t *state)
+{
+    rxcore_pipeline_t *pipeline = ctx->pipeline;
+    uint32_t num_render_items = gs_dyn_array_size(view->visible_items);
+    uint32_t worker_count = rxcore_jobs_get_worker_count(ctx->jobs);
+    uint32_t chunk_size = gs_max((num_render_items + worker_count - 1) / worker_count, RXCORE_PIPELINE_MIN_CHUNK_SIZE);
+    uint32_t chunk_count = (num_render_items + chunk_size - 1) / chunk_size;
+
+    // the chunks have to exist before the workers start, as growing the array would move them
+    while (gs_dyn_array_size(pipeline->chunks) < chunk_count)
+    {
+        rxcore_pipeline_chunk_t chunk = {0};
+        chunk.cb = gs_command_buffer_new();
+        gs_dyn_array_push(pipeline->chunks, chunk);
+    }
+
+    for (uint32_t i = 0; i < chunk_count; i++)
+    {
+        gs_command_buffer_clear(&pipeline->chunks[i].cb);
+        pipeline->chunks[i].stats = (rxcore_render_state_stats_t){0};
+    }
+
+    rxcore_pipeline_record_job_t job = {.ctx = ctx, .view = view, .snapshot = snapshot, .chunk_size = chunk_size};
+    rxcore_jobs_parallel_for(ctx->jobs, num_render_items, chunk_size, _rxcore_pipeline_record_job, &job);
+
+    // stitch the chunks together in order, so the result is the same as recording serially
+    for (uint32_t i = 0; i < chunk_count; i++)
+    {
+        rxcore_pipeline_chunk_t *chunk = &pipeline->chunks[i];
+        gs_byte_buffer_write_bulk(&state->cb->commands, chunk->cb.commands.data, chunk->cb.commands.position);
+        state->cb->num_commands += chunk->cb.num_commands;
+        state->stats.issued += chunk->stats.issued;
+        state->stats.filtered += chunk->stats.filtered;
+    }
+
+    // whatever the last chunk bound is now bound on the command buffer
+    rxcore_render_state_invalidate(state);
 }
 
 void rxcore_pipeline_destroy(rxcore_pipeline_t *pipeline)
 {
-    gs_graphics_pipeline_destroy(pipeline->pipeline_hndl);
-    free(pipeline->render_passes);
-    free(pipeline->render_pass_data);
+    rxcore_frame_graph_destroy(pipeline->frame_graph);
+    for (uint32_t i = 0; i < gs_dyn_array_size(pipeline->chunks); i++)
+    {
+        gs_command_buffer_free(&pipeline->chunks[i].cb);
+    }
+    gs_dyn_array_free(pipeline->chunks);
+    for (uint32_t i = 0; i < gs_dyn_array_size(pipeline->views); i++)
+    {
+        rxcore_render_view_destroy(pipeline->views[i]);
+    }
+    gs_dyn_array_free(pipeline->views);
+    gs_dyn_array_free(pipeline->view_passes);
+    rxcore_pso_cache_destroy(pipeline->pso_cache);
+    gs_graphics_uniform_destroy(pipeline->model_uniform);
     free(pipeline);
 }
 
-void rxcore_pipeline_render_node(gs_command_buffer_t *cb, rxcore_draw_item_t item)
+void rxcore_pipeline_render_node(rxcore_pipeline_t *pipeline, rxcore_render_state_t *state, rxcore_render_proxy_t *proxy, uint32_t lod)
 {
+    rxcore_mesh_t *mesh = &proxy->mesh;
+
+    // meshes in the same buffer share their bindings, so this is almost always filtered. The buffer went up in
+    // _rxcore_pipeline_upload_meshes, only its handles are read on the workers
+    rxcore_render_state_bind_buffers(
+        state,
+        rxcore_mesh_buffer_get_vertex_buffer(mesh->buffer),
+        rxcore_mesh_buffer_get_index_buffer(mesh->buffer));
+
     // pass in the model matrix
-    gs_handle(gs_graphics_uniform_t) model_binding = gs_graphics_uniform_create(
-        &(gs_graphics_uniform_desc_t){
-            .stage = GS_GRAPHICS_SHADER_STAGE_VERTEX,
-            .name = "u_model",
-            .layout = &(gs_graphics_uniform_layout_desc_t){
-                .type = GS_GRAPHICS_UNIFORM_MAT4,
-            },
-        });
+    rxcore_render_state_bind_uniform(state, pipeline->model_uniform, &proxy->world_matrix, sizeof(gs_mat4));
 
-    // bind the model matrix
-    gs_graphics_bind_uniform_desc_t model_desc = {
-        .uniform = model_binding,
-        .data = &item.node->world_matrix,
-    };
+    // now draw the mesh, at the detail the view picked for it
+    rxcore_mesh_draw_lod(mesh, lod, state->cb);
+}
 
-    gs_graphics_bind_desc_t bind_desc = {
-        .uniforms = {
-            .desc = &model_desc,
-        }};
+void _rxcore_pipeline_bind_material(rxcore_render_state_t *state, rxcore_render_snapshot_t *snapshot, rxcore_swap_item_t *swap)
+{
+    // the copy in the snapshot, the material itself belongs to the simulation and may be changing while this records
+    rxcore_render_material_t *material = &snapshot->materials[snapshot->proxies[swap->proxy].material];
+    rxcore_render_state_bind_uniforms(state, &snapshot->uniforms[material->first_uniform], material->num_uniforms);
+}
 
-    gs_graphics_apply_bindings(cb, &bind_desc);
+void _rxcore_pipeline_bind_frame(rxcore_rendering_context_t *ctx, rxcore_render_camera_t *camera, rxcore_render_state_t *state)
+{
+    // now create the bindings for the meshes
+    rxcore_render_state_bind_buffers(
+        state,
+        rxcore_mesh_buffer_get_vertex_buffer(ctx->mesh_registry->buffer),
+        rxcore_mesh_buffer_get_index_buffer(ctx->mesh_registry->buffer));
 
-    // now draw the mesh
-    rxcore_mesh_draw(&item.node->mesh, cb);
-}
\ No newline at end of file
+    rxcore_render_state_bind_uniform(state, camera->view_uniform, &camera->view_matrix, sizeof(gs_mat4));
+    rxcore_render_state_bind_uniform(state, camera->projection_uniform, &camera->projection_matrix, sizeof(gs_mat4));
+}
@@ -6,40 +6,94 @@
 #include <rxcore/rendering/shader.h>
 #include <rxcore/rendering/material.h>
 #include <rxcore/rendering/scene_graph.h>
+#include <rxcore/rendering/render_state.h>
+#include <rxcore/rendering/pso.h>
+#include <rxcore/rendering/frame_graph.h>
+#include <rxcore/rendering/render_snapshot.h>
+#include <rxcore/rendering/render_group.h>
+#include <rxcore/rendering/render_view.h>
+#include <rxcore/jobs.h>
+
+// below this many render items the scene is recorded on the calling thread
+#define RXCORE_PIPELINE_PARALLEL_THRESHOLD 4096
+#define RXCORE_PIPELINE_MIN_CHUNK_SIZE 1024
 
-typedef struct rxcore_render_pass_t rxcore_render_pass_t;
 typedef struct rxcore_rendering_context_t rxcore_rendering_context_t;
 typedef struct rxcore_draw_item_t rxcore_draw_item_t;
 
-enum rxcore_render_pass_type_t
+/// @brief A secondary command buffer that one slice of the render group is recorded into
+typedef struct rxcore_pipeline_chunk_t
 {
-    RXCORE_BEFORE_SCENE_RENDER,
-    RXCORE_AFTER_SCENE_RENDER,
-};
+    gs_command_buffer_t cb;
+    rxcore_render_state_stats_t stats;
+} rxcore_pipeline_chunk_t;
 
-typedef struct rxcore_render_pass_t
+typedef struct rxcore_pipeline_record_job_t
 {
-    enum rxcore_render_pass_type_t type;
-    void (*begin)(gs_command_buffer_t *cb, rxcore_render_pass_t *pass, void *data);
-    void (*execute)(gs_command_buffer_t *cb, rxcore_render_pass_t *pass, void *data);
-    void (*end)(gs_command_buffer_t *cb, rxcore_render_pass_t *pass, void *data);
-} rxcore_render_pass_t;
+    rxcore_rendering_context_t *ctx;
+    rxcore_render_view_t *view;
+    rxcore_render_snapshot_t *snapshot;
+    uint32_t chunk_size;
+} rxcore_pipeline_record_job_t;
 
 typedef struct rxcore_pipeline_t
 {
-    gs_handle(gs_graphics_pipeline_t) pipeline_hndl;
-    rxcore_render_pass_t *render_passes;
-    void **render_pass_data;
-    uint32_t render_pass_count;
+    rxcore_pso_cache_t *pso_cache;
+    rxcore_pso_t *default_pso; // bound before any material, owned by the pso cache
+    gs_handle(gs_graphics_uniform_t) model_uniform;
+    rxcore_frame_graph_t *frame_graph; // the first pass is always the main view
+    gs_dyn_array(rxcore_pipeline_chunk_t) chunks; // reused every frame, only grows. views are recorded one after another so they share them
+    gs_dyn_array(rxcore_render_view_t *) views;  // owning pointers, the first is always RXCORE_RENDER_VIEW_MAIN
+    gs_dyn_array(uint32_t) view_passes;          // the frame graph pass of each view
+    rxcore_rendering_context_t *ctx;             // set when the pipeline begins
 } rxcore_pipeline_t;
 
-rxcore_pipeline_t *rxcore_pipeline_create(gs_graphics_pipeline_desc_t pipeline_desc);
-rxcore_pipeline_t *rxcore_pipeline_default();
+/// @brief The state of culling every view at once, one view per job
+typedef struct rxcore_pipeline_cull_job_t
+{
+    rxcore_pipeline_t *pipeline;
+    rxcore_render_snapshot_t *snapshot;
+    rxcore_render_group_t *group;
+} rxcore_pipeline_cull_job_t;
+
+/// @return The pipeline, or NULL if the pso of default_key couldn't be created
+rxcore_pipeline_t *rxcore_pipeline_create(rxcore_shader_registry_t *shader_registry, rxcore_pso_key_t default_key);
+rxcore_pipeline_t *rxcore_pipeline_default(rxcore_shader_registry_t *shader_registry);
+
+/// @brief Adds a pass to the frame graph. Passes are ordered by the targets they read and write, and a pass is
+/// skipped when nothing that reaches the backbuffer depends on it
 rxcore_pipeline_t *rxcore_pipeline_add_render_pass(rxcore_pipeline_t *pipeline, rxcore_render_pass_t pass, void *data);
+
+/// @brief Declares a transient render target
+/// @return The id of the target, for the reads and writes of passes
+uint32_t rxcore_pipeline_add_render_target(rxcore_pipeline_t *pipeline, rxcore_render_target_desc_t desc);
+
+/// @brief Redirects the scene into a target instead of the backbuffer, so that later passes can read it
+void rxcore_pipeline_set_scene_target(rxcore_pipeline_t *pipeline, uint32_t target);
+
+/// @brief Adds a view, rendered in its own pass of the frame graph from the same snapshot as every other view.
+/// Like any other pass it is skipped when nothing that reaches the backbuffer reads its target
+/// @return The index of the view
+uint32_t rxcore_pipeline_add_view(rxcore_pipeline_t *pipeline, rxcore_render_view_desc_t desc);
+
+rxcore_render_view_t *rxcore_pipeline_get_view(rxcore_pipeline_t *pipeline, uint32_t index);
+
 void rxcore_pipeline_begin(rxcore_rendering_context_t *ctx);
 void rxcore_pipeline_render(rxcore_rendering_context_t *ctx);
 void rxcore_pipeline_destroy(rxcore_pipeline_t *pipeline);
 
-void rxcore_pipeline_render_node(gs_command_buffer_t *cb, rxcore_draw_item_t item);
+void rxcore_pipeline_render_node(rxcore_pipeline_t *pipeline, rxcore_render_state_t *state, rxcore_render_proxy_t *proxy, uint32_t lod);
+
+// private methods
+bool _rxcore_pipeline_upload_meshes(rxcore_rendering_context_t *ctx, rxcore_render_snapshot_t *snapshot);
+void _rxcore_pipeline_view_pass(gs_command_buffer_t *cb, rxcore_render_pass_t *pass, void *data);
+void _rxcore_pipeline_cull_views(rxcore_rendering_context_t *ctx, rxcore_render_snapshot_t *snapshot);
+void _rxcore_pipeline_cull_job(void *data, uint32_t start, uint32_t end, uint32_t worker);
+void _rxcore_pipeline_resolve_psos(rxcore_pipeline_t *pipeline, rxcore_render_group_t *group);
+void _rxcore_pipeline_record_items(rxcore_rendering_context_t *ctx, rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_state_t *state, uint32_t start, uint32_t end);
+void _rxcore_pipeline_record_job(void *data, uint32_t start, uint32_t end, uint32_t worker);
+void _rxcore_pipeline_record_parallel(rxcore_rendering_context_t *ctx, rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_state_t *state);
+void _rxcore_pipeline_bind_material(rxcore_render_state_t *state, rxcore_render_snapshot_t *snapshot, rxcore_swap_item_t *swap);
+void _rxcore_pipeline_bind_frame(rxcore_rendering_context_t *ctx, rxcore_render_camera_t *camera, rxcore_render_state_t *state);
 
 #endif // __PIPELINE_H__
\ No newline at end of file
@@ -0,0 +1,180 @@
+// pso.c
+
+#include <rxcore/rendering/pso.h>
+#include <gs/gs.h>
+
+rxcore_pso_state_t rxcore_pso_state_default()
+{
+    rxcore_pso_state_t state = {0};
+    state.face_culling = GS_GRAPHICS_FACE_CULLING_BACK;
+    state.winding_order = GS_GRAPHICS_WINDING_ORDER_CCW;
+    state.primitive = GS_GRAPHICS_PRIMITIVE_TRIANGLES;
+    state.depth_func = GS_GRAPHICS_DEPTH_FUNC_LESS;
+    return state;
+}
+
+bool rxcore_pso_state_equals(const rxcore_pso_state_t *a, const rxcore_pso_state_t *b)
+{
+    return a->face_culling == b->face_culling &&
+           a->winding_order == b->winding_order &&
+           a->primitive == b->primitive &&
+           a->depth_func == b->depth_func &&
+           a->blend.func == b->blend.func &&
+           a->blend.src == b->blend.src &&
+           a->blend.dst == b->blend.dst;
+}
+
+rxcore_pso_key_t rxcore_pso_key_create(rxcore_shader_set_t set, rxcore_vertex_layout_t layout, rxcore_pso_state_t state)
+{
+    rxcore_pso_key_t key = {0};
+    key.shader_set = set;
+    key.layout = layout;
+    key.index_size = sizeof(uint16_t);
+    key.state = state;
+    return key;
+}
+
+uint64_t rxcore_pso_key_hash(const rxcore_pso_key_t *key)
+{
+    // fnv-1a over the fields, hashing the struct directly would pick up padding
+    uint64_t fields[] = {
+        (uint64_t)(uintptr_t)key->shader_set.vertex_shader,
+        (uint64_t)(uintptr_t)key->shader_set.fragment_shader,
+        (uint64_t)key->layout,
+        (uint64_t)key->index_size,
+        (uint64_t)key->state.face_culling,
+        (uint64_t)key->state.winding_order,
+        (uint64_t)key->state.primitive,
+        (uint64_t)key->state.depth_func,
+        (uint64_t)key->state.blend.func,
+        (uint64_t)key->state.blend.src,
+        (uint64_t)key->state.blend.dst,
+    };
+
+    uint64_t hash = 14695981039346656037ull;
+    for (uint32_t i = 0; i < sizeof(fields) / sizeof(uint64_t); i++)
+    {
+        hash ^= fields[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+bool rxcore_pso_key_equals(const rxcore_pso_key_t *a, const rxcore_pso_key_t *b)
+{
+    return rxcore_shader_set_equals(a->shader_set, b->shader_set) &&
+           a->layout == b->layout &&
+           a->index_size == b->index_size &&
+           rxcore_pso_state_equals(&a->state, &b->state);
+}
+
+int rxcore_pso_key_compare(const rxcore_pso_key_t *a, const rxcore_pso_key_t *b)
+{
+    // the program is the most expensive thing to switch, so it is the primary key
+    uintptr_t program_a[] = {(uintptr_t)a->shader_set.vertex_shader, (uintptr_t)a->shader_set.fragment_shader};
+    uintptr_t program_b[] = {(uintptr_t)b->shader_set.vertex_shader, (uintptr_t)b->shader_set.fragment_shader};
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        if (program_a[i] != program_b[i])
+        {
+            return program_a[i] < program_b[i] ? -1 : 1;
+        }
+    }
+
+    if (a->layout != b->layout)
+    {
+        return a->layout < b->layout ? -1 : 1;
+    }
+    if (a->index_size != b->index_size)
+    {
+        return a->index_size < b->index_size ? -1 : 1;
+    }
+
+    uint64_t hash_a = rxcore_pso_key_hash(a);
+    uint64_t hash_b = rxcore_pso_key_hash(b);
+    if (hash_a != hash_b)
+    {
+        return hash_a < hash_b ? -1 : 1;
+    }
+
+    return 0;
+}
+
+rxcore_pso_cache_t *rxcore_pso_cache_create(rxcore_shader_registry_t *shader_registry)
+{
+    rxcore_pso_cache_t *cache = malloc(sizeof(rxcore_pso_cache_t));
+    cache->shader_registry = shader_registry;
+    cache->psos = gs_dyn_array_new(rxcore_pso_t *);
+    return cache;
+}
+
+rxcore_pso_t *rxcore_pso_cache_get(rxcore_pso_cache_t *cache, const rxcore_pso_key_t *key)
+{
+    uint64_t hash = rxcore_pso_key_hash(key);
+    for (uint32_t i = 0; i < gs_dyn_array_size(cache->psos); i++)
+    {
+        rxcore_pso_t *pso = cache->psos[i];
+        if (pso->hash == hash && rxcore_pso_key_equals(&pso->key, key))
+        {
+            return pso;
+        }
+    }
+
+    return _rxcore_pso_create(cache, key, hash);
+}
+
+rxcore_pso_t *_rxcore_pso_create(rxcore_pso_cache_t *cache, const rxcore_pso_key_t *key, uint64_t hash)
+{
+    // packed layouts are read by a copy of the vertex shader that knows how to unpack them
+    rxcore_shader_set_t set = key->shader_set;
+    const char *define = rxcore_vertex_layout_get_info(key->layout)->shader_define;
+    if (define != NULL)
+    {
+        set.vertex_shader = rxcore_shader_registry_get_variant(cache->shader_registry, set.vertex_shader, define);
+    }
+
+    rxcore_shader_program_t *program = rxcore_shader_registry_get_program(cache->shader_registry, set);
+    if (program == NULL)
+    {
+        return NULL;
+    }
+
+    gs_graphics_pipeline_desc_t desc = {
+        .raster = {
+            .face_culling = key->state.face_culling,
+            .index_buffer_element_size = key->index_size,
+            .winding_order = key->state.winding_order,
+            .shader = program->program,
+            .primitive = key->state.primitive,
+        },
+        .layout = rxcore_vertex_layout_get_desc(key->layout),
+        .depth = {
+            .func = key->state.depth_func,
+        },
+        .blend = key->state.blend,
+    };
+
+    rxcore_pso_t *pso = malloc(sizeof(rxcore_pso_t));
+    pso->key = *key;
+    pso->hash = hash;
+    pso->program = program;
+    pso->pipeline_hndl = gs_graphics_pipeline_create(&desc);
+    gs_dyn_array_push(cache->psos, pso);
+
+    RXCORE_LOG_DEBUG("rendering::pso", "Created pipeline state object for program %s with the %s vertex layout and %d-bit indices, %d in cache",
+                     program->program_name, rxcore_vertex_layout_get_info(key->layout)->name, key->index_size * 8, gs_dyn_array_size(cache->psos));
+    return pso;
+}
+
+void rxcore_pso_cache_destroy(rxcore_pso_cache_t *cache)
+{
+    for (uint32_t i = 0; i < gs_dyn_array_size(cache->psos); i++)
+    {
+        gs_graphics_pipeline_destroy(cache->psos[i]->pipeline_hndl);
+        free(cache->psos[i]);
+    }
+
+    gs_dyn_array_free(cache->psos);
+    free(cache);
+}
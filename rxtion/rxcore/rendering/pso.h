@@ -0,0 +1,70 @@
+#ifndef __PSO_H__
+#define __PSO_H__
+
+#include <gs/gs.h>
+#include <stdbool.h>
+#include <rxcore/profiler.h>
+#include <rxcore/rendering/shader.h>
+#include <rxcore/rendering/mesh.h>
+
+/// @brief The fixed function state of a pipeline, everything that isn't the program or the vertex layout
+typedef struct rxcore_pso_state_t
+{
+    gs_graphics_face_culling_type face_culling;
+    gs_graphics_winding_order_type winding_order;
+    gs_graphics_primitive_type primitive;
+    gs_graphics_depth_func_type depth_func;
+    gs_graphics_blend_state_desc_t blend;
+} rxcore_pso_state_t;
+
+/// @brief Everything needed to create a pipeline state object, used to look it up in the cache
+typedef struct rxcore_pso_key_t
+{
+    rxcore_shader_set_t shader_set; // maps 1:1 to a program through the shader registry
+    rxcore_vertex_layout_t layout;  // of the mesh buffer being drawn, which picks the variant of the vertex shader
+    uint32_t index_size;            // of the mesh buffer being drawn, sizeof(uint16_t) unless it holds a mesh too big for them
+    rxcore_pso_state_t state;
+} rxcore_pso_key_t;
+
+/// @brief A pipeline state object, created lazily by the cache
+typedef struct rxcore_pso_t
+{
+    rxcore_pso_key_t key;
+    uint64_t hash;
+    rxcore_shader_program_t *program; // non-owning pointer, owned by the shader registry
+    gs_handle(gs_graphics_pipeline_t) pipeline_hndl;
+} rxcore_pso_t;
+
+/// @brief Owns every pipeline state object that has been requested
+typedef struct rxcore_pso_cache_t
+{
+    rxcore_shader_registry_t *shader_registry; // non-owning pointer
+    gs_dyn_array(rxcore_pso_t *) psos;
+} rxcore_pso_cache_t;
+
+/// @brief The state used by materials unless told otherwise: back face culling, depth testing, no blending
+rxcore_pso_state_t rxcore_pso_state_default();
+bool rxcore_pso_state_equals(const rxcore_pso_state_t *a, const rxcore_pso_state_t *b);
+
+/// @brief Creates a key for buffers with 16-bit indices, the index_size of a buffer holding larger meshes replaces it when drawing
+rxcore_pso_key_t rxcore_pso_key_create(rxcore_shader_set_t set, rxcore_vertex_layout_t layout, rxcore_pso_state_t state);
+uint64_t rxcore_pso_key_hash(const rxcore_pso_key_t *key);
+bool rxcore_pso_key_equals(const rxcore_pso_key_t *a, const rxcore_pso_key_t *b);
+
+/// @brief Orders keys so that keys sharing a program end up next to each other, usable with qsort
+int rxcore_pso_key_compare(const rxcore_pso_key_t *a, const rxcore_pso_key_t *b);
+
+/// @brief Creates an empty cache, allocated on the heap
+/// @param shader_registry The registry used to get the programs of the keys
+rxcore_pso_cache_t *rxcore_pso_cache_create(rxcore_shader_registry_t *shader_registry);
+
+/// @brief Gets the pipeline state object for a key, creating it the first time the key is requested
+/// @return A pointer to the pso, or NULL if the key's shader set could not be compiled. Stays valid until the cache is destroyed
+rxcore_pso_t *rxcore_pso_cache_get(rxcore_pso_cache_t *cache, const rxcore_pso_key_t *key);
+
+void rxcore_pso_cache_destroy(rxcore_pso_cache_t *cache);
+
+// private methods
+rxcore_pso_t *_rxcore_pso_create(rxcore_pso_cache_t *cache, const rxcore_pso_key_t *key, uint64_t hash);
+
+#endif // __PSO_H__
@@ -12,26 +12,24 @@ rxcore_render_group_t *_rxcore_render_group_create_empty()
 {
     rxcore_render_group_t *group = malloc(sizeof(rxcore_render_group_t));
     group->items = gs_dyn_array_new(rxcore_render_item_t);
+    group->structure_version = 0;
     return group;
 }
 
-void _rxcore_render_group_traversal(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data)
+void _rxcore_render_group_add_proxy(gs_dyn_array(rxcore_material_group_t) *material_groups, rxcore_render_snapshot_t *snapshot, uint32_t index)
 {
-    gs_dyn_array(rxcore_material_group_t) *material_groups = (gs_dyn_array(rxcore_material_group_t) *)user_data;
-                 
-    if (node->material == NULL || rxcore_mesh_is_empty(&node->mesh))
-    {
-        return;
-    }
-
+    rxcore_render_proxy_t *proxy = &snapshot->proxies[index];
 
-    // check if we have a material group for this material
+    // check if we have a material group for this material, vertex layout and index size
+    rxcore_vertex_layout_t layout = proxy->mesh.buffer != NULL ? proxy->mesh.buffer->layout : RXCORE_VERTEX_LAYOUT_DEFAULT;
+    uint32_t index_size = proxy->mesh.buffer != NULL ? proxy->mesh.buffer->index_size : sizeof(uint16_t);
     rxcore_material_group_t *material_group = NULL;
     for (uint32_t i = 0; i < gs_dyn_array_size(*material_groups); i++)
     {
-        if ((*material_groups)[i].material == node->material)
+        if ((*material_groups)[i].material == proxy->material && (*material_groups)[i].layout == layout &&
+            (*material_groups)[i].index_size == index_size)
         {
-            // gs_println("Found material group for material %p", node->material);
+            // gs_println("Found material group for material %d", proxy->material);
             material_group = &(*material_groups)[i];
             break;
         }
@@ -39,9 +37,12 @@ void _rxcore_render_group_traversal(rxcore_scene_node_t *node, gs_mat4 model_mat
 
     if (material_group == NULL)
     {
-        gs_println("Creating new material group for material %p", node->material);
+        RXCORE_LOG_TRACE("rendering::render_group", "Creating new material group for material %d", proxy->material);
         rxcore_material_group_t new_group = {0};
-        new_group.material = node->material;
+        new_group.material = proxy->material;
+        new_group.pso_key = snapshot->materials[proxy->material].pso_key;
+        new_group.layout = layout;
+        new_group.index_size = index_size;
         new_group.draw_items = gs_dyn_array_new(rxcore_draw_item_t);
         gs_dyn_array_push(*material_groups, new_group);
         material_group = &(*material_groups)[gs_dyn_array_size(*material_groups) - 1];
@@ -51,45 +52,58 @@ void _rxcore_render_group_traversal(rxcore_scene_node_t *node, gs_mat4 model_mat
     // gs_println("Material group: %p", material_group);
 
     rxcore_draw_item_t draw_item = {0};
-    draw_item.model_matrix = model_matrix;
-    draw_item.node = node;
+    draw_item.proxy = index;
     gs_dyn_array_push(material_group->draw_items, draw_item);
 }
 
-bool rxcore_material_group_compare(const void *a, const void *b)
+int rxcore_material_group_compare(const void *a, const void *b)
 {
-    rxcore_material_t *ma = ((rxcore_material_group_t *)a)->material;
-    rxcore_material_t *mb = ((rxcore_material_group_t *)b)->material;
-
-    // sort by shader set
-    // this doesn't really matter, just that all the materials with the same shader set are together
-    return (
-        (size_t)ma->shader_set.fragment_shader + (size_t)ma->shader_set.vertex_shader) >
-        ((size_t)mb->shader_set.fragment_shader + (size_t)mb->shader_set.vertex_shader
-    );
+    rxcore_material_group_t *ga = (rxcore_material_group_t *)a;
+    rxcore_material_group_t *gb = (rxcore_material_group_t *)b;
+
+    // sort by pso, so that the pipeline is only rebound when it actually changes
+    rxcore_pso_key_t key_a = ga->pso_key;
+    rxcore_pso_key_t key_b = gb->pso_key;
+    key_a.layout = ga->layout;
+    key_b.layout = gb->layout;
+    key_a.index_size = ga->index_size;
+    key_b.index_size = gb->index_size;
+    int pso_order = rxcore_pso_key_compare(&key_a, &key_b);
+    if (pso_order != 0)
+    {
+        return pso_order;
+    }
+
+    // then by material, just to keep the order stable between rebuilds
+    return ga->material < gb->material ? -1 : ga->material > gb->material;
 }
 
-rxcore_render_group_t *rxcore_render_group_create(rxcore_scene_graph_t *graph)
+rxcore_render_group_t *rxcore_render_group_create(rxcore_render_snapshot_t *snapshot)
 {
     gs_dyn_array(rxcore_material_group_t) material_groups = gs_dyn_array_new(rxcore_material_group_t);
-    rxcore_scene_graph_traverse(graph, _rxcore_render_group_traversal, &material_groups);
+    for (uint32_t i = 0; i < gs_dyn_array_size(snapshot->proxies); i++)
+    {
+        _rxcore_render_group_add_proxy(&material_groups, snapshot, i);
+    }
 
     // now we need to sort the material groups by material
     // so that we can swap materials efficiently
     uint32_t num_groups = gs_dyn_array_size(material_groups);
-    gs_println("Number of material groups: %d", num_groups);
-    // qsort(material_groups, num_groups, sizeof(rxcore_material_group_t), rxcore_material_group_compare);
+    qsort(material_groups, num_groups, sizeof(rxcore_material_group_t), rxcore_material_group_compare);
 
     rxcore_render_group_t *res = _rxcore_render_group_create_empty();
+    res->structure_version = snapshot->structure_version;
 
     for (uint32_t i = 0; i < num_groups; i++)
     {
-        gs_println("Adding material group %d", i);
-        gs_println("Num draw items: %d", gs_dyn_array_size(material_groups[i].draw_items));
+        RXCORE_LOG_TRACE("rendering::render_group", "Adding material group %d with %d draw items", i, gs_dyn_array_size(material_groups[i].draw_items));
         rxcore_material_group_t group = material_groups[i];
         rxcore_render_item_t item = {0};
         item.type = RXCORE_SWAP_ITEM;
-        item.swap_item.material = group.material;
+        item.swap_item.proxy = group.draw_items[0].proxy;
+        item.swap_item.pso_key = group.pso_key;
+        item.swap_item.layout = group.layout;
+        item.swap_item.index_size = group.index_size;
         gs_dyn_array_push(res->items, item);
 
         for (uint32_t j = 0; j < gs_dyn_array_size(group.draw_items); j++)
@@ -103,10 +117,12 @@ rxcore_render_group_t *rxcore_render_group_create(rxcore_scene_graph_t *graph)
     
     }
 
-    gs_println("Number of items in render group: %d", gs_dyn_array_size(res->items));
-    gs_println("Number of material groups: %d", gs_dyn_array_size(material_groups));
+    RXCORE_LOG_DEBUG("rendering::render_group", "Created render group with %d items in %d material groups",
+                     gs_dyn_array_size(res->items), num_groups);
 
+#if RXCORE_LOG_ENABLED(RXCORE_LOG_LEVEL_TRACE)
     rxcore_render_group_print(res, printf);
+#endif
 
     for (uint32_t i = 0; i < gs_dyn_array_size(material_groups); i++)
     {
@@ -114,11 +130,17 @@ rxcore_render_group_t *rxcore_render_group_create(rxcore_scene_graph_t *graph)
     }
     gs_dyn_array_free(material_groups);
 
-    gs_println("Render group created");
-
     return res;
 }
 
+rxcore_pso_key_t rxcore_swap_item_get_pso_key(const rxcore_swap_item_t *item)
+{
+    rxcore_pso_key_t key = item->pso_key;
+    key.layout = item->layout;
+    key.index_size = item->index_size;
+    return key;
+}
+
 void rxcore_render_group_print(rxcore_render_group_t *group, void (*print_fn)(const char *str, ...))
 {
     print_fn("Render Group:\n");
@@ -129,12 +151,11 @@ void rxcore_render_group_print(rxcore_render_group_t *group, void (*print_fn)(co
         {
         case RXCORE_DRAW_ITEM:
             print_fn("  Draw Item\n");
-            print_fn("    Model Matrix: %f %f %f %f\n", item.draw_item.model_matrix.elements[0], item.draw_item.model_matrix.elements[1], item.draw_item.model_matrix.elements[2], item.draw_item.model_matrix.elements[3]);
-            print_fn("    Node: %p\n", item.draw_item.node);
+            print_fn("    Proxy: %d\n", item.draw_item.proxy);
             break;
         case RXCORE_SWAP_ITEM:
             print_fn("  Swap Item\n");
-            print_fn("    Material: %p\n", item.swap_item.material);
+            print_fn("    Material of proxy: %d\n", item.swap_item.proxy);
             break;
         }
     }
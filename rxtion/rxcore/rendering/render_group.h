@@ -6,21 +6,30 @@
 #include <rxcore/rendering/material.h>
 #include <rxcore/rendering/shader.h>
 #include <rxcore/rendering/scene_graph.h>
+#include <rxcore/rendering/pso.h>
+#include <rxcore/rendering/render_snapshot.h>
 
 typedef struct rxcore_draw_item_t
 {
-    gs_mat4 model_matrix;
-    rxcore_scene_node_t *node;
+    uint32_t proxy; // index into the proxies of the snapshot being rendered
+    uint32_t lod;   // of the proxy's mesh, picked by each view as it culls and always 0 in the render group
 } rxcore_draw_item_t;
 
 typedef struct rxcore_swap_item_t
 {
-    rxcore_material_t *material; // non-owning pointer, owned by the material registry
+    uint32_t proxy;                // the first drawn with the material, whose material is bound from the snapshot being rendered
+    rxcore_pso_key_t pso_key;      // of the material
+    rxcore_vertex_layout_t layout; // of the mesh buffers drawn until the next swap, which replaces the one in the material's pso key
+    uint32_t index_size;           // the same for the size of their indices
+    rxcore_pso_t *pso; // non-owning pointer, owned by the pso cache. resolved by the pipeline on the main thread
 } rxcore_swap_item_t;
 
 typedef struct rxcore_material_group_t 
 {
-    rxcore_material_t *material; // non-owning pointer, owned by the material registry
+    uint32_t material;             // index into the materials of the snapshot the group is built from
+    rxcore_pso_key_t pso_key;      // of the material
+    rxcore_vertex_layout_t layout; // meshes in buffers of different layouts need different pipelines, so they get their own groups
+    uint32_t index_size;           // as do meshes in buffers with 16 and 32-bit indices
     gs_dyn_array(rxcore_draw_item_t) draw_items; // owning pointers
 } rxcore_material_group_t;
 
@@ -42,13 +51,17 @@ typedef struct rxcore_render_item_t
 typedef struct rxcore_render_group_t
 {
     gs_dyn_array(rxcore_render_item_t) items;
+    uint32_t structure_version; // of the snapshot it was built from, proxy indices are only valid for the same version
 } rxcore_render_group_t;
 
 void _rxcore_material_group_destroy(rxcore_material_group_t *group);
-void _rxcore_render_group_traversal(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data);
+void _rxcore_render_group_add_proxy(gs_dyn_array(rxcore_material_group_t) *material_groups, rxcore_render_snapshot_t *snapshot, uint32_t index);
+int rxcore_material_group_compare(const void *a, const void *b);
 
 rxcore_render_group_t *_rxcore_render_group_create_empty();
-rxcore_render_group_t *rxcore_render_group_create(rxcore_scene_graph_t *graph);
+rxcore_render_group_t *rxcore_render_group_create(rxcore_render_snapshot_t *snapshot);
+/// @return The pso key a swap item draws with, the material's with the layout and index size of the swap item
+rxcore_pso_key_t rxcore_swap_item_get_pso_key(const rxcore_swap_item_t *item);
 void rxcore_render_group_print(rxcore_render_group_t *group, void (*print_fn)(const char *str, ...));
 void rxcore_render_group_destroy(rxcore_render_group_t *group);
 
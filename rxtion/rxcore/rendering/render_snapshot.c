@@ -0,0 +1,166 @@
+// render_snapshot.c
+
+#include <rxcore/rendering/render_snapshot.h>
+
+rxcore_render_snapshots_t *rxcore_render_snapshots_create()
+{
+    rxcore_render_snapshots_t *snapshots = malloc(sizeof(rxcore_render_snapshots_t));
+    memset(snapshots, 0, sizeof(rxcore_render_snapshots_t));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        snapshots->buffers[i].proxies = gs_dyn_array_new(rxcore_render_proxy_t);
+        snapshots->buffers[i].cull_bounds = rxcore_cull_bounds_create(0);
+        snapshots->buffers[i].occluders = gs_dyn_array_new(uint32_t);
+        snapshots->buffers[i].materials = gs_dyn_array_new(rxcore_render_material_t);
+        snapshots->buffers[i].uniforms = gs_dyn_array_new(gs_graphics_bind_uniform_desc_t);
+        snapshots->buffers[i].uniform_data = gs_dyn_array_new(uint8_t);
+        snapshots->buffers[i].cameras = gs_dyn_array_new(rxcore_render_camera_t);
+    }
+
+    // render groups start out at version 0, so the first snapshot always builds one
+    snapshots->structure_version = 1;
+    return snapshots;
+}
+
+void rxcore_render_snapshots_extract(rxcore_render_snapshots_t *snapshots, rxcore_scene_graph_t *graph, rxcore_camera_t **cameras, uint32_t camera_count, float aspect_ratio)
+{
+    rxcore_render_snapshot_t *snapshot = &snapshots->buffers[snapshots->write_index];
+
+    // the traversal clears the dirty flag, so check it first
+    if (graph->is_dirty)
+    {
+        snapshots->structure_version++;
+    }
+
+    gs_dyn_array_clear(snapshot->proxies);
+    rxcore_cull_bounds_clear(snapshot->cull_bounds);
+    gs_dyn_array_clear(snapshot->occluders);
+    gs_dyn_array_clear(snapshot->materials);
+    gs_dyn_array_clear(snapshot->uniforms);
+    gs_dyn_array_clear(snapshot->uniform_data);
+    snapshot->frame = snapshots->frame++;
+    rxcore_scene_graph_traverse(graph, _rxcore_render_snapshot_extract_node, snapshot);
+
+    // the data kept moving as it grew, so the uniforms only point into it once it is all there
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < gs_dyn_array_size(snapshot->uniforms); i++)
+    {
+        snapshot->uniforms[i].data = snapshot->uniform_data + offset;
+        offset += snapshot->uniforms[i].binding;
+    }
+
+    // only rebuilds what changed since the last tick, most of the time nothing
+    if (camera_count > 0)
+    {
+        rxcore_camera_set_aspect_ratio(cameras[0], aspect_ratio);
+    }
+
+    gs_dyn_array_clear(snapshot->cameras);
+    for (uint32_t i = 0; i < camera_count; i++)
+    {
+        gs_dyn_array_push(snapshot->cameras, _rxcore_render_snapshot_extract_camera(cameras[i]));
+    }
+
+    snapshot->structure_version = snapshots->structure_version;
+}
+
+void rxcore_render_snapshots_publish(rxcore_render_snapshots_t *snapshots)
+{
+    snapshots->write_index = 1 - snapshots->write_index;
+}
+
+rxcore_render_snapshot_t *rxcore_render_snapshots_get_read(rxcore_render_snapshots_t *snapshots)
+{
+    return &snapshots->buffers[1 - snapshots->write_index];
+}
+
+void rxcore_render_snapshots_destroy(rxcore_render_snapshots_t *snapshots)
+{
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        gs_dyn_array_free(snapshots->buffers[i].proxies);
+        rxcore_cull_bounds_destroy(snapshots->buffers[i].cull_bounds);
+        gs_dyn_array_free(snapshots->buffers[i].occluders);
+        gs_dyn_array_free(snapshots->buffers[i].materials);
+        gs_dyn_array_free(snapshots->buffers[i].uniforms);
+        gs_dyn_array_free(snapshots->buffers[i].uniform_data);
+        gs_dyn_array_free(snapshots->buffers[i].cameras);
+    }
+    free(snapshots);
+}
+
+void _rxcore_render_snapshot_extract_node(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data)
+{
+    rxcore_render_snapshot_t *snapshot = user_data;
+
+    // nodes that can't be drawn don't need a proxy
+    if (node->material == NULL || rxcore_mesh_is_empty(&node->mesh))
+    {
+        return;
+    }
+
+    rxcore_render_proxy_t proxy = {0};
+    proxy.world_matrix = model_matrix;
+    proxy.bounds = node->world_bounds; // already in world space, the traversal keeps it up to date
+    proxy.mesh = node->mesh;
+    proxy.material = _rxcore_render_snapshot_extract_material(snapshot, node->material);
+    proxy.is_occluder = node->is_occluder;
+    if (proxy.is_occluder)
+    {
+        gs_dyn_array_push(snapshot->occluders, gs_dyn_array_size(snapshot->proxies));
+    }
+    gs_dyn_array_push(snapshot->proxies, proxy);
+    rxcore_cull_bounds_push(snapshot->cull_bounds, &proxy.bounds);
+}
+
+uint32_t _rxcore_render_snapshot_extract_material(rxcore_render_snapshot_t *snapshot, rxcore_material_t *material)
+{
+    // most materials are shared by many nodes, which share one copy of it
+    if (material->snapshot_frame == snapshot->frame)
+    {
+        return material->snapshot_index;
+    }
+
+    rxcore_render_material_t res = {0};
+    res.pso_key = material->pso_key;
+    res.first_uniform = gs_dyn_array_size(snapshot->uniforms);
+    for (uint32_t i = 0; i < material->num_uniforms; i++)
+    {
+        gs_graphics_bind_uniform_desc_t binding = material->uniform_bindings[i];
+        if (binding.data == NULL)
+        {
+            continue;
+        }
+
+        // rxcore_material_add_binding stores the size of the data in the binding slot. Growing by at least double keeps
+        // the copies of the first tick from reallocating for every uniform
+        uint32_t size = gs_dyn_array_size(snapshot->uniform_data);
+        uint32_t needed = size + (uint32_t)binding.binding;
+        if (needed > (uint32_t)gs_dyn_array_capacity(snapshot->uniform_data))
+        {
+            gs_dyn_array_reserve(snapshot->uniform_data, gs_max(needed, (uint32_t)gs_dyn_array_capacity(snapshot->uniform_data) * 2));
+        }
+        memcpy(snapshot->uniform_data + size, binding.data, binding.binding);
+        gs_dyn_array_head(snapshot->uniform_data)->size = needed;
+        binding.data = NULL;
+        gs_dyn_array_push(snapshot->uniforms, binding);
+        res.num_uniforms++;
+    }
+
+    material->snapshot_frame = snapshot->frame;
+    material->snapshot_index = gs_dyn_array_size(snapshot->materials);
+    gs_dyn_array_push(snapshot->materials, res);
+    return material->snapshot_index;
+}
+
+rxcore_render_camera_t _rxcore_render_snapshot_extract_camera(rxcore_camera_t *camera)
+{
+    rxcore_render_camera_t res = {0};
+    res.position = camera->position;
+    res.view_matrix = rxcore_camera_get_view_matrix(camera);
+    res.projection_matrix = rxcore_camera_get_projection_matrix(camera);
+    res.frustum = *rxcore_camera_get_frustum(camera);
+    res.view_uniform = camera->view_uniform;
+    res.projection_uniform = camera->projection_uniform;
+    return res;
+}
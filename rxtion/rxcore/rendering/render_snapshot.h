@@ -0,0 +1,88 @@
+#ifndef __RENDER_SNAPSHOT_H__
+#define __RENDER_SNAPSHOT_H__
+
+#include <gs/gs.h>
+#include <stdbool.h>
+#include <rxcore/profiler.h>
+#include <rxcore/rendering/mesh.h>
+#include <rxcore/rendering/material.h>
+#include <rxcore/rendering/scene_graph.h>
+#include <rxcore/rendering/camera.h>
+#include <rxcore/bounding_box.h>
+#include <rxcore/frustum.h>
+#include <rxcore/cull.h>
+
+/// @brief The part of a scene node that rendering needs, copied out so the node can keep changing
+typedef struct rxcore_render_proxy_t
+{
+    gs_mat4 world_matrix;
+    rxcore_bounding_box_t bounds; // the bounds of the mesh in world space
+    rxcore_mesh_t mesh;           // only the buffer and the ranges inside of it. Rendering reads just the gpu side of the buffer
+    uint32_t material;            // index into the materials of the snapshot
+    bool is_occluder;
+} rxcore_render_proxy_t;
+
+/// @brief The part of a material that rendering needs, its uniforms copied out so the material can keep changing
+typedef struct rxcore_render_material_t
+{
+    rxcore_pso_key_t pso_key;
+    uint32_t first_uniform; // into the uniforms of the snapshot
+    uint32_t num_uniforms;  // only those with a value bound to them
+} rxcore_render_material_t;
+
+/// @brief The part of a camera that rendering needs
+typedef struct rxcore_render_camera_t
+{
+    gs_vec3 position;
+    gs_mat4 view_matrix;
+    gs_mat4 projection_matrix;
+    rxcore_frustum_t frustum; // in world space
+    gs_handle(gs_graphics_uniform_t) view_uniform;
+    gs_handle(gs_graphics_uniform_t) projection_uniform;
+} rxcore_render_camera_t;
+
+/// @brief Everything needed to render one frame, which is never changed once it is published
+typedef struct rxcore_render_snapshot_t
+{
+    gs_dyn_array(rxcore_render_proxy_t) proxies; // in scene graph order, so indices are stable until the structure changes
+    rxcore_cull_bounds_t *cull_bounds;           // the bounds of the proxies again, packed for the culler
+    gs_dyn_array(uint32_t) occluders;            // the proxies that hide what is behind them
+    gs_dyn_array(rxcore_render_material_t) materials; // one for every material the proxies use
+    gs_dyn_array(gs_graphics_bind_uniform_desc_t) uniforms; // of the materials, their data pointing into uniform_data
+    gs_dyn_array(uint8_t) uniform_data;
+    gs_dyn_array(rxcore_render_camera_t) cameras; // in the order they were extracted, every view picks one by index
+    uint32_t structure_version; // changes whenever nodes are added or removed
+    uint64_t frame;
+} rxcore_render_snapshot_t;
+
+/// @brief Two snapshots, one being extracted into by the simulation and one being read by rendering
+typedef struct rxcore_render_snapshots_t
+{
+    rxcore_render_snapshot_t buffers[2];
+    uint32_t write_index;
+    uint32_t structure_version;
+    uint64_t frame;
+} rxcore_render_snapshots_t;
+
+rxcore_render_snapshots_t *rxcore_render_snapshots_create();
+
+/// @brief Copies the scene and cameras into the snapshot that isn't being read, updating world matrices on the way
+/// @param cameras The first is the main camera, which follows the framebuffer. The others keep the aspect ratio they have
+/// @param aspect_ratio The aspect ratio of the framebuffer, given to the main camera if it is a perspective one
+void rxcore_render_snapshots_extract(rxcore_render_snapshots_t *snapshots, rxcore_scene_graph_t *graph, rxcore_camera_t **cameras, uint32_t camera_count, float aspect_ratio);
+
+/// @brief Makes the last extracted snapshot the one rendering reads. Rendering of the previous snapshot must be done,
+/// everything before this can overlap with it
+void rxcore_render_snapshots_publish(rxcore_render_snapshots_t *snapshots);
+
+/// @brief Gets the snapshot to render from, valid until the next publish
+rxcore_render_snapshot_t *rxcore_render_snapshots_get_read(rxcore_render_snapshots_t *snapshots);
+
+void rxcore_render_snapshots_destroy(rxcore_render_snapshots_t *snapshots);
+
+// private methods
+void _rxcore_render_snapshot_extract_node(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data);
+uint32_t _rxcore_render_snapshot_extract_material(rxcore_render_snapshot_t *snapshot, rxcore_material_t *material);
+rxcore_render_camera_t _rxcore_render_snapshot_extract_camera(rxcore_camera_t *camera);
+
+#endif // __RENDER_SNAPSHOT_H__
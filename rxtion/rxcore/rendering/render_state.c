@@ -0,0 +1,190 @@
+// render_state.c
+
+#include <rxcore/rendering/render_state.h>
+#include <gs/gs.h>
+
+rxcore_render_state_t rxcore_render_state_create(gs_command_buffer_t *cb)
+{
+    rxcore_render_state_t state = {0};
+    state.cb = cb;
+    rxcore_render_state_invalidate(&state);
+    return state;
+}
+
+void rxcore_render_state_invalidate(rxcore_render_state_t *state)
+{
+    // handle ids start at 1, so 0 never matches a real resource
+    state->pipeline_id = 0;
+    _rxcore_render_state_invalidate_bindings(state);
+}
+
+void _rxcore_render_state_invalidate_bindings(rxcore_render_state_t *state)
+{
+    state->vertex_buffer_id = 0;
+    state->index_buffer_id = 0;
+    state->uniform_count = 0;
+}
+
+bool rxcore_render_state_bind_pipeline(rxcore_render_state_t *state, gs_handle(gs_graphics_pipeline_t) pipeline)
+{
+    if (state->pipeline_id == pipeline.id)
+    {
+        state->stats.filtered++;
+        return false;
+    }
+
+    gs_graphics_pipeline_bind(state->cb, pipeline);
+    state->stats.issued++;
+
+    // uniforms live in the program, and the vertex layout lives in the pipeline
+    // so nothing that was bound before can be trusted anymore
+    _rxcore_render_state_invalidate_bindings(state);
+    state->pipeline_id = pipeline.id;
+    return true;
+}
+
+bool rxcore_render_state_bind_buffers(rxcore_render_state_t *state, gs_handle(gs_graphics_vertex_buffer_t) vb, gs_handle(gs_graphics_index_buffer_t) ib)
+{
+    if (state->vertex_buffer_id == vb.id && state->index_buffer_id == ib.id)
+    {
+        state->stats.filtered++;
+        return false;
+    }
+
+    gs_graphics_bind_desc_t binds = {
+        .vertex_buffers = {.desc = &(gs_graphics_bind_vertex_buffer_desc_t){.buffer = vb}},
+        .index_buffers = {.desc = &(gs_graphics_bind_index_buffer_desc_t){.buffer = ib}},
+    };
+    gs_graphics_apply_bindings(state->cb, &binds);
+    state->stats.issued++;
+
+    state->vertex_buffer_id = vb.id;
+    state->index_buffer_id = ib.id;
+    return true;
+}
+
+rxcore_render_state_uniform_t *_rxcore_render_state_find_uniform(rxcore_render_state_t *state, uint32_t uniform_id)
+{
+    for (uint32_t i = 0; i < state->uniform_count; i++)
+    {
+        if (state->uniforms[i].uniform_id == uniform_id)
+        {
+            return &state->uniforms[i];
+        }
+    }
+
+    return NULL;
+}
+
+bool _rxcore_render_state_uniform_changed(rxcore_render_state_t *state, uint32_t uniform_id, void *data, uint32_t size)
+{
+    if (size > RXCORE_RENDER_STATE_MAX_UNIFORM_SIZE)
+    {
+        return true;
+    }
+
+    rxcore_render_state_uniform_t *cached = _rxcore_render_state_find_uniform(state, uniform_id);
+    if (cached != NULL && cached->size == size && memcmp(cached->data, data, size) == 0)
+    {
+        return false;
+    }
+
+    if (cached == NULL)
+    {
+        if (state->uniform_count == RXCORE_RENDER_STATE_MAX_UNIFORMS)
+        {
+            // the cache is full, the value will just be issued every time
+            return true;
+        }
+
+        cached = &state->uniforms[state->uniform_count++];
+        cached->uniform_id = uniform_id;
+    }
+
+    cached->size = size;
+    memcpy(cached->data, data, size);
+    return true;
+}
+
+bool rxcore_render_state_bind_uniform(rxcore_render_state_t *state, gs_handle(gs_graphics_uniform_t) uniform, void *data, uint32_t size)
+{
+    if (!_rxcore_render_state_uniform_changed(state, uniform.id, data, size))
+    {
+        state->stats.filtered++;
+        return false;
+    }
+
+    gs_graphics_bind_uniform_desc_t uniform_desc = {
+        .uniform = uniform,
+        .data = data,
+    };
+
+    gs_graphics_bind_desc_t bind_desc = {
+        .uniforms = {
+            .desc = &uniform_desc,
+            .size = sizeof(gs_graphics_bind_uniform_desc_t),
+        }};
+
+    gs_graphics_apply_bindings(state->cb, &bind_desc);
+    state->stats.issued++;
+    return true;
+}
+
+bool rxcore_render_state_bind_uniforms(rxcore_render_state_t *state, const gs_graphics_bind_uniform_desc_t *uniforms, uint32_t count)
+{
+    gs_graphics_bind_uniform_desc_t changed[RXCORE_RENDER_STATE_MAX_UNIFORMS];
+    uint32_t num_changed = 0;
+    bool issued = false;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        gs_graphics_bind_uniform_desc_t binding = uniforms[i];
+        if (binding.data == NULL)
+        {
+            // nothing has been bound to this uniform yet
+            continue;
+        }
+
+        // rxcore_material_add_binding stores the size of the data in the binding slot
+        if (!_rxcore_render_state_uniform_changed(state, binding.uniform.id, binding.data, binding.binding))
+        {
+            state->stats.filtered++;
+            continue;
+        }
+
+        // the shadow copy already holds the new value, so it has to be issued even when more changed than fit in one batch
+        if (num_changed == RXCORE_RENDER_STATE_MAX_UNIFORMS)
+        {
+            _rxcore_render_state_apply_uniforms(state, changed, num_changed);
+            num_changed = 0;
+            issued = true;
+        }
+        changed[num_changed++] = binding;
+    }
+
+    if (num_changed > 0)
+    {
+        _rxcore_render_state_apply_uniforms(state, changed, num_changed);
+        issued = true;
+    }
+    return issued;
+}
+
+void _rxcore_render_state_apply_uniforms(rxcore_render_state_t *state, gs_graphics_bind_uniform_desc_t *uniforms, uint32_t count)
+{
+    gs_graphics_bind_desc_t bind_desc = {
+        .uniforms = {
+            .desc = uniforms,
+            .size = count * sizeof(gs_graphics_bind_uniform_desc_t),
+        }};
+
+    gs_graphics_apply_bindings(state->cb, &bind_desc);
+    state->stats.issued += count;
+}
+
+void rxcore_render_state_report(rxcore_render_state_t *state)
+{
+    RXCORE_PROFILER_COUNTER_SET("render_state_issued", state->stats.issued);
+    RXCORE_PROFILER_COUNTER_SET("render_state_filtered", state->stats.filtered);
+    state->stats = (rxcore_render_state_stats_t){0};
+}
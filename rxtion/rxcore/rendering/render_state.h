@@ -0,0 +1,75 @@
+#ifndef __RENDER_STATE_H__
+#define __RENDER_STATE_H__
+
+#include <gs/gs.h>
+#include <stdbool.h>
+#include <rxcore/profiler.h>
+#include <rxcore/rendering/shader.h>
+#include <rxcore/rendering/material.h>
+
+// the largest uniform we will shadow, anything bigger is always issued
+#define RXCORE_RENDER_STATE_MAX_UNIFORM_SIZE sizeof(gs_mat4)
+#define RXCORE_RENDER_STATE_MAX_UNIFORMS 32
+
+/// @brief A shadow copy of the last value bound to a uniform
+typedef struct rxcore_render_state_uniform_t
+{
+    uint32_t uniform_id;
+    uint32_t size;
+    uint8_t data[RXCORE_RENDER_STATE_MAX_UNIFORM_SIZE];
+} rxcore_render_state_uniform_t;
+
+/// @brief Counts of the commands that reached the command buffer, and the ones that were dropped
+typedef struct rxcore_render_state_stats_t
+{
+    uint32_t issued;
+    uint32_t filtered;
+} rxcore_render_state_stats_t;
+
+/// @brief Tracks what is currently bound on a command buffer, so that redundant binds can be skipped
+typedef struct rxcore_render_state_t
+{
+    gs_command_buffer_t *cb;
+    uint32_t pipeline_id;
+    uint32_t vertex_buffer_id;
+    uint32_t index_buffer_id;
+    rxcore_render_state_uniform_t uniforms[RXCORE_RENDER_STATE_MAX_UNIFORMS];
+    uint32_t uniform_count;
+    rxcore_render_state_stats_t stats;
+} rxcore_render_state_t;
+
+/// @brief Creates an empty render state, with nothing bound
+/// @param cb The command buffer that the binds will be recorded into
+rxcore_render_state_t rxcore_render_state_create(gs_command_buffer_t *cb);
+
+/// @brief Forgets everything that is bound, should be called whenever a render pass begins
+/// @param state The render state to reset
+void rxcore_render_state_invalidate(rxcore_render_state_t *state);
+
+/// @brief Binds a pipeline, unless it is already bound. Binding a new pipeline invalidates buffers and uniforms
+/// @return true if the bind was issued to the command buffer
+bool rxcore_render_state_bind_pipeline(rxcore_render_state_t *state, gs_handle(gs_graphics_pipeline_t) pipeline);
+
+/// @brief Binds a vertex and index buffer, unless both are already bound
+/// @return true if the bind was issued to the command buffer
+bool rxcore_render_state_bind_buffers(rxcore_render_state_t *state, gs_handle(gs_graphics_vertex_buffer_t) vb, gs_handle(gs_graphics_index_buffer_t) ib);
+
+/// @brief Binds a single uniform, unless the bound value is byte-for-byte identical
+/// @return true if the bind was issued to the command buffer
+bool rxcore_render_state_bind_uniform(rxcore_render_state_t *state, gs_handle(gs_graphics_uniform_t) uniform, void *data, uint32_t size);
+
+/// @brief Binds a block of uniforms, such as those of a material in a render snapshot, only issuing the ones that changed
+/// @return true if any bind was issued to the command buffer
+bool rxcore_render_state_bind_uniforms(rxcore_render_state_t *state, const gs_graphics_bind_uniform_desc_t *uniforms, uint32_t count);
+
+/// @brief Publishes the issued and filtered counts to the profiler, and clears them
+/// @param state The render state to report
+void rxcore_render_state_report(rxcore_render_state_t *state);
+
+// private methods
+void _rxcore_render_state_invalidate_bindings(rxcore_render_state_t *state);
+rxcore_render_state_uniform_t *_rxcore_render_state_find_uniform(rxcore_render_state_t *state, uint32_t uniform_id);
+bool _rxcore_render_state_uniform_changed(rxcore_render_state_t *state, uint32_t uniform_id, void *data, uint32_t size);
+void _rxcore_render_state_apply_uniforms(rxcore_render_state_t *state, gs_graphics_bind_uniform_desc_t *uniforms, uint32_t count);
+
+#endif // __RENDER_STATE_H__
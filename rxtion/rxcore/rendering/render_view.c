@@ -0,0 +1,236 @@
+// render_view.c
+
+#include <rxcore/rendering/render_view.h>
+#include <rxcore/cull.h>
+
+rxcore_render_view_t *rxcore_render_view_create(rxcore_render_view_desc_t desc)
+{
+    rxcore_render_view_t *view = malloc(sizeof(rxcore_render_view_t));
+    memset(view, 0, sizeof(rxcore_render_view_t));
+    view->desc = desc;
+    view->proxy_visible = gs_dyn_array_new(uint8_t);
+    view->visible_proxies = gs_dyn_array_new(uint32_t);
+    view->visible_items = gs_dyn_array_new(rxcore_render_item_t);
+    view->occlusion_boxes = gs_dyn_array_new(rxcore_bounding_box_t);
+    view->occlusion_results = gs_dyn_array_new(uint8_t);
+    view->proxy_lods = gs_dyn_array_new(uint8_t);
+    if (desc.use_occlusion)
+    {
+        view->occlusion = rxcore_occlusion_buffer_create(RXCORE_OCCLUSION_WIDTH, RXCORE_OCCLUSION_HEIGHT);
+    }
+    return view;
+}
+
+rxcore_render_camera_t *rxcore_render_view_get_camera(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot)
+{
+    if (view->desc.camera >= gs_dyn_array_size(snapshot->cameras))
+    {
+        return NULL;
+    }
+    return &snapshot->cameras[view->desc.camera];
+}
+
+void rxcore_render_view_prepare(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_group_t *group)
+{
+    uint32_t num_proxies = gs_dyn_array_size(snapshot->proxies);
+
+    // the culler writes straight into the arrays, so they have to be sized up front
+    gs_dyn_array_reserve(view->visible_proxies, num_proxies);
+    gs_dyn_array_reserve(view->proxy_visible, num_proxies);
+    gs_dyn_array_head(view->visible_proxies)->size = num_proxies;
+    gs_dyn_array_head(view->proxy_visible)->size = num_proxies;
+
+    // proxy indices mean something else once the structure changes, so the lods picked for them do too
+    if (view->structure_version != snapshot->structure_version || gs_dyn_array_size(view->proxy_lods) != num_proxies)
+    {
+        gs_dyn_array_reserve(view->proxy_lods, num_proxies);
+        gs_dyn_array_head(view->proxy_lods)->size = num_proxies;
+        memset(view->proxy_lods, 0, num_proxies);
+        view->structure_version = snapshot->structure_version;
+    }
+
+    // the draw list is never longer than the render group
+    gs_dyn_array_reserve(view->visible_items, gs_dyn_array_size(group->items));
+    if (view->occlusion != NULL)
+    {
+        gs_dyn_array_reserve(view->occlusion_boxes, num_proxies);
+        gs_dyn_array_reserve(view->occlusion_results, num_proxies);
+    }
+}
+
+void rxcore_render_view_cull(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_jobs_t *jobs)
+{
+    uint32_t num_proxies = gs_dyn_array_size(snapshot->proxies);
+    rxcore_render_camera_t *camera = rxcore_render_view_get_camera(view, snapshot);
+    memset(view->proxy_visible, 0, num_proxies);
+
+    // a view whose camera wasn't extracted sees nothing
+    if (camera == NULL)
+    {
+        gs_dyn_array_head(view->visible_proxies)->size = 0;
+        view->in_frustum = 0;
+        view->visible = 0;
+        view->reduced = 0;
+        return;
+    }
+
+    gs_dyn_array_head(view->visible_proxies)->size = num_proxies;
+    uint32_t in_frustum = rxcore_cull_frustum_parallel(jobs, &camera->frustum, snapshot->cull_bounds, view->visible_proxies);
+    gs_dyn_array_head(view->visible_proxies)->size = in_frustum;
+
+    // the render group is in material order, so it looks visibility up by proxy
+    for (uint32_t i = 0; i < in_frustum; i++)
+    {
+        view->proxy_visible[view->visible_proxies[i]] = 1;
+    }
+
+    uint32_t visible = in_frustum;
+    if (view->occlusion != NULL && gs_dyn_array_size(snapshot->occluders) > 0)
+    {
+        visible = _rxcore_render_view_occlude(view, snapshot, jobs);
+    }
+
+    _rxcore_render_view_select_lods(view, snapshot, camera);
+    view->in_frustum = in_frustum;
+    view->visible = visible;
+}
+
+void rxcore_render_view_build_draw_list(rxcore_render_view_t *view, rxcore_render_group_t *group)
+{
+    gs_dyn_array_clear(view->visible_items);
+
+    // a swap is only kept once something after it is drawn
+    rxcore_render_item_t *pending_swap = NULL;
+    for (uint32_t i = 0; i < gs_dyn_array_size(group->items); i++)
+    {
+        rxcore_render_item_t *item = &group->items[i];
+        if (item->type == RXCORE_SWAP_ITEM)
+        {
+            pending_swap = item;
+            continue;
+        }
+
+        if (!view->proxy_visible[item->draw_item.proxy])
+        {
+            continue;
+        }
+
+        if (pending_swap != NULL)
+        {
+            gs_dyn_array_push(view->visible_items, *pending_swap);
+            pending_swap = NULL;
+        }
+        rxcore_render_item_t draw = *item;
+        draw.draw_item.lod = view->proxy_lods[item->draw_item.proxy];
+        gs_dyn_array_push(view->visible_items, draw);
+    }
+}
+
+float rxcore_render_view_get_screen_size(rxcore_render_camera_t *camera, rxcore_bounding_box_t *bounds)
+{
+    // the sphere around the box, which covers about the same whichever way it is looked at
+    gs_vec3 center = gs_vec3_scale(gs_vec3_add(bounds->min, bounds->max), 0.5f);
+    float radius = gs_vec3_len(gs_vec3_sub(bounds->max, bounds->min)) * 0.5f;
+
+    // the projection scales y by cot(fov / 2) for perspective, and by 2 / height for orthographic, which has no w to divide by
+    gs_mat4 projection = camera->projection_matrix;
+    float scale = projection.elements[5];
+    if (projection.elements[15] != 0.f)
+    {
+        return radius * scale;
+    }
+
+    float distance = gs_vec3_len(gs_vec3_sub(center, camera->position));
+    if (distance <= radius)
+    {
+        return 1.f;
+    }
+    return radius * scale / distance;
+}
+
+void rxcore_render_view_destroy(rxcore_render_view_t *view)
+{
+    gs_dyn_array_free(view->proxy_visible);
+    gs_dyn_array_free(view->visible_proxies);
+    gs_dyn_array_free(view->visible_items);
+    gs_dyn_array_free(view->occlusion_boxes);
+    gs_dyn_array_free(view->occlusion_results);
+    gs_dyn_array_free(view->proxy_lods);
+    if (view->occlusion != NULL)
+    {
+        rxcore_occlusion_buffer_destroy(view->occlusion);
+    }
+    free(view);
+}
+
+uint32_t _rxcore_render_view_occlude(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_jobs_t *jobs)
+{
+    rxcore_render_camera_t *camera = rxcore_render_view_get_camera(view, snapshot);
+    rxcore_occlusion_buffer_begin(view->occlusion, gs_mat4_mul(camera->projection_matrix, camera->view_matrix));
+
+    // occluders outside the frustum can't hide anything inside it
+    for (uint32_t i = 0; i < gs_dyn_array_size(snapshot->occluders); i++)
+    {
+        uint32_t index = snapshot->occluders[i];
+        if (!view->proxy_visible[index])
+        {
+            continue;
+        }
+
+        // the coarsest lod is plenty for an occluder, and the cheapest to rasterize
+        rxcore_render_proxy_t *proxy = &snapshot->proxies[index];
+        rxcore_mesh_t *mesh = &proxy->mesh;
+        rxcore_mesh_lod_t lod = rxcore_mesh_get_lod(mesh, RXCORE_MESH_MAX_LODS - 1);
+        rxcore_vertex_t *vertices = mesh->buffer->vertices + lod.base_vertex;
+        rxcore_occlusion_buffer_add_triangles(view->occlusion, &vertices->position, sizeof(rxcore_vertex_t), mesh->buffer->indices + lod.starting_index, lod.index_count, proxy->world_matrix);
+    }
+    rxcore_occlusion_buffer_end(view->occlusion);
+
+    uint32_t visible = gs_dyn_array_size(view->visible_proxies);
+    gs_dyn_array_clear(view->occlusion_boxes);
+    gs_dyn_array_head(view->occlusion_results)->size = visible;
+    for (uint32_t i = 0; i < visible; i++)
+    {
+        gs_dyn_array_push(view->occlusion_boxes, snapshot->proxies[view->visible_proxies[i]].bounds);
+    }
+
+    rxcore_occlusion_buffer_test_aabbs(view->occlusion, jobs, view->occlusion_boxes, visible, view->occlusion_results);
+
+    // keep the order of the survivors, and hide the rest from the render group
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < visible; i++)
+    {
+        uint32_t index = view->visible_proxies[i];
+        if (view->occlusion_results[i])
+        {
+            view->visible_proxies[kept++] = index;
+        }
+        else
+        {
+            view->proxy_visible[index] = 0;
+        }
+    }
+    gs_dyn_array_head(view->visible_proxies)->size = kept;
+
+    return kept;
+}
+
+void _rxcore_render_view_select_lods(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_camera_t *camera)
+{
+    // only visible proxies are looked at, the rest keep whatever lod they had when they were last seen
+    uint32_t reduced = 0;
+    for (uint32_t i = 0; i < gs_dyn_array_size(view->visible_proxies); i++)
+    {
+        uint32_t index = view->visible_proxies[i];
+        rxcore_render_proxy_t *proxy = &snapshot->proxies[index];
+        if (proxy->mesh.lod_count <= 1)
+        {
+            continue;
+        }
+
+        float screen_size = rxcore_render_view_get_screen_size(camera, &proxy->bounds);
+        view->proxy_lods[index] = (uint8_t)rxcore_mesh_select_lod(&proxy->mesh, screen_size, view->proxy_lods[index]);
+        reduced += view->proxy_lods[index] > 0;
+    }
+    view->reduced = reduced;
+}
@@ -0,0 +1,77 @@
+#ifndef __RENDER_VIEW_H__
+#define __RENDER_VIEW_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rxcore/rendering/render_snapshot.h>
+#include <rxcore/rendering/render_group.h>
+#include <rxcore/rendering/occlusion.h>
+#include <rxcore/rendering/frame_graph.h>
+#include <rxcore/jobs.h>
+
+// the view every pipeline starts with, which renders the main camera to the backbuffer
+#define RXCORE_RENDER_VIEW_MAIN 0
+
+/**
+ * Example Usage
+ * uint32_t camera = rxcore_rendering_context_add_camera(&ctx, minimap_camera);
+ * uint32_t target = rxcore_pipeline_add_render_target(pipeline, (rxcore_render_target_desc_t){"minimap", GS_GRAPHICS_TEXTURE_FORMAT_RGBA8, 0.25f});
+ * rxcore_pipeline_add_view(pipeline, (rxcore_render_view_desc_t){.name = "minimap", .camera = camera, .target = target});
+ */
+
+typedef struct rxcore_rendering_context_t rxcore_rendering_context_t;
+
+typedef struct rxcore_render_view_desc_t
+{
+    const char *name;     // of the frame graph pass the view is rendered in
+    uint32_t camera;      // index into the cameras of the snapshot, 0 being the main camera
+    uint32_t target;      // the frame graph target rendered into, RXCORE_RENDER_TARGET_BACKBUFFER for the screen
+    gs_vec4 clear_color;
+    bool use_occlusion;   // rasterizes the occluders from this view's camera, only worth it for views that draw a lot
+} rxcore_render_view_desc_t;
+
+/// @brief One camera looking at the shared snapshot, with what it can see and the draws left once the rest is culled
+typedef struct rxcore_render_view_t
+{
+    rxcore_render_view_desc_t desc;
+    rxcore_rendering_context_t *ctx;                    // set when the pipeline begins, for the pass of the view
+    gs_dyn_array(uint8_t) proxy_visible;                // per proxy of the snapshot being rendered
+    gs_dyn_array(uint32_t) visible_proxies;             // indices of the proxies that passed culling
+    gs_dyn_array(rxcore_render_item_t) visible_items;   // the render group without culled draws, or swaps with nothing to draw
+    rxcore_occlusion_buffer_t *occlusion;               // NULL unless the view uses occlusion
+    gs_dyn_array(rxcore_bounding_box_t) occlusion_boxes; // the bounds of the proxies that passed frustum culling
+    gs_dyn_array(uint8_t) occlusion_results;
+    gs_dyn_array(uint8_t) proxy_lods;                   // per proxy, kept from frame to frame so lods only change past the hysteresis
+    uint32_t structure_version;                         // of the snapshot the lods were picked for, they start over when it changes
+    uint32_t in_frustum;                                // results of the last cull, reported by the pipeline
+    uint32_t visible;
+    uint32_t reduced;                                   // visible proxies drawn with a coarser lod
+} rxcore_render_view_t;
+
+rxcore_render_view_t *rxcore_render_view_create(rxcore_render_view_desc_t desc);
+
+/// @return The camera of the view in the snapshot, or NULL if the snapshot has no such camera
+rxcore_render_camera_t *rxcore_render_view_get_camera(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot);
+
+/// @brief Sizes everything the view fills in for the snapshot and render group, so that culling never allocates
+/// and views can be culled on the job system
+void rxcore_render_view_prepare(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_group_t *group);
+
+/// @brief Culls the snapshot against the frustum of the view's camera, and then its occluders if the view uses them
+/// @param jobs May be NULL, in which case everything runs on the calling thread
+void rxcore_render_view_cull(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_jobs_t *jobs);
+
+/// @brief Fills the draw list with the visible part of the render group, keeping its order, and the lod each draw uses
+void rxcore_render_view_build_draw_list(rxcore_render_view_t *view, rxcore_render_group_t *group);
+
+/// @return How much of the screen's height a box covers from the camera, 1 being all of it
+float rxcore_render_view_get_screen_size(rxcore_render_camera_t *camera, rxcore_bounding_box_t *bounds);
+
+void rxcore_render_view_destroy(rxcore_render_view_t *view);
+
+// private methods
+uint32_t _rxcore_render_view_occlude(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_jobs_t *jobs);
+void _rxcore_render_view_select_lods(rxcore_render_view_t *view, rxcore_render_snapshot_t *snapshot, rxcore_render_camera_t *camera);
+
+#endif // __RENDER_VIEW_H__
@@ -12,6 +12,11 @@ rxcore_scene_node_t *rxcore_scene_node_create(rxcore_transform_t transform, rxco
     node->children = gs_dyn_array_new(rxcore_scene_node_t *);
     node->parent = NULL;
     node->graph = NULL;
+    node->world_matrix = gs_mat4_identity();
+    node->world_bounds = rxcore_bounding_box_empty();
+    node->subtree_bounds = rxcore_bounding_box_empty();
+    node->bvh_leaf = RXCORE_BVH_NULL;
+    node->is_occluder = false;
     return node;
 }
 
@@ -22,12 +27,13 @@ void rxcore_scene_node_add_child(rxcore_scene_node_t *node, rxcore_scene_node_t
 
     gs_dyn_array_push(node->children, child);
     child->parent = node;
-    child->graph = node->graph;
 
-    // update the graph's node count
-    if (child->graph)
+    // the child may bring a whole branch with it, all of which the traversal stacks need room for
+    uint32_t count = _rxcore_scene_node_attach(child, node->graph);
+    if (node->graph)
     {
-        child->graph->node_count++;
+        node->graph->node_count += count;
+        node->graph->is_dirty = true;
     }
 }
 
@@ -42,6 +48,7 @@ rxcore_scene_node_t *rxcore_scene_node_copy(rxcore_scene_node_t *node, bool deep
 
     copy->parent = NULL;
     copy->graph = NULL;
+    copy->is_occluder = node->is_occluder;
 
     if (deep_copy)
     {
@@ -64,15 +71,15 @@ void rxcore_scene_node_remove_child(rxcore_scene_node_t *node, rxcore_scene_node
     {
         if (node->children[i] == child)
         {
-            // turn this into a scene_graph real quick lol
-            rxcore_scene_graph_t *graph = rxcore_scene_graph_create_from_node(child);
-            // free this graph to destroy all the children
-            rxcore_scene_graph_destroy(graph);
+            // the whole branch goes, not just the child
+            uint32_t count = _rxcore_scene_node_count(child);
+            rxcore_scene_node_destroy(child);
             node->children[i] = NULL;
             // update the graph's node count
             if (node->graph)
             {
-                node->graph->node_count--;
+                node->graph->node_count -= count;
+                node->graph->is_dirty = true;
             }
 
             // create a new array, and copy all the children except the one we are removing
@@ -102,6 +109,11 @@ void rxcore_scene_node_destroy(rxcore_scene_node_t *node)
         rxcore_scene_node_destroy(node->children[i]);
     }
 
+    if (node->graph && node->bvh_leaf != RXCORE_BVH_NULL)
+    {
+        rxcore_bvh_remove(node->graph->bvh, node->bvh_leaf);
+    }
+
     gs_dyn_array_free(node->children);
     free(node);
 }
@@ -111,12 +123,16 @@ rxcore_scene_graph_t *rxcore_scene_graph_create()
     rxcore_scene_graph_t *graph = malloc(sizeof(rxcore_scene_graph_t));
     graph->node_count = 1;
     graph->is_dirty = false;
+    graph->bvh = rxcore_bvh_create();
+    graph->grid = rxcore_spatial_grid_create(RXCORE_SCENE_GRAPH_GRID_CELL_SIZE);
+    graph->jobs = NULL;
 
     // malloc the stacks
     uint32_t stack_size = 16;
     graph->matrix_stack = malloc(sizeof(gs_mat4) * stack_size);
     graph->node_stack = malloc(sizeof(rxcore_scene_node_t *) * stack_size);
     graph->depth_stack = malloc(sizeof(uint32_t) * stack_size);
+    graph->visit_order = malloc(sizeof(rxcore_scene_node_t *) * stack_size);
     graph->stack_size = stack_size;
 
     // create the root node
@@ -139,6 +155,8 @@ rxcore_scene_graph_t *rxcore_scene_graph_create_from_node(rxcore_scene_node_t *n
     rxcore_scene_graph_t *graph = rxcore_scene_graph_create();
     rxcore_scene_node_destroy(graph->root);
     graph->root = node;
+    graph->node_count = _rxcore_scene_node_attach(node, graph);
+    graph->is_dirty = true;
     return graph;
 }
 
@@ -177,6 +195,10 @@ void rxcore_scene_graph_traverse(rxcore_scene_graph_t *graph, rxcore_scene_graph
     uint32_t *depth_stack = graph->depth_stack;
     uint32_t depth_stack_ptr = 0;
 
+    rxcore_scene_node_t **visit_order = graph->visit_order;
+    uint32_t visit_count = 0;
+    rxcore_spatial_grid_clear(graph->grid);
+
     // traverse the graph in a depth first manner
     node_stack[node_stack_ptr++] = graph->root;
     matrix_stack[model_stack_ptr++] = model_matrix;
@@ -188,6 +210,15 @@ void rxcore_scene_graph_traverse(rxcore_scene_graph_t *graph, rxcore_scene_graph
         model_matrix = matrix_stack[--model_stack_ptr];
         depth = depth_stack[--depth_stack_ptr];
         node->world_matrix = model_matrix;
+        node->world_bounds = rxcore_bounding_box_transform(&node->mesh.bounds, model_matrix);
+        _rxcore_scene_graph_sync_bvh(graph, node);
+
+        // the grid ids are the visit order, so they can be turned back into nodes
+        if (node != graph->root)
+        {
+            rxcore_spatial_grid_push(graph->grid, gs_v2(model_matrix.elements[12], model_matrix.elements[13]), visit_count);
+        }
+        visit_order[visit_count++] = node;
 
         // call the traversal function
         if (fn)
@@ -203,6 +234,81 @@ void rxcore_scene_graph_traverse(rxcore_scene_graph_t *graph, rxcore_scene_graph
             depth_stack[depth_stack_ptr++] = depth + 1;
         }
     }
+
+    _rxcore_scene_graph_update_subtree_bounds(graph, visit_count);
+    rxcore_bvh_refit(graph->bvh);
+    rxcore_spatial_grid_build(graph->grid, graph->jobs);
+}
+
+void rxcore_scene_graph_rebuild_bvh(rxcore_scene_graph_t *graph)
+{
+    RXCORE_SCENE_GRAPH_UPDATE_MATRICES(graph);
+    rxcore_bvh_rebuild(graph->bvh);
+}
+
+rxcore_scene_node_t *rxcore_scene_graph_get_grid_node(rxcore_scene_graph_t *graph, uint32_t id)
+{
+    assert(id < graph->node_count);
+    return graph->visit_order[id];
+}
+
+void rxcore_scene_graph_traverse_culled(rxcore_scene_graph_t *graph, rxcore_frustum_t *frustum, rxcore_scene_graph_traveral_fn fn, void *user_data)
+{
+    // the stacks are only sized by the full traversal, so nodes added since then haven't been seen yet
+    if (graph->is_dirty)
+    {
+        rxcore_scene_graph_traverse(graph, NULL, NULL);
+    }
+
+    rxcore_scene_node_t **node_stack = graph->node_stack;
+    uint32_t *depth_stack = graph->depth_stack;
+    uint32_t stack_ptr = 0;
+
+    node_stack[stack_ptr] = graph->root;
+    depth_stack[stack_ptr++] = 0;
+
+    while (stack_ptr > 0)
+    {
+        rxcore_scene_node_t *node = node_stack[--stack_ptr];
+        uint32_t depth = depth_stack[stack_ptr];
+
+        // nothing below this node can be seen, so none of it needs to be looked at
+        if (rxcore_bounding_box_is_empty(&node->subtree_bounds) || !rxcore_frustum_test_aabb(frustum, &node->subtree_bounds))
+        {
+            continue;
+        }
+
+        if (!rxcore_bounding_box_is_empty(&node->world_bounds) && rxcore_frustum_test_aabb(frustum, &node->world_bounds))
+        {
+            fn(node, node->world_matrix, depth, user_data);
+        }
+
+        for (uint32_t i = 0; i < gs_dyn_array_size(node->children); i++)
+        {
+            node_stack[stack_ptr] = node->children[i];
+            depth_stack[stack_ptr++] = depth + 1;
+        }
+    }
+}
+
+bool rxcore_scene_graph_raycast(rxcore_scene_graph_t *graph, rxcore_ray_t *ray, float max_distance, rxcore_scene_raycast_hit_t *hit_out)
+{
+    if (graph->is_dirty)
+    {
+        rxcore_scene_graph_traverse(graph, NULL, NULL);
+    }
+
+    // the bvh hands over the meshes whose bounds the ray passes through nearest first, and skips any behind the closest hit
+    rxcore_scene_raycast_hit_t hit = {0};
+    rxcore_bvh_query_ray(graph->bvh, ray, max_distance, _rxcore_scene_graph_raycast_node, &hit);
+    if (hit.node == NULL)
+    {
+        return false;
+    }
+
+    hit.point = rxcore_ray_get_point(ray, hit.distance);
+    *hit_out = hit;
+    return true;
 }
 
 void rxcore_scene_graph_print(rxcore_scene_graph_t *graph, void (*print_fn)(const char *str, ...))
@@ -212,9 +318,14 @@ void rxcore_scene_graph_print(rxcore_scene_graph_t *graph, void (*print_fn)(cons
 
 void rxcore_scene_graph_destroy(rxcore_scene_graph_t *graph)
 {
-    rxcore_scene_graph_traverse(graph, _rxcore_scene_graph_free_node, NULL);
+    // destroying the root takes every node with it
+    rxcore_scene_node_destroy(graph->root);
+    rxcore_bvh_destroy(graph->bvh);
+    rxcore_spatial_grid_destroy(graph->grid);
     free(graph->matrix_stack);
     free(graph->node_stack);
+    free(graph->depth_stack);
+    free(graph->visit_order);
     free(graph);
 }
 
@@ -230,19 +341,107 @@ void _rxcore_scene_graph_regen_stacks(rxcore_scene_graph_t *graph)
     // we don't care about the old data
     free(graph->matrix_stack);
     free(graph->node_stack);
+    free(graph->depth_stack);
+    free(graph->visit_order);
     // we will either double the stack size or use the node count, whichever is larger
     // the reason being that we want to avoid reallocating the stack too often
     uint32_t new_size = graph->node_count < graph->stack_size * 2 ? graph->stack_size * 2 : graph->node_count;
     graph->matrix_stack = malloc(sizeof(gs_mat4) * new_size);
     graph->node_stack = malloc(sizeof(rxcore_scene_node_t *) * new_size);
     graph->depth_stack = malloc(sizeof(uint32_t) * new_size);
+    graph->visit_order = malloc(sizeof(rxcore_scene_node_t *) * new_size);
     graph->stack_size = new_size;
     graph->is_dirty = false;
 }
 
-void _rxcore_scene_graph_free_node(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data)
+uint32_t _rxcore_scene_node_attach(rxcore_scene_node_t *node, rxcore_scene_graph_t *graph)
+{
+    // a node moving between graphs can't stay in the bvh of the old one
+    if (node->graph != graph && node->graph && node->bvh_leaf != RXCORE_BVH_NULL)
+    {
+        rxcore_bvh_remove(node->graph->bvh, node->bvh_leaf);
+        node->bvh_leaf = RXCORE_BVH_NULL;
+    }
+    node->graph = graph;
+
+    uint32_t count = 1;
+    for (uint32_t i = 0; i < gs_dyn_array_size(node->children); i++)
+    {
+        count += _rxcore_scene_node_attach(node->children[i], graph);
+    }
+    return count;
+}
+
+uint32_t _rxcore_scene_node_count(rxcore_scene_node_t *node)
+{
+    uint32_t count = 1;
+    for (uint32_t i = 0; i < gs_dyn_array_size(node->children); i++)
+    {
+        count += _rxcore_scene_node_count(node->children[i]);
+    }
+    return count;
+}
+
+void _rxcore_scene_graph_update_subtree_bounds(rxcore_scene_graph_t *graph, uint32_t count)
+{
+    // every node is visited after its parent, so walking the visits backwards
+    // finishes all of a node's children before the node itself
+    for (uint32_t i = count; i > 0; i--)
+    {
+        rxcore_scene_node_t *node = graph->visit_order[i - 1];
+        node->subtree_bounds = node->world_bounds;
+        for (uint32_t c = 0; c < gs_dyn_array_size(node->children); c++)
+        {
+            rxcore_scene_node_t *child = node->children[c];
+            if (!rxcore_bounding_box_is_empty(&child->subtree_bounds))
+            {
+                rxcore_bounding_box_encapsulate_box(&node->subtree_bounds, &child->subtree_bounds);
+            }
+        }
+    }
+}
+
+void _rxcore_scene_graph_sync_bvh(rxcore_scene_graph_t *graph, rxcore_scene_node_t *node)
+{
+    if (rxcore_bounding_box_is_empty(&node->world_bounds))
+    {
+        if (node->bvh_leaf != RXCORE_BVH_NULL)
+        {
+            rxcore_bvh_remove(graph->bvh, node->bvh_leaf);
+            node->bvh_leaf = RXCORE_BVH_NULL;
+        }
+        return;
+    }
+
+    if (node->bvh_leaf == RXCORE_BVH_NULL)
+    {
+        node->bvh_leaf = rxcore_bvh_insert(graph->bvh, &node->world_bounds, node);
+    }
+    else if (memcmp(rxcore_bvh_get_bounds(graph->bvh, node->bvh_leaf), &node->world_bounds, sizeof(rxcore_bounding_box_t)) != 0)
+    {
+        // only leaves that actually moved are refit
+        rxcore_bvh_update(graph->bvh, node->bvh_leaf, &node->world_bounds);
+    }
+}
+
+float _rxcore_scene_graph_raycast_node(uint32_t leaf, void *leaf_data, rxcore_ray_t *ray, float max_distance, void *user_data)
 {
-    rxcore_scene_node_destroy(node);
+    rxcore_scene_node_t *node = leaf_data;
+    rxcore_scene_raycast_hit_t *hit = user_data;
+
+    // testing the triangles where they are stored is cheaper than moving every one of them into the world
+    rxcore_ray_t local = rxcore_ray_transform(ray, gs_mat4_inverse(node->world_matrix));
+    rxcore_raycast_hit_t mesh_hit = {0};
+    if (!rxcore_mesh_raycast(&node->mesh, &local, max_distance, &mesh_hit))
+    {
+        return max_distance;
+    }
+
+    hit->node = node;
+    hit->distance = mesh_hit.distance;
+    hit->triangle = mesh_hit.triangle;
+    hit->barycentric = mesh_hit.barycentric;
+    return mesh_hit.distance;
 }
 
 void _rxcore_scene_graph_print_node(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data)
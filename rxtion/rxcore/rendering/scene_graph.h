@@ -7,10 +7,29 @@
 #include <rxcore/rendering/material.h>
 #include <rxcore/rendering/shader.h>
 #include <rxcore/rendering/mesh.h>
+#include <rxcore/bounding_box.h>
+#include <rxcore/frustum.h>
+#include <rxcore/bvh.h>
+#include <rxcore/raycast.h>
+#include <rxcore/spatial_grid.h>
+#include <rxcore/jobs.h>
+
+// the size of the cells of the graph's grid, in world units. Change it with rxcore_spatial_grid_set_cell_size
+#define RXCORE_SCENE_GRAPH_GRID_CELL_SIZE 4.f
 
 // forward declaration
 typedef struct rxcore_scene_node_t rxcore_scene_node_t;
 typedef struct rxcore_scene_graph_t rxcore_scene_graph_t;
+/// @brief The nearest triangle a ray cast into the scene hit
+typedef struct rxcore_scene_raycast_hit_t
+{
+    rxcore_scene_node_t *node;
+    float distance;      // along the ray, in world units if its direction is normalized
+    gs_vec3 point;       // in world space
+    uint32_t triangle;   // counted from the start of the node's mesh
+    gs_vec2 barycentric; // the weights of the second and third vertex of the triangle
+} rxcore_scene_raycast_hit_t;
+
 typedef void (*rxcore_scene_graph_traveral_fn)(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data);
 
 typedef struct rxcore_scene_node_t
@@ -22,12 +41,19 @@ typedef struct rxcore_scene_node_t
     rxcore_scene_node_t *parent;
     rxcore_scene_graph_t *graph;
     gs_mat4 world_matrix;
+    rxcore_bounding_box_t world_bounds;   // the mesh bounds in world space, empty if there is no mesh
+    rxcore_bounding_box_t subtree_bounds; // world_bounds of this node and everything below it
+    uint32_t bvh_leaf;                    // RXCORE_BVH_NULL while the node has no bounds, or isn't in a graph
+    bool is_occluder;                     // rasterized for occlusion culling, best kept to big, simple meshes like terrain
 } rxcore_scene_node_t;
 
 typedef struct rxcore_scene_graph_t
 {
     rxcore_scene_node_t *root;
     uint32_t node_count;
+    rxcore_bvh_t *bvh;           // the world bounds of every node with a mesh, kept in sync by the traversal
+    rxcore_spatial_grid_t *grid; // the world xy position of every node but the root, rebuilt by the traversal
+    rxcore_jobs_t *jobs;         // optional, non-owning. Spreads rebuilding the grid across threads
     // caches for the stacks using in the traversal
     // these are used during the traversal to avoid having to allocate memory on the stack
     // as traversals of the scene graph are likely to be frequent
@@ -37,6 +63,7 @@ typedef struct rxcore_scene_graph_t
     gs_mat4 *matrix_stack;
     rxcore_scene_node_t **node_stack;
     uint32_t *depth_stack;
+    rxcore_scene_node_t **visit_order; // the order of the last traversal, walked backwards to build subtree bounds
     uint32_t stack_size;
     bool is_dirty;
 } rxcore_scene_graph_t;
@@ -53,11 +80,30 @@ void rxcore_scene_graph_add_child(rxcore_scene_graph_t *graph, rxcore_scene_node
 void rxcore_scene_graph_remove_child(rxcore_scene_graph_t *graph, rxcore_scene_node_t *node);
 void rxcore_scene_graph_traverse(rxcore_scene_graph_t *graph, rxcore_scene_graph_traveral_fn fn, void *user_data);
 #define RXCORE_SCENE_GRAPH_UPDATE_MATRICES(graph) rxcore_scene_graph_traverse(graph, NULL, NULL)
+
+/// @brief Updates the matrices and rebuilds the bvh from scratch, best done once a scene has been loaded
+void rxcore_scene_graph_rebuild_bvh(rxcore_scene_graph_t *graph);
+
+/// @brief Gets the node behind an id found in the grid, valid until the next traversal
+rxcore_scene_node_t *rxcore_scene_graph_get_grid_node(rxcore_scene_graph_t *graph, uint32_t id);
+
+/// @brief Visits the nodes whose world bounds may be inside the frustum, skipping whole branches whose subtree bounds aren't.
+/// Uses the matrices and bounds from the last full traversal, and doesn't update them
+void rxcore_scene_graph_traverse_culled(rxcore_scene_graph_t *graph, rxcore_frustum_t *frustum, rxcore_scene_graph_traveral_fn fn, void *user_data);
+/// @brief Finds the nearest mesh triangle the ray hits, testing only the meshes whose world bounds it passes through.
+/// Uses the matrices and bounds from the last full traversal, like rxcore_scene_graph_traverse_culled
+/// @param hit_out Receives the nearest hit, untouched if there is none
+/// @return true if anything is hit before max_distance
+bool rxcore_scene_graph_raycast(rxcore_scene_graph_t *graph, rxcore_ray_t *ray, float max_distance, rxcore_scene_raycast_hit_t *hit_out);
 void rxcore_scene_graph_print(rxcore_scene_graph_t *graph, void (*print_fn)(const char *str, ...));
 void rxcore_scene_graph_destroy(rxcore_scene_graph_t *graph);
 
+uint32_t _rxcore_scene_node_attach(rxcore_scene_node_t *node, rxcore_scene_graph_t *graph);
+uint32_t _rxcore_scene_node_count(rxcore_scene_node_t *node);
 void _rxcore_scene_graph_regen_stacks(rxcore_scene_graph_t *graph);
-void _rxcore_scene_graph_free_node(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth,void *user_data);
+void _rxcore_scene_graph_update_subtree_bounds(rxcore_scene_graph_t *graph, uint32_t count);
+void _rxcore_scene_graph_sync_bvh(rxcore_scene_graph_t *graph, rxcore_scene_node_t *node);
+float _rxcore_scene_graph_raycast_node(uint32_t leaf, void *leaf_data, rxcore_ray_t *ray, float max_distance, void *user_data);
 void _rxcore_scene_graph_print_node(rxcore_scene_node_t *node, gs_mat4 model_matrix, int depth, void *user_data);
 
 #endif // __SCENE_GRAPH_H__
\ No newline at end of file
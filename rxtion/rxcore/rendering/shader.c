@@ -28,9 +28,8 @@ rxcore_shader_t *_rxcore_shader_create(rxcore_shader_registry_t *reg, rxcore_sha
     }
 
     rxcore_shader_t *shader = malloc(sizeof(rxcore_shader_t));
-    const char *shader_name_buf = malloc(strlen(desc.shader_name) + 1);
-    strcpy(shader_name_buf, desc.shader_name);
-    shader->shader_name = shader_name_buf;
+    shader->shader_id = rxcore_strid_intern(desc.shader_name);
+    shader->shader_name = rxcore_strid_get_string(shader->shader_id);
     shader->stage = desc.stage;
 
     RXCORE_SHADER_DEBUG_PRINTF("Creating shader: %s", shader->shader_name);
@@ -166,7 +165,9 @@ char *_rxcore_shader_resolve_includes(rxcore_shader_registry_t *reg, const char
         }
         else
         {
+            // the split takes the newlines out, and without them a comment or directive would swallow the rest of the source
             resolved_src = sdscat(resolved_src, line);
+            resolved_src = sdscat(resolved_src, "\n");
         }
 
         free(filename);
@@ -177,7 +178,6 @@ char *_rxcore_shader_resolve_includes(rxcore_shader_registry_t *reg, const char
 
 void _rxcore_shader_destroy(rxcore_shader_t *shader)
 {
-    free(shader->shader_name);
     free(shader->shader_src);
 }
 
@@ -185,7 +185,10 @@ rxcore_shader_registry_t *rxcore_shader_registry_create()
 {
     rxcore_shader_registry_t *reg = malloc(sizeof(rxcore_shader_registry_t));
     reg->shaders = gs_dyn_array_new(rxcore_shader_t *);
+    reg->shader_ids = rxcore_strid_map_create();
     reg->dependencies = gs_dyn_array_new(rxcore_shader_t *);
+    reg->dependency_ids = rxcore_strid_map_create();
+    reg->programs = gs_dyn_array_new(rxcore_shader_program_t *);
     return reg;
 }
 
@@ -199,6 +202,7 @@ void rxcore_shader_registry_add_dependency(rxcore_shader_registry_t *reg, const
         RXCORE_SHADER_DEBUG_PRINTF("Failed to create dependency: %s", dep_name);
         return;
     }
+    rxcore_strid_map_insert(reg->dependency_ids, dep->shader_id, gs_dyn_array_size(reg->dependencies));
     gs_dyn_array_push(reg->dependencies, dep);
 }
 
@@ -212,6 +216,7 @@ rxcore_shader_t *rxcore_shader_registry_add_shader(rxcore_shader_registry_t *reg
         return NULL;
     }
 
+    rxcore_strid_map_insert(reg->shader_ids, shader->shader_id, gs_dyn_array_size(reg->shaders));
     gs_dyn_array_push(reg->shaders, shader);
     return shader;
 }
@@ -247,6 +252,63 @@ rxcore_shader_set_t rxcore_shader_registry_get_shader_set(rxcore_shader_registry
     return set;
 }
 
+rxcore_shader_program_t *rxcore_shader_registry_get_program(rxcore_shader_registry_t *reg, rxcore_shader_set_t set)
+{
+    for (uint32_t i = 0; i < gs_dyn_array_size(reg->programs); i++)
+    {
+        rxcore_shader_program_t *program = reg->programs[i];
+        if (rxcore_shader_set_equals(program->set, set))
+        {
+            return program;
+        }
+    }
+
+    // first time we have seen this combination, compile it
+    rxcore_shader_program_t *program = rxcore_shader_program_set(set);
+    if (!program)
+    {
+        RXCORE_SHADER_DEBUG_PRINT("Failed to create shader program for set!");
+        return NULL;
+    }
+
+    gs_dyn_array_push(reg->programs, program);
+    return program;
+}
+
+rxcore_shader_t *rxcore_shader_registry_get_variant(rxcore_shader_registry_t *reg, rxcore_shader_t *shader, const char *define)
+{
+    if (!shader)
+    {
+        return NULL;
+    }
+
+    // the copies are registered like any other shader, named after what they were made from
+    sds variant_name = sdscatprintf(sdsempty(), "%s/%s", shader->shader_name, define);
+    uint32_t index = 0;
+    if (rxcore_strid_map_get(reg->shader_ids, rxcore_strid_hash(variant_name), &index))
+    {
+        sdsfree(variant_name);
+        return reg->shaders[index];
+    }
+
+    RXCORE_SHADER_DEBUG_PRINTF("Creating shader variant: %s", variant_name);
+    rxcore_shader_t *variant = malloc(sizeof(rxcore_shader_t));
+    variant->shader_id = rxcore_strid_intern(variant_name);
+    sdsfree(variant_name);
+
+    sds variant_src = sdscatprintf(sdsempty(), "#define %s\n%s", define, shader->shader_src);
+    char *variant_src_buf = malloc(sdslen(variant_src) + 1);
+    strcpy(variant_src_buf, variant_src);
+    sdsfree(variant_src);
+
+    variant->shader_name = rxcore_strid_get_string(variant->shader_id);
+    variant->shader_src = variant_src_buf;
+    variant->stage = shader->stage;
+    rxcore_strid_map_insert(reg->shader_ids, variant->shader_id, gs_dyn_array_size(reg->shaders));
+    gs_dyn_array_push(reg->shaders, variant);
+    return variant;
+}
+
 void rxcore_shader_registry_write_compiled_shaders_to_file(rxcore_shader_registry_t *reg, const char *output_dir)
 {
     if (!gs_platform_dir_exists(output_dir))
@@ -320,20 +382,25 @@ void rxcore_shader_registry_destroy(rxcore_shader_registry_t *reg)
         _rxcore_shader_destroy(dep);
     }
 
+    for (uint32_t i = 0; i < gs_dyn_array_size(reg->programs); i++)
+    {
+        rxcore_shader_program_destroy(reg->programs[i]);
+    }
+
     gs_dyn_array_free(reg->shaders);
+    rxcore_strid_map_destroy(reg->shader_ids);
     gs_dyn_array_free(reg->dependencies);
+    rxcore_strid_map_destroy(reg->dependency_ids);
+    gs_dyn_array_free(reg->programs);
     free(reg);
 }
 
 rxcore_shader_t *_rxcore_shader_registry_find_dependency(rxcore_shader_registry_t *reg, const char *shader_name)
 {
-    for (uint32_t i = 0; i < gs_dyn_array_size(reg->dependencies); i++)
+    uint32_t index = 0;
+    if (rxcore_strid_map_get(reg->dependency_ids, rxcore_strid_hash(shader_name), &index))
     {
-        rxcore_shader_t *dep = reg->dependencies[i];
-        if (strcmp(dep->shader_name, shader_name) == 0)
-        {
-            return dep;
-        }
+        return reg->dependencies[index];
     }
 
     RXCORE_SHADER_DEBUG_PRINTF("Dependency not found: %s", shader_name);
@@ -342,13 +409,10 @@ rxcore_shader_t *_rxcore_shader_registry_find_dependency(rxcore_shader_registry_
 
 rxcore_shader_t *_rxcore_shader_registry_find_shader(rxcore_shader_registry_t *reg, const char *shader_name)
 {
-    for (uint32_t i = 0; i < gs_dyn_array_size(reg->shaders); i++)
+    uint32_t index = 0;
+    if (rxcore_strid_map_get(reg->shader_ids, rxcore_strid_hash(shader_name), &index))
     {
-        rxcore_shader_t *shader = reg->shaders[i];
-        if (strcmp(shader->shader_name, shader_name) == 0)
-        {
-            return shader;
-        }
+        return reg->shaders[index];
     }
 
     RXCORE_SHADER_DEBUG_PRINTF("Shader not found: %s", shader_name);
@@ -386,7 +450,7 @@ rxcore_shader_program_t *rxcore_shader_program_set(rxcore_shader_set_t set)
     strncat(program_name, set.vertex_shader->shader_name,
             gs_clamp(strlen(set.vertex_shader->shader_name), 1, 31));
             
-    gs_println("Creating shader program: %s", program_name);
+    RXCORE_SHADER_DEBUG_PRINTF("Creating shader program: %s", program_name);
 
     gs_graphics_shader_desc_t shader_desc =
     {
@@ -398,13 +462,17 @@ rxcore_shader_program_t *rxcore_shader_program_set(rxcore_shader_set_t set)
     };
 
     strncpy(shader_desc.name, program_name, 63);
-    shader_desc.name[64] = '\0';
+    shader_desc.name[63] = '\0';
 
     gs_handle(gs_graphics_shader_t) shader = gs_graphics_shader_create(&shader_desc);
 
+    char *program_name_buf = malloc(strlen(program_name) + 1);
+    strcpy(program_name_buf, program_name);
+
     rxcore_shader_program_t *program = malloc(sizeof(rxcore_shader_program_t));
     program->program = shader;
-    program->program_name = program_name;
+    program->program_name = program_name_buf;
+    program->set = set;
 
     return program;
 }
@@ -2,14 +2,16 @@
 #define __SHADER_H__
 
 #include <gs/gs.h>
+#include <rxcore/log.h>
 #include <rxcore/profiler.h>
+#include <rxcore/strid.h>
 
 #define SRC_MAX_LENGTH 1024
 #define RXCORE_SHADER_DEBUG
 
 #ifdef RXCORE_SHADER_DEBUG
-#define RXCORE_SHADER_DEBUG_PRINT(str) gs_println("RXCORE::rendering::shader::" str)
-#define RXCORE_SHADER_DEBUG_PRINTF(str, ...) gs_println("RXCORE::rendering::shader::" str, __VA_ARGS__)
+#define RXCORE_SHADER_DEBUG_PRINT(str) RXCORE_LOG_DEBUG("rendering::shader", str)
+#define RXCORE_SHADER_DEBUG_PRINTF(str, ...) RXCORE_LOG_DEBUG("rendering::shader", str, __VA_ARGS__)
 #else
 #define RXCORE_SHADER_DEBUG_PRINT(...) ((void)0)
 #define RXCORE_SHADER_DEBUG_PRINTF(...) ((void)0)
@@ -39,7 +41,8 @@ typedef struct rxcore_shader_desc_t
 typedef struct rxcore_shader_t
 {
     rxcore_shader_stage_t stage;
-    const char *shader_name;
+    rxcore_strid_t shader_id;
+    const char *shader_name; // interned, see rxcore/strid.h
     const char *shader_src;
 } rxcore_shader_t;
 
@@ -47,8 +50,10 @@ typedef struct rxcore_shader_t
 typedef struct rxcore_shader_registry_t
 {
     gs_dyn_array(rxcore_shader_t *) shaders;
+    rxcore_strid_map_t *shader_ids; // to indices into shaders
     gs_dyn_array(rxcore_shader_t *) dependencies;
-
+    rxcore_strid_map_t *dependency_ids;
+    gs_dyn_array(struct rxcore_shader_program_t *) programs;
 } rxcore_shader_registry_t;
 
 /// @brief A set of shaders, which can be used to create a shader program
@@ -62,8 +67,8 @@ typedef struct rxcore_shader_set_t
 typedef struct rxcore_shader_program_t
 {
     const char *program_name;
+    rxcore_shader_set_t set;
     gs_handle(gs_graphics_shader_t) program;
-    // gonna need a pipeline to stored here or smth
 } rxcore_shader_program_t;
 
 /// @brief Creates a shader description, allocated on the stack, which can be used to create a shader.
@@ -113,12 +118,26 @@ rxcore_shader_t *rxcore_shader_registry_add_shader(rxcore_shader_registry_t *reg
 /// @return The shader set, which contains the vertex and fragment shaders
 rxcore_shader_set_t rxcore_shader_registry_get_shader_set(rxcore_shader_registry_t *reg, const char *vertex_shader_name, const char *fragment_shader_name);
 
+/// @brief Gets the shader program for a shader set, compiling it the first time the set is requested
+/// @param reg The shader registry that owns the program cache
+/// @param set The shader set to get the program for
+/// @return A pointer to the cached shader program, or NULL if the set is invalid. Does not need to be freed, as it is managed by the registry
+rxcore_shader_program_t *rxcore_shader_registry_get_program(rxcore_shader_registry_t *reg, rxcore_shader_set_t set);
+
+/// @brief Gets a copy of a shader with a define at the top of it, creating it the first time it is requested.
+/// Used to build the vertex shaders of the packed vertex layouts out of the ones written for the default layout
+/// @param reg The shader registry that owns the shader, and will own the copy
+/// @param shader The shader to copy
+/// @param define The name to define, e.g. "RXCORE_VERTEX_PACKED"
+/// @return A pointer to the copy, or NULL if shader is NULL. Does not need to be freed, as it is managed by the registry
+rxcore_shader_t *rxcore_shader_registry_get_variant(rxcore_shader_registry_t *reg, rxcore_shader_t *shader, const char *define);
+
 /// @brief Writes the compiled shaders to a file
 /// @param reg The shader registry to write the compiled shaders from
 /// @param path The path to the file to write the compiled shaders to
 void rxcore_shader_registry_write_compiled_shaders_to_file(rxcore_shader_registry_t *reg, const char *path);
 
-/// @brief Frees all memory associated with the shader registry, will break shader sets, and shader ptrs created from the registry
+/// @brief Frees all memory associated with the shader registry, will break shader sets, programs, and shader ptrs created from the registry
 /// @param reg The shader registry to destroy
 void rxcore_shader_registry_destroy(rxcore_shader_registry_t *reg);
 
@@ -143,7 +162,7 @@ rxcore_shader_t *_rxcore_shader_registry_find_shader(rxcore_shader_registry_t *r
 ///@param set2 The second shader set
 bool rxcore_shader_set_equals(rxcore_shader_set_t a, rxcore_shader_set_t b);
 
-/// @brief Creates a shader program from a shader set
+/// @brief Creates a shader program from a shader set, compiling it. Prefer rxcore_shader_registry_get_program, which caches the result
 /// @param set The shader set to create the program from
 /// @return A pointer to the created shader program, allocated on the heap, or NULL if the program could not be created. Ownership is transferred to the caller
 rxcore_shader_program_t *rxcore_shader_program_set(rxcore_shader_set_t set);
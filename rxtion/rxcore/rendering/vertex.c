@@ -0,0 +1,195 @@
+// vertex.c
+
+#include <rxcore/rendering/vertex.h>
+#include <string.h>
+#include <math.h>
+
+static gs_graphics_vertex_attribute_desc_t _rxcore_vertex_layout_default_attrs[] = {
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT3, .name = "a_position"},
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT3, .name = "a_normal"},
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT2, .name = "a_uv"},
+};
+
+// the packed attributes are integers the shader unpacks, so they go by other names than what it reads
+static gs_graphics_vertex_attribute_desc_t _rxcore_vertex_layout_packed_attrs[] = {
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_FLOAT3, .name = "a_position"},
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_UINT, .name = "a_packed_normal"},
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_UINT, .name = "a_packed_uv"},
+};
+
+static gs_graphics_vertex_attribute_desc_t _rxcore_vertex_layout_packed_half_attrs[] = {
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_UINT2, .name = "a_packed_position"},
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_UINT, .name = "a_packed_normal"},
+    {.format = GS_GRAPHICS_VERTEX_ATTRIBUTE_UINT, .name = "a_packed_uv"},
+};
+
+static const rxcore_vertex_layout_info_t _rxcore_vertex_layouts[RXCORE_VERTEX_LAYOUT_COUNT] = {
+    [RXCORE_VERTEX_LAYOUT_DEFAULT] = {
+        .name = "default",
+        .attrs = _rxcore_vertex_layout_default_attrs,
+        .attr_count = sizeof(_rxcore_vertex_layout_default_attrs) / sizeof(gs_graphics_vertex_attribute_desc_t),
+        .size = sizeof(rxcore_vertex_t),
+        .shader_define = NULL,
+        .pack = NULL,
+    },
+    [RXCORE_VERTEX_LAYOUT_PACKED] = {
+        .name = "packed",
+        .attrs = _rxcore_vertex_layout_packed_attrs,
+        .attr_count = sizeof(_rxcore_vertex_layout_packed_attrs) / sizeof(gs_graphics_vertex_attribute_desc_t),
+        .size = sizeof(rxcore_vertex_packed_t),
+        .shader_define = "RXCORE_VERTEX_PACKED",
+        .pack = _rxcore_vertex_pack_packed,
+    },
+    [RXCORE_VERTEX_LAYOUT_PACKED_HALF] = {
+        .name = "packed_half",
+        .attrs = _rxcore_vertex_layout_packed_half_attrs,
+        .attr_count = sizeof(_rxcore_vertex_layout_packed_half_attrs) / sizeof(gs_graphics_vertex_attribute_desc_t),
+        .size = sizeof(rxcore_vertex_packed_half_t),
+        .shader_define = "RXCORE_VERTEX_PACKED_HALF",
+        .pack = _rxcore_vertex_pack_packed_half,
+    },
+};
+
+const rxcore_vertex_layout_info_t *rxcore_vertex_layout_get_info(rxcore_vertex_layout_t layout)
+{
+    return &_rxcore_vertex_layouts[layout < RXCORE_VERTEX_LAYOUT_COUNT ? layout : RXCORE_VERTEX_LAYOUT_DEFAULT];
+}
+
+gs_graphics_vertex_layout_desc_t rxcore_vertex_layout_get_desc(rxcore_vertex_layout_t layout)
+{
+    const rxcore_vertex_layout_info_t *info = rxcore_vertex_layout_get_info(layout);
+    return (gs_graphics_vertex_layout_desc_t){
+        .attrs = info->attrs,
+        .size = info->attr_count * sizeof(gs_graphics_vertex_attribute_desc_t),
+    };
+}
+
+void rxcore_vertex_layout_pack(rxcore_vertex_layout_t layout, const rxcore_vertex_t *vertices, uint32_t count, void *out)
+{
+    const rxcore_vertex_layout_info_t *info = rxcore_vertex_layout_get_info(layout);
+    if (info->pack == NULL)
+    {
+        memcpy(out, vertices, sizeof(rxcore_vertex_t) * count);
+        return;
+    }
+
+    info->pack(vertices, count, out);
+}
+
+uint32_t rxcore_vertex_pack_octahedral(gs_vec3 normal)
+{
+    float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    if (length == 0.f)
+    {
+        return 0;
+    }
+
+    // onto the octahedron, then the lower half is folded out over the corners of the upper one
+    float x = normal.x / length;
+    float y = normal.y / length;
+    if (normal.z < 0.f)
+    {
+        float folded_x = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+        float folded_y = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = folded_x;
+        y = folded_y;
+    }
+
+    int16_t packed_x = (int16_t)lrintf(gs_clamp(x, -1.f, 1.f) * 32767.f);
+    int16_t packed_y = (int16_t)lrintf(gs_clamp(y, -1.f, 1.f) * 32767.f);
+    return (uint32_t)(uint16_t)packed_x | ((uint32_t)(uint16_t)packed_y << 16);
+}
+
+gs_vec3 rxcore_vertex_unpack_octahedral(uint32_t packed)
+{
+    float x = gs_max((float)(int16_t)(packed & 0xffffu) / 32767.f, -1.f);
+    float y = gs_max((float)(int16_t)(packed >> 16) / 32767.f, -1.f);
+    float z = 1.f - fabsf(x) - fabsf(y);
+    if (z < 0.f)
+    {
+        float unfolded_x = (1.f - fabsf(y)) * (x >= 0.f ? 1.f : -1.f);
+        float unfolded_y = (1.f - fabsf(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = unfolded_x;
+        y = unfolded_y;
+    }
+
+    return gs_vec3_norm(gs_v3(x, y, z));
+}
+
+uint16_t rxcore_vertex_float_to_half(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t float_exponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+    int32_t exponent = (int32_t)float_exponent - 127 + 15;
+
+    // infinities and nans come out as the largest half too, a vertex has no use for either
+    if (float_exponent == 0xffu || exponent >= 31)
+    {
+        return (uint16_t)(sign | 0x7bffu);
+    }
+
+    // too small for a normal half, so the implicit bit is shifted down into the mantissa
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+        {
+            return (uint16_t)sign;
+        }
+
+        mantissa |= 0x800000u;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        half += (mantissa >> (shift - 1)) & 1u;
+        return (uint16_t)(sign | half);
+    }
+
+    // rounding may carry into the exponent, which is still the right value unless it carries past the largest half
+    uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    half += (mantissa >> 12) & 1u;
+    return (uint16_t)(sign | gs_min(half, 0x7bffu));
+}
+
+float rxcore_vertex_half_to_float(uint16_t half)
+{
+    uint32_t sign = ((uint32_t)half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1fu;
+    uint32_t mantissa = half & 0x3ffu;
+
+    if (exponent == 0)
+    {
+        float value = ldexpf((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+
+    uint32_t bits = exponent == 31 ? (sign | 0x7f800000u | (mantissa << 13)) : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void _rxcore_vertex_pack_packed(const rxcore_vertex_t *vertices, uint32_t count, void *out)
+{
+    rxcore_vertex_packed_t *packed = out;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        packed[i].position = vertices[i].position;
+        packed[i].normal = rxcore_vertex_pack_octahedral(vertices[i].normal);
+        packed[i].uv = rxcore_vertex_float_to_half(vertices[i].uv.x) | ((uint32_t)rxcore_vertex_float_to_half(vertices[i].uv.y) << 16);
+    }
+}
+
+void _rxcore_vertex_pack_packed_half(const rxcore_vertex_t *vertices, uint32_t count, void *out)
+{
+    rxcore_vertex_packed_half_t *packed = out;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        gs_vec3 position = vertices[i].position;
+        packed[i].position[0] = rxcore_vertex_float_to_half(position.x) | ((uint32_t)rxcore_vertex_float_to_half(position.y) << 16);
+        packed[i].position[1] = rxcore_vertex_float_to_half(position.z);
+        packed[i].normal = rxcore_vertex_pack_octahedral(vertices[i].normal);
+        packed[i].uv = rxcore_vertex_float_to_half(vertices[i].uv.x) | ((uint32_t)rxcore_vertex_float_to_half(vertices[i].uv.y) << 16);
+    }
+}
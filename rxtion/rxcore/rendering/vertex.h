@@ -0,0 +1,81 @@
+#ifndef __VERTEX_H__
+#define __VERTEX_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Mesh buffers always hold rxcore_vertex_t, which picking, occlusion and the mesh files read, and pack them into the
+ * buffer's layout as they are uploaded, so only the gpu copy shrinks. Vertex shaders drawn with a packed layout get its
+ * shader_define and read the same a_position, a_normal and a_uv as always, see shaders/util/vertex_util.glsl
+ *
+ * Example Usage
+ * rxcore_mesh_registry_set_layout(registry, RXCORE_VERTEX_LAYOUT_PACKED);
+ * rxcore_mesh_registry_add_mesh(registry, "rock", vertices, vertex_count, indices, index_count);
+ */
+
+typedef struct rxcore_vertex_t
+{
+    gs_vec3 position;
+    gs_vec3 normal;
+    gs_vec2 uv;
+} rxcore_vertex_t;
+
+// the vertex layouts that pipelines can be created for
+typedef enum rxcore_vertex_layout_t
+{
+    RXCORE_VERTEX_LAYOUT_DEFAULT,     // rxcore_vertex_t, position, normal and uv as floats, 32 bytes
+    RXCORE_VERTEX_LAYOUT_PACKED,      // rxcore_vertex_packed_t, 20 bytes
+    RXCORE_VERTEX_LAYOUT_PACKED_HALF, // rxcore_vertex_packed_half_t, 16 bytes
+    RXCORE_VERTEX_LAYOUT_COUNT
+} rxcore_vertex_layout_t;
+
+/// @brief A float position, with the normal and uv packed into 32 bits each. Loses nothing visible on any mesh
+typedef struct rxcore_vertex_packed_t
+{
+    gs_vec3 position;
+    uint32_t normal; // octahedral, see rxcore_vertex_pack_octahedral
+    uint32_t uv;     // two half floats, u in the low bits
+} rxcore_vertex_packed_t;
+
+/// @brief Everything packed, the position into half floats. Those keep 11 bits, a step of 1/1024 at 1 and 1/32 at 50,
+/// so it is only for meshes that stay within a few units of their origin, like props and characters
+typedef struct rxcore_vertex_packed_half_t
+{
+    uint32_t position[2]; // x and y, then z and a zero, as half floats with the first in the low bits
+    uint32_t normal;
+    uint32_t uv;
+} rxcore_vertex_packed_half_t;
+
+/// @brief How a layout is laid out in the gpu buffers and read by vertex shaders
+typedef struct rxcore_vertex_layout_info_t
+{
+    const char *name;
+    gs_graphics_vertex_attribute_desc_t *attrs;
+    uint32_t attr_count;
+    uint32_t size;             // bytes per vertex in the gpu buffers
+    const char *shader_define; // defined at the top of vertex shaders drawn with the layout, NULL for the default
+    void (*pack)(const rxcore_vertex_t *vertices, uint32_t count, void *out); // NULL when the vertices go up as they are
+} rxcore_vertex_layout_info_t;
+
+const rxcore_vertex_layout_info_t *rxcore_vertex_layout_get_info(rxcore_vertex_layout_t layout);
+gs_graphics_vertex_layout_desc_t rxcore_vertex_layout_get_desc(rxcore_vertex_layout_t layout);
+
+/// @brief Packs vertices into a layout, which has to have room for count * rxcore_vertex_layout_get_info(layout)->size bytes
+void rxcore_vertex_layout_pack(rxcore_vertex_layout_t layout, const rxcore_vertex_t *vertices, uint32_t count, void *out);
+
+/// @brief Folds a unit vector onto the octahedron and then flat, keeping both coordinates as snorm16, x in the low bits.
+/// Good to about a hundredth of a degree
+uint32_t rxcore_vertex_pack_octahedral(gs_vec3 normal);
+gs_vec3 rxcore_vertex_unpack_octahedral(uint32_t packed);
+
+/// @brief Rounds to the nearest half float, clamping to the largest one rather than becoming infinite
+uint16_t rxcore_vertex_float_to_half(float value);
+float rxcore_vertex_half_to_float(uint16_t half);
+
+// private methods
+void _rxcore_vertex_pack_packed(const rxcore_vertex_t *vertices, uint32_t count, void *out);
+void _rxcore_vertex_pack_packed_half(const rxcore_vertex_t *vertices, uint32_t count, void *out);
+
+#endif // __VERTEX_H__
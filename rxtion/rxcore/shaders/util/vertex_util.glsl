@@ -4,10 +4,44 @@ uniform mat4 u_model;
 uniform mat4 u_view;
 uniform mat4 u_projection;
 
-// attributes
+// attributes, which the packed vertex layouts unpack into the same names, see rxcore/rendering/vertex.h
+#if defined(RXCORE_VERTEX_PACKED) || defined(RXCORE_VERTEX_PACKED_HALF)
+in uint a_packed_normal;
+in uint a_packed_uv;
+
+float rxcore_unpack_half(uint h) {
+    uint exponent = (h >> 10u) & 31u;
+    uint mantissa = h & 1023u;
+    float value = exponent == 0u ? float(mantissa) / 16777216.0 : uintBitsToFloat(((exponent + 112u) << 23u) | (mantissa << 13u));
+    return (h & 32768u) != 0u ? -value : value;
+}
+
+vec2 rxcore_unpack_half2(uint packed) {
+    return vec2(rxcore_unpack_half(packed & 65535u), rxcore_unpack_half(packed >> 16u));
+}
+
+vec3 rxcore_unpack_octahedral(uint packed) {
+    vec2 e = max(vec2(float(int(packed << 16u) >> 16), float(int(packed) >> 16)) / 32767.0, vec2(-1.0));
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+#ifdef RXCORE_VERTEX_PACKED_HALF
+in uvec2 a_packed_position;
+#define a_position vec3(rxcore_unpack_half2(a_packed_position.x), rxcore_unpack_half(a_packed_position.y & 65535u))
+#else
+attribute vec3 a_position;
+#endif
+#define a_normal rxcore_unpack_octahedral(a_packed_normal)
+#define a_uv rxcore_unpack_half2(a_packed_uv)
+#else
 attribute vec3 a_position;
 attribute vec3 a_normal;
 attribute vec2 a_uv;
+#endif
 
 // pass to fragment shader
 out vec3 v_world_position;
@@ -0,0 +1,329 @@
+// spatial_grid.c
+
+#include <rxcore/spatial_grid.h>
+#include <rxcore/profiler.h>
+
+rxcore_spatial_grid_t *rxcore_spatial_grid_create(float cell_size)
+{
+    rxcore_spatial_grid_t *grid = malloc(sizeof(rxcore_spatial_grid_t));
+    memset(grid, 0, sizeof(rxcore_spatial_grid_t));
+    rxcore_spatial_grid_set_cell_size(grid, cell_size);
+    grid->points = gs_dyn_array_new(rxcore_spatial_grid_entry_t);
+    grid->point_buckets = gs_dyn_array_new(uint32_t);
+    grid->entries = gs_dyn_array_new(rxcore_spatial_grid_entry_t);
+    grid->bucket_starts = gs_dyn_array_new(uint32_t);
+    grid->chunk_counts = gs_dyn_array_new(uint32_t);
+
+    // an empty table, so that querying before the first build finds nothing rather than crashing
+    grid->table_size = 1;
+    gs_dyn_array_push(grid->bucket_starts, 0);
+    gs_dyn_array_push(grid->bucket_starts, 0);
+    return grid;
+}
+
+void rxcore_spatial_grid_set_cell_size(rxcore_spatial_grid_t *grid, float cell_size)
+{
+    assert(cell_size > 0.f);
+    grid->cell_size = cell_size;
+    grid->inv_cell_size = 1.f / cell_size;
+}
+
+void rxcore_spatial_grid_clear(rxcore_spatial_grid_t *grid)
+{
+    gs_dyn_array_clear(grid->points);
+}
+
+void rxcore_spatial_grid_push(rxcore_spatial_grid_t *grid, gs_vec2 position, uint32_t id)
+{
+    rxcore_spatial_grid_entry_t entry = {.x = position.x, .y = position.y, .id = id};
+    gs_dyn_array_push(grid->points, entry);
+}
+
+void rxcore_spatial_grid_build(rxcore_spatial_grid_t *grid, rxcore_jobs_t *jobs)
+{
+    uint32_t count = gs_dyn_array_size(grid->points);
+
+    // about one point per bucket keeps the runs short without the table outgrowing the points
+    uint32_t table_size = RXCORE_SPATIAL_GRID_MIN_TABLE_SIZE;
+    while (table_size < count)
+    {
+        table_size <<= 1;
+    }
+    grid->table_size = table_size;
+
+    // one chunk per worker, each with its own histogram, so the chunks never write to the same counter
+    uint32_t worker_count = jobs != NULL ? rxcore_jobs_get_worker_count(jobs) : 1;
+    if (count < RXCORE_SPATIAL_GRID_MIN_CHUNK_SIZE * 2)
+    {
+        worker_count = 1;
+    }
+    grid->chunk_size = gs_max((count + worker_count - 1) / worker_count, 1);
+    grid->chunk_count = (count + grid->chunk_size - 1) / grid->chunk_size;
+
+    // the jobs write straight into the arrays, so they have to be sized up front
+    gs_dyn_array_reserve(grid->point_buckets, count);
+    gs_dyn_array_reserve(grid->entries, count);
+    gs_dyn_array_reserve(grid->bucket_starts, table_size + 1);
+    gs_dyn_array_reserve(grid->chunk_counts, table_size * gs_max(grid->chunk_count, 1));
+    gs_dyn_array_head(grid->point_buckets)->size = count;
+    gs_dyn_array_head(grid->entries)->size = count;
+    gs_dyn_array_head(grid->bucket_starts)->size = table_size + 1;
+    gs_dyn_array_head(grid->chunk_counts)->size = table_size * gs_max(grid->chunk_count, 1);
+    memset(grid->chunk_counts, 0, sizeof(uint32_t) * table_size * gs_max(grid->chunk_count, 1));
+
+    if (grid->chunk_count > 1)
+    {
+        rxcore_jobs_parallel_for(jobs, count, grid->chunk_size, _rxcore_spatial_grid_count_job, grid);
+    }
+    else if (count > 0)
+    {
+        _rxcore_spatial_grid_count_job(grid, 0, count, 0);
+    }
+
+    // turn the counts into where each chunk starts writing each bucket, chunks in order within a bucket
+    uint32_t running = 0;
+    for (uint32_t b = 0; b < table_size; b++)
+    {
+        grid->bucket_starts[b] = running;
+        for (uint32_t c = 0; c < grid->chunk_count; c++)
+        {
+            uint32_t bucket_count = grid->chunk_counts[c * table_size + b];
+            grid->chunk_counts[c * table_size + b] = running;
+            running += bucket_count;
+        }
+    }
+    grid->bucket_starts[table_size] = running;
+
+    if (grid->chunk_count > 1)
+    {
+        rxcore_jobs_parallel_for(jobs, count, grid->chunk_size, _rxcore_spatial_grid_scatter_job, grid);
+    }
+    else if (count > 0)
+    {
+        _rxcore_spatial_grid_scatter_job(grid, 0, count, 0);
+    }
+
+    RXCORE_PROFILER_COUNTER_SET("spatial_grid_points", count);
+}
+
+void rxcore_spatial_grid_query_radius(rxcore_spatial_grid_t *grid, gs_vec2 center, float radius, rxcore_spatial_grid_query_fn fn, void *user_data)
+{
+    int32_t min_x = _rxcore_spatial_grid_cell(grid, center.x - radius);
+    int32_t max_x = _rxcore_spatial_grid_cell(grid, center.x + radius);
+    int32_t min_y = _rxcore_spatial_grid_cell(grid, center.y - radius);
+    int32_t max_y = _rxcore_spatial_grid_cell(grid, center.y + radius);
+    float radius_sq = radius * radius;
+
+    // a query covering more cells than there are buckets would visit every bucket, most of them many times over
+    if (_rxcore_spatial_grid_spans_table(grid, min_x, max_x, min_y, max_y))
+    {
+        for (uint32_t i = 0; i < gs_dyn_array_size(grid->entries); i++)
+        {
+            rxcore_spatial_grid_entry_t *entry = &grid->entries[i];
+            float dx = entry->x - center.x;
+            float dy = entry->y - center.y;
+            if (dx * dx + dy * dy <= radius_sq)
+            {
+                fn(entry->id, gs_v2(entry->x, entry->y), user_data);
+            }
+        }
+        return;
+    }
+
+    for (int32_t cell_y = min_y; cell_y <= max_y; cell_y++)
+    {
+        for (int32_t cell_x = min_x; cell_x <= max_x; cell_x++)
+        {
+            uint32_t bucket = _rxcore_spatial_grid_hash(grid, cell_x, cell_y);
+            for (uint32_t i = grid->bucket_starts[bucket]; i < grid->bucket_starts[bucket + 1]; i++)
+            {
+                rxcore_spatial_grid_entry_t *entry = &grid->entries[i];
+                float dx = entry->x - center.x;
+                float dy = entry->y - center.y;
+                if (dx * dx + dy * dy > radius_sq)
+                {
+                    continue;
+                }
+
+                // other cells share this bucket too, only report points from the one being visited so none are found twice
+                if (_rxcore_spatial_grid_cell(grid, entry->x) != cell_x || _rxcore_spatial_grid_cell(grid, entry->y) != cell_y)
+                {
+                    continue;
+                }
+
+                fn(entry->id, gs_v2(entry->x, entry->y), user_data);
+            }
+        }
+    }
+}
+
+void rxcore_spatial_grid_query_rect(rxcore_spatial_grid_t *grid, gs_vec2 min, gs_vec2 max, rxcore_spatial_grid_query_fn fn, void *user_data)
+{
+    int32_t min_x = _rxcore_spatial_grid_cell(grid, min.x);
+    int32_t max_x = _rxcore_spatial_grid_cell(grid, max.x);
+    int32_t min_y = _rxcore_spatial_grid_cell(grid, min.y);
+    int32_t max_y = _rxcore_spatial_grid_cell(grid, max.y);
+
+    if (_rxcore_spatial_grid_spans_table(grid, min_x, max_x, min_y, max_y))
+    {
+        for (uint32_t i = 0; i < gs_dyn_array_size(grid->entries); i++)
+        {
+            rxcore_spatial_grid_entry_t *entry = &grid->entries[i];
+            if (entry->x >= min.x && entry->x <= max.x && entry->y >= min.y && entry->y <= max.y)
+            {
+                fn(entry->id, gs_v2(entry->x, entry->y), user_data);
+            }
+        }
+        return;
+    }
+
+    for (int32_t cell_y = min_y; cell_y <= max_y; cell_y++)
+    {
+        for (int32_t cell_x = min_x; cell_x <= max_x; cell_x++)
+        {
+            uint32_t bucket = _rxcore_spatial_grid_hash(grid, cell_x, cell_y);
+            for (uint32_t i = grid->bucket_starts[bucket]; i < grid->bucket_starts[bucket + 1]; i++)
+            {
+                rxcore_spatial_grid_entry_t *entry = &grid->entries[i];
+                if (entry->x < min.x || entry->x > max.x || entry->y < min.y || entry->y > max.y)
+                {
+                    continue;
+                }
+
+                if (_rxcore_spatial_grid_cell(grid, entry->x) != cell_x || _rxcore_spatial_grid_cell(grid, entry->y) != cell_y)
+                {
+                    continue;
+                }
+
+                fn(entry->id, gs_v2(entry->x, entry->y), user_data);
+            }
+        }
+    }
+}
+
+uint32_t rxcore_spatial_grid_gather_radius(rxcore_spatial_grid_t *grid, gs_vec2 center, float radius, uint32_t *ids_out, uint32_t max_count)
+{
+    int32_t min_x = _rxcore_spatial_grid_cell(grid, center.x - radius);
+    int32_t max_x = _rxcore_spatial_grid_cell(grid, center.x + radius);
+    int32_t min_y = _rxcore_spatial_grid_cell(grid, center.y - radius);
+    int32_t max_y = _rxcore_spatial_grid_cell(grid, center.y + radius);
+    float radius_sq = radius * radius;
+
+    // the first point found is written before the count is checked
+    if (max_count == 0)
+    {
+        return 0;
+    }
+
+    uint32_t found = 0;
+
+    if (_rxcore_spatial_grid_spans_table(grid, min_x, max_x, min_y, max_y))
+    {
+        for (uint32_t i = 0; i < gs_dyn_array_size(grid->entries); i++)
+        {
+            rxcore_spatial_grid_entry_t *entry = &grid->entries[i];
+            float dx = entry->x - center.x;
+            float dy = entry->y - center.y;
+            if (dx * dx + dy * dy > radius_sq)
+            {
+                continue;
+            }
+
+            ids_out[found++] = entry->id;
+            if (found == max_count)
+            {
+                break;
+            }
+        }
+        return found;
+    }
+
+    for (int32_t cell_y = min_y; cell_y <= max_y; cell_y++)
+    {
+        for (int32_t cell_x = min_x; cell_x <= max_x; cell_x++)
+        {
+            uint32_t bucket = _rxcore_spatial_grid_hash(grid, cell_x, cell_y);
+            for (uint32_t i = grid->bucket_starts[bucket]; i < grid->bucket_starts[bucket + 1]; i++)
+            {
+                rxcore_spatial_grid_entry_t *entry = &grid->entries[i];
+                float dx = entry->x - center.x;
+                float dy = entry->y - center.y;
+                if (dx * dx + dy * dy > radius_sq)
+                {
+                    continue;
+                }
+
+                if (_rxcore_spatial_grid_cell(grid, entry->x) != cell_x || _rxcore_spatial_grid_cell(grid, entry->y) != cell_y)
+                {
+                    continue;
+                }
+
+                ids_out[found++] = entry->id;
+                if (found == max_count)
+                {
+                    return found;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+uint32_t rxcore_spatial_grid_get_count(rxcore_spatial_grid_t *grid)
+{
+    return gs_dyn_array_size(grid->points);
+}
+
+void rxcore_spatial_grid_destroy(rxcore_spatial_grid_t *grid)
+{
+    gs_dyn_array_free(grid->points);
+    gs_dyn_array_free(grid->point_buckets);
+    gs_dyn_array_free(grid->entries);
+    gs_dyn_array_free(grid->bucket_starts);
+    gs_dyn_array_free(grid->chunk_counts);
+    free(grid);
+}
+
+uint32_t _rxcore_spatial_grid_hash(rxcore_spatial_grid_t *grid, int32_t cell_x, int32_t cell_y)
+{
+    // rows are scattered across the table, but cells next to each other in a row get buckets next to each other,
+    // so the cells of a query are a few runs of memory rather than one jump per cell
+    return ((uint32_t)cell_y * 0x9E3779B1u + (uint32_t)cell_x) & (grid->table_size - 1);
+}
+
+bool _rxcore_spatial_grid_spans_table(rxcore_spatial_grid_t *grid, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y)
+{
+    // in 64 bits, a span of cells can be wider than an int32_t holds
+    uint64_t width = (uint64_t)((int64_t)max_x - min_x + 1);
+    uint64_t height = (uint64_t)((int64_t)max_y - min_y + 1);
+    return width > grid->table_size || height > grid->table_size || width * height > grid->table_size;
+}
+
+int32_t _rxcore_spatial_grid_cell(rxcore_spatial_grid_t *grid, float coordinate)
+{
+    return (int32_t)floorf(coordinate * grid->inv_cell_size);
+}
+
+void _rxcore_spatial_grid_count_job(void *data, uint32_t start, uint32_t end, uint32_t worker)
+{
+    rxcore_spatial_grid_t *grid = data;
+    uint32_t *counts = grid->chunk_counts + (start / grid->chunk_size) * grid->table_size;
+    for (uint32_t i = start; i < end; i++)
+    {
+        rxcore_spatial_grid_entry_t *point = &grid->points[i];
+        uint32_t bucket = _rxcore_spatial_grid_hash(grid, _rxcore_spatial_grid_cell(grid, point->x), _rxcore_spatial_grid_cell(grid, point->y));
+        grid->point_buckets[i] = bucket;
+        counts[bucket]++;
+    }
+}
+
+void _rxcore_spatial_grid_scatter_job(void *data, uint32_t start, uint32_t end, uint32_t worker)
+{
+    rxcore_spatial_grid_t *grid = data;
+    uint32_t *offsets = grid->chunk_counts + (start / grid->chunk_size) * grid->table_size;
+    for (uint32_t i = start; i < end; i++)
+    {
+        grid->entries[offsets[grid->point_buckets[i]]++] = grid->points[i];
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef __SPATIAL_GRID_H__
+#define __SPATIAL_GRID_H__
+
+#include <gs/gs.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <rxcore/jobs.h>
+
+// below this many points per worker, building isn't worth spreading across the job system
+#define RXCORE_SPATIAL_GRID_MIN_CHUNK_SIZE 8192
+
+// the fewest buckets the table will have, however few points there are
+#define RXCORE_SPATIAL_GRID_MIN_TABLE_SIZE 64
+
+/**
+ * Example Usage
+ * rxcore_spatial_grid_clear(grid);
+ * for each entity: rxcore_spatial_grid_push(grid, position, id);
+ * rxcore_spatial_grid_build(grid, jobs);
+ * uint32_t n = rxcore_spatial_grid_gather_radius(grid, position, 2.f, neighbours, 16);
+ */
+
+/// @brief Called for each point a query finds
+typedef void (*rxcore_spatial_grid_query_fn)(uint32_t id, gs_vec2 position, void *user_data);
+
+typedef struct rxcore_spatial_grid_entry_t
+{
+    float x;
+    float y;
+    uint32_t id;
+} rxcore_spatial_grid_entry_t;
+
+/// @brief Points in the plane, hashed by the square cell they fall in. Every build sorts the points by bucket
+/// with a counting sort, so each bucket is one contiguous run of entries
+typedef struct rxcore_spatial_grid_t
+{
+    float cell_size;
+    float inv_cell_size;
+    gs_dyn_array(rxcore_spatial_grid_entry_t) points;  // in the order they were pushed
+    gs_dyn_array(uint32_t) point_buckets;              // the bucket of each point, filled in by the build
+    gs_dyn_array(rxcore_spatial_grid_entry_t) entries; // sorted by bucket
+    gs_dyn_array(uint32_t) bucket_starts;              // table_size + 1, the entries of bucket b are [starts[b], starts[b + 1])
+    gs_dyn_array(uint32_t) chunk_counts;               // a histogram per chunk of the build, chunk major
+    uint32_t table_size;                               // always a power of two
+    uint32_t chunk_size;                               // of the build in progress
+    uint32_t chunk_count;
+} rxcore_spatial_grid_t;
+
+rxcore_spatial_grid_t *rxcore_spatial_grid_create(float cell_size);
+
+/// @brief Queries work best when the cell size is about the radius they use
+void rxcore_spatial_grid_set_cell_size(rxcore_spatial_grid_t *grid, float cell_size);
+
+void rxcore_spatial_grid_clear(rxcore_spatial_grid_t *grid);
+void rxcore_spatial_grid_push(rxcore_spatial_grid_t *grid, gs_vec2 position, uint32_t id);
+
+/// @brief Sorts the pushed points into their buckets, must be done before querying
+/// @param jobs May be NULL, in which case everything runs on the calling thread
+void rxcore_spatial_grid_build(rxcore_spatial_grid_t *grid, rxcore_jobs_t *jobs);
+
+void rxcore_spatial_grid_query_radius(rxcore_spatial_grid_t *grid, gs_vec2 center, float radius, rxcore_spatial_grid_query_fn fn, void *user_data);
+void rxcore_spatial_grid_query_rect(rxcore_spatial_grid_t *grid, gs_vec2 min, gs_vec2 max, rxcore_spatial_grid_query_fn fn, void *user_data);
+
+/// @brief Writes the ids of up to max_count points within the radius, in no particular order
+/// @return The number of ids written
+uint32_t rxcore_spatial_grid_gather_radius(rxcore_spatial_grid_t *grid, gs_vec2 center, float radius, uint32_t *ids_out, uint32_t max_count);
+
+uint32_t rxcore_spatial_grid_get_count(rxcore_spatial_grid_t *grid);
+void rxcore_spatial_grid_destroy(rxcore_spatial_grid_t *grid);
+
+// private methods
+uint32_t _rxcore_spatial_grid_hash(rxcore_spatial_grid_t *grid, int32_t cell_x, int32_t cell_y);
+int32_t _rxcore_spatial_grid_cell(rxcore_spatial_grid_t *grid, float coordinate);
+bool _rxcore_spatial_grid_spans_table(rxcore_spatial_grid_t *grid, int32_t min_x, int32_t max_x, int32_t min_y, int32_t max_y);
+void _rxcore_spatial_grid_count_job(void *data, uint32_t start, uint32_t end, uint32_t worker);
+void _rxcore_spatial_grid_scatter_job(void *data, uint32_t start, uint32_t end, uint32_t worker);
+
+#endif // __SPATIAL_GRID_H__
@@ -0,0 +1,138 @@
+// strid.c
+
+#include <rxcore/strid.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the pool isn't freed, the interned strings live as long as the program, so it doesn't go through the profiler either
+static rxcore_strid_pool_t _rxcore_strid_pool = {0};
+
+rxcore_strid_t rxcore_strid_hash(const char *str)
+{
+    rxcore_strid_t hash = RXCORE_STRID_OFFSET;
+    for (const uint8_t *c = (const uint8_t *)str; *c; c++)
+    {
+        hash = (hash ^ *c) * RXCORE_STRID_PRIME;
+    }
+    return hash;
+}
+
+rxcore_strid_t rxcore_strid_intern(const char *str)
+{
+    rxcore_strid_t id = rxcore_strid_hash(str);
+    if (_rxcore_strid_pool.ids == NULL)
+    {
+        _rxcore_strid_pool.ids = rxcore_strid_map_create();
+    }
+
+    uint32_t index;
+    if (rxcore_strid_map_get(_rxcore_strid_pool.ids, id, &index))
+    {
+        // two different strings with one id can't be told apart anywhere, which 64 bits make unlikely but not impossible
+        if (strcmp(_rxcore_strid_pool.strings[index], str) != 0)
+        {
+            RXCORE_LOG_ERROR("strid", "%s and %s have the same id %llx", _rxcore_strid_pool.strings[index], str, (unsigned long long)id);
+        }
+        return id;
+    }
+
+    size_t length = strlen(str);
+    char *copy = malloc(length + 1);
+    memcpy(copy, str, length + 1);
+    rxcore_strid_map_insert(_rxcore_strid_pool.ids, id, gs_dyn_array_size(_rxcore_strid_pool.strings));
+    gs_dyn_array_push(_rxcore_strid_pool.strings, copy);
+    return id;
+}
+
+const char *rxcore_strid_get_string(rxcore_strid_t id)
+{
+    uint32_t index;
+    if (_rxcore_strid_pool.ids == NULL || !rxcore_strid_map_get(_rxcore_strid_pool.ids, id, &index))
+    {
+        return NULL;
+    }
+    return _rxcore_strid_pool.strings[index];
+}
+
+rxcore_strid_map_t *rxcore_strid_map_create()
+{
+    rxcore_strid_map_t *map = malloc(sizeof(rxcore_strid_map_t));
+    map->capacity = 16;
+    map->count = 0;
+    map->keys = malloc(sizeof(rxcore_strid_t) * map->capacity);
+    map->values = malloc(sizeof(uint32_t) * map->capacity);
+    memset(map->values, 0xff, sizeof(uint32_t) * map->capacity);
+    return map;
+}
+
+bool rxcore_strid_map_get(const rxcore_strid_map_t *map, rxcore_strid_t id, uint32_t *value_out)
+{
+    uint32_t slot = _rxcore_strid_map_find_slot(map, id);
+    if (map->values[slot] == UINT32_MAX)
+    {
+        return false;
+    }
+    *value_out = map->values[slot];
+    return true;
+}
+
+bool rxcore_strid_map_insert(rxcore_strid_map_t *map, rxcore_strid_t id, uint32_t value)
+{
+    if ((map->count + 1) * 2 > map->capacity)
+    {
+        _rxcore_strid_map_grow(map);
+    }
+
+    uint32_t slot = _rxcore_strid_map_find_slot(map, id);
+    if (map->values[slot] != UINT32_MAX)
+    {
+        return false;
+    }
+    map->keys[slot] = id;
+    map->values[slot] = value;
+    map->count++;
+    return true;
+}
+
+void rxcore_strid_map_destroy(rxcore_strid_map_t *map)
+{
+    free(map->keys);
+    free(map->values);
+    free(map);
+}
+
+uint32_t _rxcore_strid_map_find_slot(const rxcore_strid_map_t *map, rxcore_strid_t id)
+{
+    // the ids are hashes already, the top bits are mixed the most by fnv-1a's multiply. Linear probing, which the
+    // load of at most a half keeps short
+    uint32_t mask = map->capacity - 1;
+    uint32_t slot = (uint32_t)(id >> 32 ^ id) & mask;
+    while (map->values[slot] != UINT32_MAX && map->keys[slot] != id)
+    {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void _rxcore_strid_map_grow(rxcore_strid_map_t *map)
+{
+    rxcore_strid_t *keys = map->keys;
+    uint32_t *values = map->values;
+    uint32_t capacity = map->capacity;
+
+    map->capacity = capacity * 2;
+    map->keys = malloc(sizeof(rxcore_strid_t) * map->capacity);
+    map->values = malloc(sizeof(uint32_t) * map->capacity);
+    memset(map->values, 0xff, sizeof(uint32_t) * map->capacity);
+    for (uint32_t i = 0; i < capacity; i++)
+    {
+        if (values[i] != UINT32_MAX)
+        {
+            uint32_t slot = _rxcore_strid_map_find_slot(map, keys[i]);
+            map->keys[slot] = keys[i];
+            map->values[slot] = values[i];
+        }
+    }
+    free(keys);
+    free(values);
+}
@@ -0,0 +1,84 @@
+#ifndef __STRID_H__
+#define __STRID_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <gs/gs.h>
+#include <rxcore/log.h>
+
+/**
+ * Strings as 64-bit ids, the fnv-1a hash of the string, so that finding something by name hashes the name once
+ * rather than comparing it with every name there is. RXCORE_STRID hashes a literal at compile time, and
+ * rxcore_strid_hash hashes any other string to the same id.
+ *
+ * rxcore_strid_intern keeps one copy of each string for as long as the program runs. Registries hold that copy rather
+ * than one of their own, and an id can be turned back into its name for logging.
+ *
+ * Example Usage
+ * rxcore_mesh_t rock = rxcore_mesh_registry_get_mesh_by_id(registry, RXCORE_STRID("rock"));
+ * rxcore_strid_t id = rxcore_strid_intern(name); // the name can be freed now
+ * RXCORE_LOG_DEBUG("game", "Loaded %s", rxcore_strid_get_string(id));
+ */
+
+typedef uint64_t rxcore_strid_t;
+
+#define RXCORE_STRID_OFFSET 14695981039346656037ull
+#define RXCORE_STRID_PRIME 1099511628211ull
+
+// the longest literal RXCORE_STRID hashes at compile time, longer ones are hashed when the code runs
+#define RXCORE_STRID_MAX_LITERAL 64
+
+// the id of a string literal. Folded to a constant by the compiler, though C doesn't count it as one, so it can't be a case label
+#define RXCORE_STRID(literal)                                         \
+    (sizeof("" literal "") - 1 <= RXCORE_STRID_MAX_LITERAL             \
+         ? _RXCORE_STRID_64("" literal "", 0, RXCORE_STRID_OFFSET)      \
+         : rxcore_strid_hash(literal))
+
+// one byte of fnv-1a, which leaves the hash as it is past the end of the literal
+#define _RXCORE_STRID_STEP(s, i, h)                                                                    \
+    (((h) ^ ((uint64_t)(uint8_t)(s)[(i) < sizeof(s) - 1 ? (i) : 0] * ((i) < sizeof(s) - 1))) *         \
+     ((i) < sizeof(s) - 1 ? RXCORE_STRID_PRIME : 1ull))
+#define _RXCORE_STRID_4(s, i, h) _RXCORE_STRID_STEP(s, i + 3, _RXCORE_STRID_STEP(s, i + 2, _RXCORE_STRID_STEP(s, i + 1, _RXCORE_STRID_STEP(s, i, h))))
+#define _RXCORE_STRID_16(s, i, h) _RXCORE_STRID_4(s, i + 12, _RXCORE_STRID_4(s, i + 8, _RXCORE_STRID_4(s, i + 4, _RXCORE_STRID_4(s, i, h))))
+#define _RXCORE_STRID_64(s, i, h) _RXCORE_STRID_16(s, i + 48, _RXCORE_STRID_16(s, i + 32, _RXCORE_STRID_16(s, i + 16, _RXCORE_STRID_16(s, i, h))))
+
+/// @brief An open addressing map from ids to indices, which the registries find what they hold by name with
+typedef struct rxcore_strid_map_t
+{
+    rxcore_strid_t *keys;
+    uint32_t *values;  // UINT32_MAX for an empty slot, so it can't be stored
+    uint32_t capacity; // a power of two, kept at least twice the count
+    uint32_t count;
+} rxcore_strid_map_t;
+
+/// @brief The interned strings, one of each
+typedef struct rxcore_strid_pool_t
+{
+    rxcore_strid_map_t *ids; // to indices into strings
+    gs_dyn_array(char *) strings;
+} rxcore_strid_pool_t;
+
+rxcore_strid_t rxcore_strid_hash(const char *str);
+
+/// @brief Keeps a copy of the string, unless one is kept already. Not thread safe, strings are interned as assets are
+/// registered on the main thread
+/// @return The id of the string, the same as rxcore_strid_hash gives
+rxcore_strid_t rxcore_strid_intern(const char *str);
+
+/// @return The interned copy of the string with the id, or NULL if it was never interned
+const char *rxcore_strid_get_string(rxcore_strid_t id);
+
+rxcore_strid_map_t *rxcore_strid_map_create();
+
+/// @return false if the id isn't in the map
+bool rxcore_strid_map_get(const rxcore_strid_map_t *map, rxcore_strid_t id, uint32_t *value_out);
+
+/// @return false if the id is in the map already, which keeps the value it had
+bool rxcore_strid_map_insert(rxcore_strid_map_t *map, rxcore_strid_t id, uint32_t value);
+void rxcore_strid_map_destroy(rxcore_strid_map_t *map);
+
+// private methods
+uint32_t _rxcore_strid_map_find_slot(const rxcore_strid_map_t *map, rxcore_strid_t id);
+void _rxcore_strid_map_grow(rxcore_strid_map_t *map);
+
+#endif // __STRID_H__
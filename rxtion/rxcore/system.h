@@ -3,11 +3,12 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <rxcore/log.h>
 
 #define RXCORE_SYSTEM_DEBUG
 
 #ifdef RXCORE_SYSTEM_DEBUG
-#define RXCORE_SYSTEM_DEBUG_PRINT(str, ...) gs_println("RXCORE::system::" str, __VA_ARGS__)
+#define RXCORE_SYSTEM_DEBUG_PRINT(str, ...) RXCORE_LOG_DEBUG("system", str, __VA_ARGS__)
 #else
 #define RXCORE_SYSTEM_DEBUG_PRINT(...) ((void)0)
 #endif
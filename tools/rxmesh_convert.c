@@ -0,0 +1,797 @@
+// rxmesh_convert.c
+
+/**
+ * Converts OBJ and glTF meshes into .rxmesh files, which the engine loads with rxcore_mesh_buffer_add_mesh_from_file.
+ * Built on its own, as it has a main of its own, see proc/tools/rxmesh_convert.sh
+ *
+ * Example Usage
+ * rxmesh_convert rock.rxmesh rock.obj
+ * rxmesh_convert rock.rxmesh rock.gltf rock_lod1.obj 0.25 rock_lod2.glb 0.1
+ *
+ * Every input after the first is a coarser lod, followed by the fraction of the screen's height the mesh has to cover
+ * less of for it to be drawn. Every mesh and primitive of a glTF file is merged into one, without the node transforms.
+ * Normals are generated when the input has none. Every lod is welded and reordered for drawing, see rxcore/rendering/mesh_optimizer.h
+ */
+
+#include <rxcore/rendering/mesh_file.h>
+#include <rxcore/rendering/mesh_optimizer.h>
+#include <cjson/cJSON.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// laid out like rxcore_vertex_t, which this tool can't include without the rest of the engine
+typedef struct rxmesh_vertex_t
+{
+    float position[3];
+    float normal[3];
+    float uv[2];
+} rxmesh_vertex_t;
+
+typedef struct rxmesh_t
+{
+    rxmesh_vertex_t *vertices;
+    uint32_t vertex_count;
+    uint32_t vertex_capacity;
+    uint32_t *indices;
+    uint32_t index_count;
+    uint32_t index_capacity;
+} rxmesh_t;
+
+// the position, uv and normal indices of an obj face corner, 0 when the corner doesn't have one
+typedef struct rxmesh_obj_corner_t
+{
+    int32_t position;
+    int32_t uv;
+    int32_t normal;
+} rxmesh_obj_corner_t;
+
+typedef struct rxmesh_obj_map_t
+{
+    rxmesh_obj_corner_t *keys;
+    uint32_t *values;
+    uint32_t capacity; // a power of two, kept at least twice the count
+    uint32_t count;
+} rxmesh_obj_map_t;
+
+static void *_rxmesh_grow(void *data, uint32_t *capacity, uint32_t needed, size_t element_size)
+{
+    if (needed <= *capacity)
+    {
+        return data;
+    }
+
+    uint32_t new_capacity = *capacity ? *capacity * 2 : 1024;
+    while (new_capacity < needed)
+    {
+        new_capacity *= 2;
+    }
+
+    void *grown = realloc(data, element_size * new_capacity);
+    if (grown == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    *capacity = new_capacity;
+    return grown;
+}
+
+static uint32_t _rxmesh_add_vertex(rxmesh_t *mesh, rxmesh_vertex_t vertex)
+{
+    mesh->vertices = _rxmesh_grow(mesh->vertices, &mesh->vertex_capacity, mesh->vertex_count + 1, sizeof(rxmesh_vertex_t));
+    mesh->vertices[mesh->vertex_count] = vertex;
+    return mesh->vertex_count++;
+}
+
+static void _rxmesh_add_index(rxmesh_t *mesh, uint32_t index)
+{
+    mesh->indices = _rxmesh_grow(mesh->indices, &mesh->index_capacity, mesh->index_count + 1, sizeof(uint32_t));
+    mesh->indices[mesh->index_count++] = index;
+}
+
+static void _rxmesh_free(rxmesh_t *mesh)
+{
+    free(mesh->vertices);
+    free(mesh->indices);
+    memset(mesh, 0, sizeof(rxmesh_t));
+}
+
+static char *_rxmesh_read_file(const char *path, size_t *size_out)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        return NULL;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *data = malloc((size_t)size + 1);
+    if (data == NULL || fread(data, 1, (size_t)size, f) != (size_t)size)
+    {
+        free(data);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+
+    // text formats are parsed straight out of the buffer, so it ends like a string
+    data[size] = '\0';
+    *size_out = (size_t)size;
+    return data;
+}
+
+static bool _rxmesh_ends_with(const char *str, const char *suffix)
+{
+    size_t length = strlen(str);
+    size_t suffix_length = strlen(suffix);
+    return length >= suffix_length && strcmp(str + length - suffix_length, suffix) == 0;
+}
+
+// area weighted, so big triangles count for more than the slivers around them
+static void _rxmesh_generate_normals(rxmesh_t *mesh, uint32_t first_vertex, uint32_t first_index)
+{
+    for (uint32_t i = first_vertex; i < mesh->vertex_count; i++)
+    {
+        memset(mesh->vertices[i].normal, 0, sizeof(mesh->vertices[i].normal));
+    }
+
+    for (uint32_t i = first_index; i + 2 < mesh->index_count; i += 3)
+    {
+        float *a = mesh->vertices[mesh->indices[i]].position;
+        float *b = mesh->vertices[mesh->indices[i + 1]].position;
+        float *c = mesh->vertices[mesh->indices[i + 2]].position;
+        float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+        float ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+        float n[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+        for (uint32_t corner = 0; corner < 3; corner++)
+        {
+            float *normal = mesh->vertices[mesh->indices[i + corner]].normal;
+            normal[0] += n[0];
+            normal[1] += n[1];
+            normal[2] += n[2];
+        }
+    }
+
+    for (uint32_t i = first_vertex; i < mesh->vertex_count; i++)
+    {
+        float *normal = mesh->vertices[i].normal;
+        float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0.f)
+        {
+            normal[0] /= length;
+            normal[1] /= length;
+            normal[2] /= length;
+        }
+    }
+}
+
+static uint32_t _rxmesh_obj_hash(rxmesh_obj_corner_t key)
+{
+    uint32_t hash = 2166136261u;
+    hash = (hash ^ (uint32_t)key.position) * 16777619u;
+    hash = (hash ^ (uint32_t)key.uv) * 16777619u;
+    hash = (hash ^ (uint32_t)key.normal) * 16777619u;
+    return hash;
+}
+
+static void _rxmesh_obj_map_insert(rxmesh_obj_map_t *map, rxmesh_obj_corner_t key, uint32_t value)
+{
+    uint32_t slot = _rxmesh_obj_hash(key) & (map->capacity - 1);
+    while (map->keys[slot].position != 0)
+    {
+        slot = (slot + 1) & (map->capacity - 1);
+    }
+    map->keys[slot] = key;
+    map->values[slot] = value;
+    map->count++;
+}
+
+static void _rxmesh_obj_map_grow(rxmesh_obj_map_t *map)
+{
+    rxmesh_obj_map_t old = *map;
+    map->capacity = old.capacity ? old.capacity * 2 : 4096;
+    map->keys = calloc(map->capacity, sizeof(rxmesh_obj_corner_t));
+    map->values = malloc(sizeof(uint32_t) * map->capacity);
+    map->count = 0;
+    for (uint32_t i = 0; i < old.capacity; i++)
+    {
+        if (old.keys[i].position != 0)
+        {
+            _rxmesh_obj_map_insert(map, old.keys[i], old.values[i]);
+        }
+    }
+    free(old.keys);
+    free(old.values);
+}
+
+// the same corner used by many faces is one vertex, a position with another uv or normal is another
+static uint32_t _rxmesh_obj_get_vertex(rxmesh_t *mesh, rxmesh_obj_map_t *map, rxmesh_obj_corner_t key, float *positions, float *uvs, float *normals)
+{
+    if ((map->count + 1) * 2 > map->capacity)
+    {
+        _rxmesh_obj_map_grow(map);
+    }
+
+    uint32_t slot = _rxmesh_obj_hash(key) & (map->capacity - 1);
+    while (map->keys[slot].position != 0)
+    {
+        rxmesh_obj_corner_t *existing = &map->keys[slot];
+        if (existing->position == key.position && existing->uv == key.uv && existing->normal == key.normal)
+        {
+            return map->values[slot];
+        }
+        slot = (slot + 1) & (map->capacity - 1);
+    }
+
+    rxmesh_vertex_t vertex = {0};
+    memcpy(vertex.position, &positions[(key.position - 1) * 3], sizeof(vertex.position));
+    if (key.uv != 0)
+    {
+        memcpy(vertex.uv, &uvs[(key.uv - 1) * 2], sizeof(vertex.uv));
+    }
+    if (key.normal != 0)
+    {
+        memcpy(vertex.normal, &normals[(key.normal - 1) * 3], sizeof(vertex.normal));
+    }
+
+    uint32_t index = _rxmesh_add_vertex(mesh, vertex);
+    map->keys[slot] = key;
+    map->values[slot] = index;
+    map->count++;
+    return index;
+}
+
+// obj indices start at 1, and count back from the end when negative
+static int32_t _rxmesh_obj_resolve(long index, uint32_t count)
+{
+    if (index < 0)
+    {
+        index += (long)count + 1;
+    }
+    return (index >= 1 && index <= (long)count) ? (int32_t)index : -1;
+}
+
+static bool _rxmesh_load_obj(const char *path, rxmesh_t *mesh)
+{
+    size_t size = 0;
+    char *text = _rxmesh_read_file(path, &size);
+    if (text == NULL)
+    {
+        fprintf(stderr, "%s: couldn't read the file\n", path);
+        return false;
+    }
+
+    float *positions = NULL, *uvs = NULL, *normals = NULL;
+    uint32_t position_count = 0, uv_count = 0, normal_count = 0;
+    uint32_t position_capacity = 0, uv_capacity = 0, normal_capacity = 0;
+    rxmesh_obj_map_t map = {0};
+    uint32_t first_vertex = mesh->vertex_count;
+    uint32_t first_index = mesh->index_count;
+    bool ok = true;
+
+    uint32_t line_number = 0;
+    for (char *line = strtok(text, "\r\n"); line != NULL && ok; line = strtok(NULL, "\r\n"))
+    {
+        line_number++;
+        while (*line == ' ' || *line == '\t')
+        {
+            line++;
+        }
+
+        if (line[0] == 'v' && line[1] == ' ')
+        {
+            positions = _rxmesh_grow(positions, &position_capacity, (position_count + 1) * 3, sizeof(float));
+            float *p = &positions[position_count++ * 3];
+            p[0] = p[1] = p[2] = 0.f;
+            sscanf(line + 2, "%f %f %f", &p[0], &p[1], &p[2]);
+        }
+        else if (line[0] == 'v' && line[1] == 't')
+        {
+            uvs = _rxmesh_grow(uvs, &uv_capacity, (uv_count + 1) * 2, sizeof(float));
+            float *t = &uvs[uv_count++ * 2];
+            t[0] = t[1] = 0.f;
+            sscanf(line + 3, "%f %f", &t[0], &t[1]);
+        }
+        else if (line[0] == 'v' && line[1] == 'n')
+        {
+            normals = _rxmesh_grow(normals, &normal_capacity, (normal_count + 1) * 3, sizeof(float));
+            float *n = &normals[normal_count++ * 3];
+            n[0] = n[1] = n[2] = 0.f;
+            sscanf(line + 3, "%f %f %f", &n[0], &n[1], &n[2]);
+        }
+        else if (line[0] == 'f' && line[1] == ' ')
+        {
+            // polygons are split into a fan around their first corner
+            uint32_t corners[3];
+            uint32_t corner_count = 0;
+            char *cursor = line + 2;
+            while (*cursor != '\0')
+            {
+                while (*cursor == ' ' || *cursor == '\t')
+                {
+                    cursor++;
+                }
+                if (*cursor == '\0')
+                {
+                    break;
+                }
+
+                rxmesh_obj_corner_t key = {0};
+                key.position = _rxmesh_obj_resolve(strtol(cursor, &cursor, 10), position_count);
+                if (*cursor == '/')
+                {
+                    cursor++;
+                    if (*cursor != '/')
+                    {
+                        key.uv = _rxmesh_obj_resolve(strtol(cursor, &cursor, 10), uv_count);
+                    }
+                    if (*cursor == '/')
+                    {
+                        cursor++;
+                        key.normal = _rxmesh_obj_resolve(strtol(cursor, &cursor, 10), normal_count);
+                    }
+                }
+                while (*cursor != '\0' && *cursor != ' ' && *cursor != '\t')
+                {
+                    cursor++;
+                }
+
+                if (key.position < 0 || key.uv < 0 || key.normal < 0)
+                {
+                    fprintf(stderr, "%s:%u: face refers to something that doesn't exist\n", path, line_number);
+                    ok = false;
+                    break;
+                }
+
+                uint32_t vertex = _rxmesh_obj_get_vertex(mesh, &map, key, positions, uvs, normals);
+                if (corner_count < 2)
+                {
+                    corners[corner_count++] = vertex;
+                    continue;
+                }
+                corners[2] = vertex;
+                _rxmesh_add_index(mesh, corners[0]);
+                _rxmesh_add_index(mesh, corners[1]);
+                _rxmesh_add_index(mesh, corners[2]);
+                corners[1] = corners[2];
+            }
+        }
+    }
+
+    if (ok && normal_count == 0)
+    {
+        _rxmesh_generate_normals(mesh, first_vertex, first_index);
+    }
+
+    free(positions);
+    free(uvs);
+    free(normals);
+    free(map.keys);
+    free(map.values);
+    free(text);
+    return ok;
+}
+
+typedef struct rxmesh_gltf_t
+{
+    cJSON *json;
+    uint8_t **buffers;
+    size_t *buffer_sizes;
+    uint32_t buffer_count;
+    char *glb; // the whole file for binary gltf, whose first buffer lives inside it
+} rxmesh_gltf_t;
+
+static int32_t _rxmesh_json_int(cJSON *object, const char *name, int32_t fallback)
+{
+    cJSON *item = cJSON_GetObjectItemCaseSensitive(object, name);
+    return cJSON_IsNumber(item) ? item->valueint : fallback;
+}
+
+static uint8_t *_rxmesh_base64_decode(const char *text, size_t *size_out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t length = strlen(text);
+    uint8_t *data = malloc(length / 4 * 3 + 3);
+    size_t size = 0;
+    uint32_t bits = 0;
+    uint32_t bit_count = 0;
+    for (size_t i = 0; i < length && text[i] != '='; i++)
+    {
+        const char *found = strchr(alphabet, text[i]);
+        if (found == NULL || text[i] == '\0')
+        {
+            continue;
+        }
+        bits = (bits << 6) | (uint32_t)(found - alphabet);
+        bit_count += 6;
+        if (bit_count >= 8)
+        {
+            bit_count -= 8;
+            data[size++] = (uint8_t)(bits >> bit_count);
+        }
+    }
+    *size_out = size;
+    return data;
+}
+
+static bool _rxmesh_gltf_load_buffers(rxmesh_gltf_t *gltf, const char *path, uint8_t *glb_chunk, size_t glb_chunk_size)
+{
+    cJSON *buffers = cJSON_GetObjectItemCaseSensitive(gltf->json, "buffers");
+    gltf->buffer_count = (uint32_t)cJSON_GetArraySize(buffers);
+    gltf->buffers = calloc(gltf->buffer_count + 1, sizeof(uint8_t *));
+    gltf->buffer_sizes = calloc(gltf->buffer_count + 1, sizeof(size_t));
+
+    for (uint32_t i = 0; i < gltf->buffer_count; i++)
+    {
+        cJSON *buffer = cJSON_GetArrayItem(buffers, (int)i);
+        cJSON *uri = cJSON_GetObjectItemCaseSensitive(buffer, "uri");
+        if (!cJSON_IsString(uri))
+        {
+            // a buffer without a uri is the binary chunk of a glb
+            if (glb_chunk == NULL)
+            {
+                fprintf(stderr, "%s: buffer %u has no data\n", path, i);
+                return false;
+            }
+            gltf->buffers[i] = malloc(glb_chunk_size);
+            memcpy(gltf->buffers[i], glb_chunk, glb_chunk_size);
+            gltf->buffer_sizes[i] = glb_chunk_size;
+            continue;
+        }
+
+        const char *base64 = strstr(uri->valuestring, ";base64,");
+        if (strncmp(uri->valuestring, "data:", 5) == 0 && base64 != NULL)
+        {
+            gltf->buffers[i] = _rxmesh_base64_decode(base64 + 8, &gltf->buffer_sizes[i]);
+            continue;
+        }
+
+        // anything else is a file next to the gltf
+        char buffer_path[4096];
+        const char *slash = strrchr(path, '/');
+        const char *backslash = strrchr(path, '\\');
+        if (backslash != NULL && (slash == NULL || backslash > slash))
+        {
+            slash = backslash;
+        }
+        int directory_length = slash != NULL ? (int)(slash - path + 1) : 0;
+        snprintf(buffer_path, sizeof(buffer_path), "%.*s%s", directory_length, path, uri->valuestring);
+        gltf->buffers[i] = (uint8_t *)_rxmesh_read_file(buffer_path, &gltf->buffer_sizes[i]);
+        if (gltf->buffers[i] == NULL)
+        {
+            fprintf(stderr, "%s: couldn't read buffer %s\n", path, buffer_path);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// reads float components of an accessor, or unsigned integers for indices, into out as floats or uint32_t
+static bool _rxmesh_gltf_read_accessor(rxmesh_gltf_t *gltf, int32_t index, uint32_t components, bool as_indices, void *out, uint32_t *count_out)
+{
+    cJSON *accessor = cJSON_GetArrayItem(cJSON_GetObjectItemCaseSensitive(gltf->json, "accessors"), index);
+    if (accessor == NULL)
+    {
+        return false;
+    }
+
+    uint32_t count = (uint32_t)_rxmesh_json_int(accessor, "count", 0);
+    int32_t component_type = _rxmesh_json_int(accessor, "componentType", 0);
+    cJSON *view = cJSON_GetArrayItem(cJSON_GetObjectItemCaseSensitive(gltf->json, "bufferViews"), _rxmesh_json_int(accessor, "bufferView", -1));
+    if (out == NULL)
+    {
+        *count_out = count;
+        return view != NULL;
+    }
+    if (view == NULL)
+    {
+        return false;
+    }
+
+    uint32_t component_size = component_type == 5121 ? 1 : component_type == 5123 ? 2 : 4;
+    if ((!as_indices && component_type != 5126) || (as_indices && component_type != 5121 && component_type != 5123 && component_type != 5125))
+    {
+        return false;
+    }
+
+    int32_t buffer = _rxmesh_json_int(view, "buffer", -1);
+    size_t offset = (size_t)_rxmesh_json_int(view, "byteOffset", 0) + (size_t)_rxmesh_json_int(accessor, "byteOffset", 0);
+    size_t stride = (size_t)_rxmesh_json_int(view, "byteStride", (int32_t)(component_size * components));
+    if (buffer < 0 || (uint32_t)buffer >= gltf->buffer_count || (count > 0 && offset + stride * (count - 1) + component_size * components > gltf->buffer_sizes[buffer]))
+    {
+        return false;
+    }
+
+    const uint8_t *data = gltf->buffers[buffer] + offset;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *element = data + stride * i;
+        if (!as_indices)
+        {
+            memcpy((float *)out + i * components, element, sizeof(float) * components);
+        }
+        else if (component_size == 1)
+        {
+            ((uint32_t *)out)[i] = element[0];
+        }
+        else if (component_size == 2)
+        {
+            uint16_t value;
+            memcpy(&value, element, sizeof(value));
+            ((uint32_t *)out)[i] = value;
+        }
+        else
+        {
+            memcpy((uint32_t *)out + i, element, sizeof(uint32_t));
+        }
+    }
+    *count_out = count;
+    return true;
+}
+
+static bool _rxmesh_gltf_add_primitive(rxmesh_gltf_t *gltf, const char *path, cJSON *primitive, rxmesh_t *mesh)
+{
+    // only triangle lists, which is what the mode defaults to
+    if (_rxmesh_json_int(primitive, "mode", 4) != 4)
+    {
+        fprintf(stderr, "%s: skipping a primitive that isn't a triangle list\n", path);
+        return true;
+    }
+
+    cJSON *attributes = cJSON_GetObjectItemCaseSensitive(primitive, "attributes");
+    int32_t position_accessor = _rxmesh_json_int(attributes, "POSITION", -1);
+    int32_t normal_accessor = _rxmesh_json_int(attributes, "NORMAL", -1);
+    int32_t uv_accessor = _rxmesh_json_int(attributes, "TEXCOORD_0", -1);
+    int32_t index_accessor = _rxmesh_json_int(primitive, "indices", -1);
+
+    uint32_t vertex_count = 0;
+    if (position_accessor < 0 || !_rxmesh_gltf_read_accessor(gltf, position_accessor, 3, false, NULL, &vertex_count))
+    {
+        fprintf(stderr, "%s: primitive has no positions\n", path);
+        return false;
+    }
+
+    float *positions = malloc(sizeof(float) * 3 * vertex_count + 1);
+    float *normals = calloc((size_t)vertex_count * 3 + 1, sizeof(float));
+    float *uvs = calloc((size_t)vertex_count * 2 + 1, sizeof(float));
+    uint32_t count = 0;
+    bool ok = _rxmesh_gltf_read_accessor(gltf, position_accessor, 3, false, positions, &count);
+    if (ok && normal_accessor >= 0)
+    {
+        ok = _rxmesh_gltf_read_accessor(gltf, normal_accessor, 3, false, normals, &count) && count == vertex_count;
+    }
+    if (ok && uv_accessor >= 0 && !(_rxmesh_gltf_read_accessor(gltf, uv_accessor, 2, false, uvs, &count) && count == vertex_count))
+    {
+        fprintf(stderr, "%s: texture coordinates aren't floats, leaving them at zero\n", path);
+        memset(uvs, 0, sizeof(float) * 2 * vertex_count);
+    }
+    if (!ok)
+    {
+        fprintf(stderr, "%s: couldn't read the vertices of a primitive\n", path);
+        free(positions);
+        free(normals);
+        free(uvs);
+        return false;
+    }
+
+    uint32_t first_vertex = mesh->vertex_count;
+    uint32_t first_index = mesh->index_count;
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        rxmesh_vertex_t vertex = {0};
+        memcpy(vertex.position, &positions[i * 3], sizeof(vertex.position));
+        memcpy(vertex.normal, &normals[i * 3], sizeof(vertex.normal));
+        memcpy(vertex.uv, &uvs[i * 2], sizeof(vertex.uv));
+        _rxmesh_add_vertex(mesh, vertex);
+    }
+
+    // without indices, every three vertices are a triangle
+    uint32_t index_count = vertex_count;
+    uint32_t *indices = NULL;
+    if (index_accessor >= 0)
+    {
+        _rxmesh_gltf_read_accessor(gltf, index_accessor, 1, true, NULL, &index_count);
+        indices = malloc(sizeof(uint32_t) * index_count + 1);
+        if (!_rxmesh_gltf_read_accessor(gltf, index_accessor, 1, true, indices, &index_count))
+        {
+            fprintf(stderr, "%s: couldn't read the indices of a primitive\n", path);
+            ok = false;
+        }
+    }
+
+    for (uint32_t i = 0; ok && i < index_count; i++)
+    {
+        uint32_t index = indices != NULL ? indices[i] : i;
+        if (index >= vertex_count)
+        {
+            fprintf(stderr, "%s: index %u is past the end of the vertices\n", path, index);
+            ok = false;
+            break;
+        }
+        _rxmesh_add_index(mesh, first_vertex + index);
+    }
+
+    if (ok && normal_accessor < 0)
+    {
+        _rxmesh_generate_normals(mesh, first_vertex, first_index);
+    }
+
+    free(positions);
+    free(normals);
+    free(uvs);
+    free(indices);
+    return ok;
+}
+
+static bool _rxmesh_load_gltf(const char *path, rxmesh_t *mesh)
+{
+    size_t size = 0;
+    char *data = _rxmesh_read_file(path, &size);
+    if (data == NULL)
+    {
+        fprintf(stderr, "%s: couldn't read the file\n", path);
+        return false;
+    }
+
+    rxmesh_gltf_t gltf = {0};
+    uint8_t *bin_chunk = NULL;
+    size_t bin_chunk_size = 0;
+    const char *json_text = data;
+    size_t json_size = size;
+
+    // a glb is a header, then a json chunk, then optionally a binary one
+    uint32_t magic = 0;
+    memcpy(&magic, data, size >= 4 ? 4 : 0);
+    if (magic == 0x46546c67u)
+    {
+        uint32_t chunk_header[2];
+        if (size < 20)
+        {
+            fprintf(stderr, "%s: truncated glb\n", path);
+            free(data);
+            return false;
+        }
+        memcpy(chunk_header, data + 12, sizeof(chunk_header));
+        json_text = data + 20;
+        json_size = chunk_header[0];
+        size_t bin_start = 20 + ((json_size + 3) & ~(size_t)3);
+        if (bin_start + 8 <= size)
+        {
+            memcpy(chunk_header, data + bin_start, sizeof(chunk_header));
+            bin_chunk = (uint8_t *)data + bin_start + 8;
+            bin_chunk_size = chunk_header[0] < size - bin_start - 8 ? chunk_header[0] : size - bin_start - 8;
+        }
+    }
+
+    gltf.json = cJSON_ParseWithLength(json_text, json_size);
+    bool ok = gltf.json != NULL && _rxmesh_gltf_load_buffers(&gltf, path, bin_chunk, bin_chunk_size);
+    if (gltf.json == NULL)
+    {
+        fprintf(stderr, "%s: couldn't parse the json\n", path);
+    }
+
+    cJSON *meshes = ok ? cJSON_GetObjectItemCaseSensitive(gltf.json, "meshes") : NULL;
+    cJSON *gltf_mesh = NULL;
+    cJSON_ArrayForEach(gltf_mesh, meshes)
+    {
+        cJSON *primitive = NULL;
+        cJSON_ArrayForEach(primitive, cJSON_GetObjectItemCaseSensitive(gltf_mesh, "primitives"))
+        {
+            ok = ok && _rxmesh_gltf_add_primitive(&gltf, path, primitive, mesh);
+        }
+    }
+
+    for (uint32_t i = 0; i < gltf.buffer_count; i++)
+    {
+        free(gltf.buffers[i]);
+    }
+    free(gltf.buffers);
+    free(gltf.buffer_sizes);
+    cJSON_Delete(gltf.json);
+    free(data);
+    return ok;
+}
+
+static bool _rxmesh_load(const char *path, rxmesh_t *mesh)
+{
+    if (_rxmesh_ends_with(path, ".obj") || _rxmesh_ends_with(path, ".OBJ"))
+    {
+        return _rxmesh_load_obj(path, mesh);
+    }
+    if (_rxmesh_ends_with(path, ".gltf") || _rxmesh_ends_with(path, ".glb") || _rxmesh_ends_with(path, ".GLTF") || _rxmesh_ends_with(path, ".GLB"))
+    {
+        return _rxmesh_load_gltf(path, mesh);
+    }
+
+    fprintf(stderr, "%s: only .obj, .gltf and .glb files can be converted\n", path);
+    return false;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 3 || argc % 2 == 0)
+    {
+        fprintf(stderr, "usage: %s <output.rxmesh> <input> [<lod input> <screen size>]...\n", argv[0]);
+        return 1;
+    }
+
+    // every lod goes in the same blobs, one after another
+    rxmesh_t mesh = {0};
+    rxcore_mesh_file_header_t header = {0};
+    header.vertex_size = sizeof(rxmesh_vertex_t);
+    header.index_size = sizeof(uint32_t);
+    // the first input stands alone, every one after it is followed by its screen size
+    for (int arg = 2; arg < argc; arg += arg == 2 ? 1 : 2)
+    {
+        if (header.lod_count == RXCORE_MESH_FILE_MAX_LODS)
+        {
+            fprintf(stderr, "a mesh can have at most %d lods\n", RXCORE_MESH_FILE_MAX_LODS);
+            return 1;
+        }
+
+        float screen_size = arg == 2 ? FLT_MAX : strtof(argv[arg + 1], NULL);
+        if (arg > 2 && !(screen_size > 0.f && screen_size < header.lods[header.lod_count - 1].screen_size))
+        {
+            fprintf(stderr, "the screen size of %s has to be above zero, and below that of the lod before it\n", argv[arg]);
+            return 1;
+        }
+
+        rxcore_mesh_file_lod_t *lod = &header.lods[header.lod_count++];
+        lod->starting_index = mesh.index_count;
+        lod->base_vertex = mesh.vertex_count;
+        lod->screen_size = screen_size;
+
+        // the loaders index from the start of the blob, the lods from their base vertex
+        if (!_rxmesh_load(argv[arg], &mesh))
+        {
+            return 1;
+        }
+        for (uint32_t i = lod->starting_index; i < mesh.index_count; i++)
+        {
+            mesh.indices[i] -= lod->base_vertex;
+        }
+        lod->index_count = mesh.index_count - lod->starting_index;
+
+        // the lod is last in the blobs, so the vertices welded away are simply dropped from the end
+        rxcore_mesh_optimizer_stats_t before, after;
+        uint32_t vertex_count = rxcore_mesh_optimizer_optimize(mesh.vertices + lod->base_vertex, mesh.vertex_count - lod->base_vertex, sizeof(rxmesh_vertex_t),
+                                                               mesh.indices + lod->starting_index, lod->index_count, &before, &after);
+        mesh.vertex_count = lod->base_vertex + vertex_count;
+        printf("%s: %u vertices, %u triangles\n", argv[arg], vertex_count, lod->index_count / 3);
+        printf("  optimized from %u vertices, acmr %.3f to %.3f, atvr %.3f to %.3f\n", before.vertex_count, before.acmr, after.acmr, before.atvr, after.atvr);
+    }
+
+    // the bounds are those of the mesh itself, which the coarser lods are expected to stay inside of
+    uint32_t lod0_vertices = header.lod_count > 1 ? header.lods[1].base_vertex : mesh.vertex_count;
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        header.bounds_min[axis] = lod0_vertices > 0 ? FLT_MAX : 0.f;
+        header.bounds_max[axis] = lod0_vertices > 0 ? -FLT_MAX : 0.f;
+    }
+    for (uint32_t i = 0; i < lod0_vertices; i++)
+    {
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            header.bounds_min[axis] = fminf(header.bounds_min[axis], mesh.vertices[i].position[axis]);
+            header.bounds_max[axis] = fmaxf(header.bounds_max[axis], mesh.vertices[i].position[axis]);
+        }
+    }
+
+    header.vertex_count = mesh.vertex_count;
+    header.index_count = mesh.index_count;
+    if (!rxcore_mesh_file_write(argv[1], &header, mesh.vertices, mesh.indices))
+    {
+        fprintf(stderr, "%s: couldn't write the file\n", argv[1]);
+        return 1;
+    }
+
+    printf("wrote %s, %u vertices, %u indices, %u lods\n", argv[1], header.vertex_count, header.index_count, header.lod_count);
+    _rxmesh_free(&mesh);
+    return 0;
+}